@@ -193,6 +193,7 @@
               (toggle ("Expand beamer slides" "texmacs->pdf:expand slides"))
 	      (toggle ("Distill encapsulated Pdf files" "texmacs->pdf:distill inclusion"))
 	      (toggle ("Check exported files" "texmacs->pdf:check"))
+	      (toggle ("Compress Pdf objects" "texmacs->pdf:object streams"))
 	      (enum ("Pdf version" "texmacs->pdf:version")
 		    ("Default" "default")
 		    ("1.4" "1.4")
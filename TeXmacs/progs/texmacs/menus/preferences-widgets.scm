@@ -482,6 +482,9 @@
       (aligned (meti (hlist // (text "Check exported Pdf files for correctness"))
 	(toggle (set-boolean-preference "texmacs->pdf:check" answer)
 		(get-boolean-preference "texmacs->pdf:check"))))
+      (aligned (meti (hlist // (text "Compress Pdf objects (Pdf 1.5)"))
+	(toggle (set-boolean-preference "texmacs->pdf:object streams" answer)
+		(get-boolean-preference "texmacs->pdf:object streams"))))
       (aligned (item (text "Pdf version number:")
         (enum (set-preference "texmacs->pdf:version" answer)
 	      '("default" "1.4" "1.5" "1.6" "1.7")
@@ -77,6 +77,7 @@
   ("show full context" "on" (lambda args (noop)))
   ("show table cells" (get-default-show-table-cells) (lambda args (noop)))
   ("show focus" "on" (lambda args (noop)))
+  ("tile cache" "on" (lambda args (noop)))
   ("show only semantic focus" "on" (lambda args (noop)))
   ("semantic editing" "off" (lambda args (noop)))
   ("semantic selections" "on" (lambda args (noop)))
@@ -19,30 +19,48 @@
 ;; Learning characters
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
+;; The learned glyphs are kept in glyphs-file.  Since recomputing their
+;; invariants is slow, the C++ index is also saved in glyphs-index, which
+;; is used for recognition as long as glyphs-file did not change.
+
 (tm-define last-glyph '())
 (tm-define glyph-table (make-ahash-table))
 
+(define glyphs-file "~/.TeXmacs/system/glyphs.scm")
+(define glyphs-index "~/.TeXmacs/system/glyphs.index")
 (define glyphs-loaded? #f)
+(define glyph-table-loaded? #f)
+
+(define (load-glyph-list)
+  (with l (if (url-exists? glyphs-file) (load-object glyphs-file) '())
+    (when (not glyph-table-loaded?)
+      (set! glyph-table-loaded? #t)
+      (set! glyph-table (list->ahash-table l)))
+    l))
+
+(define (load-glyph-table)
+  (when (not glyph-table-loaded?)
+    (load-glyph-list)))
 
 (define (load-glyphs)
   (when (not glyphs-loaded?)
     (set! glyphs-loaded? #t)
-    (with l (if (url-exists? "~/.TeXmacs/system/glyphs.scm")
-                (load-object "~/.TeXmacs/system/glyphs.scm")
-                '())
-      (set! glyph-table (list->ahash-table l))
-      (for (x l)
+    (when (not (glyph-index-load glyphs-index glyphs-file))
+      (for (x (load-glyph-list))
         (let* ((key (car x))
                (im (cdr x)))
           (for (y im)
-            (glyph-register key y)))))))
+            (glyph-register key y))))
+      (when (url-exists? glyphs-file)
+        (glyph-index-save glyphs-index glyphs-file)))))
 
 (define (save-glyphs)
-  (save-object "~/.TeXmacs/system/glyphs.scm"
-               (ahash-table->list glyph-table)))
+  (save-object glyphs-file (ahash-table->list glyph-table))
+  (glyph-index-save glyphs-index glyphs-file))
 
 (tm-define (learn-glyph name)
   (load-glyphs)
+  (load-glyph-table)
   (when (and (list? last-glyph) (nnull? last-glyph))
     (glyph-register name last-glyph)
     (with old (or (ahash-ref glyph-table name) '())
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "tree.hpp"
+#include "vars.hpp"
+
+tree finalize_misc (tree t, bool floats);
+tree finalize_textm (tree t);
+
+// The shape of an imported article after upgrading, with n sections of
+// paragraphs, font changes, links, lists, displayed formulas and floats
+static tree
+article (int n) {
+  tree doc (DOCUMENT);
+  doc << compound ("doc-data", compound ("doc-title", "A long article"));
+  doc << compound ("geometry", tree (COLLECTION));
+  for (int i=0; i<n; i++) {
+    doc << compound ("section", concat ("Section ", as_string (i)));
+    doc << concat (compound ("label", "sec" * as_string (i)), " ");
+    for (int j=0; j<8; j++) {
+      tree par (CONCAT);
+      par << "Some text with "
+          << tree (WITH, FONT_SERIES, "bold", "bold words")
+          << " and "
+          << tree (WITH, FONT_FAMILY, "tt", "https://www.texmacs.org")
+          << " and "
+          << tree (WITH, FONT_SHAPE, "italic",
+                   tree (WITH, FONT_SERIES, "bold", concat ("nested")))
+          << ", followed by a formula "
+          << compound ("math", concat ("x", tree (RSUP, "2"), "+y"))
+          << compound ("new-line") << " and more text.";
+      doc << par;
+    }
+    doc << compound ("itemize", document (compound ("item"), "First",
+                                          compound ("item"), "Second"));
+    doc << compound ("eqnarray*",
+                     tree (TABLE, tree (ROW, tree (CELL, "a"), tree (CELL, "b"),
+                                        tree (CELL, compound ("no-number")))));
+    doc << compound ("bigfigure",
+                     document (compound ("center", compound ("image", "f.eps")),
+                               compound ("caption", "A figure"), ""));
+    doc << compound ("flushleft", document ("Flushed text", ""));
+    doc << compound ("!emptyline");
+  }
+  return doc;
+}
+
+static void
+latex_finalize_floats_misc (benchmark::State& state) {
+  tree t= article (state.range(0));
+  for (auto _ : state) {
+    tree r= finalize_misc (t, true);
+    benchmark::DoNotOptimize (r);
+  }
+}
+
+static void
+latex_finalize_textm (benchmark::State& state) {
+  tree t= finalize_misc (article (state.range(0)), true);
+  for (auto _ : state) {
+    tree r= finalize_textm (t);
+    benchmark::DoNotOptimize (r);
+  }
+}
+
+BENCHMARK (latex_finalize_floats_misc)->Range (8, 512);
+BENCHMARK (latex_finalize_textm)->Range (8, 512);
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include "convert.hpp"
+#include "drd_std.hpp"
+#include "vars.hpp"
+
+// A document as saved by TeXmacs 1.0.3, with n sections containing
+// the constructs which are rewritten when upgrading to later versions
+static tree
+legacy_document (int n) {
+  tree doc (DOCUMENT);
+  for (int i=0; i<n; i++) {
+    doc << compound ("section", concat ("Section ", as_string (i)));
+    doc << tree (ASSIGN, "the-label", "sec" * as_string (i));
+    for (int j=0; j<8; j++) {
+      tree par (CONCAT);
+      par << "Some text with a "
+          << compound ("hyper-link", "link", "https://www.texmacs.org")
+          << " and a formula "
+          << compound ("math", concat ("x", tree (RSUP, "2"), "+y"))
+          << tree (VALUE, "cursor") << " and more text.";
+      doc << par;
+    }
+    doc << tree (VALUE, "hrule");
+    doc << compound ("fold", "Summary", document ("Details", "More details"));
+    doc << compound ("scheme-code", "(define (f x) (* x x))");
+    doc << tree (IMAGE, "picture.eps", "*2", "/2", "", "", "", "");
+    doc << tree (TABLE, tree (ROW, tree (CELL, "1.5"), tree (CELL, "2,5")));
+    doc << tree (CWITH, "1", "1", CELL_HALIGN, ".");
+  }
+  return doc;
+}
+
+static void
+upgrade_legacy_document (benchmark::State& state) {
+  init_std_drd ();
+  tree doc= legacy_document (state.range(0));
+  int size= N (tree_to_texmacs (doc));
+  for (auto _ : state) {
+    tree r= upgrade (doc, "1.0.3");
+    benchmark::DoNotOptimize (r);
+  }
+  state.SetBytesProcessed (state.iterations () * size);
+}
+
+BENCHMARK (upgrade_legacy_document)->Range (8, 512);
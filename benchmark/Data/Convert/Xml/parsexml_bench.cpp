@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include "convert.hpp"
+
+// An Xhtml document with n sections of paragraphs, lists and tables
+static string
+xhtml_document (int n) {
+  string s= "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<html><head><title>Benchmark</title></head><body>\n";
+  for (int i=0; i<n; i++) {
+    s << "<h2 id=\"sec" << as_string (i) << "\">Section "
+      << as_string (i) << "</h2>\n";
+    for (int j=0; j<8; j++)
+      s << "<p class=\"text\">Some text with <b>bold</b>, <i>italic</i> "
+        << "and a <a href=\"https://www.texmacs.org\">link</a> &amp; "
+        << "an entity&nbsp;&#x41;.<br/></p>\n";
+    s << "<ul><li>first</li><li>second</li><li>third</li></ul>\n";
+    s << "<table><tr><td>1</td><td>2</td></tr>"
+      << "<tr><td>3</td><td>4</td></tr></table>\n";
+  }
+  s << "</body></html>\n";
+  return s;
+}
+
+static void
+parse_html_document (benchmark::State& state) {
+  string s= xhtml_document (state.range(0));
+  for (auto _ : state) {
+    tree t= parse_html (s);
+    benchmark::DoNotOptimize (t);
+  }
+  state.SetBytesProcessed (state.iterations () * N(s));
+}
+
+// The document is fed to the parser in chunks of 64KB
+static void
+parse_html_stream (benchmark::State& state) {
+  string s= xhtml_document (state.range(0));
+  for (auto _ : state) {
+    xml_html_stream stream (true);
+    for (int i=0; i<N(s); i+=65536)
+      stream.feed (s (i, min (i+65536, N(s))));
+    tree t= stream.finish ();
+    benchmark::DoNotOptimize (t);
+  }
+  state.SetBytesProcessed (state.iterations () * N(s));
+}
+
+static void
+parse_xml_document (benchmark::State& state) {
+  string s= xhtml_document (state.range(0));
+  for (auto _ : state) {
+    tree t= parse_xml (s);
+    benchmark::DoNotOptimize (t);
+  }
+  state.SetBytesProcessed (state.iterations () * N(s));
+}
+
+BENCHMARK (parse_html_document)->Range (8, 512);
+BENCHMARK (parse_html_stream)->Range (8, 512);
+BENCHMARK (parse_xml_document)->Range (8, 512);
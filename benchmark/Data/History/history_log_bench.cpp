@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include "history_log.hpp"
+
+// Undo history of typing one character at a time in a few paragraphs,
+// with the nesting of patches used by the archiver
+static patch
+typing_history (int n) {
+  patch a= patch (true, array<patch> ());
+  for (int i=0; i<n; i++) {
+    path p= path (0, path (i / 64, path (1)));
+    int  pos= i % 64;
+    patch q (mod_remove (p, pos, 1), mod_insert (p, pos, tree ("x")));
+    a= patch (patch (1.0, q), a);
+  }
+  return a;
+}
+
+static void
+history_in_memory (benchmark::State& state) {
+  for (auto _ : state) {
+    int before= mem_used ();
+    patch a= typing_history (state.range(0));
+    state.counters["bytes"]= mem_used () - before;
+    benchmark::DoNotOptimize (a);
+  }
+}
+
+static void
+history_log_push (benchmark::State& state) {
+  patch a= typing_history (state.range(0));
+  for (auto _ : state) {
+    history_log log;
+    log->push (a);
+    state.counters["bytes"]= log->memory ();
+  }
+}
+
+static void
+history_log_pop (benchmark::State& state) {
+  patch a= typing_history (state.range(0));
+  history_log log;
+  for (auto _ : state) {
+    log->push (a);
+    patch b= log->pop ();
+    benchmark::DoNotOptimize (b);
+  }
+}
+
+BENCHMARK(history_in_memory)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(history_log_push)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(history_log_pop)->RangeMultiplier(8)->Range(64, 4096);
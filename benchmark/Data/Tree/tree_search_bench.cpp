@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include "tree_search.hpp"
+#include "modification.hpp"
+
+extern tree the_et;
+
+static tree
+paragraphs (int n) {
+  tree doc (DOCUMENT);
+  for (int i=0; i<n; i++)
+    doc << concat ("Some text in paragraph ", as_string (i),
+                   compound ("em", "with emphasis"), " and more text.");
+  return doc;
+}
+
+static void
+search_detached (benchmark::State& state) {
+  tree doc= paragraphs (state.range(0));
+  for (auto _ : state) {
+    range_set r= search (doc, "needle", path ());
+    benchmark::DoNotOptimize (r);
+  }
+}
+
+static void
+search_attached (benchmark::State& state) {
+  the_et= paragraphs (state.range(0));
+  attach_ip (the_et, path ());
+  for (auto _ : state) {
+    range_set r= search (the_et, "needle", path ());
+    benchmark::DoNotOptimize (r);
+  }
+  the_et= tree ();
+}
+
+static void
+search_while_typing (benchmark::State& state) {
+  // the summaries of the modified paragraph and of its ancestors are
+  // recomputed before each search
+  int n= state.range(0);
+  the_et= paragraphs (n);
+  attach_ip (the_et, path ());
+  int i= 0;
+  for (auto _ : state) {
+    apply (the_et, mod_insert (path (i % n, 0), 0, "x"));
+    apply (the_et, mod_remove (path (i % n, 0), 0, 1));
+    range_set r= search (the_et, "needle", path ());
+    benchmark::DoNotOptimize (r);
+    i++;
+  }
+  the_et= tree ();
+}
+
+BENCHMARK (search_detached)->Range (8, 8192);
+BENCHMARK (search_attached)->Range (8, 8192);
+BENCHMARK (search_while_typing)->Range (8, 8192);
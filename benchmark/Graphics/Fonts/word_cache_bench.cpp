@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include "word_cache.hpp"
+#include "hashmap.hpp"
+
+// A long prose document: n words drawn from a vocabulary of 5000 words
+// with the Zipf distribution of natural language
+static array<string>
+prose (int n) {
+  array<string> voc;
+  array<double> cumul;
+  double tot= 0.0;
+  for (int i=0; i<5000; i++) {
+    string w;
+    int len= 2 + (i * 7) % 9;
+    for (int j=0; j<len; j++) w << ((char) ('a' + ((i * 13 + j * 5) % 26)));
+    voc << w;
+    tot += 1.0 / (i + 1);
+    cumul << tot;
+  }
+  array<string> r;
+  unsigned int seed= 1;
+  for (int k=0; k<n; k++) {
+    seed= seed * 1103515245 + 12345;
+    double x= tot * ((seed >> 8) & 0xffff) / 65536.0;
+    int lo= 0, hi= N(voc) - 1;
+    while (lo < hi) {
+      int mid= (lo + hi) >> 1;
+      if (cumul[mid] < x) lo= mid + 1; else hi= mid;
+    }
+    r << voc[lo];
+  }
+  return r;
+}
+
+// Stand-in for the shaping of a word by a font: metrics, ligatures and
+// kerning of each character
+static metric_struct            glyph_metrics[256];
+static hashmap<int,SI>          kerning_pairs (0);
+
+static void
+shape (string s, metric& ex, SI* xpos) {
+  SI x= 0;
+  int i, n= N(s);
+  xpos[0]= 0;
+  ex->y1= ex->y3= 0; ex->y2= ex->y4= 0;
+  for (i=0; i<n; i++) {
+    int c= (unsigned char) s[i];
+    if (c == 'f' && i+1 < n && (s[i+1] == 'i' || s[i+1] == 'l')) {
+      xpos[i+1]= x;
+      c= 256 - s[++i];
+    }
+    metric_struct& m= glyph_metrics[c];
+    if (i > 0) x += kerning_pairs [((int) s[i-1] << 8) + c];
+    x += m.x2;
+    xpos[i+1]= x;
+    ex->y1= min (ex->y1, m.y1);
+    ex->y2= max (ex->y2, m.y2);
+  }
+  ex->x1= ex->x3= 0;
+  ex->x2= ex->x4= x;
+}
+
+static void
+init_metrics () {
+  for (int c=0; c<256; c++) {
+    glyph_metrics[c].x2= 500 + 37 * (c % 11);
+    glyph_metrics[c].y1= - 10 * (c % 3);
+    glyph_metrics[c].y2= 700 + 10 * (c % 5);
+  }
+  for (int a='a'; a<='z'; a++)
+    for (int b='a'; b<='z'; b += 3)
+      kerning_pairs ((a << 8) + b)= - (a % 7);
+}
+
+// Retypesetting the document, measuring every word again
+static void
+retypeset_uncached (benchmark::State& state) {
+  init_metrics ();
+  array<string> doc= prose (state.range (0));
+  SI xpos[WORD_CACHE_LENGTH + 1];
+  for (auto _ : state) {
+    SI tot= 0;
+    for (int i=0; i<N(doc); i++) {
+      metric ex;
+      shape (doc[i], ex, xpos);
+      tot += ex->x2 + xpos[N(doc[i])];
+    }
+    benchmark::DoNotOptimize (tot);
+  }
+  state.SetItemsProcessed (state.iterations () * N(doc));
+}
+
+// Retypesetting the document using a word cache, as smart fonts do
+static void
+retypeset_cached (benchmark::State& state) {
+  init_metrics ();
+  array<string> doc= prose (state.range (0));
+  word_cache wc;
+  for (auto _ : state) {
+    SI tot= 0;
+    for (int i=0; i<N(doc); i++) {
+      string s= doc[i];
+      int j, n= N(s);
+      word_shape* w= wc.find (s);
+      if (w == NULL || !w->has_extents) {
+        metric ex;
+        SI xpos[WORD_CACHE_LENGTH + 1];
+        shape (s, ex, xpos);
+        wc.miss ();
+        w= wc.insert (s);
+        w->ex= ex[0];
+        w->has_extents= true;
+        w->xpos= array<SI> (n+1);
+        for (j=0; j<=n; j++) w->xpos[j]= xpos[j];
+      }
+      else wc.hit ();
+      tot += w->ex.x2 + w->xpos[n];
+    }
+    benchmark::DoNotOptimize (tot);
+  }
+  state.SetItemsProcessed (state.iterations () * N(doc));
+  state.counters["hit_rate"]= ((double) wc.hits) / (wc.hits + wc.misses);
+}
+
+BENCHMARK (retypeset_uncached)->Arg (100000)->Unit (benchmark::kMillisecond);
+BENCHMARK (retypeset_cached)->Arg (100000)->Unit (benchmark::kMillisecond);
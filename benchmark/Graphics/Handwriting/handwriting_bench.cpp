@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+#include "handwriting.hpp"
+
+// A wavy stroke whose shape depends on the sample number
+static contours
+sample (int k, int strokes) {
+  contours gl;
+  for (int s=0; s<strokes; s++) {
+    poly_line pl;
+    for (int i=0; i<=24; i++) {
+      double t= i / 24.0;
+      double w= 0.05 * ((k * 7 + s * 3) % 11) * sin (6.0 * t + k);
+      pl << point (s + t + w, t * t - w);
+    }
+    gl << pl;
+  }
+  return gl;
+}
+
+static void
+recognize_glyph_among (benchmark::State& state) {
+  glyph_buckets= array<glyph_bucket> ();
+  glyph_bucket_index= hashmap<string,int> (-1);
+  int n= state.range(0);
+  for (int k=0; k<n; k++)
+    register_glyph (as_string (k % 26), sample (k, 1 + (k % 3)));
+  contours gl= sample (n / 2, 2);
+  for (auto _ : state) {
+    string r= recognize_glyph (gl);
+    benchmark::DoNotOptimize (r);
+  }
+}
+
+BENCHMARK (recognize_glyph_among)->Range (64, 8192);
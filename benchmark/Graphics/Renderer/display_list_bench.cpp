@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include "display_list.hpp"
+#include "colors.hpp"
+
+// A screen renderer which only counts the drawing instructions it receives
+class null_renderer_rep: public renderer_rep {
+public:
+  pencil pen;
+  brush  bg;
+  int    count;
+
+  null_renderer_rep ():
+    renderer_rep (true), pen (rgb_color (0, 0, 0), PIXEL),
+    bg (rgb_color (255, 255, 255)), count (0) {
+      cx1= cy1= MINUS_INFINITY; cx2= cy2= PLUS_INFINITY; }
+  pencil get_pencil () { return pen; }
+  brush get_background () { return bg; }
+  void set_pencil (pencil p) { pen= p; }
+  void set_background (brush b) { bg= b; }
+  void draw (int c, font_glyphs fn, SI x, SI y) {
+    (void) c; (void) fn; (void) x; (void) y; count++; }
+  void line (SI x1, SI y1, SI x2, SI y2) {
+    (void) x1; (void) y1; (void) x2; (void) y2; count++; }
+  void lines (array<SI> x, array<SI> y) { (void) x; (void) y; count++; }
+  void clear (SI x1, SI y1, SI x2, SI y2) {
+    (void) x1; (void) y1; (void) x2; (void) y2; count++; }
+  void fill (SI x1, SI y1, SI x2, SI y2) {
+    (void) x1; (void) y1; (void) x2; (void) y2; count++; }
+  void arc (SI x1, SI y1, SI x2, SI y2, int a, int d) {
+    (void) x1; (void) y1; (void) x2; (void) y2; (void) a; (void) d; }
+  void fill_arc (SI x1, SI y1, SI x2, SI y2, int a, int d) {
+    (void) x1; (void) y1; (void) x2; (void) y2; (void) a; (void) d; }
+  void polygon (array<SI> x, array<SI> y, bool convex) {
+    (void) x; (void) y; (void) convex; }
+  void fetch (SI x1, SI y1, SI x2, SI y2, renderer ren, SI x, SI y) {
+    (void) x1; (void) y1; (void) x2; (void) y2;
+    (void) ren; (void) x; (void) y; }
+  void new_shadow (renderer& ren) { ren= this; }
+  void delete_shadow (renderer& ren) { ren= NULL; }
+  void get_shadow (renderer ren, SI x1, SI y1, SI x2, SI y2) {
+    (void) ren; (void) x1; (void) y1; (void) x2; (void) y2; }
+  void put_shadow (renderer ren, SI x1, SI y1, SI x2, SI y2) {
+    (void) ren; (void) x1; (void) y1; (void) x2; (void) y2; }
+  void apply_shadow (SI x1, SI y1, SI x2, SI y2) {
+    (void) x1; (void) y1; (void) x2; (void) y2; }
+};
+
+// A dense page: a grid of rules and filled cells, as in a large table,
+// with state changes every few instructions
+static void
+draw_page (renderer ren, int n) {
+  pencil thin (rgb_color (0, 0, 0), PIXEL);
+  pencil thick (rgb_color (0, 0, 255), 2*PIXEL);
+  brush  cell (rgb_color (255, 255, 0)), plain (rgb_color (255, 255, 255));
+  for (int i=0; i<n; i++) {
+    SI x= (i % 40) * 600, y= -(i / 40) * 1200;
+    ren->set_pencil ((i & 7) == 0? thick: thin);
+    ren->line (x, y, x + 600, y);
+    ren->line (x, y, x, y - 1200);
+    ren->set_background ((i & 3) == 0? cell: plain);
+    ren->fill (x + 100, y - 1100, x + 500, y - 100);
+  }
+}
+
+static display_list
+record_page (renderer ref, int n) {
+  display_list dl (ref);
+  renderer rec= display_list_renderer (dl, ref);
+  draw_page (rec, n);
+  delete_renderer (rec);
+  return dl;
+}
+
+static void
+page_draw_direct (benchmark::State& state) {
+  null_renderer_rep ren;
+  for (auto _ : state) draw_page (&ren, state.range(0));
+  benchmark::DoNotOptimize (ren.count);
+}
+
+static void
+page_record (benchmark::State& state) {
+  null_renderer_rep ren;
+  for (auto _ : state) {
+    display_list dl= record_page (&ren, state.range(0));
+    benchmark::DoNotOptimize (dl);
+  }
+}
+
+static void
+page_replay (benchmark::State& state) {
+  null_renderer_rep ren;
+  display_list dl= record_page (&ren, state.range(0));
+  for (auto _ : state) dl->replay (&ren);
+  benchmark::DoNotOptimize (ren.count);
+}
+
+// Repainting a small exposed part of the page only replays
+// the segments which intersect the clipping rectangle
+static void
+page_replay_exposed (benchmark::State& state) {
+  null_renderer_rep ren;
+  display_list dl= record_page (&ren, state.range(0));
+  ren.set_clipping (0, -6000, 24000, 0);
+  for (auto _ : state) dl->replay (&ren);
+  benchmark::DoNotOptimize (ren.count);
+}
+
+BENCHMARK (page_draw_direct)->Range (256, 8192);
+BENCHMARK (page_record)->Range (256, 8192);
+BENCHMARK (page_replay)->Range (256, 8192);
+BENCHMARK (page_replay_exposed)->Range (256, 8192);
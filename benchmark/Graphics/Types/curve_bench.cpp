@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "curve.hpp"
+#include "path.hpp"
+
+// A synthetic technical drawing with n curves of each kind
+static array<curve>
+drawing (int n) {
+  array<curve> r;
+  for (int i=0; i<n; i++) {
+    double x= 10.0 * (i % 32), y= 10.0 * (i / 32);
+    array<point> a;
+    a << point (x, y) << point (x + 3.0, y + 7.0) << point (x + 6.0, y - 2.0)
+      << point (x + 8.0, y + 4.0) << point (x + 9.0, y);
+    r << bezier (range (a, 0, 4));
+    r << spline (a, array<path> ());
+    r << arc (range (a, 0, 3), array<path> ());
+  }
+  return r;
+}
+
+static void
+rectify_drawing (benchmark::State& state) {
+  array<curve> cs= drawing (state.range(0));
+  for (auto _ : state) {
+    int tot= 0;
+    for (int i=0; i<N(cs); i++)
+      tot += N (cs[i]->rectify (0.01));
+    benchmark::DoNotOptimize (tot);
+  }
+  state.SetItemsProcessed (state.iterations () * N(cs));
+}
+
+static void
+evaluate_drawing (benchmark::State& state) {
+  array<curve> cs= drawing (state.range(0));
+  array<double> ts;
+  for (int i=0; i<=64; i++) ts << i / 64.0;
+  for (auto _ : state) {
+    double sum= 0.0;
+    for (int i=0; i<N(cs); i++) {
+      array<point2> r= cs[i]->evaluate_batch (ts);
+      sum += r[N(r)-1].x;
+    }
+    benchmark::DoNotOptimize (sum);
+  }
+  state.SetItemsProcessed (state.iterations () * N(cs) * N(ts));
+}
+
+BENCHMARK (rectify_drawing)->Range (8, 1024);
+BENCHMARK (evaluate_drawing)->Range (8, 1024);
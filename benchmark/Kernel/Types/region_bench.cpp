@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "region.hpp"
+
+// Typical invalidation pattern while editing: small rectangles around
+// glyphs and cursors on a few consecutive lines, partially overlapping
+static rectangle
+edit_rectangle (int i) {
+  SI line= (i / 40) % 8;
+  SI col = (i * 7) % 40;
+  return rectangle (col * 600, -line * 1200 - 1000,
+                    col * 600 + 900, -line * 1200 + 200);
+}
+
+static void
+rectangles_edit_union (benchmark::State& state) {
+  for (auto _ : state) {
+    rectangles rs;
+    for (int i=0; i<state.range(0); i++)
+      rs= rs | rectangles (edit_rectangle (i));
+    benchmark::DoNotOptimize (rs);
+  }
+}
+
+static void
+region_edit_union (benchmark::State& state) {
+  for (auto _ : state) {
+    region rs;
+    for (int i=0; i<state.range(0); i++)
+      rs= rs | region (edit_rectangle (i));
+    benchmark::DoNotOptimize (rs);
+  }
+}
+
+// Scrolling: the invalid region is shifted, clipped to the window
+// and the newly exposed strip is added
+static void
+region_scroll (benchmark::State& state) {
+  region window (0, -60000, 40000, 0);
+  region rs;
+  for (int i=0; i<state.range(0); i++)
+    rs= rs | region (edit_rectangle (i));
+  for (auto _ : state) {
+    region r= translate (rs, 0, 1200) & window;
+    r= r | region (0, -1200, 40000, 0);
+    benchmark::DoNotOptimize (r);
+  }
+}
+
+static void
+region_subtract (benchmark::State& state) {
+  region stored (0, -60000, 40000, 0);
+  region rs;
+  for (int i=0; i<state.range(0); i++)
+    rs= rs | region (edit_rectangle (i));
+  for (auto _ : state)
+    benchmark::DoNotOptimize (stored - rs);
+}
+
+BENCHMARK (rectangles_edit_union)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK (region_edit_union)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK (region_scroll)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK (region_subtract)->RangeMultiplier(4)->Range(4, 1024);
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include "tree.hpp"
+
+// A document in the style of the manual, where most of the markup
+// (environments, formulas, links) occurs many times
+static tree
+manual_document (int n) {
+  tree doc (DOCUMENT);
+  for (int i=0; i<n; i++) {
+    doc << compound ("section", concat ("Section ", as_string (i % 16)));
+    tree par= concat ("In order to insert a ", compound ("markup", "strong"),
+                      " text, use ", compound ("shortcut", "(make 'strong)"));
+    par << " or " << compound ("menu", "Format", "Font shape") << ".";
+    doc << par;
+    doc << compound ("equation*", concat ("x", tree (RSUP, "2"), "+y",
+                                          tree (RSUB, "i"), "=0"));
+    doc << compound ("itemize", document (compound ("item"), "An item."));
+  }
+  return doc;
+}
+
+static int
+number_of_nodes (tree t) {
+  if (is_atomic (t)) return 1;
+  int r= 1;
+  for (int i=0; i<N(t); i++) r += number_of_nodes (t[i]);
+  return r;
+}
+
+static void
+tree_copy_compare (benchmark::State& state) {
+  tree t1= manual_document (state.range(0));
+  tree t2= copy (t1);
+  for (auto _ : state) {
+    bool b= (t1 == t2) && hash (t1) == hash (t2);
+    benchmark::DoNotOptimize (b);
+  }
+}
+
+static void
+tree_frozen_compare (benchmark::State& state) {
+  tree t1= freeze (manual_document (state.range(0)));
+  tree t2= freeze (manual_document (state.range(0)));
+  for (auto _ : state) {
+    bool b= (t1 == t2) && hash (t1) == hash (t2);
+    benchmark::DoNotOptimize (b);
+  }
+}
+
+static void
+tree_copy (benchmark::State& state) {
+  tree t= manual_document (state.range(0));
+  for (auto _ : state) {
+    tree r= copy (t);
+    benchmark::DoNotOptimize (r);
+  }
+}
+
+static void
+tree_freeze (benchmark::State& state) {
+  tree t= manual_document (state.range(0));
+  tree shared= freeze (t);
+  for (auto _ : state) {
+    tree r= freeze (t);
+    benchmark::DoNotOptimize (r);
+  }
+  // memory: distinct nodes after hash-consing, against the copied nodes
+  state.counters["nodes"]= number_of_nodes (t);
+  state.counters["frozen"]= number_of_frozen_trees ();
+}
+
+BENCHMARK (tree_copy_compare)->Range (8, 4096);
+BENCHMARK (tree_frozen_compare)->Range (8, 4096);
+BENCHMARK (tree_copy)->Range (8, 4096);
+BENCHMARK (tree_freeze)->Range (8, 4096);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include "Bibtex/bibtex_functions.hpp"
+#include "file.hpp"
+#include <utime.h>
+
+// A bibliography with n entries, of which 200 are cited
+static url
+large_bibliography (int n, tree& cited) {
+  url u= url_temp_dir () * ("large_" * as_string (n) * ".bib");
+  string s= "@string{ jsc = \"Journal of Symbolic Computation\" }\n";
+  for (int i=0; i<n; i++) {
+    string key= "key" * as_string (i);
+    s << "@article{" << key << ",\n"
+      << "  author  = {A. Author" << as_string (i % 97)
+      << " and B. {van der} Coauthor},\n"
+      << "  title   = {On the {C}omplexity of $x^{" << as_string (i)
+      << "}$ and Other Problems},\n"
+      << "  journal = jsc,\n"
+      << "  volume  = " << as_string (i % 50) << ",\n"
+      << "  pages   = {" << as_string (i) << "--" << as_string (i+10) << "},\n"
+      << "  year    = 2026\n"
+      << "}\n\n";
+  }
+  save_string (u, s);
+  cited= tree (DOCUMENT);
+  for (int i=0; i<200; i++)
+    cited << ("key" * as_string ((int) (((long) i * 7919) % n)));
+  return u;
+}
+
+// Regeneration by parsing the whole file, as before
+static void
+bib_generate_parsed (benchmark::State& state) {
+  tree cited;
+  url u= large_bibliography (state.range (0), cited);
+  for (auto _ : state) {
+    string s;
+    load_string (u, s, false);
+    tree t= bib_entries (parse_bib (s), cited);
+    benchmark::DoNotOptimize (t);
+  }
+}
+
+// First regeneration after a modification of the file
+static void
+bib_generate_modified (benchmark::State& state) {
+  tree cited;
+  url u= large_bibliography (state.range (0), cited);
+  c_string path (concretize (u));
+  int date= 1000000000;
+  for (auto _ : state) {
+    state.PauseTiming ();
+    struct utimbuf times;
+    times.actime = date;
+    times.modtime= date++;
+    utime (path, &times);
+    state.ResumeTiming ();
+    tree t= bib_entries (u, cited);
+    benchmark::DoNotOptimize (t);
+  }
+}
+
+// Later regenerations of an unchanged file
+static void
+bib_generate_cached (benchmark::State& state) {
+  tree cited;
+  url u= large_bibliography (state.range (0), cited);
+  for (auto _ : state) {
+    tree t= bib_entries (u, cited);
+    benchmark::DoNotOptimize (t);
+  }
+}
+
+BENCHMARK (bib_generate_parsed)->Arg (1000)->Arg (10000)
+  ->Unit (benchmark::kMillisecond);
+BENCHMARK (bib_generate_modified)->Arg (1000)->Arg (10000)->Arg (50000)
+  ->Unit (benchmark::kMillisecond);
+BENCHMARK (bib_generate_cached)->Arg (1000)->Arg (10000)->Arg (50000)
+  ->Unit (benchmark::kMillisecond);
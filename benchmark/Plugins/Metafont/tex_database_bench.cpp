@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "Metafont/tex_database.hpp"
+#include "file.hpp"
+#include "sys_utils.hpp"
+
+// A TeX tree with 50 font families of 8 sizes each, as read by kpathsea
+// through the TEXMFCNF environment variable
+static url
+font_tree () {
+  url root= url_temp_dir () * "tex_database_bench";
+  string r= as_string (root);
+  mkdir (root);
+  mkdir (root * "web2c");
+  mkdir (root * "texmf-dist");
+  save_string (root * "web2c/texmf.cnf",
+    "TEXMFDIST = " * r * "/texmf-dist\n"
+    "TEXMF = {!!$TEXMFDIST}\n"
+    "TEXMFDBS = {!!$TEXMFDIST}\n"
+    "TFMFONTS = .;$TEXMF/fonts/tfm//\n");
+  string db= "% ls-R -- filename database for kpathsea\n";
+  for (int i=0; i<50; i++) {
+    db << "\n./fonts/tfm/public/family" << as_string (i) << ":\n";
+    for (int sz=5; sz<=12; sz++)
+      db << "font" << as_string (i) << "r" << as_string (sz) << ".tfm\n";
+  }
+  save_string (root * "texmf-dist/ls-R", db);
+  set_env ("TEXMFCNF", as_string (root * "web2c"));
+  return root;
+}
+
+// Resolution of the fonts of a session, including the reading of the
+// configuration and the database
+static void
+resolve_native (benchmark::State& state) {
+  font_tree ();
+  for (auto _ : state) {
+    reset_tex_database ();
+    for (int i=0; i<50; i++) {
+      url u= tex_database_resolve ("font" * as_string (i) * "r10.tfm");
+      benchmark::DoNotOptimize (u);
+    }
+  }
+}
+
+// The same resolutions by launching kpsewhich for every font
+static void
+resolve_kpsewhich (benchmark::State& state) {
+  font_tree ();
+  bool ok= exists_in_path ("kpsewhich");
+  if (!ok) state.SkipWithError ("kpsewhich not available");
+  for (auto _ : state)
+    for (int i=0; ok && i<50; i++) {
+      string s= var_eval_system ("kpsewhich font" * as_string (i) * "r10.tfm");
+      benchmark::DoNotOptimize (s);
+    }
+}
+
+BENCHMARK (resolve_native)->Unit (benchmark::kMillisecond);
+BENCHMARK (resolve_kpsewhich)->Unit (benchmark::kMillisecond);
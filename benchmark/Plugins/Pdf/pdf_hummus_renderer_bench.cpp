@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include "Pdf/pdf_hummus_renderer.hpp"
+#include "Freetype/tt_file.hpp"
+#include "file.hpp"
+#include "sys_utils.hpp"
+#include "boot.hpp"
+
+// Export justified lines of text in a TrueType font, as for a book;
+// the inter-word spaces differ from line to line
+static void
+export_book (url pdf, font_glyphs fn, int nr_pages) {
+  string text=
+    "TeXmacs is a free scientific text editor, which was both inspired "
+    "by TeX and GNU Emacs. The editor allows you to write structured "
+    "documents via a wysiwyg and user friendly interface. ";
+  int dpi= 600;
+  renderer ren= pdf_hummus_renderer (pdf, dpi, nr_pages);
+  SI px= ren->pixel;
+  SI left= dpi * px, right= (dpi * 15 / 2) * px;
+  int pos= 0, n= N(text);
+  for (int page=0; page<nr_pages; page++) {
+    if (page > 0) ren->next_page ();
+    for (int line=0; line<60; line++) {
+      SI x= left, y= -(dpi + 100 * line) * px;
+      SI space= (20 + (line % 7)) * px;
+      while (x < right) {
+        int c= (int) (unsigned char) text[pos];
+        pos= (pos + 1) % n;
+        if (c == ' ') { x += space; continue; }
+        ren->draw (c, fn, x, y);
+        x += fn->get (c)->lwidth * px;
+      }
+    }
+  }
+  tm_delete (ren);
+}
+
+// The second argument selects the packing of objects into object streams
+static void
+pdf_export_text (benchmark::State& state) {
+  if (is_none (tt_font_find ("texgyretermes-regular"))) {
+    state.SkipWithError ("TeX Gyre Termes not found; set TEXMACS_PATH");
+    return;
+  }
+  font_glyphs fn= tt_font_glyphs ("texgyretermes-regular", 10, 600, 600);
+  set_user_preference ("texmacs->pdf:object streams",
+                       state.range(1) != 0? "on": "off");
+  url pdf= url_temp (".pdf");
+  int size= 0;
+  for (auto _ : state) {
+    export_book (pdf, fn, state.range(0));
+    size= file_size (pdf);
+  }
+  remove (pdf);
+  reset_user_preference ("texmacs->pdf:object streams");
+  state.counters["pdf_bytes"]= size;
+  state.counters["bytes_per_page"]= size / (double) state.range(0);
+}
+
+// The argument is the number of threads for the compression of pages;
+// with one thread, pages are compressed while they are written
+static void
+pdf_export_threads (benchmark::State& state) {
+  if (is_none (tt_font_find ("texgyretermes-regular"))) {
+    state.SkipWithError ("TeX Gyre Termes not found; set TEXMACS_PATH");
+    return;
+  }
+  font_glyphs fn= tt_font_glyphs ("texgyretermes-regular", 10, 600, 600);
+  set_user_preference ("texmacs->pdf:threads", as_string (state.range(0)));
+  url pdf= url_temp (".pdf");
+  for (auto _ : state)
+    export_book (pdf, fn, 200);
+  remove (pdf);
+  reset_user_preference ("texmacs->pdf:threads");
+}
+
+BENCHMARK (pdf_export_text)->ArgNames ({"pages", "objstm"})
+  ->Args ({10, 0})->Args ({10, 1})->Args ({100, 0})->Args ({100, 1})
+  ->Args ({500, 0})->Args ({500, 1})->Unit (benchmark::kMillisecond);
+BENCHMARK (pdf_export_threads)->Arg (1)->Arg (2)->Arg (4)->Arg (8)
+  ->UseRealTime ()->Unit (benchmark::kMillisecond);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "Boxes/construct.hpp"
+
+static box
+gen_line (int64_t n) {
+  array<box> bs;
+  array<SI>  x, y;
+  for (int i=0; i<n; i++) {
+    bs << empty_box (path (i), 0, -200, 1000, 800);
+    x  << 1000 * i;
+    y  << 0;
+  }
+  return composite_box (path (), bs, x, y);
+}
+
+static box
+gen_grid (int64_t n) {
+  array<box> bs;
+  array<SI>  x, y;
+  int cols= (int) sqrt ((double) n);
+  for (int i=0; i<n; i++) {
+    bs << empty_box (path (i), 0, 0, 800, 800);
+    x  << 1000 * (i % cols);
+    y  << -1000 * (i / cols);
+  }
+  return composite_box (path (), bs, x, y);
+}
+
+static void
+find_box_path_line (benchmark::State& state) {
+  box b= gen_line (state.range(0));
+  SI  x= 0;
+  for (auto _ : state) {
+    bool found= false;
+    benchmark::DoNotOptimize (b->find_box_path (x, 0, 0, false, found));
+    x= (x + 7919) % b->x2;
+  }
+}
+
+static void
+find_box_path_grid (benchmark::State& state) {
+  box b= gen_grid (state.range(0));
+  SI  x= 0, y= 0;
+  for (auto _ : state) {
+    bool found= false;
+    benchmark::DoNotOptimize (b->find_box_path (x, y, 0, false, found));
+    x= (x + 7919) % b->x2;
+    y= (y - 6271) % b->y1;
+  }
+}
+
+static void
+graphical_select_grid (benchmark::State& state) {
+  box b= gen_grid (state.range(0));
+  SI  x= 0, y= 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize (b->graphical_select (x, y, 500));
+    x= (x + 7919) % b->x2;
+    y= (y - 6271) % b->y1;
+  }
+}
+
+BENCHMARK (find_box_path_line)->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK (find_box_path_grid)->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK (graphical_select_grid)->RangeMultiplier(4)->Range(16, 16384);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include "Boxes/construct.hpp"
+#include "Format/page_item.hpp"
+#include "Page/skeleton.hpp"
+#include "font.hpp"
+
+skeleton break_pages (array<page_item> l, space ph, int qual,
+                      space fn_sep, space fnote_sep, space float_sep,
+                      font fn, int first_page,
+                      array<page_item> old_l, skeleton old_sk);
+
+struct bench_font_rep: font_rep {
+  bench_font_rep (): font_rep ("page-breaker-bench") { y1= -2000; y2= 8000; }
+  bool supports (string c) { (void) c; return true; }
+  void get_extents (string s, metric& ex) { (void) s; (void) ex; }
+  void draw_fixed (renderer ren, string s, SI x, SI y) {
+    (void) ren; (void) s; (void) x; (void) y; }
+  font magnify (double zx, double zy) { (void) zx; (void) zy; return this; }
+};
+
+static font
+bench_font () {
+  static font fn= tm_new<bench_font_rep> ();
+  return fn;
+}
+
+// Lines of a document with paragraphs of eight lines, about 45 per page
+static page_item
+line (int i) {
+  page_item item (empty_box (path (i), 0, -2000, 300000, 8000));
+  int j= i % 8;
+  item->spc    = j == 7? space (4000, 6000, 10000): space (2000);
+  item->penalty= j == 0 || j == 6? 100: (j == 7? 0: 1);
+  return item;
+}
+
+static array<page_item>
+document (int nr_pages) {
+  array<page_item> l;
+  for (int i=0; i<45*nr_pages; i++) l << line (i);
+  return l;
+}
+
+static skeleton
+break_document (array<page_item> l, array<page_item> old_l, skeleton old_sk) {
+  space ht (550000, 570000, 590000);
+  return break_pages (l, ht, 2, space (0), space (0), space (0),
+                      bench_font (), 1, old_l, old_sk);
+}
+
+// Retype a line on page 200 of a 300 page document and break it again
+static void
+rebreak_after_keystroke (benchmark::State& state) {
+  bool incremental= state.range (0) != 0;
+  array<page_item> l= document (300);
+  skeleton sk= break_document (l, array<page_item> (), skeleton ());
+  int k= 45 * 200 + 3, serial= 45 * 300;
+  for (auto _ : state) {
+    array<page_item> new_l= copy (l);
+    page_item item= line (k);
+    item->b= empty_box (path (serial++), 0, -2000, 300000, 8000);
+    new_l[k]= item;
+    if (incremental) sk= break_document (new_l, l, sk);
+    else sk= break_document (new_l, array<page_item> (), skeleton ());
+    l= new_l;
+  }
+  state.counters["pages"]= N(sk);
+}
+
+// Add or remove a line of a paragraph on page 200
+static void
+rebreak_after_new_line (benchmark::State& state) {
+  bool incremental= state.range (0) != 0;
+  array<page_item> l= document (300);
+  skeleton sk= break_document (l, array<page_item> (), skeleton ());
+  int k= 45 * 200 + 3, serial= 45 * 300;
+  bool grow= true;
+  for (auto _ : state) {
+    array<page_item> new_l;
+    new_l << range (l, 0, k);
+    if (grow) new_l << line (serial++);
+    new_l << range (l, grow? k: k+1, N(l));
+    if (incremental) sk= break_document (new_l, l, sk);
+    else sk= break_document (new_l, array<page_item> (), skeleton ());
+    l= new_l;
+    grow= !grow;
+  }
+  state.counters["pages"]= N(sk);
+}
+
+BENCHMARK (rebreak_after_keystroke)->Arg (0)->Arg (1);
+BENCHMARK (rebreak_after_new_line)->Arg (0)->Arg (1);
@@ -294,6 +294,7 @@ bib_entry (string s, int& pos, tree type, tree& t) {
   bib_blank (s, pos);
   string tag;
   bib_until (s, pos, cs, tag);
+  tag= trim_spaces_right (tag);
   bib_current_tag= copy (tag);
   bib_blank (s, pos);
   string ce;
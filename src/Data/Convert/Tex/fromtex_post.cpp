@@ -17,6 +17,7 @@
 #include "vars.hpp"
 #include "tree_correct.hpp"
 #include "url.hpp"
+#include "tm_timer.hpp"
 
 tree upgrade_tex (tree t);
 extern bool textm_class_flag;
@@ -1529,44 +1530,56 @@ find_caption (tree t) {
   }
 }
 
-tree
-finalize_floats (tree t) {
-  if (is_atomic (t)) return t;
-  else if (is_var_compound (t, "bigfigure", 1)) {
+static bool
+finalize_float (tree t, tree& r) {
+  // if t is a float, then set r to the corresponding TeXmacs float
+  if (is_var_compound (t, "bigfigure", 1)) {
     tree body= float_body (t[N(t)-1]);
     tree capt= find_caption (t[N(t)-1]);
-    return tree (make_tree_label ("big-figure"), body, capt);
+    r= tree (make_tree_label ("big-figure"), body, capt);
   }
   else if (is_var_compound (t, "bigtable", 1)) {
     tree body= float_body (t[N(t)-1]);
     tree capt= find_caption (t[N(t)-1]);
-    return tree (make_tree_label ("big-table"), body, capt);
+    r= tree (make_tree_label ("big-table"), body, capt);
   }
   else if (is_var_compound (t, "bigfigure*", 1)) {
     tree body= float_body (t[N(t)-1]);
     tree capt= find_caption (t[N(t)-1]);
-    return tree (WITH, "par-columns", "1",
-                 tree (make_tree_label ("big-figure"), body, capt));
+    r= tree (WITH, "par-columns", "1",
+             tree (make_tree_label ("big-figure"), body, capt));
   }
   else if (is_var_compound (t, "bigtable*", 1)) {
     tree body= float_body (t[N(t)-1]);
     tree capt= find_caption (t[N(t)-1]);
-    return tree (WITH, "par-columns", "1",
-                 tree (make_tree_label ("big-table"), body, capt));
+    r= tree (WITH, "par-columns", "1",
+             tree (make_tree_label ("big-table"), body, capt));
   }
   else if (is_var_compound (t, "algorithm", 1)) {
     tree body= float_body (t[N(t)-1]);
     tree capt= find_caption (t[N(t)-1]);
-    if (capt == "")
-      return t;
-    else
-      return tree (make_tree_label ("specified-algorithm"), capt, body);
+    if (capt == "") r= t;
+    else r= tree (make_tree_label ("specified-algorithm"), capt, body);
   }
+  else return false;
+  return true;
+}
+
+tree
+finalize_floats (tree t) {
+  tree r;
+  if (is_atomic (t)) return t;
+  else if (finalize_float (t, r)) return r;
   else {
+    // subtrees without floats are shared with t
     int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= finalize_floats (t[i]);
+    r= t;
+    for (i=0; i<n; i++) {
+      tree u= finalize_floats (t[i]);
+      if (strong_equal (u, t[i])) continue;
+      if (strong_equal (r, t)) r= t (0, n);
+      r[i]= u;
+    }
     return r;
   }
 }
@@ -1577,58 +1590,72 @@ is_hyper_link (string s) {
 }
 
 tree
-finalize_misc (tree t) {
+finalize_misc (tree t, bool floats) {
+  // if floats holds, then finalize_floats is applied first, in the same
+  // traversal; unchanged subtrees are shared with t
+  tree r;
   if (is_atomic (t)) return t;
+  else if (floats && finalize_float (t, r))
+    return finalize_misc (r, false);
   // Fixme: to be improved when TeXmacs will allow easy personalisation
   else if (is_compound (t, "enumerate", 2))
-    return compound ("enumerate", t[1]);
+    return compound ("enumerate", floats? finalize_floats (t[1]): t[1]);
   else if (is_compound (t, "verbatim", 1) &&
            is_atomic (t[0]) && is_hyper_link (t[0]->label)) {
-    return compound ("slink", finalize_misc (t[0]));
+    return compound ("slink", t[0]);
   }
   else if (is_func (t, WITH, 3) && t[0] == FONT_FAMILY && t[1] == "tt" &&
            is_atomic (t[2]) && is_hyper_link (t[2]->label)) {
-    return compound ("slink", finalize_misc (t[2]));
+    return compound ("slink", t[2]);
   }
   else if (is_compound (t, "flushleft", 1) ||
            is_compound (t, "leftaligned", 1))
-    return compound ("left-aligned", finalize_misc (t[0]));
+    return compound ("left-aligned", finalize_misc (t[0], floats));
   else if (is_compound (t, "flushright", 1) ||
            is_compound (t, "rightaligned", 1))
-    return compound ("right-aligned", finalize_misc (t[0]));
+    return compound ("right-aligned", finalize_misc (t[0], floats));
   else if (is_compound (t, "acknowledgments", 1))
-    return compound ("acknowledgments*", finalize_misc (t[0]));
+    return compound ("acknowledgments*", finalize_misc (t[0], floats));
   else if (is_compound (t, "text", 1) &&
            is_func (t[0], WITH, 3) &&
            t[0][0] == "font-family" &&
            t[0][1] == "rm")
-    return compound ("math-up", finalize_misc (t[0][2]));
+    return compound ("math-up", finalize_misc (t[0][2], floats));
   else if (is_var_compound (t, "algo-for", 4)) {
     return compound ("algo-for-all",
-        finalize_misc (t[N(t)-2]), finalize_misc (t[N(t)-1]));
+        finalize_misc (t[N(t)-2], floats), finalize_misc (t[N(t)-1], floats));
   }
   else if (is_compound (t, "minipage", 3)) {
-    if (is_document (t[2]) && N(t[2]) == 1)
-      t[2]= t[2][0];
-    return t;
+    r= tree (t, 3);
+    for (int i=0; i<3; i++)
+      r[i]= floats? finalize_floats (t[i]): t[i];
+    if (is_document (r[2]) && N(r[2]) == 1)
+      r[2]= r[2][0];
+    return r;
   }
   else {
     int i, n= N(t);
     string l= as_string (L(t));
     // Restore name of users envs, munged in finalize_layout.
-    if (latex_type ("\\begin-"*l) == "user" && latex_arity ("\\begin-"*l) < 0
-        && N(t) == abs (latex_arity ("\\begin-"*l))+1) {
-      tree r= compound (l*"*");
+    // Only user defined environments have the type "user".
+    string env= "\\begin-" * l;
+    if (command_type->contains (env) && command_type[env] == "user" &&
+        latex_arity (env) < 0 && N(t) == abs (latex_arity (env))+1) {
+      r= compound (l*"*");
       for (int i=0; i<n; i++)
-        r << finalize_misc (t[i]);
+        r << finalize_misc (t[i], floats);
       return r;
     }
     if (n > 1 && is_var_compound (t, "algo-if-else-if")
         && ((t[n-1] == "" || t[n-1] == document () || t[n-1] == concat ())))
       n--;
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= finalize_misc (t[i]);
+    r= (n == N(t)? t: t (0, n));
+    for (i=0; i<n; i++) {
+      tree u= finalize_misc (t[i], floats);
+      if (strong_equal (u, t[i])) continue;
+      if (strong_equal (r, t)) r= t (0, n);
+      r[i]= u;
+    }
     return r;
   }
 }
@@ -1680,12 +1707,14 @@ contains_newline (tree t) {
 
 tree
 modernize_newlines (tree t, bool skip) {
+  // also removes the geometry of the document
   if (is_atomic (t)) return t;
   if (is_compound (t, "doc-data") || is_compound (t, "abstract-data"))
     skip= true;
   tree r= tree (L(t));
   for (int i=0; i<N(t); i++)
-    r << modernize_newlines (t[i], skip);
+    if (!is_compound (t[i], "geometry"))
+      r << modernize_newlines (t[i], skip);
   if (is_concat (r)) {
     if (contains_newline (r)) {
       array<tree> tmp=
@@ -1794,41 +1823,13 @@ eat_space_around_control (tree t) {
   return t;
 }
 
-/************************ Remove superfluous newlines ************************/
-
-bool
-is_verbatim (tree t) {
-  return is_compound (t, "cpp-code") || is_compound (t, "mmx-code")   ||
-         is_compound (t, "scm-code") || is_compound (t, "shell-code") ||
-         is_compound (t, "code")     || is_compound (t, "verbatim")   ||
-         is_compound (t, "scilab-code") || is_compound (t, "scala-code") ||
-         is_compound (t, "latex_preview") ||
-         is_compound (t, "picture-mixed");
-}
-
-static tree
-remove_superfluous_newlines (tree t) {
-  if (is_verbatim (t) || is_atomic (t)) return t;
-  if (is_compound (t, "!emptyline")) return "";
-  tree r (L(t));
-  for (int i=0; i<N(t); i++) {
-    if (!is_document (t) || t[i] != "")
-      r << remove_superfluous_newlines (t[i]);
-    }
-  if (is_document (r) && N(r) == 0) r << "";
-  return r;
-}
-
 /************************** Concat document correct **************************/
 
-tree
-concat_document_correct (tree t) {
-  if (is_atomic (t)) return t;
-  tree r (L(t));
-  for (int i=0; i<N(t); i++)
-    r << concat_document_correct (t[i]);
+static tree
+concat_document_correct_node (tree r) {
+  // correct r, assuming that its children are already correct
   if (is_concat (r) && contains_document (r)) {
-    t= r;
+    tree t= r;
     tree tmp (CONCAT);
     r= tree (DOCUMENT);
     for (int i=0; i<N(t); i++) {
@@ -1853,6 +1854,41 @@ concat_document_correct (tree t) {
   return r;
 }
 
+tree
+concat_document_correct (tree t) {
+  if (is_atomic (t)) return t;
+  tree r (L(t));
+  for (int i=0; i<N(t); i++)
+    r << concat_document_correct (t[i]);
+  return concat_document_correct_node (r);
+}
+
+/************************ Remove superfluous newlines ************************/
+
+bool
+is_verbatim (tree t) {
+  return is_compound (t, "cpp-code") || is_compound (t, "mmx-code")   ||
+         is_compound (t, "scm-code") || is_compound (t, "shell-code") ||
+         is_compound (t, "code")     || is_compound (t, "verbatim")   ||
+         is_compound (t, "scilab-code") || is_compound (t, "scala-code") ||
+         is_compound (t, "latex_preview") ||
+         is_compound (t, "picture-mixed");
+}
+
+tree
+remove_superfluous_newlines (tree t) {
+  // also applies concat_document_correct in the same traversal
+  if (is_verbatim (t) || is_atomic (t)) return concat_document_correct (t);
+  if (is_compound (t, "!emptyline")) return "";
+  tree r (L(t));
+  for (int i=0; i<N(t); i++) {
+    if (!is_document (t) || t[i] != "")
+      r << remove_superfluous_newlines (t[i]);
+    }
+  if (is_document (r) && N(r) == 0) r << "";
+  return concat_document_correct_node (r);
+}
+
 /****************************** Finalize textm *******************************/
 
 static bool
@@ -1948,26 +1984,6 @@ concat_sections_and_labels (tree t) {
   return t;
 }
 
-tree
-remove_empty_withs (tree t) {
-  if (is_atomic (t)) return t;
-  if (is_func (t, WITH)) {
-    int n= N(t);
-    if (t[n-1] == "" || t[n-1] == document () || t[n-1] == concat ()
-        || t[n-1] == document ("") || t[n-1] == concat (""))
-      return "";
-  }
-  int i, n= N(t);
-  tree r(L(t));
-  for (i=0; i<n; i++) {
-    tree tmp= remove_empty_withs (t[i]);
-    if (tmp != "" || !is_func (t[i], WITH)) {
-      r << tmp;
-    }
-  }
-  return r;
-}
-
 tree
 merge_successive_withs (tree t, bool force_concat= false) {
   (void) force_concat;
@@ -2007,38 +2023,37 @@ merge_successive_withs (tree t, bool force_concat= false) {
 }
 
 tree
-unnest_withs (tree t) {
+remove_empty_withs (tree t, bool unnest) {
+  // if unnest holds, then nested withs are merged in the same traversal;
+  // unchanged subtrees are shared with t
   if (is_atomic (t)) return t;
-  if (is_func (t, WITH) && N(t) > 0) {
-    int n= N(t);
+  int i, n= N(t);
+  if (unnest && is_func (t, WITH)) {
     if (is_func (t[n-1], WITH)) {
-      tree r= t(0, n-1);
+      tree r= t (0, n-1);
       r << A(t[n-1]);
-      return r;
+      return remove_empty_withs (r, false);
     }
     else if ((is_func (t[n-1], CONCAT, 1)   && is_func (t[n-1][0], WITH)) ||
              (is_func (t[n-1], DOCUMENT, 1) && is_func (t[n-1][0], WITH))) {
-      t[n-1]= t[n-1][0];
-      return unnest_withs (t);
+      tree r= t (0, n);
+      r[n-1]= t[n-1][0];
+      return remove_empty_withs (r, true);
     }
   }
-  int i, n= N(t);
-  tree r(t,n);
-  for (i=0; i<n; i++)
-    r[i]= unnest_withs (t[i]);
-  return r;
-}
-
-/****************************** Remove geometry ******************************/
-
-static tree
-remove_geometry (tree t) {
-  if (is_atomic (t)) return t;
-  int i, n= N(t);
-  tree r(L(t));
-  for (i=0; i<n; i++)
-    if (!is_compound (t[i], "geometry"))
-      r << remove_geometry (t[i]);
+  if (is_func (t, WITH)) {
+    if (t[n-1] == "" || t[n-1] == document () || t[n-1] == concat ()
+        || t[n-1] == document ("") || t[n-1] == concat (""))
+      return "";
+  }
+  tree r= t;
+  for (i=0; i<n; i++) {
+    tree u= remove_empty_withs (t[i], unnest);
+    bool keep= (u != "" || !is_func (t[i], WITH));
+    if (keep && strong_equal (u, t[i]) && strong_equal (r, t)) continue;
+    if (strong_equal (r, t)) r= t (0, i);
+    if (keep) r << u;
+  }
   return r;
 }
 
@@ -2046,15 +2061,12 @@ remove_geometry (tree t) {
 
 tree
 finalize_textm (tree t) {
-  t= remove_geometry (t);
   t= modernize_newlines (t, false);
   t= merge_successive_withs (t);
-  t= unnest_withs (t);
-  t= remove_empty_withs (t);
+  t= remove_empty_withs (t, true);
   t= nonumber_to_eqnumber (t);
   t= eat_space_around_control (t);
   t= remove_superfluous_newlines (t);
-  t= concat_document_correct (t);
   t= remove_labels_from_sections (t);
   t= concat_sections_and_labels (t);
   return simplify_correct (t);
@@ -2082,6 +2094,35 @@ filter_geometry (tree t) {
   return r;
 }
 
+/******************************************************************************
+* Timing of the conversion passes
+******************************************************************************/
+
+static array<string> latex_passes;
+
+static void
+latex_pass_start (string pass) {
+  if (!contains (pass, latex_passes)) latex_passes << pass;
+  bench_start ("latex " * pass);
+}
+
+static tree
+latex_pass_end (string pass, tree t) {
+  bench_cumul ("latex " * pass);
+  return t;
+}
+
+#define LATEX_PASS(pass,x) (latex_pass_start (pass), latex_pass_end (pass, x))
+
+static void
+latex_print_timings () {
+  // print and reset the cumulated timings of the passes in DEBUG_BENCH mode
+  for (int i=0; i<N(latex_passes); i++) {
+    bench_print ("latex " * latex_passes[i]);
+    bench_reset ("latex " * latex_passes[i]);
+  }
+}
+
 /******************************************************************************
 * Interface
 ******************************************************************************/
@@ -2089,7 +2130,7 @@ filter_geometry (tree t) {
 tree
 latex_to_tree (tree t0) {
   // cout << "\n\nt0= " << t0 << "\n\n";
-  tree t1= kill_space_invaders (t0);
+  tree t1= LATEX_PASS ("kill space invaders", kill_space_invaders (t0));
   string style, lan= "";
   bool is_document= is_compound (t1, "!file", 1);
   if (is_document) t1= t1[0];
@@ -2104,30 +2145,30 @@ latex_to_tree (tree t0) {
   textm_natbib    = false;
   command_type ("!em") = "false";
   // cout << "\n\nt1= " << t1 << "\n\n";
-  tree t2= is_document? filter_preamble (t1): t1;
+  tree t2= is_document?
+    LATEX_PASS ("filter preamble", filter_preamble (t1)): t1;
   // cout << "\n\nt2= " << t2 << "\n\n";
-  tree t3= parsed_latex_to_tree (t2);
+  tree t3= LATEX_PASS ("convert", parsed_latex_to_tree (t2));
   // cout << "\n\nt3= " << t3 << "\n\n";
-  tree t4= finalize_document (t3);
+  tree t4= LATEX_PASS ("finalize document", finalize_document (t3));
   // cout << "\n\nt4= " << t4 << "\n\n";
-  tree t5= is_document? finalize_preamble (t4, style): t4;
+  tree t5= is_document?
+    LATEX_PASS ("finalize preamble", finalize_preamble (t4, style)): t4;
   // cout << "\n\nt5= " << t5 << "\n\n";
-  tree t6= handle_matches (t5);
+  tree t6= LATEX_PASS ("handle matches", handle_matches (t5));
   // cout << "\n\nt6= " << t6 << "\n\n";
   if ((!is_document) && is_func (t6, DOCUMENT, 1)) t6= t6[0];
-  tree t7= upgrade_tex (t6);
+  tree t7= LATEX_PASS ("upgrade", upgrade_tex (t6));
   // cout << "\n\nt7= " << t7 << "\n\n";
-  tree t8= finalize_floats (t7);
-  // cout << "\n\nt8= " << t8 << "\n\n";
-  tree t9= finalize_misc (t8);
+  tree t9= LATEX_PASS ("finalize floats and misc", finalize_misc (t7, true));
   // cout << "\n\nt9= " << t9 << "\n\n";
 
   tree initial (COLLECTION), mods (WITH);
   if (is_document) initial << filter_geometry (t9);
 
-  tree t10= finalize_textm (t9);
+  tree t10= LATEX_PASS ("finalize textm", finalize_textm (t9));
   // cout << "\n\nt10= " << t10 << "\n\n";
-  tree t11= drd_correct (std_drd, t10);
+  tree t11= LATEX_PASS ("drd correct", drd_correct (std_drd, t10));
   // cout << "\n\nt11= " << t11 << "\n\n";
 
   if (!exists (url ("$TEXMACS_STYLE_PATH", style * ".ts")))
@@ -2151,10 +2192,10 @@ latex_to_tree (tree t0) {
   }
 
   tree t12= t11;
-  if (is_document) t12= simplify_correct (t11);
+  if (is_document) t12= LATEX_PASS ("simplify", simplify_correct (t11));
   else if (N (mods) > 0) { t12= mods; t12 << t11; }
   // cout << "\n\nt12= " << t12 << "\n\n";
-  tree t13= latex_correct (t12);
+  tree t13= LATEX_PASS ("latex correct", latex_correct (t12));
   // cout << "\n\nt13= " << t13 << "\n\n";
 
   if (is_document) {
@@ -2181,9 +2222,10 @@ latex_document_to_tree (string s, bool as_pic) {
   command_type ->extend ();
   command_arity->extend ();
   command_def  ->extend ();
-  tree t= parse_latex_document (s, true, as_pic);
+  tree t= LATEX_PASS ("parse", parse_latex_document (s, true, as_pic));
   if (as_pic) t= latex_fallback_on_pictures (s, t);
   r= latex_to_tree (t);
+  latex_print_timings ();
   command_type ->shorten ();
   command_arity->shorten ();
   command_def  ->shorten ();
@@ -2308,38 +2308,35 @@ upgrade_item_punct (tree t) {
 * Forget default page parameters
 ******************************************************************************/
 
-tree
+static tree
 upgrade_page_pars (tree t) {
-  if (is_atomic (t)) return t;
-  else if (L(t) == COLLECTION) {
-    int i, n= N(t);
-    tree r (COLLECTION);
-    for (i=0; i<n; i++) {
-      tree u= t[i];
-      if (!is_func (u, ASSOCIATE, 2));
-      else if (u == tree (ASSOCIATE, PAGE_TYPE, "a4"));
-      else if (u == tree (ASSOCIATE, PAGE_EVEN, "30mm"));
-      else if (u == tree (ASSOCIATE, PAGE_ODD, "30mm"));
-      else if (u == tree (ASSOCIATE, PAGE_RIGHT, "30mm"));
-      else if (u == tree (ASSOCIATE, PAGE_TOP, "30mm"));
-      else if (u == tree (ASSOCIATE, PAGE_BOT, "30mm"));
-      else if (u == tree (ASSOCIATE, PAR_WIDTH, "150mm"));
-      else if (u[0] == "page-reduce-left");
-      else if (u[0] == "page-reduce-right");
-      else if (u[0] == "page-reduce-top");
-      else if (u[0] == "page-reduce-bot");
-      else if (u[0] == "sfactor");
-      else r << u;
-    }
-    return r;
-  }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_page_pars (t[i]);
-    return r;
+  if (L(t) != COLLECTION) return t;
+  int i, n= N(t);
+  tree r (COLLECTION);
+  for (i=0; i<n; i++) {
+    tree u= t[i];
+    if (!is_func (u, ASSOCIATE, 2));
+    else if (u == tree (ASSOCIATE, PAGE_TYPE, "a4"));
+    else if (u == tree (ASSOCIATE, PAGE_EVEN, "30mm"));
+    else if (u == tree (ASSOCIATE, PAGE_ODD, "30mm"));
+    else if (u == tree (ASSOCIATE, PAGE_RIGHT, "30mm"));
+    else if (u == tree (ASSOCIATE, PAGE_TOP, "30mm"));
+    else if (u == tree (ASSOCIATE, PAGE_BOT, "30mm"));
+    else if (u == tree (ASSOCIATE, PAR_WIDTH, "150mm"));
+    else if (u[0] == "page-reduce-left");
+    else if (u[0] == "page-reduce-right");
+    else if (u[0] == "page-reduce-top");
+    else if (u[0] == "page-reduce-bot");
+    else if (u[0] == "sfactor");
+    else r << u;
   }
+  return r;
+}
+
+static tree
+upgrade_hrule (tree t) {
+  if (t == tree (VALUE, "hrule")) return compound ("hrule");
+  return t;
 }
 
 /******************************************************************************
@@ -2514,72 +2511,88 @@ upgrade_doc_info (tree t) {
   return t;
 }
 
+/******************************************************************************
+* Local upgrade rules
+******************************************************************************/
+
+typedef tree (*upgrade_rule) (tree t);
+
+static tree
+upgrade_locally (tree t, array<upgrade_rule> rules) {
+  // Apply several upgrade rules in a single bottom-up traversal.
+  // A rule is applied to a compound node whose children have already
+  // been upgraded, and returns the node itself if it does not apply.
+  // Rules should not modify their argument, which may be shared with t.
+  if (is_atomic (t) || N(rules) == 0) return t;
+  int i, n= N(t);
+  tree r= t;
+  for (i=0; i<n; i++) {
+    tree u= upgrade_locally (t[i], rules);
+    if (strong_equal (u, t[i])) continue;
+    if (strong_equal (r, t)) r= t (0, n);
+    r[i]= u;
+  }
+  for (i=0; i<N(rules); i++)
+    if (is_compound (r)) r= rules[i] (r);
+  return r;
+}
+
 /******************************************************************************
 * Upgrade bibliographies
 ******************************************************************************/
 
-tree
+static tree
 upgrade_bibliography (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_bibliography (t[i]);
-    if (is_compound (t, "bibliography") || is_compound (t, "bibliography*")) {
-      int l= N(r)-1;
-      if (is_func (r[l], DOCUMENT, 1) && is_compound (r[l][0], "bib-list"));
-      else if (is_compound (r[l], "bib-list"));
-      else r[l]= tree (DOCUMENT, compound ("bib-list", "[99]", r[l]));
+  if (is_compound (t, "bibliography") || is_compound (t, "bibliography*")) {
+    int l= N(t)-1;
+    if (is_func (t[l], DOCUMENT, 1) && is_compound (t[l][0], "bib-list"));
+    else if (is_compound (t[l], "bib-list"));
+    else {
+      tree r= t (0, N(t));
+      r[l]= tree (DOCUMENT, compound ("bib-list", "[99]", t[l]));
+      return r;
     }
-    return r;
   }
+  return t;
 }
 
 /******************************************************************************
 * Upgrade switches
 ******************************************************************************/
 
-tree
+static tree
 upgrade_switch (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
+  if (is_compound (t, "switch", 2)) {
+    int i, n= N(t[1]);
+    tree u (make_tree_label ("switch"), n);
     for (i=0; i<n; i++)
-      r[i]= upgrade_switch (t[i]);
-    if (is_compound (r, "switch", 2)) {
-      int i, n= N(r[1]);
-      tree u (make_tree_label ("switch"), n);
-      for (i=0; i<n; i++)
-	if (is_compound (r[1][i], "tmarker", 0)) u[i]= r[0];
-	else u[i]= compound ("hidden", r[1][i]);
-      return u;
-    }
-    if (is_compound (r, "fold", 2))
-      return compound ("folded", r[0], r[1]);
-    if (is_compound (r, "unfold", 2))
-      return compound ("unfolded", r[0], r[1]);
-    if (is_compound (r, "fold-bpr", 2) ||
-	is_compound (r, "fold-text", 2) ||
-	is_compound (r, "fold-proof", 2) ||
-	is_compound (r, "fold-exercise", 2))
-      return compound ("summarized", r[0], r[1]);
-    if (is_compound (r, "unfold-bpr", 2) ||
-	is_compound (r, "unfold-text", 2) ||
-	is_compound (r, "unfold-proof", 2) ||
-	is_compound (r, "unfold-exercise", 2))
-      return compound ("detailed", r[0], r[1]);
-    if (is_compound (r, "fold-algorithm", 2))
-      return compound ("summarized-algorithm", r[0], r[1]);
-    if (is_compound (r, "unfold-algorithm", 2))
-      return compound ("detailed-algorithm", r[0], r[1]);
-    if (is_func (r, ASSIGN, 2) && r[0] == "fold-algorithm")
-      return tree (ASSIGN, "summarized-algorithm", r[1]);
-    if (is_func (r, ASSIGN, 2) && r[0] == "unfold-algorithm")
-      return tree (ASSIGN, "detailed-algorithm", r[1]);
-    return r;
+      if (is_compound (t[1][i], "tmarker", 0)) u[i]= t[0];
+      else u[i]= compound ("hidden", t[1][i]);
+    return u;
   }
+  if (is_compound (t, "fold", 2))
+    return compound ("folded", t[0], t[1]);
+  if (is_compound (t, "unfold", 2))
+    return compound ("unfolded", t[0], t[1]);
+  if (is_compound (t, "fold-bpr", 2) ||
+      is_compound (t, "fold-text", 2) ||
+      is_compound (t, "fold-proof", 2) ||
+      is_compound (t, "fold-exercise", 2))
+    return compound ("summarized", t[0], t[1]);
+  if (is_compound (t, "unfold-bpr", 2) ||
+      is_compound (t, "unfold-text", 2) ||
+      is_compound (t, "unfold-proof", 2) ||
+      is_compound (t, "unfold-exercise", 2))
+    return compound ("detailed", t[0], t[1]);
+  if (is_compound (t, "fold-algorithm", 2))
+    return compound ("summarized-algorithm", t[0], t[1]);
+  if (is_compound (t, "unfold-algorithm", 2))
+    return compound ("detailed-algorithm", t[0], t[1]);
+  if (is_func (t, ASSIGN, 2) && t[0] == "fold-algorithm")
+    return tree (ASSIGN, "summarized-algorithm", t[1]);
+  if (is_func (t, ASSIGN, 2) && t[0] == "unfold-algorithm")
+    return tree (ASSIGN, "detailed-algorithm", t[1]);
+  return t;
 }
 
 /******************************************************************************
@@ -2643,28 +2656,26 @@ remove_attr (tree t, string name) {
   }
 }
 
-tree
+static tree
 upgrade_fill (tree t) {
   int i;
-  if (is_atomic (t)) return t;
-  if (is_compound (t, "with")) {
-    if ((i= find_attr_pos (t, "gr-mode")) != -1
-     && is_tuple (t[i+1],"edit-prop"))
-      t[i+1]= tuple ("group-edit","props");
-
-    tree fm= get_attr (t, "fill-mode", tree ("none"));
-    t= remove_attr (t, "fill-mode");
-    t= remove_attr (t, "gr-fill-mode");
-    if (fm == "none")
-      t= remove_attr (t, "fill-color");
-    if (fm == "inside")
-      t= set_attr (t, "color", tree ("none"));
-  }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_fill (t[i]);
-  return r;
+  if (!is_compound (t, "with")) return t;
+  if (!find_attr (t, "gr-mode") && !find_attr (t, "fill-mode") &&
+      !find_attr (t, "gr-fill-mode") && !find_attr (t, "fill-color"))
+    return t;
+  t= t (0, N(t));
+  if ((i= find_attr_pos (t, "gr-mode")) != -1
+   && is_tuple (t[i+1],"edit-prop"))
+    t[i+1]= tuple ("group-edit","props");
+
+  tree fm= get_attr (t, "fill-mode", tree ("none"));
+  t= remove_attr (t, "fill-mode");
+  t= remove_attr (t, "gr-fill-mode");
+  if (fm == "none")
+    t= remove_attr (t, "fill-color");
+  if (fm == "inside")
+    t= set_attr (t, "color", tree ("none"));
+  return t;
 }
 
 static void
@@ -2724,15 +2735,13 @@ length_add (string l1, string l2) {
   }
 }
 
-tree
+static tree
 upgrade_graphics (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
   if (is_compound (t, "with") &&
       (find_attr (t, "gr-frame") || find_attr (t, "gr-clip"))) {
-    tree fr= get_attr (t, "gr-frame",
-			  tuple ("scale", "1cm",
-				 tree (TUPLE, "0.5par", "0cm")));
+    tree fr= copy (get_attr (t, "gr-frame",
+			        tuple ("scale", "1cm",
+				       tree (TUPLE, "0.5par", "0cm"))));
     tree clip= get_attr (t, "gr-clip",
 			    tuple ("clip",
 				   tuple ("0par", "-0.3par"),
@@ -2755,38 +2764,26 @@ upgrade_graphics (tree t) {
     t= add_attr (t, "gr-geometry", geom);
     t= set_attr (t, "gr-frame", fr);
   }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_graphics (t[i]);
-  return r;
+  return t;
 }
 
-tree
+static tree
 upgrade_textat (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
   if (is_compound (t, "text-at") && N(t) == 4) {
     tree t0= t;
     t= tree (WITH, tree (TEXT_AT, t[0], t[1]));
     t= set_attr (t, "text-at-halign", t0[2]);
     t= set_attr (t, "text-at-valign", t0[3]);
   }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_textat (t[i]);
-  return r;
+  return t;
 }
 
 /******************************************************************************
 * Upgrade cell alignment
 ******************************************************************************/
 
-tree
+static tree
 upgrade_cell_alignment (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
   if (is_func (t, CWITH) && (N(t) >= 2))
     if (t[N(t)-2] == CELL_HALIGN)
       if (t[N(t)-1] == "." || t[N(t)-1] == ",") {
@@ -2794,47 +2791,29 @@ upgrade_cell_alignment (tree t) {
 	r[N(t)-1]= "L" * t[N(t)-1]->label;
 	return r;
       }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_cell_alignment (t[i]);
-  return r;
+  return t;
 }
 
 /******************************************************************************
 * Renaming primitives
 ******************************************************************************/
 
-tree
-rename_primitive (tree t, string which, string by) {
-  int i;
-  if (is_atomic (t)) return t;
-  int n= N(t);
-  tree r (t, n);
-  if (is_compound (t, which))
-    r= tree (make_tree_label (by), n);
-  for (i=0; i<n; i++)
-    r[i]= rename_primitive (t[i], which, by);
-  return r;
+static tree
+upgrade_hyper_link (tree t) {
+  if (is_compound (t, "hyper-link"))
+    return tree (make_tree_label ("hlink"), A(t));
+  return t;
 }
 
 /******************************************************************************
 * Upgrade label assignment
 ******************************************************************************/
 
-tree
+static tree
 upgrade_label_assignment (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  else if (is_func (t, ASSIGN, 2) && t[0] == "the-label")
+  if (is_func (t, ASSIGN, 2) && t[0] == "the-label")
     return tree (SET_BINDING, t[1]);
-  else {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_label_assignment (t[i]);
-    return r;
-  }
+  return t;
 }
 
 /******************************************************************************
@@ -2871,11 +2850,9 @@ upgrade_scheme_doc (tree t) {
 * Upgrade Mathemagix tag
 ******************************************************************************/
 
-tree
+static tree
 upgrade_mmx (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  else if (is_compound (t, "mmx", 0) || t == tree (VALUE, "mmx"))
+  if (is_compound (t, "mmx", 0) || t == tree (VALUE, "mmx"))
     return compound ("mathemagix");
   else if (is_compound (t, "mml", 0) || t == tree (VALUE, "mml"))
     return compound ("mmxlib");
@@ -2884,18 +2861,12 @@ upgrade_mmx (tree t) {
   else if (is_compound (t, "cpp", 0) || t == tree (VALUE, "cpp"))
     return compound ("c++");
   else if (is_compound (t, "scheme-code", 1))
-    return compound ("scm", upgrade_mmx (t[0]));
+    return compound ("scm", t[0]);
   else if (is_compound (t, "scheme-fragment", 1))
-    return compound ("scm-fragment", upgrade_mmx (t[0]));
+    return compound ("scm-fragment", t[0]);
   else if (is_compound (t, "cpp-code", 1))
-    return compound ("cpp", upgrade_mmx (t[0]));
-  else {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_mmx (t[i]);
-    return r;
-  }
+    return compound ("cpp", t[0]);
+  return t;
 }
 
 /******************************************************************************
@@ -3462,21 +3433,19 @@ replace_magnification (tree& t, string var, string repl) {
 
 static tree
 upgrade_gr_attributes (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  if (is_func (t, WITH)) {
-    replace_dash_style (t, "dash-style");
-    replace_dash_style (t, "gr-dash-style");
-    replace_line_arrows (t, "line-arrows", "arrow-begin", "arrow-end");
-    replace_line_arrows (t, "gr-line-arrows",
-                            "gr-arrow-begin", "gr-arrow-end");
-    replace_magnification (t, "magnification", "magnify");
-  }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_gr_attributes (t[i]);
-  return r;
+  if (!is_func (t, WITH)) return t;
+  if (!find_attr (t, "dash-style") && !find_attr (t, "gr-dash-style") &&
+      !find_attr (t, "line-arrows") && !find_attr (t, "gr-line-arrows") &&
+      !find_attr (t, "magnification"))
+    return t;
+  t= t (0, N(t));
+  replace_dash_style (t, "dash-style");
+  replace_dash_style (t, "gr-dash-style");
+  replace_line_arrows (t, "line-arrows", "arrow-begin", "arrow-end");
+  replace_line_arrows (t, "gr-line-arrows",
+                          "gr-arrow-begin", "gr-arrow-end");
+  replace_magnification (t, "magnification", "magnify");
+  return t;
 }
 
 /******************************************************************************
@@ -3485,17 +3454,9 @@ upgrade_gr_attributes (tree t) {
 
 static tree
 upgrade_cursor (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  if (is_func (t, VALUE)) {
-    if (t == tree (VALUE, "cursor")) return compound ("cursor");
-    if (t == tree (VALUE, "math-cursor")) return compound ("math-cursor");
-  }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_cursor (t[i]);
-  return r;
+  if (t == tree (VALUE, "cursor")) return compound ("cursor");
+  if (t == tree (VALUE, "math-cursor")) return compound ("math-cursor");
+  return t;
 }
 
 /******************************************************************************
@@ -4213,32 +4174,34 @@ upgrade (tree t, string version) {
     t= upgrade_style_rename (t);
   if (version_inf_eq (version, "1.0.3.4"))
     t= upgrade_item_punct (t);
+  array<upgrade_rule> rules;
   if (version_inf_eq (version, "1.0.3.7"))
-    t= upgrade_page_pars (t);
-  if (version_inf_eq (version, "1.0.4")) {
-    t= substitute (t, tree (VALUE, "hrule"), compound ("hrule"));
+    rules << upgrade_page_pars;
+  if (version_inf_eq (version, "1.0.4"))
+    rules << upgrade_hrule;
+  t= upgrade_locally (t, rules);
+  if (version_inf_eq (version, "1.0.4"))
     t= upgrade_doc_info (t);
-  }
+  rules= array<upgrade_rule> ();
   if (version_inf_eq (version, "1.0.4.6"))
-    t= upgrade_bibliography (t);
+    rules << upgrade_bibliography;
   if (version_inf_eq (version, "1.0.5.4"))
-    t= upgrade_switch (t);
+    rules << upgrade_switch;
   if (version_inf_eq (version, "1.0.5.7"))
-    t= upgrade_fill (t);
+    rules << upgrade_fill;
   if (version_inf_eq (version, "1.0.5.8"))
-    t= upgrade_graphics (t);
+    rules << upgrade_graphics;
   if (version_inf_eq (version, "1.0.5.11"))
-    t= upgrade_textat (t);
+    rules << upgrade_textat;
   if (version_inf_eq (version, "1.0.6.1"))
-    t= upgrade_cell_alignment (t);
-  if (version_inf_eq (version, "1.0.6.2"))
-    t= rename_primitive (t, "hyper-link", "hlink");
+    rules << upgrade_cell_alignment;
   if (version_inf_eq (version, "1.0.6.2"))
-    t= upgrade_label_assignment (t);
+    rules << upgrade_hyper_link << upgrade_label_assignment;
+  if (version_inf_eq (version, "1.0.6.14"))
+    rules << upgrade_mmx;
+  t= upgrade_locally (t, rules);
   if (version_inf_eq (version, "1.0.6.10"))
     t= upgrade_scheme_doc (t);
-  if (version_inf_eq (version, "1.0.6.14"))
-    t= upgrade_mmx (t);
   if (version_inf_eq (version, "1.0.7.1"))
     t= upgrade_session (t, "scheme", "default");
   if (version_inf_eq (version, "1.0.7.6"))
@@ -4269,10 +4232,12 @@ upgrade (tree t, string version) {
   }
   if (version_inf_eq (version, "1.0.7.10"))
     t= downgrade_big (t);
+  rules= array<upgrade_rule> ();
   if (version_inf_eq (version, "1.0.7.13"))
-    t= upgrade_gr_attributes (t);
+    rules << upgrade_gr_attributes;
   if (version_inf_eq (version, "1.0.7.14"))
-    t= upgrade_cursor (t);
+    rules << upgrade_cursor;
+  t= upgrade_locally (t, rules);
   if (version_inf_eq (version, "1.0.7.15"))
     t= upgrade_cyrillic (t);
   if (version_inf_eq (version, "1.0.7.17")) {
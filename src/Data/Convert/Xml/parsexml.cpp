@@ -13,6 +13,10 @@
 #include "hashset.hpp"
 #include "converter.hpp"
 #include "parse_string.hpp"
+#include "merge_sort.hpp"
+#include "iterator.hpp"
+#include "file.hpp"
+#include <stdio.h>
 
 /******************************************************************************
 * The xml/html parser aims to parse a superset of the set of valid documents.
@@ -22,12 +26,20 @@
 * should be parsed correctly and incorrect documents are transformed into
 * correct documents in a heuristic way.
 *
-* The parser proceeds in three steps: the first pass does all parsing
+* The parser proceeds in two steps: the first step does all parsing
 * except for the construction of a tree structure for nested tags.
-* The second stage takes care of the nesting, while heuristically
-* correcting improper nested trees, and while taking care of optional
-* closing tags in the case of Html. The last stage does some final
-* white space and entity cleanup.
+* Each token (opening or closing tag, character data, etc.) is passed
+* on to the second step as soon as it has been read. The second step
+* takes care of the nesting, while heuristically correcting improper
+* nested trees, and while taking care of optional closing tags in the
+* case of Html. Elements are converted into SXML as soon as they are
+* closed, so that no intermediate representation of the entire
+* document is built.
+*
+* The input may be provided in chunks (see xml_html_stream). A token
+* which reaches the end of the input received so far is parsed again
+* once more input is available, so the resulting tree does not depend
+* on the way the input was split.
 *
 * Present limitations: we do not fully parse <!DOCTYPE ...> constructs yet.
 * Entities which are present in the DOCTYPE definition of the document
@@ -39,9 +51,15 @@ struct xml_html_parser {
   bool html;
   parse_string s;
   hashmap<string,string> entities;
-  array<tree> a;
-  int i, n;
-  tree stack;
+  bool final;            // no more input will be appended to s
+  bool is_cr;            // the last input character was a carriage return
+  bool known;            // the encoding of the Html input has been decided
+  bool latin1;           // guessed Html encoding turned out not to be utf-8
+  string encoding;       // declared encoding of the Html input
+  string pending;        // Html input which has not yet been transcoded
+  string text;           // character data which has not yet been built
+  array<string> names;   // names of the open elements
+  array<tree> nodes;     // SXML for the open elements
 
   xml_html_parser ();
   inline void skip_space () {
@@ -51,13 +69,18 @@ struct xml_html_parser {
       (c == '_') || (c == ':') || (c == '.') || (c == '-') ||
       (((int) ((unsigned char) c)) >= 128); }
 
+  string newlines (string s);
+  string declared_encoding (string s);
   string transcode (string s);
+  string transcode_chunk (string s);
 
   string parse_until (string what);
   string parse_name ();
   string parse_quoted ();
   string expand_entity (string s);
   string expand_entities (string s);
+  string read_entity ();
+  string expand_read_entity (string r);
   string parse_entity ();
   tree parse_attribute ();
   tree parse_opening ();
@@ -84,9 +107,12 @@ struct xml_html_parser {
   bool build_valid_child (string parent, string child);
   bool build_must_close (string tag);
   bool build_can_close (string tag);
-  void build (tree& r);
+  tree build_element (tree t);
+  void build_close ();
+  void build (tree t);
 
-  tree finalize_sxml (tree t);
+  void feed (string chunk);
+  tree finish ();
   tree parse (string s);
 };
 
@@ -99,6 +125,101 @@ static hashset<string> html_auto_close_table;
 static hashset<string> html_block_table;
 static hashmap<string,string> html_entity ("");
 
+/******************************************************************************
+* Html entities are looked up in a compiled trie: the outgoing edges of
+* each node are stored contiguously, and each node which terminates an
+* entity name stores the fully expanded entity.
+******************************************************************************/
+
+struct entity_trie {
+  array<int>    first;   // index of the first outgoing edge of each node
+  array<int>    count;   // number of outgoing edges of each node
+  string        label;   // characters of the edges
+  array<int>    next;    // targets of the edges
+  array<string> value;   // expanded entities, or "" for inner nodes
+
+  int  compile (array<string> a, array<string> v, int i1, int i2, int d);
+  void compile (hashmap<string,string> h);
+  string lookup (string s, int i1, int i2);
+};
+
+static entity_trie html_entity_trie;
+
+static string
+expand_html_entity (string s) {
+  // HTML entity references expand to character references
+  // so they need to be finalized a second time.
+  if (N(s)>1 && s[0] == '&') {
+    if (s[1] == '#') {
+      int i= 2;
+      bool okay= false;
+      string r= convert_char_entity (s, i, okay);
+      if (okay) return r;
+    }
+    else {
+      string ss= s (1, s [N(s)-1] == ';' ? N(s)-1 : N(s));
+      if (html_entity->contains (ss))
+	return expand_html_entity (html_entity [ss]);
+    }
+  }
+  return s;
+}
+
+int
+entity_trie::compile (array<string> a, array<string> v,
+                      int i1, int i2, int d) {
+  // compile the sorted names a[i1], ..., a[i2-1] with common prefix
+  // of length d; return the index of the corresponding node
+  int node= N(first);
+  first << N(label);
+  count << 0;
+  value << string ("");
+  if (i1 < i2 && N(a[i1]) == d) value[node]= v[i1++];
+  array<int> starts;
+  for (int i=i1; i<i2; ) {
+    int j= i+1;
+    while (j<i2 && a[j][d] == a[i][d]) j++;
+    label << a[i][d];
+    next << -1;
+    count[node]++;
+    starts << i;
+    i= j;
+  }
+  starts << i2;
+  for (int k=0; k+1<N(starts); k++) {
+    int child= compile (a, v, starts[k], starts[k+1], d+1);
+    next[first[node] + k]= child;
+  }
+  return node;
+}
+
+void
+entity_trie::compile (hashmap<string,string> h) {
+  array<string> a;
+  iterator<string> it= iterate (h);
+  while (it->busy ()) a << it->next ();
+  merge_sort (a);
+  array<string> v (N(a));
+  for (int i=0; i<N(a); i++)
+    v[i]= expand_html_entity ("&" * a[i] * ";");
+  (void) compile (a, v, 0, N(a), 0);
+}
+
+string
+entity_trie::lookup (string s, int i1, int i2) {
+  // expansion of the entity with name s (i1, i2), or "" if unknown
+  if (N(first) == 0) return "";
+  int node= 0;
+  for (int i=i1; i<i2; i++) {
+    char c= s[i];
+    int e= first[node], end= e + count[node];
+    while (e < end && label[e] != c) e++;
+    if (e == end) return "";
+    node= next[e];
+  }
+  return value[node];
+}
+
 void load_html_entities (hashmap<string, string> table, string fname) {
   string s;
   if (DEBUG_CONVERT) debug_convert << "Loading " << fname << "\n";
@@ -117,7 +238,10 @@ void load_html_entities (hashmap<string, string> table, string fname) {
       }
 }
 
-xml_html_parser::xml_html_parser (): entities ("") {
+xml_html_parser::xml_html_parser ():
+  html (false), entities (""), final (true), is_cr (false),
+  known (false), latin1 (false)
+{
   if (N(html_empty_tag_table) == 0) {
     html_empty_tag_table->insert ("basefont");
     html_empty_tag_table->insert ("br");
@@ -181,7 +305,11 @@ xml_html_parser::xml_html_parser (): entities ("") {
     load_html_entities (html_entity, "HTMLlat1.scm");
     load_html_entities (html_entity, "HTMLspecial.scm");
     load_html_entities (html_entity, "HTMLsymbol.scm");
+    html_entity_trie.compile (html_entity);
   }
+
+  names << string ("<bottom>");
+  nodes << tuple ("*TOP*");
 }
 
 /******************************************************************************
@@ -199,7 +327,31 @@ xml_html_parser::xml_html_parser (): entities ("") {
 // ISO-8859-1 if iconv cannot perform an utf8->utf8 conversion.
 
 string
-xml_html_parser::transcode (string s2) {
+xml_html_parser::newlines (string s2) {
+  // end of line handling; is_cr is kept between successive chunks
+  int i, n= N(s2);
+  if (!is_cr) {
+    for (i=0; i<n; i++)
+      if (s2[i] == '\15') break;
+    if (i == n) return s2;
+  }
+  string s3;
+  for (i=0; i<n; i++) {
+    bool prev_is_cr= is_cr;
+    is_cr= false;
+    char c= s2[i];
+    if (c == '\15') {
+      s3 << '\12';
+      is_cr= true;
+    }
+    else if (prev_is_cr && (c == '\12')) /* no-op */;
+    else s3 << c;
+  }
+  return s3;
+}
+
+string
+xml_html_parser::declared_encoding (string s2) {
   s= parse_string (s2);
 
   string encoding;
@@ -235,7 +387,13 @@ xml_html_parser::transcode (string s2) {
       }
     }
   }
+  s= parse_string ();
+  return encoding;
+}
 
+string
+xml_html_parser::transcode (string s2) {
+  string encoding= declared_encoding (s2);
   if (N(encoding) != 0) {
     // cout << "encoding was specified\n" ;
     string s3= convert (s2, encoding, "UTF-8");
@@ -256,14 +414,91 @@ xml_html_parser::transcode (string s2) {
   return s2;
 }
 
+static bool
+is_single_byte_encoding (string encoding) {
+  return starts (encoding, "ISO-8859") || starts (encoding, "ISO_8859") ||
+         starts (encoding, "WINDOWS-125") || starts (encoding, "CP125") ||
+         starts (encoding, "LATIN") || starts (encoding, "KOI8") ||
+         encoding == "ASCII" || encoding == "US-ASCII";
+}
+
+static int
+utf8_boundary (string s) {
+  // length of the longest prefix of s which does not end inside
+  // a multi-byte utf-8 character
+  int n= N(s), i= n;
+  while (i > 0 && i > n-4) {
+    unsigned char c= (unsigned char) s[i-1];
+    if (c < 0x80) return n;
+    if (c >= 0xC0) {
+      int l= (c >= 0xF0? 4: (c >= 0xE0? 3: 2));
+      return (i-1+l <= n? n: i-1);
+    }
+    i--;
+  }
+  return n;
+}
+
+string
+xml_html_parser::transcode_chunk (string s2) {
+  // Transcode the next chunk of the Html input, as transcode does for
+  // the entire input. The prolog is awaited before deciding on the
+  // encoding. Single byte encodings are converted chunk by chunk,
+  // other declared encodings at the end of the input. If no encoding
+  // is declared, then chunks are taken to be utf-8 until a chunk with
+  // invalid utf-8 is encountered; from there on, the input is taken
+  // to be ISO-8859-1.
+  if (!known) {
+    pending << s2;
+    if (!final && N(pending) < 2) return "";
+    if (!final && starts (pending, "<?") && search_forwards ("?>", pending) < 0)
+      return "";
+    known= true;
+    encoding= declared_encoding (pending);
+    s2= pending;
+    pending= "";
+  }
+  if (N(encoding) == 0) {
+    s2= pending * s2;
+    pending= "";
+    if (!latin1) {
+      int k= (final? N(s2): utf8_boundary (s2));
+      string r= s2 (0, k);
+      if (check_encoding (r, "UTF-8")) {
+        pending= s2 (k, N(s2));
+        return r;
+      }
+      latin1= true;
+    }
+    string s3= convert (s2, "ISO-8859-1", "UTF-8");
+    return N(s3) != 0? s3: s2;
+  }
+  else if (encoding == "UTF-8") return s2;
+  else if (is_single_byte_encoding (encoding)) {
+    string s3= convert (s2, encoding, "UTF-8");
+    return N(s3) != 0? s3: s2;
+  }
+  else {
+    pending << s2;
+    if (!final) return "";
+    s2= pending;
+    pending= "";
+    string s3= convert (s2, encoding, "UTF-8");
+    return N(s3) != 0? s3: s2;
+  }
+}
+
 /******************************************************************************
 * Parsing without structuring
 ******************************************************************************/
 
 string
 xml_html_parser::parse_until (string what) {
-  string r;
-  while (s && !test (s, what)) r << s->read (1);
+  string r, stop= what (0, 1);
+  while (s && !test (s, what)) {
+    r << s->read_until (stop);
+    if (s && !test (s, what)) r << s->read (1);
+  }
   if (test (s, what)) s += N(what);
   return expand_entities (r);
 }
@@ -278,7 +513,7 @@ xml_html_parser::parse_name () {
 
 string
 xml_html_parser::expand_entity (string s) {
-  if (entities->contains (s)) return entities[s];
+  if (N(entities) != 0 && entities->contains (s)) return entities[s];
   else if (s[0] == '&') {
     if (N(s)>1 && s[1] == '#') {
       int i= 2;
@@ -288,11 +523,9 @@ xml_html_parser::expand_entity (string s) {
       return s;
     }
     else if (html) {
-      string ss= s (1, s [N(s)-1] == ';' ? N(s)-1 : N(s));
-      if (html_entity->contains (ss))
-	// HTML entity references expand to character references
-	// so they need to be finalized a second time.
-	return expand_entity (html_entity [ss]);
+      int end= (s [N(s)-1] == ';'? N(s)-1: N(s));
+      string r= html_entity_trie.lookup (s, 1, end);
+      if (N(r) != 0) return r;
     }
   }
   return s;
@@ -300,9 +533,12 @@ xml_html_parser::expand_entity (string s) {
 
 string
 xml_html_parser::expand_entities (string s) {
-  string r;
   int i, n= N(s);
-  for (i=0; i<n; ) {
+  for (i=0; i<n; i++)
+    if (s[i] == '&' || s[i] == '%') break;
+  if (i == n) return s;
+  string r= s (0, i);
+  while (i<n) {
     if (s[i] == '&' || s[i] == '%') {
       int start= i++;
       if (i<n && s[i] == '#') {
@@ -324,7 +560,7 @@ xml_html_parser::expand_entities (string s) {
 }
 
 string
-xml_html_parser::parse_entity () {
+xml_html_parser::read_entity () {
   string r= s->read (1);
   if (test (s, "#")) {
     r << s->read (1);
@@ -336,12 +572,22 @@ xml_html_parser::parse_entity () {
   }
   else while (s && is_name_char (s[0])) r << s->read (1);
   if (test (s, ";")) r << s->read (1);
+  return r;
+}
+
+string
+xml_html_parser::expand_read_entity (string r) {
   string x= expand_entity (r);
   if (x == r || r == "&lt;" || r == "&amp;") return x;
   s->write (x);
   return "";
 }
 
+string
+xml_html_parser::parse_entity () {
+  return expand_read_entity (read_entity ());
+}
+
 string
 xml_html_parser::parse_quoted () {
   if (test (s, "\42")) {
@@ -429,6 +675,7 @@ xml_html_parser::parse_misc () {
   tree t= tuple ("misc");
   while (true) {
     skip_space ();
+    if (!s) break;
     if (test (s, ">")) { s += 1; break; }
     string r;
     while (s) {
@@ -440,25 +687,47 @@ xml_html_parser::parse_misc () {
   return t;
 }
 
+// length of the longest keyword for which the tokenizer tests
+#define XML_LOOKAHEAD 10
+
 void
 xml_html_parser::parse () {
-  string r;
+  // Parse the input received so far. Unless the input is final, a token
+  // which ends less than XML_LOOKAHEAD characters before the end of the
+  // input may have been parsed differently with more input: it is then
+  // put back and parsed again once more input has been received.
   while (s) {
     if (s[0] == '<') {
-      if (N(r) != 0) { a << tree (r); }
-      if (test (s, "</")) a << parse_closing ();
-      else if (test (s, "<?")) a << parse_pi ();
-      else if (test (s, "<!--")) a << parse_comment ();
-      else if (test (s, "<![CDATA[")) a << parse_cdata ();
-      else if (test (s, "<!DOCTYPE")) a << parse_doctype ();
-      else if (test (s, "<!")) a << parse_misc ();
-      else a << parse_opening ();
-      r= "";
+      if (N(text) != 0) { build (tree (text)); text= ""; }
+      parse_string saved;
+      hashmap<string,string> declared= entities;
+      if (!final) saved= copy (s);
+      tree t;
+      if (test (s, "</")) t= parse_closing ();
+      else if (test (s, "<?")) t= parse_pi ();
+      else if (test (s, "<!--")) t= parse_comment ();
+      else if (test (s, "<![CDATA[")) t= parse_cdata ();
+      else if (test (s, "<!DOCTYPE")) {
+        // the entity declarations are undone if the doctype is put back
+        if (!final) declared= copy (entities);
+        t= parse_doctype ();
+      }
+      else if (test (s, "<!")) t= parse_misc ();
+      else t= parse_opening ();
+      if (!final && N (s->get_string (XML_LOOKAHEAD)) < XML_LOOKAHEAD) {
+        s= saved;
+        entities= declared;
+        return;
+      }
+      build (t);
+    }
+    else if (s[0] == '&') {
+      string r= read_entity ();
+      if (!s && !final) { s->write (r); return; }
+      text << expand_read_entity (r);
     }
-    else if (s[0] == '&') r << parse_entity ();
-    else r << s->read (1);
+    else text << s->read_until ("<&");
   }
-  if (N(r) != 0) a << tree (r);
 }
 
 /******************************************************************************
@@ -555,7 +824,7 @@ xml_html_parser::parse_doctype () {
       else if (test (s, "<!ELEMENT")) dt << parse_element ();
       else if (test (s, "<!ATTLIST")) dt << parse_cdata ();
       else if (test (s, "<!ENTITY")) parse_entity_decl ();
-      else if (test (s, "<!NOTATION")) a << parse_notation ();
+      else if (test (s, "<!NOTATION")) (void) parse_notation ();
       else if (test (s, "<?")) dt << parse_pi ();
       else if (test (s, "<!--")) dt << parse_comment ();
       else if (s[0] == '&' || s[0] == '%') (void) parse_entity ();
@@ -601,52 +870,80 @@ xml_html_parser::build_valid_child (string parent, string child) {
 
 bool
 xml_html_parser::build_must_close (string tag) {
-  if (build_valid_child (stack[0]->label, tag)) return false;
-  // if !html, we have already returned false
-  tree counter= stack;
-  while (counter != tuple ("<bottom>")) {
-    if (build_valid_child (counter[0]->label, tag)) return true;
-    counter= counter[1];
-  }
-  // since <html> and <body> can have any child we only get here when parsing
-  // something where both are omitted and we can close nodes up to the root.
-  return true;
+  // since <html> and <body> can have any child, the element being built
+  // must be closed whenever tag is not a valid child: either an enclosing
+  // element accepts tag, or both <html> and <body> were omitted and we
+  // can close elements up to the root.  If !html, tags are always valid.
+  return !build_valid_child (names[N(names)-1], tag);
 }
 
 bool
 xml_html_parser::build_can_close (string tag) {
-  if (N(stack) < 2) return false;
-  tree counter= stack[1];
-  while (counter != tuple ("<bottom>")) {
-    if (counter[0]->label == tag) return true;
-    counter= counter[1];
-  }
+  for (int k= N(names)-2; k>0; k--)
+    if (names[k] == tag) return true;
   return false;
 }
 
-void
-xml_html_parser::build (tree& r) {
-  while (i<n) {
-    if (is_tuple (a[i], "begin")) {
-      string name= a[i][1]->label;
-      if (build_must_close (name)) return;
-      tree sub= copy (a[i]); sub[0]= "tag";
-      i++;
-      if (html && html_empty_tag_table->contains (name))
-	r << sub;
-      else {
-	stack= tuple (name, stack);
-	build (sub);
-	r << sub;
-	stack= stack[1];
-      }
+static string
+simple_quote (string s) {
+  return "\"" * s * "\"";
+}
+
+tree
+xml_html_parser::build_element (tree t) {
+  // SXML for an element with opening tag t, without its content
+  int i, n= N(t);
+  tree tag = tuple (t[1]);
+  tree attrs = tuple ("@");
+  for (i=2; i<n; i++)
+    if (is_tuple (t[i], "attr")) {
+      tree attr;
+      if (N(t[i]) == 2) attr= tuple (t[i][1]);
+      else attr= tuple (t[i][1]->label, simple_quote (t[i][2]->label));
+      attrs << attr;
     }
-    else if (is_tuple (a[i], "end")) {
-      if (stack[0]->label == a[i][1]->label) { i++; return; }
-      if (build_can_close (a[i][1]->label)) return;
-      i++;
+  if (N(attrs) > 1) tag << attrs;
+  return tag;
+}
+
+void
+xml_html_parser::build_close () {
+  int k= N(nodes) - 1;
+  tree t= nodes[k];
+  names->resize (k);
+  nodes->resize (k);
+  nodes[k-1] << t;
+}
+
+void
+xml_html_parser::build (tree t) {
+  if (is_tuple (t, "begin")) {
+    string name= t[1]->label;
+    while (build_must_close (name) && N(nodes) > 1) build_close ();
+    if (html && html_empty_tag_table->contains (name))
+      nodes[N(nodes)-1] << build_element (t);
+    else {
+      names << name;
+      nodes << build_element (t);
     }
-    else r << a[i++];
+  }
+  else if (is_tuple (t, "end")) {
+    string name= t[1]->label;
+    while (names[N(names)-1] != name && build_can_close (name))
+      build_close ();
+    if (N(nodes) > 1 && names[N(names)-1] == name) build_close ();
+  }
+  else {
+    tree& r= nodes[N(nodes)-1];
+    if (is_tuple (t, "tag")) r << build_element (t);
+    else if (is_atomic (t)) r << simple_quote (t->label);
+    else if (is_tuple (t, "pi"))
+      r << tuple ("*PI*", t[1]->label, simple_quote (t[2]->label));
+    else if (is_tuple (t, "doctype"))
+      // TODO: convert DTD declarations
+      r << tuple ("*DOCTYPE*", simple_quote (t[1]->label));
+    else if (is_tuple (t, "cdata"))
+      r << simple_quote (t[1]->label);
   }
 }
 
@@ -708,83 +1005,37 @@ xml_html_parser::finalize_space (tree t) {
   }
 }
 
-static string
-simple_quote (string s) {
-  return "\"" * s * "\"";
+/******************************************************************************
+* Feeding the parser
+******************************************************************************/
+
+void
+xml_html_parser::feed (string chunk) {
+  chunk= newlines (chunk);
+  if (html) chunk= transcode_chunk (chunk);
+  s->append (chunk);
+  parse ();
 }
 
 tree
-xml_html_parser::finalize_sxml (tree t) {
-  if (!is_tuple (t, "tag")) return ""; // sanity
-  int i, n= N(t);
-  tree tag = tuple (t[1]);
-  if (t[1] == "<document>") tag= tuple ("*TOP*");
-  tree attrs = tuple ("@");
-  tree content = tuple ();
-  for (i=2; i<n; i++)
-    if (is_tuple (t[i], "attr")) {
-      tree attr;
-      if (N(t[i]) == 2) attr= tuple (t[i][1]);
-      else attr= tuple (t[i][1]->label, simple_quote (t[i][2]->label));
-      attrs << attr;
-    }
-    else if (is_tuple (t[i], "tag"))
-      content << finalize_sxml (t[i]);
-    else if (is_atomic (t[i]))
-      content << simple_quote (t[i]->label);
-    else if (is_tuple (t[i], "pi"))
-      content << tuple ("*PI*", t[i][1]->label, simple_quote (t[i][2]->label));
-    else if (is_tuple (t[i], "doctype"))
-      // TODO: convert DTD declarations
-      content << tuple ("*DOCTYPE*", simple_quote (t[i][1]->label));
-    else if (is_tuple (t[i], "cdata"))
-      content << simple_quote (t[i][1]->label);
-  if (N(attrs) > 1) tag << attrs;
-  tag << A(content);
-  return tag;
+xml_html_parser::finish () {
+  if (html && !final) {
+    final= true;
+    s->append (transcode_chunk (""));
+  }
+  final= true;
+  parse ();
+  if (N(text) != 0) { build (tree (text)); text= ""; }
+  while (N(nodes) > 1) build_close ();
+  return nodes[0];
 }
 
-/******************************************************************************
-* Building the structured parse tree with error correction
-******************************************************************************/
-
 tree
 xml_html_parser::parse (string s2) {
-  // end of line handling
-  string s3;
-  i= 0, n= N(s2);
-  bool is_cr= false;
-  while (i<n) {
-    bool prev_is_cr= is_cr;
-    is_cr= false;
-    char c= s2[i];
-    if (c == '\15') {
-      s3 << '\12';
-      is_cr= true;
-    }
-    else if (prev_is_cr && (c == '\12')) /* no-op */;
-    else s3 << c;
-    i++;
-  }
-  s2= s3;
-
-  // cout << "Transcoding " << s2 << "\n";
+  s2= newlines (s2);
   if (html) s2= transcode (s2);
-  // cout << HRULE << LF;
   s= parse_string (s2);
-  //cout << "Parsing " << s << "\n";
-  parse ();
-  // cout << HRULE << LF;
-  // cout << "a= " << a << "\n";
-  i= 0; n= N(a); stack= tuple ("<bottom>");
-  tree r= tuple ("tag", "<document>");
-  build (r);
-  // cout << HRULE << LF;
-  // print_tree (r);
-  r= finalize_sxml (r);
-  // cout << HRULE << LF;
-  // print_tree (r);
-  return r;
+  return finish ();
 }
 
 /******************************************************************************
@@ -806,3 +1057,68 @@ parse_html (string s) {
   tree t= parser.parse (s);
   return t;
 }
+
+/******************************************************************************
+* Parsing input in chunks
+******************************************************************************/
+
+xml_html_stream::xml_html_stream (bool html):
+  parser (tm_new<xml_html_parser> ())
+{
+  parser->html = html;
+  parser->final= false;
+}
+
+xml_html_stream::~xml_html_stream () {
+  tm_delete (parser);
+}
+
+void
+xml_html_stream::feed (string chunk) {
+  parser->feed (chunk);
+}
+
+tree
+xml_html_stream::finish () {
+  return parser->finish ();
+}
+
+#define XML_CHUNK_SIZE 65536
+
+static tree
+parse_xml_html_file (url u, bool html) {
+  // read the file in chunks, so as to never hold both the entire
+  // input and the entire parse tree in memory
+  xml_html_stream stream (html);
+  url r= u;
+  if (!is_rooted_name (r)) r= resolve (r);
+  if (!is_rooted_name (r)) {
+    std_warning << "Load error for " << as_string (u) << "\n";
+    return stream.finish ();
+  }
+  c_string name (concretize (r));
+  FILE* fin= fopen (name, "rb");
+  if (fin == NULL) {
+    std_warning << "Load error for " << as_string (u) << "\n";
+    return stream.finish ();
+  }
+  char* buffer= tm_new_array<char> (XML_CHUNK_SIZE);
+  while (true) {
+    int n= (int) fread (buffer, 1, XML_CHUNK_SIZE, fin);
+    if (n <= 0) break;
+    stream.feed (string (buffer, n));
+  }
+  tm_delete_array (buffer);
+  fclose (fin);
+  return stream.finish ();
+}
+
+tree
+parse_xml_file (url u) {
+  return parse_xml_html_file (u, false);
+}
+
+tree
+parse_html_file (url u) {
+  return parse_xml_html_file (u, true);
+}
@@ -95,9 +95,24 @@ int    number_latex_pages (url log);
 /*** Xml / Html / Mathml ***/
 tree   parse_xml (string s);
 tree   parse_html (string s);
+tree   parse_xml_file (url u);
+tree   parse_html_file (url u);
 tree   tmml_upgrade (scheme_tree t);
 tree   upgrade_mathml (tree t);
 
+struct xml_html_parser;
+class xml_html_stream {
+  // parse xml or html input which is provided in successive chunks
+  xml_html_parser* parser;
+  xml_html_stream (const xml_html_stream&);
+  xml_html_stream& operator = (const xml_html_stream&);
+public:
+  xml_html_stream (bool html);
+  ~xml_html_stream ();
+  void feed (string chunk);
+  tree finish ();
+};
+
 /*** BibTeX ***/
 tree   parse_bib (string s);
 tree   conservative_bib_import (string olds, tree oldt, string news);
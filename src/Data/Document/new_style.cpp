@@ -101,8 +101,8 @@ void
 style_set_cache (tree style, hashmap<string,tree> H, tree t) {
   init_style_data ();
   // cout << "set cache " << style << LF;
-  sd->style_cache (copy (style))= H;
-  sd->style_drd   (copy (style))= t;
+  sd->style_cache (freeze (style))= H;
+  sd->style_drd   (freeze (style))= t;
   url name ("$TEXMACS_HOME_PATH/system/cache", cache_file_name (style));
   if (!exists (name)) {
     save_string (name, tree_to_scheme (tuple ((tree) H, t)));
@@ -128,8 +128,8 @@ style_get_cache (tree style, hashmap<string,tree>& H, tree& t, bool& f) {
       tree p= scheme_to_tree (s);
       H= hashmap<string,tree> (UNINIT, p[0]);
       t= p[1];
-      sd->style_cache (copy (style))= H;
-      sd->style_drd   (copy (style))= t;
+      sd->style_cache (freeze (style))= H;
+      sd->style_drd   (freeze (style))= t;
       f= true;
     }
   }
@@ -175,8 +175,8 @@ compute_env_and_drd (tree style) {
       env->read_env (H);
       drd->heuristic_init (H);
     }
-    sd->style_cached (style)= H;
-    sd->drd_cached (style)= drd;
+    sd->style_cached (freeze (style))= H;
+    sd->drd_cached (freeze (style))= drd;
   }
   //cout << UNINDENT << "Got environment of " << style << LF;
 
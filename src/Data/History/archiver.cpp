@@ -20,6 +20,7 @@ static patch make_branches (array<patch> a);
 static hashset<double> genuine_authors;
 static hashset<pointer> archs;
 static hashset<pointer> pending_archs;
+static int history_keep= HISTORY_KEEP;
 
 /******************************************************************************
 * Constructors, destructors, printing and announcements
@@ -35,7 +36,8 @@ archiver_rep::archiver_rep (double author, path rp2):
   the_owner (0),
   rp (rp2),
   undo_obs (undo_observer (this)),
-  versioning (false)
+  versioning (false),
+  fresh (0)
 {
   archs->insert ((pointer) this);
   attach_observer (subtree (the_et, rp), undo_obs);
@@ -60,6 +62,9 @@ archiver_rep::clear () {
   depth= 0;
   last_save= -1;
   last_autosave= -1;
+  old->clear ();
+  markers= hashset<double> ();
+  fresh= 0;
 }
 
 void
@@ -307,6 +312,7 @@ archiver_rep::active () {
 
 bool
 archiver_rep::has_history () {
+  unspill ();
   return nr_undo (archive) == 1;
 }
 
@@ -335,6 +341,7 @@ archiver_rep::confirm () {
       if (depth <= last_save) last_save= -1;
       if (depth <= last_autosave) last_autosave= -1;
       normalize ();
+      if (++fresh >= history_keep) spill ();
       //show_all ();
     }
   }
@@ -411,12 +418,66 @@ archiver_rep::simplify () {
     }
 }
 
+/******************************************************************************
+* Moving old history out of the archive
+******************************************************************************/
+
+static bool
+is_open_marker (patch p, hashset<double> markers) {
+  if (get_type (p) == PATCH_AUTHOR)
+    return is_open_marker (p[0], markers);
+  else if (get_type (p) == PATCH_BIRTH)
+    return !get_birth (p) && markers->contains (get_author (p));
+  else return false;
+}
+
+void
+set_history_keep (int n) {
+  // number of recent history items which remain in the archive
+  history_keep= max (n, 1);
+}
+
+void
+archiver_rep::spill () {
+  // once the undo chain has grown beyond 2 * history_keep items,
+  // move everything but the last history_keep items to the history log
+  fresh= 0;
+  array<patch> un, re;
+  patch a= archive;
+  while (nr_undo (a) != 0 && N(un) < 2 * history_keep) {
+    un << get_undo (a);
+    re << get_redo (a);
+    a= cdr (get_undo (a));
+  }
+  if (N(un) < 2 * history_keep) return;
+  patch rem= cdr (un[history_keep - 1]);
+  if (N(markers) != 0)
+    for (a= rem; nr_undo (a) != 0; a= cdr (get_undo (a)))
+      if (is_open_marker (car (get_undo (a)), markers)) return;
+  old->push (rem);
+  a= make_branches (0);
+  for (int i= history_keep - 1; i >= 0; i--)
+    a= make_history (patch (car (un[i]), a), re[i]);
+  archive= a;
+}
+
+void
+archiver_rep::unspill () {
+  // bring back the most recent segment of old history when needed
+  if (N(old) == 0 || nr_undo (archive) != 0) return;
+  patch rem;
+  if (old->pop (rem)) return;
+  patch re = append_branches (get_redo (archive), get_redo (rem));
+  archive= make_history (get_undo (rem), re);
+}
+
 /******************************************************************************
 * Undo and redo
 ******************************************************************************/
 
 int
 archiver_rep::undo_possibilities () {
+  unspill ();
   return nr_undo (archive);
 }
 
@@ -574,6 +635,7 @@ remove_marker (patch archive, double m) {
 void
 archiver_rep::mark_start (double m) {
   //cout << "Mark start " << m << "\n";
+  markers->insert (m);
   confirm ();
   start_slave (m);
   confirm ();
@@ -583,6 +645,7 @@ archiver_rep::mark_start (double m) {
 void
 archiver_rep::mark_end (double m) {
   //cout << "Mark end " << m << "\n";
+  markers->remove (m);
   if (active ()) {
     //if (does_modify (current))
     //  cout << "CONFIRM: " << current << "\n";
@@ -597,6 +660,7 @@ archiver_rep::mark_end (double m) {
 bool
 archiver_rep::mark_cancel (double m) {
   //cout << "Mark cancel " << m << "\n";
+  markers->remove (m);
   cancel ();
   while (nr_undo (archive) != 0) {
     expose ();
@@ -625,6 +689,7 @@ int
 archiver_rep::corrected_depth () {
   // NOTE : fix depth due to presence of marker
   // FIXME: implement a more robust check for conformity with saved state
+  unspill ();
   if (nr_undo (archive) == 0) return depth;
   patch p= car (get_undo (archive));
   if (get_type (p) == PATCH_AUTHOR) p= p[0];
@@ -11,8 +11,12 @@
 
 #ifndef ARCHIVER_H
 #define ARCHIVER_H
-#include "patch.hpp"
+#include "history_log.hpp"
+#include "hashset.hpp"
 
+#define HISTORY_KEEP 512
+
+void set_history_keep (int n);
 void global_clear_history ();
 void global_confirm ();
 void global_cancel ();
@@ -28,6 +32,9 @@ class archiver_rep: public concrete_struct {
   path     rp;             // root path for document
   observer undo_obs;       // observer for undoing changes
   bool     versioning;     // true during undo and redo operations
+  history_log old;         // old history which has been moved out of archive
+  hashset<double> markers; // markers of currently open blocks
+  int      fresh;          // number of items confirmed since last spill
 
 protected:
   void apply (patch p);
@@ -37,6 +44,8 @@ protected:
   void expose ();
   void normalize ();
   int corrected_depth ();
+  void spill ();
+  void unspill ();
 
 public:
   archiver_rep (double author, path rp);
@@ -0,0 +1,326 @@
+
+/******************************************************************************
+* MODULE     : history_log.cpp
+* DESCRIPTION: compact binary storage for old parts of the undo/redo history
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "history_log.hpp"
+#include "file.hpp"
+
+/******************************************************************************
+* Constructors and destructors
+******************************************************************************/
+
+history_log_rep::history_log_rep ():
+  mem (0), spilled (0)
+{
+  prefix_parent << -1;
+  prefix_item << 0;
+  rehash (16);
+}
+
+history_log_rep::~history_log_rep () {
+  clear ();
+}
+
+history_log::history_log ():
+  rep (tm_new<history_log_rep> ()) {}
+
+void
+history_log_rep::clear () {
+  for (int i=0; i<spilled; i++) remove (files[i]);
+  prefix_parent= array<int> ();
+  prefix_item= array<int> ();
+  prefix_table= array<int> ();
+  segs= array<string> ();
+  files= array<url> ();
+  mem= spilled= 0;
+  prefix_parent << -1;
+  prefix_item << 0;
+  rehash (16);
+}
+
+int
+history_log_rep::size () {
+  return N(segs);
+}
+
+int
+history_log_rep::memory () {
+  return mem + ((int) sizeof (int)) * (2 * N(prefix_item) + N(prefix_table));
+}
+
+/******************************************************************************
+* Low level encoding
+******************************************************************************/
+
+static inline void
+put_int (string& s, int i) {
+  unsigned int u= (((unsigned int) i) << 1) ^ ((unsigned int) (i >> 31));
+  while (u >= 128) {
+    s << ((char) ((u & 127) | 128));
+    u >>= 7;
+  }
+  s << ((char) u);
+}
+
+static inline int
+get_int (string& s, int& pos) {
+  unsigned int u= 0;
+  int shift= 0;
+  while (true) {
+    unsigned char c= (unsigned char) s[pos++];
+    u |= ((unsigned int) (c & 127)) << shift;
+    if (c < 128) break;
+    shift += 7;
+  }
+  return ((int) (u >> 1)) ^ (-((int) (u & 1)));
+}
+
+static inline void
+put_double (string& s, double x) {
+  char* c= (char*) ((void*) &x);
+  for (int i=0; i<(int) sizeof (double); i++) s << c[i];
+}
+
+static inline double
+get_double (string& s, int& pos) {
+  double x;
+  char* c= (char*) ((void*) &x);
+  for (int i=0; i<(int) sizeof (double); i++) c[i]= s[pos++];
+  return x;
+}
+
+/******************************************************************************
+* Interning paths
+******************************************************************************/
+
+static inline int
+prefix_hash (int parent, int item) {
+  unsigned int h= ((unsigned int) parent) * 2654435761U;
+  h ^= ((unsigned int) item) * 40503U;
+  return (int) (h ^ (h >> 16));
+}
+
+void
+history_log_rep::rehash (int n) {
+  // the prefix 0 is the empty path, so that 0 marks free table entries
+  int i, id, mask= n - 1;
+  prefix_table= array<int> (n);
+  for (i=0; i<n; i++) prefix_table[i]= 0;
+  for (id=1; id<N(prefix_item); id++) {
+    i= prefix_hash (prefix_parent[id], prefix_item[id]) & mask;
+    while (prefix_table[i] != 0) i= (i+1) & mask;
+    prefix_table[i]= id;
+  }
+}
+
+int
+history_log_rep::intern (int parent, int item) {
+  int mask= N(prefix_table) - 1;
+  int i= prefix_hash (parent, item) & mask;
+  while (prefix_table[i] != 0) {
+    int id= prefix_table[i];
+    if (prefix_parent[id] == parent && prefix_item[id] == item) return id;
+    i= (i+1) & mask;
+  }
+  int id= N(prefix_item);
+  prefix_parent << parent;
+  prefix_item << item;
+  prefix_table[i]= id;
+  if (2 * N(prefix_item) > N(prefix_table)) rehash (2 * N(prefix_table));
+  return id;
+}
+
+int
+history_log_rep::intern (path p) {
+  int id= 0;
+  for (; !is_nil (p); p= p->next)
+    id= intern (id, p->item);
+  return id;
+}
+
+path
+history_log_rep::retrieve (int id) {
+  path p;
+  for (; id != 0; id= prefix_parent[id])
+    p= path (prefix_item[id], p);
+  return p;
+}
+
+/******************************************************************************
+* Encoding and decoding patches
+******************************************************************************/
+
+void
+history_log_rep::encode (string& s, tree t) {
+  put_int (s, (int) L(t));
+  if (is_atomic (t)) {
+    put_int (s, N(t->label));
+    s << t->label;
+  }
+  else {
+    int i, n= N(t);
+    put_int (s, n);
+    for (i=0; i<n; i++) encode (s, t[i]);
+  }
+}
+
+void
+history_log_rep::encode (string& s, modification m) {
+  put_int (s, m->k);
+  put_int (s, intern (m->p));
+  encode (s, m->t);
+}
+
+void
+history_log_rep::encode (string& s, patch p) {
+  int i, n, type= get_type (p);
+  s << ((char) type);
+  switch (type) {
+  case PATCH_MODIFICATION:
+    encode (s, get_modification (p));
+    encode (s, get_inverse (p));
+    break;
+  case PATCH_COMPOUND:
+  case PATCH_BRANCH:
+    n= N(p);
+    put_int (s, n);
+    for (i=0; i<n; i++) encode (s, p[i]);
+    break;
+  case PATCH_BIRTH:
+    put_double (s, get_author (p));
+    s << ((char) get_birth (p));
+    break;
+  case PATCH_AUTHOR:
+    put_double (s, get_author (p));
+    encode (s, p[0]);
+    break;
+  default:
+    FAILED ("unsupported patch type");
+  }
+}
+
+tree
+history_log_rep::decode_tree (string& s, int& pos) {
+  tree_label l= (tree_label) get_int (s, pos);
+  int i, n= get_int (s, pos);
+  if (l == STRING) {
+    pos += n;
+    return tree (s (pos - n, pos));
+  }
+  tree t (l, n);
+  for (i=0; i<n; i++) t[i]= decode_tree (s, pos);
+  return t;
+}
+
+modification
+history_log_rep::decode_modification (string& s, int& pos) {
+  modification_type k= get_int (s, pos);
+  path p= retrieve (get_int (s, pos));
+  return modification (k, p, decode_tree (s, pos));
+}
+
+patch
+history_log_rep::decode_patch (string& s, int& pos) {
+  int i, n, type= (int) s[pos++];
+  switch (type) {
+  case PATCH_MODIFICATION:
+    {
+      modification m= decode_modification (s, pos);
+      modification inv= decode_modification (s, pos);
+      return patch (m, inv);
+    }
+  case PATCH_COMPOUND:
+  case PATCH_BRANCH:
+    {
+      n= get_int (s, pos);
+      array<patch> a (n);
+      for (i=0; i<n; i++) a[i]= decode_patch (s, pos);
+      return patch (type == PATCH_BRANCH, a);
+    }
+  case PATCH_BIRTH:
+    {
+      double author= get_double (s, pos);
+      bool birth= (s[pos++] != 0);
+      return patch (author, birth);
+    }
+  case PATCH_AUTHOR:
+    {
+      double author= get_double (s, pos);
+      return patch (author, decode_patch (s, pos));
+    }
+  default:
+    FAILED ("corrupted history log");
+    return patch ();
+  }
+}
+
+string
+history_log_rep::encode (patch p) {
+  string s;
+  encode (s, p);
+  return s;
+}
+
+patch
+history_log_rep::decode (string s) {
+  int pos= 0;
+  patch p= decode_patch (s, pos);
+  ASSERT (pos == N(s), "corrupted history log");
+  return p;
+}
+
+/******************************************************************************
+* Pushing and popping segments
+******************************************************************************/
+
+void
+history_log_rep::spill () {
+  while (mem > HISTORY_LOG_MEMORY && spilled < N(segs) - 1) {
+    url u= url_temp (".history");
+    if (save_string (u, segs[spilled])) return;
+    mem -= N(segs[spilled]);
+    segs[spilled]= string ();
+    files[spilled]= u;
+    spilled++;
+  }
+}
+
+void
+history_log_rep::push (patch p) {
+  string s= encode (p);
+  segs << s;
+  files << url_none ();
+  mem += N(s);
+  spill ();
+}
+
+bool
+history_log_rep::pop (patch& p) {
+  // pop the most recent segment into p; if it cannot be read back,
+  // then the remaining history is dropped and true is returned
+  ASSERT (N(segs) > 0, "empty history log");
+  int last= N(segs) - 1;
+  string s= segs[last];
+  if (last < spilled) {
+    if (load_string (files[last], s, false) || N(s) == 0) {
+      std_warning << "Could not read " << as_string (files[last])
+                  << ", older history is lost\n";
+      clear ();
+      return true;
+    }
+    remove (files[last]);
+    spilled= last;
+  }
+  else mem -= N(s);
+  segs->resize (last);
+  files->resize (last);
+  p= decode (s);
+  return false;
+}
@@ -0,0 +1,70 @@
+
+/******************************************************************************
+* MODULE     : history_log.hpp
+* DESCRIPTION: compact binary storage for old parts of the undo/redo history
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+#include "patch.hpp"
+#include "url.hpp"
+
+#define HISTORY_LOG_MEMORY (1 << 22)
+
+/******************************************************************************
+* A history log is a stack of segments of old history, each of which is
+* a patch encoded as a flat byte string: an opcode per patch node,
+* modifications as (type, path id, tree), where paths are interned
+* as ids of their prefixes in a table which is shared by all segments.
+* Once the encoded segments exceed HISTORY_LOG_MEMORY bytes, the oldest
+* ones are moved to temporary files until they are popped again.
+******************************************************************************/
+
+class history_log_rep: concrete_struct {
+  array<int>    prefix_parent;            // parent of each interned prefix
+  array<int>    prefix_item;              // last index of each prefix
+  array<int>    prefix_table;             // hash table of prefix ids
+  array<string> segs;                     // encoded segments, oldest first
+  array<url>    files;                    // files for spilled segments
+  int           mem;                      // number of bytes in memory
+  int           spilled;                  // number of spilled segments
+
+  void  rehash (int n);
+  int   intern (int parent, int item);
+  int   intern (path p);
+  path  retrieve (int id);
+  void  encode (string& s, tree t);
+  void  encode (string& s, modification m);
+  void  encode (string& s, patch p);
+  tree  decode_tree (string& s, int& pos);
+  modification decode_modification (string& s, int& pos);
+  patch decode_patch (string& s, int& pos);
+  void  spill ();
+
+public:
+  history_log_rep ();
+  ~history_log_rep ();
+  string encode (patch p);
+  patch  decode (string s);
+  void   push (patch p);
+  bool   pop (patch& p);
+  void   clear ();
+  int    size ();
+  int    memory ();
+  friend class history_log;
+};
+
+class history_log {
+CONCRETE(history_log);
+  history_log ();
+};
+CONCRETE_CODE(history_log);
+
+inline int N (history_log log) { return log->size (); }
+
+#endif // defined HISTORY_LOG_H
@@ -0,0 +1,149 @@
+
+/******************************************************************************
+* MODULE     : search_index.cpp
+* DESCRIPTION: Summaries of the text inside trees for faster searching
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* A search index observer is attached to the larger compound nodes of
+* attached trees.  It holds a bit mask of the (hashed) pairs of consecutive
+* bytes in the strings of the subtree, after conversion to lower case.
+* A string search can skip the subtrees whose mask lacks one of the pairs
+* of the searched string.  The summary is invalidated by any modification
+* inside the subtree, since such modifications are announced to all
+* ancestors, and recomputed from the summaries of the children on demand.
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "modification.hpp"
+#include <locale>
+
+#define SEARCH_INDEX_WORDS     8
+#define SEARCH_INDEX_MIN_SIZE  16
+
+struct search_summary {
+  int size;
+  unsigned int bits[SEARCH_INDEX_WORDS];
+  inline search_summary (): size (0) {
+    for (int i=0; i<SEARCH_INDEX_WORDS; i++) bits[i]= 0; }
+};
+
+/******************************************************************************
+* Definition of the search_index_rep class
+******************************************************************************/
+
+class search_index_rep: public observer_rep {
+public:
+  bool valid;
+  search_summary sum;
+
+  search_index_rep (search_summary sum2): valid (true), sum (sum2) {}
+  int get_type () { return OBSERVER_SEARCH_INDEX; }
+  tm_ostream& print (tm_ostream& out) { return out << " search_index"; }
+
+  void announce (tree& ref, modification mod);
+  void notify_detach (tree& ref, tree closest, bool right);
+};
+
+void
+search_index_rep::announce (tree& ref, modification mod) {
+  (void) ref;
+  if (mod->k != MOD_SET_CURSOR) valid= false;
+}
+
+void
+search_index_rep::notify_detach (tree& ref, tree closest, bool right) {
+  // detached trees do not propagate announcements to their ancestors
+  (void) ref; (void) closest; (void) right;
+  valid= false;
+}
+
+/******************************************************************************
+* Computing the summaries
+******************************************************************************/
+
+static inline unsigned char
+fold (char c) {
+  // must coincide with the conversion done by to_lower
+  return (unsigned char) (char) std::tolower (c);
+}
+
+static inline int
+pair_hash (unsigned char c1, unsigned char c2) {
+  unsigned int h= ((((unsigned int) c1) << 8) + c2) * 2654435761u;
+  return (int) (h >> 24);
+}
+
+static inline void
+add_pair (search_summary& sum, unsigned char c1, unsigned char c2) {
+  int h= pair_hash (c1, c2);
+  sum.bits[h >> 5] |= ((unsigned int) 1) << (h & 31);
+}
+
+static void
+add_string (search_summary& sum, string s) {
+  int n= N(s);
+  sum.size += n;
+  if (n < 2) return;
+  unsigned char prev= fold (s[0]);
+  for (int i=1; i<n; i++) {
+    unsigned char next= fold (s[i]);
+    add_pair (sum, prev, next);
+    prev= next;
+  }
+}
+
+static void
+add_summary (search_summary& sum, search_summary& sub) {
+  sum.size += sub.size;
+  for (int i=0; i<SEARCH_INDEX_WORDS; i++)
+    sum.bits[i] |= sub.bits[i];
+}
+
+static void
+summarize (search_summary& sum, tree& ref) {
+  if (is_atomic (ref)) {
+    add_string (sum, ref->label);
+    return;
+  }
+  observer o= search_observer (ref, OBSERVER_SEARCH_INDEX);
+  search_index_rep* rep= (search_index_rep*) o.rep;
+  if (rep != NULL && rep->valid) {
+    add_summary (sum, rep->sum);
+    return;
+  }
+  search_summary sub;
+  for (int i=0; i<N(ref); i++)
+    summarize (sub, ref[i]);
+  if (rep != NULL) {
+    rep->sum  = sub;
+    rep->valid= true;
+  }
+  else if (sub.size >= SEARCH_INDEX_MIN_SIZE)
+    attach_observer (ref, tm_new<search_index_rep> (sub));
+  add_summary (sum, sub);
+}
+
+/******************************************************************************
+* Interface
+******************************************************************************/
+
+bool
+search_index_admits (tree& ref, string what) {
+  // false if no string inside ref contains what, even after conversion
+  // of both to lower case; ref must be attached
+  if (N(what) < 2) return true;
+  search_summary sum;
+  summarize (sum, ref);
+  unsigned char prev= fold (what[0]);
+  for (int i=1; i<N(what); i++) {
+    unsigned char next= fold (what[i]);
+    int h= pair_hash (prev, next);
+    if ((sum.bits[h >> 5] & (((unsigned int) 1) << (h & 31))) == 0)
+      return false;
+    prev= next;
+  }
+  return true;
+}
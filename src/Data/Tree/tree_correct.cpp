@@ -27,9 +27,13 @@ drd_correct (drd_info drd, tree t) {
 	!drd->correct_arity (L(t), n))
       return "";
     tree r (t, n);
-    for (i=0; i<n; i++)
+    bool changed= false;
+    for (i=0; i<n; i++) {
       r[i]= drd_correct (drd, t[i]);
-    return r;
+      changed= changed || !strong_equal (r[i], t[i]);
+    }
+    // share the subtrees which needed no correction
+    return changed? r: t;
   }
 }
 
@@ -22,6 +22,7 @@ bool partial_match_flag= false;
 bool injective_match_flag= false;
 bool cascaded_match_flag= false;
 bool case_insensitive_match_flag= false;
+bool search_index_flag= false;
 
 void search (range_set& sel, tree t, tree what, path p);
 bool match (tree t, tree what);
@@ -339,6 +340,10 @@ search_document (range_set& sel, tree t, tree what, path p) {
 void
 search (range_set& sel, tree t, tree what, path p) {
   if (N(sel) > search_max_hits) return;
+  if (search_index_flag && is_compound (t) && is_atomic (what) &&
+      !search_index_admits (t, what->label))
+    // compound nodes do not match non empty strings themselves
+    return;
   if (is_atomic (t))
     search_string (sel, t->label, what, p);
   else if (is_func (t, CONCAT) && is_func (what, CONCAT))
@@ -448,12 +453,14 @@ range_set
 search (tree t, tree what, path p, int limit) {
   search_max_hits= limit;
   initialize_search ();
+  search_index_flag= ip_attached (obtain_ip (t));
   range_set sel;
   //cout << "Search " << what << ", " << contains_select_region (what) << "\n";
   if (contains_select_region (what)) select (sel, t, what, p);
   else search (sel, t, what, p);
   //cout << "Selected " << sel << "\n";
   search_max_hits= 1000000;
+  search_index_flag= false;
   return sel;
 }
 
@@ -461,19 +468,27 @@ range_set
 search (tree t, tree what, path p, path pos, int limit) {
   search_max_hits= limit;
   initialize_search ();
+  search_index_flag= ip_attached (obtain_ip (t));
   range_set sel;
   //cout << "Search " << what << ", " << contains_select_region (what) << "\n";
   if (contains_select_region (what)) select (sel, t, what, p);
   else search (sel, t, what, p, pos);
   //cout << "Selected " << sel << "\n";
   search_max_hits= 1000000;
+  search_index_flag= false;
   return sel;
 }
 
 range_set
 previous_search_hit (range_set sels, path cur, bool strict) {
-  int i= (N(sels) >> 1) << 1;
-  while (i >= 2 && !path_less_eq (sels[i-2], cur)) i -= 2;
+  // the hit starts are sorted; find the last one before cur
+  int lo= 0, hi= N(sels) >> 1;
+  while (lo < hi) {
+    int mid= (lo + hi) >> 1;
+    if (path_less_eq (sels[2*mid], cur)) lo= mid + 1;
+    else hi= mid;
+  }
+  int i= lo << 1;
   if (strict && i >= 2 && !path_less (sels[i-1], cur)) i -= 2;
   if (i >= 2) return range (sels, i-2, i);
   return range_set ();
@@ -481,8 +496,14 @@ previous_search_hit (range_set sels, path cur, bool strict) {
 
 range_set
 next_search_hit (range_set sels, path cur, bool strict) {
-  int i=0, n=N(sels);
-  while (i+2 <= n && !path_less_eq (cur, sels[i+1])) i += 2;
+  // the hit ends are sorted; find the first one after cur
+  int n= N(sels), lo= 0, hi= n >> 1;
+  while (lo < hi) {
+    int mid= (lo + hi) >> 1;
+    if (path_less_eq (cur, sels[2*mid+1])) hi= mid;
+    else lo= mid + 1;
+  }
+  int i= lo << 1;
   while (i+4 <= n && sels[i+1] == sels[i+2] && sels[i+1] == cur) i += 2;
   if (strict && i+2 <= n) i += 2;
   if (i+2 <= n) return range (sels, i, i+2);
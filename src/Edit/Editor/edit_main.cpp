@@ -21,6 +21,7 @@
 #include "message.hpp"
 #include <setjmp.h>
 #include "image_files.hpp"
+#include "word_cache.hpp"
 
 #ifdef EXPERIMENTAL
 #include "../../Style/Memorizer/clean_copy.hpp"
@@ -495,6 +496,10 @@ edit_main_rep::show_selection () {
 void
 edit_main_rep::show_meminfo () {
   mem_info ();
+  resource_info ();
+  long long hits, misses;
+  word_cache_statistics (hits, misses);
+  cout << "Word caches: " << hits << " hits, " << misses << " misses\n";
 }
 
 void
@@ -9,7 +9,6 @@
 * in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
 ******************************************************************************/
 
-#include <climits>
 #include "edit_typeset.hpp"
 #include "tm_buffer.hpp"
 #include "convert.hpp"
@@ -40,8 +39,10 @@ edit_typeset_rep::edit_typeset_rep ():
        buf->data->ref, (buf->prj==NULL? grefs: buf->prj->data->ref),
        buf->data->aux, (buf->prj==NULL? buf->data->aux: buf->prj->data->aux),
        buf->data->att, (buf->prj==NULL? buf->data->att: buf->prj->data->att)),
-  ttt (new_typesetter (env, subtree (et, rp), reverse (rp))) {
+  ttt (new_typesetter (env, subtree (et, rp), reverse (rp))),
+  typeset_start (texmacs_time ()), first_paint (true) {
     init_update ();
+    estimate_far_paragraphs (ttt);
 }
 
 edit_typeset_rep::~edit_typeset_rep () { delete_typesetter (ttt); }
@@ -793,6 +794,9 @@ void
 edit_typeset_rep::typeset_sub (SI& x1, SI& y1, SI& x2, SI& y2) {
   //time_t t1= texmacs_time ();
   typeset_prepare ();
+  array<display_list> dls;
+  array<rectangle> rs;
+  eb->collect_display_lists (0, 0, dls, rs);
   eb= empty_box (reverse (rp));
   // saves memory, also necessary for change_log update
   bench_start ("typeset");
@@ -812,9 +816,12 @@ edit_typeset_rep::typeset_sub (SI& x1, SI& y1, SI& x2, SI& y2) {
   handle_exceptions ();
 #endif
   bench_end ("typeset");
+  if (N(dls) > 0)
+    eb->reuse_display_lists (0, 0, dls, rs, rectangle (x1, y1, x2, y2));
   //time_t t2= texmacs_time ();
   //if (t2 - t1 >= 10) cout << "typeset took " << t2-t1 << "ms\n";
   picture_cache_clean ();
+  resource_cache_clean ();
 }
 
 static void
@@ -839,37 +846,91 @@ report_redefined (array<tree> redefined) {
   }
 }
 
-static void
-clean_unused (hashmap<string,tree>& refs, hashmap<string,bool> used) {
-  array<string> a;
-  for (iterator<string> it= iterate (refs); it->busy(); ) {
+static hashmap<string,tree>
+still_missing (hashmap<string,tree> missing, edit_env env) {
+  hashmap<string,tree> r (UNINIT);
+  for (iterator<string> it= iterate (missing); it->busy(); ) {
     string key= it->next ();
-    if (!used->contains (key)) a << key;
+    if (!env->local_ref->contains (key) && !env->global_ref->contains (key))
+      r (key)= missing [key];
   }
-  for (int i=0; i<N(a); i++)
-    refs->reset (a[i]);
+  return r;
+}
+
+static void
+report_pass (int pass, int nr_subtrees, int nr_typeset, time_t t) {
+  if (DEBUG_BENCH)
+    std_bench << "Typesetting pass " << pass << " retypeset "
+              << nr_subtrees << " subtrees (" << nr_typeset << " bridges) in "
+              << t << " ms\n";
 }
 
 void
 edit_typeset_rep::typeset (SI& x1, SI& y1, SI& x2, SI& y2) {
-  int missing_nr= INT_MAX;
-  int redefined_nr= INT_MAX;
+  // after a complete typesetting, the references may have changed;
+  // only the subtrees which read changed references are typeset again,
+  // until the references no longer change
+  env->changed_refs= array<string> ();
+  time_t t= texmacs_time ();
+  if (first_paint && rp < tp)
+    (void) set_typeset_focus (ttt, (tp / rp)->item, (tp / rp)->item,
+                              get_visible_height ());
+  typeset_sub (x1, y1, x2, y2);
+  if (first_paint) {
+    first_paint= false;
+    if (DEBUG_BENCH)
+      std_bench << "First paint after " << texmacs_time () - typeset_start
+                << " ms, with " << number_of_estimates (ttt)
+                << " estimated paragraphs\n";
+  }
+  bool done= estimates_completed (ttt);
+  if (done && DEBUG_BENCH)
+    std_bench << "Typesetting completed after "
+              << texmacs_time () - typeset_start << " ms\n";
+  if (!env->complete && !done) return;
+  int pass= 1;
+  report_pass (pass, 1, ttt->nr_typeset, texmacs_time () - t);
   while (true) {
-    typeset_sub (x1, y1, x2, y2);
-    if (!env->complete) break;
-    env->complete= false;
-    clean_unused (env->local_ref, env->touched);
-    if (N(env->missing) == 0 && N(env->redefined) == 0) break;
-    if ((N(env->missing) == missing_nr && N(env->redefined) == redefined_nr) ||
-        (N(env->missing) > missing_nr || N(env->redefined) > redefined_nr)) {
-      report_missing (env->missing);
-      report_redefined (env->redefined);
-      break;
+    array<path> ps= changed_readers (ttt, pass);
+    if (N(ps) == 0) break;
+    t= texmacs_time ();
+    notify_readers (ttt, ps);
+    SI X1, Y1, X2, Y2;
+    typeset_sub (X1, Y1, X2, Y2);
+    if (X1 < X2 && Y1 < Y2) {
+      if (x1 >= x2 || y1 >= y2) { x1= X1; y1= Y1; x2= X2; y2= Y2; }
+      else { x1= min (x1, X1); y1= min (y1, Y1);
+             x2= max (x2, X2); y2= max (y2, Y2); }
     }
-    missing_nr= N(env->missing);
-    redefined_nr= N(env->redefined);
-    ::notify_assign (ttt, path(), ttt->br->st);
+    pass++;
+    report_pass (pass, N(ps), ttt->nr_typeset, texmacs_time () - t);
   }
+  report_missing (still_missing (env->missing, env));
+  report_redefined (env->redefined);
+}
+
+bool
+edit_typeset_rep::typeset_estimates (rectangle visible, bool idle) {
+  // while the heights of paragraphs far from the visible part are only
+  // estimated, return true if the document should be typeset again,
+  // either because estimated paragraphs became visible, or in order to
+  // complete some more of them when idle
+  if (number_of_estimates (ttt) == 0) return false;
+  path p1= eb->find_tree_path (visible->x1, visible->y2, 0);
+  path p2= eb->find_tree_path (visible->x1, visible->y1, 0);
+  int first= (rp < p1? (p1 / rp)->item: 0);
+  int last = (rp < p2? (p2 / rp)->item: first);
+  if (last < first) { int tmp= first; first= last; last= tmp; }
+  if (set_typeset_focus (ttt, first, last, visible->y2 - visible->y1))
+    return true;
+  if (!idle) return false;
+  complete_estimates (ttt, texmacs_time () + 50);
+  return true;
+}
+
+bool
+edit_typeset_rep::typeset_provisional () {
+  return ::typeset_provisional (ttt);
 }
 
 void
@@ -892,6 +953,9 @@ void
 edit_typeset_rep::typeset_invalidate_all () {
   //cout << "Invalidate all\n";
   notify_change (THE_ENVIRONMENT);
+  estimate_far_paragraphs (ttt);
+  typeset_start= texmacs_time ();
+  first_paint  = true;
   typeset_preamble ();
   ::notify_assign (ttt, path(), subtree (et, rp));
 }
@@ -28,6 +28,8 @@ protected:
   hashmap<string,tree> grefs;             // global references
   edit_env env;                           // the environment for typesetting
   typesetter ttt;                         // the (not) yet typesetted document
+  time_t typeset_start;                   // start of complete typesetting
+  bool first_paint;                       // first typesetting still to come
 
 protected:
   typesetter           get_typesetter ();
@@ -117,6 +119,8 @@ public:
   void     typeset_sub (SI& x1, SI& y1, SI& x2, SI& y2);
   void     typeset (SI& x1, SI& y1, SI& x2, SI& y2);
   void     typeset_forced ();
+  bool     typeset_estimates (rectangle visible, bool idle);
+  bool     typeset_provisional ();
 
   friend class tm_window_rep;
   friend class tm_server_rep;
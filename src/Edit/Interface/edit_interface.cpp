@@ -65,7 +65,7 @@ edit_interface_rep::edit_interface_rep ():
   last_x (0), last_y (0), last_t (0),
   table_selection (false), mouse_adjusting (false),
   oc (0, 0), temp_invalid_cursor (false),
-  shadow (NULL), stored (NULL),
+  shadow (NULL), stored (NULL), picture_gen (0),
   cur_sb (2), cur_wb (2)
 {
   input_mode= INPUT_NORMAL;
@@ -590,11 +590,33 @@ edit_interface_rep::apply_changes () {
   update_visible ();
   rectangle new_visible= rectangle (vx1, vy1, vx2, vy2);  
 
+  int gen= picture_cache_poll ();
+  if (gen != picture_gen) {
+    // pictures which were being converted have become available
+    picture_gen= gen;
+    tiles->clear ();
+    send_invalidate_all (this);
+  }
+
+  // paragraphs which are far from the visible part of a long document are
+  // first typeset with estimated heights; they are typeset for real when
+  // they become visible, or a few at a time when the user is idle
+  bool background= false;
+  time_t old_change= last_change, old_update= last_update;
+  bool idle= (env_change == 0 && idle_time (INTERRUPTED_EVENT) >= 1000/6);
+  if (typeset_estimates (new_visible, idle) && env_change == 0) {
+    env_change= THE_TREE;
+    background= true;
+  }
+
   if (env_change == 0) {
     if (last_change-last_update > 0 &&
         idle_time (INTERRUPTED_EVENT) >= 1000/6)
       update_menus ();
-    if (new_visible == last_visible) return;
+    if (new_visible == last_visible) {
+      if (idle_time (INTERRUPTED_EVENT) >= 1000/6) prefetch_tiles ();
+      return;
+    }
   }
 
   // cout << "Applying changes " << env_change << " to " << get_name() << "\n";
@@ -671,8 +693,10 @@ edit_interface_rep::apply_changes () {
   }
   
   // cout << "Handling environment\n";
-  if (env_change & THE_ENVIRONMENT)
+  if (env_change & THE_ENVIRONMENT) {
     typeset_invalidate_all ();
+    tiles->clear ();
+  }
 
   // cout << "Handling tree\n";
   if (env_change & (THE_TREE+THE_ENVIRONMENT)) {
@@ -680,6 +704,8 @@ edit_interface_rep::apply_changes () {
     SI x1, y1, x2, y2;
     typeset (x1, y1, x2, y2);
     invalidate (x1- 2*pixel, y1- 2*pixel, x2+ 2*pixel, y2+ 2*pixel);
+    tiles->invalidate (rectangle (x1- 2*pixel, y1- 2*pixel,
+                                  x2+ 2*pixel, y2+ 2*pixel));
     // check_data_integrety ();
     the_ghost_cursor()= eb->find_check_cursor (tp);
   }
@@ -752,7 +778,7 @@ edit_interface_rep::apply_changes () {
     go_to_here ();
     env_change= (env_change & (~THE_CURSOR)) | THE_CURSOR_BAK;
     if (env_change & (THE_TREE+THE_ENVIRONMENT+THE_EXTENTS+THE_CURSOR))
-      if (!inside_active_graphics ())
+      if (!inside_active_graphics () && !background)
         cursor_visible ();
     
     cursor cu= get_cursor();
@@ -915,6 +941,11 @@ edit_interface_rep::apply_changes () {
   env_change  = 0;
   last_change = texmacs_time ();
   last_update = last_change-1;
+  if (background) {
+    // typesetting in the background does not interrupt idleness
+    last_change= old_change;
+    last_update= old_update;
+  }
   last_visible= new_visible;
   manual_focus_release ();
 }
@@ -928,6 +959,8 @@ edit_interface_rep::animate () {
   if (((double) texmacs_time ()) >= anim_next) {
     rectangles rs= eb->anim_invalid ();
     invalidate (rs);
+    for (rectangles l= rs; !is_nil (l); l= l->next)
+      tiles->invalidate (l->item);
     stored_rects= rectangles ();
   }
 }
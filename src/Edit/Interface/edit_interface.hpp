@@ -14,6 +14,7 @@
 #include "editor.hpp"
 #include "tm_timer.hpp"
 #include "widget.hpp"
+#include "tile_cache.hpp"
 
 #define INPUT_NORMAL      0
 #define INPUT_SEARCH      1
@@ -69,6 +70,8 @@ protected:
   SI            vx1, vy1, vx2, vy2;
   rectangles    stored_rects;
   renderer      stored;
+  tile_cache    tiles;
+  int           picture_gen;   // generation of asynchronously loaded pictures
   rectangles    locus_new_rects;
   rectangles    locus_rects;
   list<string>  mouse_ids;
@@ -112,6 +115,10 @@ public:
   void draw_post (renderer win, renderer ren, rectangle r);
   void draw_with_shadow (renderer win, rectangle r);
   void draw_with_stored (renderer win, rectangle r);
+  bool use_tiles (renderer ren);
+  void draw_tile (renderer ren, int i, int j);
+  void draw_tiles (renderer ren, rectangle r, rectangles& l);
+  void prefetch_tiles ();
 
   /* handle changes */
   void notify_change (int changed);
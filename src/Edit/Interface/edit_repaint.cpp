@@ -16,6 +16,7 @@
 extern int nr_painted;
 extern void clear_pattern_rectangles (renderer ren, rectangle m, rectangles l);
 extern bool animated_flag;
+extern bool recording_display;
 
 /******************************************************************************
 * repainting the window
@@ -219,18 +220,107 @@ edit_interface_rep::draw_post (renderer win, renderer ren, rectangle r) {
   win->reset_zoom_factor ();
 }
 
+/******************************************************************************
+* repainting the text using cached tiles
+******************************************************************************/
+
+bool
+edit_interface_rep::use_tiles (renderer ren) {
+  return ren->is_screen && retina_factor == 1 &&
+         !inside_active_graphics () &&
+         get_preference ("tile cache") != "off";
+}
+
+void
+edit_interface_rep::draw_tile (renderer ren, int i, int j) {
+  // animated tiles are invalidated by animate () when they change
+  picture pic;
+  renderer tr= tiles->tile_renderer (ren, pic, i, j);
+  rectangle r= tiles->get_rectangle (i, j);
+  SI x1= max (eb->x1, r->x1), y1= max (eb->y1, r->y1);
+  SI x2= min (eb->x2, r->x2), y2= min (eb->y2, r->y2);
+  if (x1 < x2 && y1 < y2) draw_background (tr, x1, y1, x2, y2);
+  bool old_recording= recording_display;
+  recording_display= true;
+  nr_painted= 0;
+  animated_flag= false;
+  rectangles l;
+  eb->redraw (tr, path (), l);
+  recording_display= old_recording;
+  delete_renderer (tr);
+  tiles->insert (i, j, pic);
+  if (animated_flag) {
+    double t= max (((double) texmacs_time ()) + 25.0, eb->anim_next ());
+    anim_next= min (anim_next, t);
+  }
+}
+
+void
+edit_interface_rep::draw_tiles (renderer ren, rectangle r, rectangles& l) {
+  tiles->reset (ren);
+  if (texmacs_time () >= anim_next) anim_next= 1.0e12;
+  rectangle v (max (r->x1, eb->x3), max (r->y1, eb->y3),
+               min (r->x2, eb->x4), min (r->y2, eb->y4));
+  int i, j, i1, j1, i2, j2;
+  tiles->get_range (v, i1, j1, i2, j2);
+  for (j=j1; j<j2; j++)
+    for (i=i1; i<i2; i++) {
+      if (!tiles->contains (i, j)) {
+        if (gui_interrupted ()) return;
+        draw_tile (ren, i, j);
+      }
+      tiles->draw (ren, i, j);
+      rectangle tr= tiles->get_rectangle (i, j);
+      l= rectangles (translate (tr, ren->ox, ren->oy), l);
+    }
+}
+
+void
+edit_interface_rep::prefetch_tiles () {
+  // rasterize one missing tile above or below the visible region
+  if (shadow == NULL || is_nil (eb)) return;
+  renderer ren= shadow;
+  ren->set_zoom_factor (zoomf);
+  if (use_tiles (ren) && tiles->matches (ren)) {
+    SI h= vy2 - vy1;
+    rectangle v (max (vx1, eb->x3), max (vy1 - h, eb->y3),
+                 min (vx2, eb->x4), min (vy2 + h, eb->y4));
+    int i, j, k, i1, j1, i2, j2;
+    tiles->get_range (v, i1, j1, i2, j2);
+    int mid= (j1 + j2) >> 1;
+    for (k=0; k < j2-j1; k++) {
+      // rows closest to the middle of the visible region come first
+      j= ((k&1) == 0? mid + (k >> 1): mid - 1 - (k >> 1));
+      if (j < j1 || j >= j2) continue;
+      for (i=i1; i<i2; i++)
+        if (!tiles->contains (i, j)) {
+          draw_tile (ren, i, j);
+          ren->reset_zoom_factor ();
+          return;
+        }
+    }
+  }
+  ren->reset_zoom_factor ();
+}
+
+/******************************************************************************
+* repainting using shadow renderers and backing store
+******************************************************************************/
+
 void
 edit_interface_rep::draw_with_shadow (renderer win, rectangle r) {
   rectangle sr= r * magf;
   win->new_shadow (shadow);
   win->get_shadow (shadow, sr->x1, sr->y1, sr->x2, sr->y2);
   renderer ren= shadow;
+  ren->is_interactive= true;
 
   rectangles l;
   win->set_zoom_factor (zoomf);
   ren->set_zoom_factor (zoomf);
   draw_pre (win, ren, r);
-  draw_text (ren, l);
+  if (use_tiles (ren)) draw_tiles (ren, r, l);
+  else draw_text (ren, l);
   ren->reset_zoom_factor ();
   win->reset_zoom_factor ();
 
@@ -129,10 +129,7 @@ edit_process_rep::generate_bibliography (
       t= as_tree (call (string ("bib-compile"), bib, style, bib_t, bib_file));
     }
     else if (starts (style, "tm-")) {
-      string sbib;
-      if (load_string (bib_file, sbib, false))
-	std_error << "Could not load BibTeX file " << fname;
-      tree te= bib_entries (parse_bib (sbib), bib_t);
+      tree te= bib_entries (bib_file, bib_t);
       object ot= tree_to_stree (te);
       eval ("(use-modules (bibtex " * style (3, N(style)) * "))");
       t= stree_to_tree (call (string ("bib-process"),
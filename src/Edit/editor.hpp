@@ -307,6 +307,8 @@ public:
   virtual void     reset_att (string key) = 0;
   virtual array<string> list_atts () = 0;
   virtual void     typeset_forced () = 0;
+  virtual bool     typeset_estimates (rectangle visible, bool idle) = 0;
+  virtual bool     typeset_provisional () = 0;
   virtual void     typeset_invalidate (path p) = 0;
   virtual void     typeset_invalidate_all () = 0;
   virtual void     typeset_invalidate_players (path p, bool reattach) = 0;
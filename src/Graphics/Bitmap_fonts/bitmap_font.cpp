@@ -10,6 +10,7 @@
 ******************************************************************************/
 
 #include "bitmap_font.hpp"
+#include "iterator.hpp"
 
 RESOURCE_CODE(font_metric);
 RESOURCE_CODE(font_glyphs);
@@ -30,6 +31,52 @@ bool font_metric_rep::exists (int char_code) {
 SI font_metric_rep::kerning (int left_code, int right_code) {
   (void) left_code; (void) right_code; return 0; }
 
+/******************************************************************************
+* Tables of metrics and glyphs which are computed on demand
+******************************************************************************/
+
+#define ENTRY_SIZE (3 * sizeof (pointer))
+
+int
+metric_table_size (hashmap<int,pointer> t) {
+  // the entries point to metrics allocated with tm_new
+  return N(t) * (sizeof (metric_struct) + ENTRY_SIZE);
+}
+
+int
+glyph_table_size (hashmap<int,glyph> t) {
+  int size= 0;
+  iterator<int> it= iterate (t);
+  while (it->busy ()) {
+    glyph gl= t [it->next ()];
+    size += ENTRY_SIZE;
+    if (is_nil (gl)) continue;
+    int w= gl->width, h= gl->height;
+    size += sizeof (glyph_rep) + (gl->depth == 1? (w*h+7)/8: w*h);
+  }
+  return size;
+}
+
+void
+clear_metric_table (hashmap<int,pointer>& t) {
+  array<int> codes;
+  iterator<int> it= iterate (t);
+  while (it->busy ()) codes << it->next ();
+  for (int i=0; i<N(codes); i++) {
+    tm_delete ((metric_struct*) t [codes[i]]);
+    t->reset (codes[i]);
+  }
+}
+
+void
+clear_glyph_table (hashmap<int,glyph>& t) {
+  array<int> codes;
+  iterator<int> it= iterate (t);
+  while (it->busy ()) codes << it->next ();
+  for (int i=0; i<N(codes); i++)
+    t->reset (codes[i]);
+}
+
 /******************************************************************************
 * Standard bitmap metrics
 ******************************************************************************/
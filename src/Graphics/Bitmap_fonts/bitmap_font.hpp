@@ -158,6 +158,11 @@ struct font_glyphs_rep: rep<font_glyphs> {
   virtual glyph& get (int char_code) = 0;
 };
 
+int  metric_table_size (hashmap<int,pointer> t);
+int  glyph_table_size (hashmap<int,glyph> t);
+void clear_metric_table (hashmap<int,pointer>& t);
+void clear_glyph_table (hashmap<int,glyph>& t);
+
 font_metric std_font_metric (string s, metric* fnm, int bc, int ec);
 font_glyphs std_font_glyphs (string name, glyph* fng, int bc, int ec);
 
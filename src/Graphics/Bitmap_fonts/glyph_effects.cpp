@@ -99,6 +99,8 @@ struct distorted_font_glyphs_rep: public font_glyphs_rep {
     if ((&orig != &error_glyph) && !gs->contains (c))
       gs(c)= distorted (orig, kind, em, c);
     return gs(c); }
+  int  cache_size () { return glyph_table_size (gs); }
+  void cache_evict () { clear_glyph_table (gs); }
 };
 
 string
@@ -52,6 +52,8 @@ struct slanted_font_metric_rep: public font_metric_rep {
       r->y4= m->y4;
     }
     return *((metric*) ((void*) ms[c])); }
+  int  cache_size () { return metric_table_size (ms); }
+  void cache_evict () { clear_metric_table (ms); }
 };
 
 font_metric
@@ -99,6 +101,8 @@ struct slanted_font_glyphs_rep: public font_glyphs_rep {
     if ((&orig != &error_glyph) && !gs->contains (c))
       gs(c)= slanted (orig, slant);
     return gs(c); }
+  int  cache_size () { return glyph_table_size (gs); }
+  void cache_evict () { clear_glyph_table (gs); }
 };
 
 font_glyphs
@@ -137,6 +141,8 @@ struct stretched_font_metric_rep: public font_metric_rep {
       r->y4= (SI) ceil  (yf * m->y4);
     }
     return *((metric*) ((void*) ms[c])); }
+  int  cache_size () { return metric_table_size (ms); }
+  void cache_evict () { clear_metric_table (ms); }
 };
 
 font_metric
@@ -209,6 +215,8 @@ struct stretched_font_glyphs_rep: public font_glyphs_rep {
     if ((&orig != &error_glyph) && !gs->contains (c))
       gs(c)= stretched (orig, xf, yf);
     return gs(c); }
+  int  cache_size () { return glyph_table_size (gs); }
+  void cache_evict () { clear_glyph_table (gs); }
 };
 
 font_glyphs
@@ -283,6 +291,8 @@ struct extended_font_glyphs_rep: public font_glyphs_rep {
     if ((&orig != &error_glyph) && !gs->contains (c))
       gs(c)= widen (orig, xf, penw);
     return gs(c); }
+  int  cache_size () { return glyph_table_size (gs); }
+  void cache_evict () { clear_glyph_table (gs); }
 };
 
 font_glyphs
@@ -321,6 +331,8 @@ struct bolden_font_metric_rep: public font_metric_rep {
       r->y4= m->y4 + (dver >> 1);
     }
     return *((metric*) ((void*) ms[c])); }
+  int  cache_size () { return metric_table_size (ms); }
+  void cache_evict () { clear_metric_table (ms); }
 };
 
 font_metric
@@ -385,6 +397,8 @@ struct bolden_font_glyphs_rep: public font_glyphs_rep {
     if ((&orig != &error_glyph) && !gs->contains (c))
       gs(c)= bolden (orig, dpen, dtot, dver);
     return gs(c); }
+  int  cache_size () { return glyph_table_size (gs); }
+  void cache_evict () { clear_glyph_table (gs); }
 };
 
 font_glyphs
@@ -655,6 +669,8 @@ struct make_bbb_font_glyphs_rep: public font_glyphs_rep {
     if ((&orig != &error_glyph) && !gs->contains (c))
       gs(c)= make_bbb (orig, c, penw, penh, fatw);
     return gs(c); }
+  int  cache_size () { return glyph_table_size (gs); }
+  void cache_evict () { clear_glyph_table (gs); }
 };
 
 font_glyphs
@@ -15,6 +15,7 @@
 #include "Freetype/tt_tools.hpp"
 #include "translator.hpp"
 #include "iterator.hpp"
+#include "word_cache.hpp"
 
 bool virtually_defined (string c, string name);
 font smart_font_bis (string f, string v, string s, string sh, int sz,
@@ -634,6 +635,7 @@ struct smart_font_rep: font_rep {
 
   array<font> fn;
   smart_map   sm;
+  word_cache  words;
 
   smart_font_rep (string name, font base_fn, font err_fn,
                   string family, string variant,
@@ -652,9 +654,14 @@ struct smart_font_rep: font_rep {
   int    adjusted_dpi (string fam, string var, string ser, string sh, int att);
 
   bool   supports (string c);
+  void   compute_extents (string s, metric& ex);
+  void   compute_xpositions (string s, SI* xpos);
+  void   compute_xpositions (string s, SI* xpos, SI xk);
   void   get_extents (string s, metric& ex);
   void   get_xpositions (string s, SI* xpos);
   void   get_xpositions (string s, SI* xpos, SI xk);
+  int    cache_size ();
+  void   cache_evict ();
   void   draw_fixed (renderer ren, string s, SI x, SI y);
   void   draw_fixed (renderer ren, string s, SI x, SI y, SI xk);
   font   magnify (double zoomx, double zoomy);
@@ -1304,7 +1311,7 @@ smart_font_rep::supports (string c) {
 }
 
 void
-smart_font_rep::get_extents (string s, metric& ex) {
+smart_font_rep::compute_extents (string s, metric& ex) {
   //cout << "Extents of " << s << " for " << res_name << "\n";
   int i=0, n= N(s);
   if (n == 0) fn[0]->get_extents (empty_string, ex);
@@ -1342,7 +1349,7 @@ smart_font_rep::get_extents (string s, metric& ex) {
 }
 
 void
-smart_font_rep::get_xpositions (string s, SI* xpos) {
+smart_font_rep::compute_xpositions (string s, SI* xpos) {
   SI x= 0;
   int i=0, n= N(s);
   xpos[0]= x;
@@ -1371,7 +1378,7 @@ smart_font_rep::get_xpositions (string s, SI* xpos) {
 }
 
 void
-smart_font_rep::get_xpositions (string s, SI* xpos, SI xk) {
+smart_font_rep::compute_xpositions (string s, SI* xpos, SI xk) {
   SI x= 0;
   int i=0, n= N(s);
   xpos[0]= x;
@@ -1443,6 +1450,72 @@ smart_font_rep::magnify (double zoomx, double zoomy) {
                          (int) tm_round (dpi * zoomy));
 }
 
+/******************************************************************************
+* Caching the extents and x-positions of words
+******************************************************************************/
+
+void
+smart_font_rep::get_extents (string s, metric& ex) {
+  word_shape* w= words.find (s);
+  if (w != NULL && w->has_extents) {
+    words.hit ();
+    ex[0]= w->ex;
+    return;
+  }
+  compute_extents (s, ex);
+  w= words.insert (s);
+  if (w == NULL) return;
+  words.miss ();
+  w->ex= ex[0];
+  w->has_extents= true;
+}
+
+void
+smart_font_rep::get_xpositions (string s, SI* xpos) {
+  int i, n= N(s);
+  word_shape* w= words.find (s);
+  if (w != NULL && N(w->xpos) == n+1) {
+    words.hit ();
+    for (i=0; i<=n; i++) xpos[i]= w->xpos[i];
+    return;
+  }
+  compute_xpositions (s, xpos);
+  w= words.insert (s);
+  if (w == NULL) return;
+  words.miss ();
+  w->xpos= array<SI> (n+1);
+  for (i=0; i<=n; i++) w->xpos[i]= xpos[i];
+}
+
+void
+smart_font_rep::get_xpositions (string s, SI* xpos, SI xk) {
+  // only the positions for the last padding are remembered
+  int i, n= N(s);
+  word_shape* w= words.find (s);
+  if (w != NULL && N(w->xkpos) == n+1 && w->xk == xk) {
+    words.hit ();
+    for (i=0; i<=n; i++) xpos[i]= w->xkpos[i];
+    return;
+  }
+  compute_xpositions (s, xpos, xk);
+  w= words.insert (s);
+  if (w == NULL) return;
+  words.miss ();
+  w->xk= xk;
+  w->xkpos= array<SI> (n+1);
+  for (i=0; i<=n; i++) w->xkpos[i]= xpos[i];
+}
+
+int
+smart_font_rep::cache_size () {
+  return words.size ();
+}
+
+void
+smart_font_rep::cache_evict () {
+  words.clear ();
+}
+
 /******************************************************************************
 * Other routines for fonts
 ******************************************************************************/
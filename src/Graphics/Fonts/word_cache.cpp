@@ -0,0 +1,123 @@
+
+/******************************************************************************
+* MODULE     : word_cache.cpp
+* DESCRIPTION: caches for the extents and x-positions of words
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* Natural language text consists of the same words over and over again.
+* Instead of determining the subfonts, metrics, kernings and ligatures of
+* each word whenever a paragraph is typeset, fonts may remember the extents
+* and x-positions of the words which they recently measured.  The cache is
+* bounded using two generations: when the recent generation is full, it
+* becomes the old one and the previous old generation is discarded; words
+* which are found in the old generation move back to the recent one.
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "word_cache.hpp"
+#include "iterator.hpp"
+
+static long long total_hits  = 0;
+static long long total_misses= 0;
+
+static void
+delete_shapes (hashmap<string,pointer> t) {
+  iterator<string> it= iterate (t);
+  while (it->busy ())
+    tm_delete ((word_shape*) t [it->next ()]);
+}
+
+/******************************************************************************
+* Constructors and destructors
+******************************************************************************/
+
+word_cache::word_cache (int max_size2):
+  max_size (max_size2), recent (NULL), old (NULL), hits (0), misses (0) {}
+
+word_cache::~word_cache () {
+  delete_shapes (recent);
+  delete_shapes (old);
+}
+
+void
+word_cache::clear () {
+  delete_shapes (recent);
+  delete_shapes (old);
+  recent= hashmap<string,pointer> (NULL);
+  old   = hashmap<string,pointer> (NULL);
+}
+
+/******************************************************************************
+* Lookup
+******************************************************************************/
+
+word_shape*
+word_cache::find (string s) {
+  // the cached shape of s, or NULL
+  if (recent->contains (s)) return (word_shape*) recent [s];
+  if (!old->contains (s)) return NULL;
+  pointer w= old [s];
+  old->reset (s);
+  recent (s)= w;
+  return (word_shape*) w;
+}
+
+word_shape*
+word_cache::insert (string s) {
+  // the cached shape of s, which is created if necessary;
+  // NULL if s is not worth caching
+  if (N(s) == 0 || N(s) > WORD_CACHE_LENGTH) return NULL;
+  word_shape* w= find (s);
+  if (w != NULL) return w;
+  if (N(recent) >= max_size) {
+    delete_shapes (old);
+    old   = recent;
+    recent= hashmap<string,pointer> (NULL);
+  }
+  w= tm_new<word_shape> ();
+  recent (s)= (pointer) w;
+  return w;
+}
+
+void
+word_cache::hit () {
+  hits++;
+  total_hits++;
+}
+
+void
+word_cache::miss () {
+  misses++;
+  total_misses++;
+}
+
+/******************************************************************************
+* Statistics
+******************************************************************************/
+
+static int
+shapes_size (hashmap<string,pointer> t) {
+  int size= 0;
+  iterator<string> it= iterate (t);
+  while (it->busy ()) {
+    string s= it->next ();
+    word_shape* w= (word_shape*) t [s];
+    size += sizeof (word_shape) + N(s) + 3 * sizeof (pointer);
+    size += (N(w->xpos) + N(w->xkpos)) * sizeof (SI);
+  }
+  return size;
+}
+
+int
+word_cache::size () {
+  return shapes_size (recent) + shapes_size (old);
+}
+
+void
+word_cache_statistics (long long& hits, long long& misses) {
+  hits  = total_hits;
+  misses= total_misses;
+}
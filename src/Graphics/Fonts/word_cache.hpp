@@ -0,0 +1,51 @@
+
+/******************************************************************************
+* MODULE     : word_cache.hpp
+* DESCRIPTION: caches for the extents and x-positions of words
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef WORD_CACHE_H
+#define WORD_CACHE_H
+#include "bitmap_font.hpp"
+
+#define WORD_CACHE_SIZE    4096   // number of recent words per font
+#define WORD_CACHE_LENGTH  64     // longer strings are not cached
+
+struct word_shape {
+  bool          has_extents;     // ex has been computed
+  metric_struct ex;              // extents of the word
+  array<SI>     xpos;            // x-positions, if computed
+  SI            xk;              // padding for xkpos
+  array<SI>     xkpos;           // x-positions with padding xk, if computed
+  inline word_shape (): has_extents (false), xk (0) {}
+};
+
+class word_cache {
+  int max_size;                  // maximal number of recent words
+  hashmap<string,pointer> recent;
+  hashmap<string,pointer> old;
+  word_cache (const word_cache& wc);             // = delete;
+  word_cache& operator= (const word_cache& wc);  // = delete;
+
+public:
+  long long hits;                // number of successful lookups
+  long long misses;              // number of failed lookups
+
+  word_cache (int max_size= WORD_CACHE_SIZE);
+  ~word_cache ();
+  word_shape* find (string s);
+  word_shape* insert (string s);
+  void hit ();
+  void miss ();
+  int  size ();
+  void clear ();
+};
+
+void word_cache_statistics (long long& hits, long long& misses);
+
+#endif // defined WORD_CACHE_H
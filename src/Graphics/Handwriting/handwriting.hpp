@@ -10,15 +10,26 @@
 ******************************************************************************/
 
 #include "poly_line.hpp"
+#include "hashmap.hpp"
+#include "url.hpp"
 
-extern array<contours>       learned_glyphs;
-extern array<string>         learned_names;
-extern array<array<tree> >   learned_disc1;
-extern array<array<double> > learned_cont1;
-extern array<array<tree> >   learned_disc2;
-extern array<array<double> > learned_cont2;
+// The learned glyphs with the same discrete invariants (at a given level)
+// are grouped into a bucket, which stores their continuous invariants
+// contiguously, dim numbers for each glyph
+struct glyph_bucket {
+  int           dim;
+  array<string> names;
+  array<float>  cont;
+  inline glyph_bucket (): dim (0) {}
+};
 
+extern array<glyph_bucket> glyph_buckets;
+extern hashmap<string,int> glyph_bucket_index;
+
+string glyph_key (contours gl, int level, array<double>& cont);
 void register_glyph (string name, contours gl);
 string recognize_glyph (contours gl);
+bool load_glyph_index (url index, url source);
+bool save_glyph_index (url index, url source);
 
 array<point> simplify (array<point> a, double eps, double thr);
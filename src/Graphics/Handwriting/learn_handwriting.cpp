@@ -10,31 +10,151 @@
 ******************************************************************************/
 
 #include "handwriting.hpp"
+#include "file.hpp"
+#include "iterator.hpp"
+#include <string.h>
 
 /******************************************************************************
 * Learning glyphs
 ******************************************************************************/
 
-array<contours>       learned_glyphs;
-array<string>         learned_names;
-array<array<tree> >   learned_disc1;
-array<array<double> > learned_cont1;
-array<array<tree> >   learned_disc2;
-array<array<double> > learned_cont2;
+array<glyph_bucket> glyph_buckets;
+hashmap<string,int> glyph_bucket_index (-1);
+
+string
+glyph_key (contours gl, int level, array<double>& cont) {
+  // the continuous invariants of gl are returned in cont
+  array<tree> disc;
+  invariants (gl, level, disc, cont);
+  string key= as_string (level);
+  for (int i=0; i<N(disc); i++)
+    key << ":" << disc[i]->label;
+  key << "/" << as_string (N(cont));
+  return key;
+}
+
+static void
+add_glyph (string key, string name, array<double> cont) {
+  int i= glyph_bucket_index[key];
+  if (i < 0) {
+    i= N(glyph_buckets);
+    glyph_bucket_index (key)= i;
+    glyph_buckets << glyph_bucket ();
+    glyph_buckets[i].dim= N(cont);
+  }
+  glyph_bucket& b= glyph_buckets[i];
+  b.names << name;
+  for (int j=0; j<N(cont); j++)
+    b.cont << ((float) cont[j]);
+}
 
 void
 register_glyph (string name, contours gl) {
-  array<tree>   disc1;
-  array<double> cont1;
-  invariants (gl, 1, disc1, cont1);
-  array<tree>   disc2;
-  array<double> cont2;
-  invariants (gl, 2, disc2, cont2);
-  learned_names  << name;
-  learned_glyphs << gl;
-  learned_disc1  << disc1;
-  learned_cont1  << cont1;
-  learned_disc2  << disc2;
-  learned_cont2  << cont2;
-  //cout << "Added " << name << ", " << disc1 << "\n";
+  array<double> cont1, cont2;
+  string key1= glyph_key (gl, 1, cont1);
+  string key2= glyph_key (gl, 2, cont2);
+  add_glyph (key1, name, cont1);
+  add_glyph (key2, name, cont2);
+}
+
+/******************************************************************************
+* Saving and loading the learned glyphs
+*******************************************************************************
+* Computing the invariants of all learned glyphs is expensive, so the
+* buckets are also saved in a binary file, together with the size and the
+* modification time of the file with the learned glyphs themselves.
+* The binary file is only valid on the machine which created it.
+******************************************************************************/
+
+#define GLYPH_INDEX_MAGIC "TeXmacs glyph index 1\n"
+
+static void
+put_int (string& s, int x) {
+  s << string ((char*) ((void*) &x), sizeof (int));
+}
+
+static void
+put_string (string& s, string x) {
+  put_int (s, N(x));
+  s << x;
+}
+
+static bool
+get_int (string s, int& pos, int& x) {
+  if (pos + (int) sizeof (int) > N(s)) return false;
+  memcpy (&x, &s[pos], sizeof (int));
+  pos += sizeof (int);
+  return true;
+}
+
+static bool
+get_string (string s, int& pos, string& x) {
+  int n;
+  if (!get_int (s, pos, n) || n < 0 || pos + n > N(s)) return false;
+  x= s (pos, pos + n);
+  pos += n;
+  return true;
+}
+
+bool
+save_glyph_index (url index, url source) {
+  string s= GLYPH_INDEX_MAGIC;
+  put_int (s, (int) sizeof (float));
+  put_int (s, file_size (source));
+  put_int (s, last_modified (source, false));
+  put_int (s, N(glyph_buckets));
+  iterator<string> it= iterate (glyph_bucket_index);
+  while (it->busy ()) {
+    string key= it->next ();
+    glyph_bucket& b= glyph_buckets[glyph_bucket_index[key]];
+    put_string (s, key);
+    put_int (s, b.dim);
+    put_int (s, N(b.names));
+    for (int i=0; i<N(b.names); i++)
+      put_string (s, b.names[i]);
+    s << string ((char*) ((void*) A(b.cont)), N(b.cont) * sizeof (float));
+  }
+  return !save_string (index, s, false);
+}
+
+bool
+load_glyph_index (url index, url source) {
+  // replace the learned glyphs by those from the index, provided that
+  // it was saved for the current version of the source
+  string s;
+  if (!exists (index) || load_string (index, s, false)) return false;
+  string magic= GLYPH_INDEX_MAGIC;
+  int pos= N(magic);
+  if (N(s) < pos || s (0, pos) != magic) return false;
+  int fsize, size, date, nr;
+  if (!get_int (s, pos, fsize) || fsize != (int) sizeof (float)) return false;
+  if (!get_int (s, pos, size) || size != file_size (source)) return false;
+  if (!get_int (s, pos, date) || date != last_modified (source, false))
+    return false;
+  if (!get_int (s, pos, nr) || nr < 0) return false;
+  array<glyph_bucket> buckets;
+  hashmap<string,int> bucket_index (-1);
+  for (int i=0; i<nr; i++) {
+    string key;
+    glyph_bucket b;
+    int n;
+    if (!get_string (s, pos, key) || !get_int (s, pos, b.dim) ||
+        !get_int (s, pos, n) || b.dim < 0 || n < 0) return false;
+    for (int j=0; j<n; j++) {
+      string name;
+      if (!get_string (s, pos, name)) return false;
+      b.names << name;
+    }
+    int len= n * b.dim * sizeof (float);
+    if (pos + len > N(s)) return false;
+    b.cont= array<float> (n * b.dim);
+    if (len > 0) memcpy ((void*) A(b.cont), (void*) &s[pos], len);
+    pos += len;
+    bucket_index (key)= i;
+    buckets << b;
+  }
+  if (pos != N(s)) return false;
+  glyph_buckets= buckets;
+  glyph_bucket_index= bucket_index;
+  return true;
 }
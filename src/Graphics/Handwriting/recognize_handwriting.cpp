@@ -15,42 +15,54 @@
 * Recognize one glyph
 ******************************************************************************/
 
+static double
+squared_distance (float* a, float* b, int n) {
+  // independent partial sums allow the compiler to vectorize the loop
+  float s0= 0.0, s1= 0.0, s2= 0.0, s3= 0.0;
+  int i;
+  for (i=0; i+4<=n; i+=4) {
+    float d0= a[i] - b[i], d1= a[i+1] - b[i+1];
+    float d2= a[i+2] - b[i+2], d3= a[i+3] - b[i+3];
+    s0 += d0 * d0; s1 += d1 * d1; s2 += d2 * d2; s3 += d3 * d3;
+  }
+  for (; i<n; i++) {
+    float d= a[i] - b[i];
+    s0 += d * d;
+  }
+  return (double) ((s0 + s1) + (s2 + s3));
+}
+
+static bool
+recognize_glyph_at (contours gl, int level, string& best, double& best_rec) {
+  // only the learned glyphs with the same discrete invariants are compared
+  array<double> cont;
+  string key= glyph_key (gl, level, cont);
+  int i= glyph_bucket_index[key];
+  if (i < 0) return false;
+  glyph_bucket& b= glyph_buckets[i];
+  int n= b.dim;
+  if (n == 0) return false;
+  array<float> q (n);
+  for (int j=0; j<n; j++) q[j]= (float) cont[j];
+  float* data= A(b.cont);
+  double sn= sqrt ((double) n);
+  for (int k=0; k<N(b.names); k++) {
+    double dist= sqrt (squared_distance (data + k*n, A(q), n)) / sn;
+    double rec = 1.0 - dist;
+    if (rec > best_rec) { best_rec= rec; best= b.names[k]; }
+  }
+  return best != "";
+}
+
 void
 recognize_glyph_one (contours gl, int& level, string& best, double& best_rec) {
-  array<tree>   disc1;
-  array<double> cont1;
-  invariants (gl, 1, disc1, cont1);
-  array<tree>   disc2;
-  array<double> cont2;
-  invariants (gl, 2, disc2, cont2);
-
   best= "";
   best_rec= -100.0;
-  for (int i=0; i<N(learned_names); i++)
-    if (N(learned_glyphs[i]) == N(gl) && disc1 == learned_disc1[i]) {
-      string        name= learned_names[i];
-      array<double> cont= learned_cont1[i];
-      double        dist= l2_norm (cont - cont1) / sqrt (N(cont1));
-      double        rec = 1.0 - dist;
-      if (rec > best_rec) { best_rec= rec; best= name; }
-      //cout << name << ": " << 100.0 * rec << "%\n";
-    }
-  if (best != "") {
-    //cout << "disc= " << disc1 << "\n";
-    //cout << "cont= " << cont1 << "\n";
+  if (recognize_glyph_at (gl, 1, best, best_rec)) {
     level= 1;
     return;
   }
-
-  for (int i=0; i<N(learned_names); i++)
-    if (N(learned_glyphs[i]) == N(gl) && disc2 == learned_disc2[i]) {
-      string        name= learned_names[i];
-      array<double> cont= learned_cont2[i];
-      double        dist= l2_norm (cont - cont2) / sqrt (N(cont2));
-      double        rec = 1.0 - dist;
-      if (rec > best_rec) { best_rec= rec; best= name; }
-      //cout << name << ": " << 100.0 * rec << "%\n";
-    }
+  recognize_glyph_at (gl, 2, best, best_rec);
   level= 2;
 }
 
@@ -177,11 +177,63 @@ picture_is_cached (url file_name, int w, int h) {
   }
 }
 
+/******************************************************************************
+* Asynchronous loading of pictures which need an external converter
+******************************************************************************/
+
+static hashmap<tree,bool> picture_pending (false);
+static int picture_generation= 0;
+
+static picture
+placeholder_picture (int w, int h) {
+  picture pic= raster_picture (w, h);
+  draw_on (pic, 0x20808080, compose_source);
+  return pic;
+}
+
+class picture_loaded_command_rep: public command_rep {
+  tree key;
+  url file_name, png;
+  int w, h;
+public:
+  picture_loaded_command_rep (tree key2, url file_name2, url png2,
+                              int w2, int h2):
+    key (key2), file_name (file_name2), png (png2), w (w2), h (h2) {}
+  void apply () {
+    picture pic= exists (png)? load_picture (png, w, h): error_picture (w, h);
+    remove (png);
+    picture_pending -> reset (key);
+    picture_cache (key)= pic;
+    picture_stamp (key)= last_modified (file_name, false);
+    picture_blacklist (key) ++;
+    picture_generation++;
+  }
+};
+
+int
+picture_cache_poll () {
+  (void) poll_image_conversions ();
+  return picture_generation;
+}
+
 picture
-cached_load_picture (url file_name, int w, int h, bool permanent) {
+cached_load_picture (url file_name, int w, int h, bool permanent,
+                     bool async) {
   tree key= tuple (file_name->t, as_string (w), as_string (h));
   if (picture_is_cached (file_name, w, h))
     return picture_cache [key];
+  if (async && picture_pending [key])
+    return placeholder_picture (w, h);
+  if (async && !permanent) {
+    // display a placeholder while an external converter is running
+    url png= url_temp (".png");
+    command done= tm_new<picture_loaded_command_rep> (key, file_name, png,
+                                                      w, h);
+    if (image_convert_async (file_name, png, w, h, 0, done)) {
+      picture_pending (key)= true;
+      return placeholder_picture (w, h);
+    }
+  }
   //cout << "Loading " << key << "\n";
   picture pic= load_picture (file_name, w, h);
   if (permanent || picture_count[key] > 0) {
@@ -77,7 +77,9 @@ picture load_xpm (url file_name);
 void picture_cache_reserve (url u, int w, int h);
 void picture_cache_release (url u, int w, int h);
 void picture_cache_clean ();
-picture cached_load_picture (url u, int w, int h, bool permanent= true);
+picture cached_load_picture (url u, int w, int h, bool permanent= true,
+                             bool async= false);
+int picture_cache_poll ();
 string picture_as_eps (picture pic, int dpi);
 
 /******************************************************************************
@@ -48,7 +48,9 @@ public:
       px= ren->pixel;
       picture_cache_reserve (u, w/px, h/px);
     }
-    picture pict= cached_load_picture (u, w/ren->pixel, h/ren->pixel, false);
+    // only editor windows are repainted once the picture is converted
+    picture pict= cached_load_picture (u, w/ren->pixel, h/ren->pixel, false,
+                                       ren->is_interactive);
     ren->draw_picture (pict, x, y, alpha); }
 };
 
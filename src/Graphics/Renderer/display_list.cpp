@@ -0,0 +1,605 @@
+
+/******************************************************************************
+* MODULE     : display_list.cpp
+* DESCRIPTION: Retained lists of rendering instructions
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "display_list.hpp"
+#include "frame.hpp"
+
+#define DL_PENCIL         0
+#define DL_BRUSH          1
+#define DL_BACKGROUND     2
+#define DL_CLIP           3
+#define DL_UNCLIP         4
+#define DL_DRAW           5
+#define DL_LINE           6
+#define DL_LINES          7
+#define DL_CLEAR          8
+#define DL_CLEAR_PATTERN  9
+#define DL_FILL          10
+#define DL_ARC           11
+#define DL_FILL_ARC      12
+#define DL_POLYGON       13
+#define DL_PICTURE       14
+#define DL_SCALABLE      15
+
+// segment state: pencil, position of pencil, brush, position of brush,
+// background, clipped flag and clipping rectangle
+#define DL_STATE         10
+#define DL_HUGE          (PLUS_INFINITY >> 1)
+
+/******************************************************************************
+* Display lists
+******************************************************************************/
+
+display_list_rep::display_list_rep (renderer ref):
+  complete (true), evicted (false), bytes (0), used (0),
+  is_screen (ref->is_screen), zoomf (ref->zoomf),
+  shrinkf (ref->shrinkf), pixel (ref->pixel),
+  retina_pixel (ref->retina_pixel), brushpx (ref->brushpx),
+  thicken (ref->thicken) {}
+
+display_list_rep::~display_list_rep () {
+  evict ();
+}
+
+display_list::display_list (renderer ref):
+  rep (tm_new<display_list_rep> (ref)) {}
+
+bool
+display_list_rep::matches (renderer ren) {
+  return ren->is_screen == is_screen && ren->zoomf == zoomf &&
+         ren->shrinkf == shrinkf && ren->pixel == pixel &&
+         ren->retina_pixel == retina_pixel && ren->brushpx == brushpx &&
+         ren->thicken == thicken;
+}
+
+int
+display_list_rep::size () {
+  return N(code);
+}
+
+/******************************************************************************
+* Memory budget for retained display lists
+******************************************************************************/
+
+static array<display_list_rep*>* retained_lists= NULL;
+static int retained_memory= 0;
+static int retained_budget= DISPLAY_LIST_MEMORY;
+static int retained_stamp = 0;
+
+static array<display_list_rep*>&
+retained () {
+  // created on demand and never deleted, since lists may be destroyed
+  // by static destructors
+  if (retained_lists == NULL)
+    retained_lists= tm_new<array<display_list_rep*> > ();
+  return *retained_lists;
+}
+
+int
+display_list_rep::memory () {
+  // estimated number of bytes of the recorded instructions; pictures,
+  // fonts, pencils and brushes are shared and only count as pointers
+  int r= sizeof (display_list_rep);
+  r += (N(code) + N(seg_start) + N(seg_state) + N(seg_box)) * sizeof (int);
+  for (int i=0; i<N(coords); i++) r += N(coords[i]) * sizeof (SI);
+  r += (N(pens) + N(brushes) + N(fonts) + N(coords) + N(pics) + N(scals)) *
+       sizeof (pointer);
+  return r;
+}
+
+static void
+evict_display_lists (display_list_rep* keep) {
+  // evict the least recently used lists until the budget is respected
+  array<display_list_rep*>& a= retained ();
+  while (retained_memory > retained_budget) {
+    int i, oldest= -1;
+    for (i=0; i<N(a); i++)
+      if (a[i] != keep && (oldest < 0 || a[i]->used < a[oldest]->used))
+        oldest= i;
+    if (oldest < 0) break;
+    a[oldest]->evict ();
+  }
+}
+
+void
+display_list_rep::retain () {
+  // account for a list which has been recorded for repeated replays
+  if (bytes > 0) return;
+  bytes= memory ();
+  used = ++retained_stamp;
+  retained () << this;
+  retained_memory += bytes;
+  evict_display_lists (this);
+}
+
+void
+display_list_rep::evict () {
+  if (bytes == 0) return;
+  array<display_list_rep*>& a= retained ();
+  int i, n= N(a);
+  for (i=0; i<n; i++)
+    if (a[i] == this) {
+      a[i]= a[n-1];
+      a->resize (n-1);
+      break;
+    }
+  retained_memory -= bytes;
+  bytes    = 0;
+  complete = false;
+  evicted  = true;
+  code     = array<int> ();
+  seg_start= array<int> ();
+  seg_state= array<int> ();
+  seg_box  = array<SI> ();
+  pens     = array<pencil> ();
+  brushes  = array<brush> ();
+  fonts    = array<font_glyphs> ();
+  coords   = array<array<SI> > ();
+  pics     = array<picture> ();
+  scals    = array<scalable> ();
+}
+
+void
+set_display_list_memory (int budget) {
+  retained_budget= budget;
+  evict_display_lists (NULL);
+}
+
+int
+display_list_memory () {
+  return retained_memory;
+}
+
+/******************************************************************************
+* Replaying display lists
+******************************************************************************/
+
+static void
+restore_state (display_list_rep* dl, renderer ren, int* st,
+               SI bx1, SI by1, SI bx2, SI by2)
+{
+  // restore the graphical state as it was at the start of a segment
+  if (st[0] >= 0 && (st[2] < 0 || st[1] < st[3]))
+    ren->set_pencil (dl->pens[st[0]]);
+  if (st[2] >= 0) ren->set_brush (dl->brushes[st[2]]);
+  if (st[0] >= 0 && st[2] >= 0 && st[1] > st[3])
+    ren->set_pencil (dl->pens[st[0]]);
+  if (st[4] >= 0) ren->set_background (dl->brushes[st[4]]);
+  if (st[5] != 0)
+    ren->set_clipping (max (st[6], bx1), max (st[7], by1),
+                       min (st[8], bx2), min (st[9], by2));
+  else ren->set_clipping (bx1, by1, bx2, by2, true);
+}
+
+void
+display_list_rep::replay (renderer ren) {
+  if (evicted) return;
+  if (bytes > 0) used= ++retained_stamp;
+  SI bx1, by1, bx2, by2;
+  ren->get_clipping (bx1, by1, bx2, by2);
+  int  s, n= N(seg_start);
+  bool skipped= false;
+  for (s=0; s<n; s++) {
+    SI* b= &seg_box[4*s];
+    if (b[0] >= bx2 || b[2] <= bx1 || b[1] >= by2 || b[3] <= by1) {
+      skipped= true;
+      continue;
+    }
+    if (skipped) restore_state (this, ren, &seg_state[DL_STATE*s],
+                                bx1, by1, bx2, by2);
+    skipped= false;
+    int i= seg_start[s], end= (s+1 < n? seg_start[s+1]: N(code));
+    int* c= &code[0];
+    while (i < end) {
+      switch (c[i]) {
+      case DL_PENCIL:
+        ren->set_pencil (pens[c[i+1]]); i += 2; break;
+      case DL_BRUSH:
+        ren->set_brush (brushes[c[i+1]]); i += 2; break;
+      case DL_BACKGROUND:
+        ren->set_background (brushes[c[i+1]]); i += 2; break;
+      case DL_CLIP:
+        ren->set_clipping (max (c[i+1], bx1), max (c[i+2], by1),
+                           min (c[i+3], bx2), min (c[i+4], by2),
+                           c[i+5] != 0);
+        i += 6; break;
+      case DL_UNCLIP:
+        ren->set_clipping (bx1, by1, bx2, by2, true); i += 1; break;
+      case DL_DRAW:
+        ren->draw (c[i+1], fonts[c[i+2]], c[i+3], c[i+4]); i += 5; break;
+      case DL_LINE:
+        ren->line (c[i+1], c[i+2], c[i+3], c[i+4]); i += 5; break;
+      case DL_LINES:
+        ren->lines (coords[c[i+1]], coords[c[i+2]]); i += 3; break;
+      case DL_CLEAR:
+        ren->clear (c[i+1], c[i+2], c[i+3], c[i+4]); i += 5; break;
+      case DL_CLEAR_PATTERN:
+        ren->clear_pattern (c[i+1], c[i+2], c[i+3], c[i+4],
+                            c[i+5], c[i+6], c[i+7], c[i+8]);
+        i += 9; break;
+      case DL_FILL:
+        ren->fill (c[i+1], c[i+2], c[i+3], c[i+4]); i += 5; break;
+      case DL_ARC:
+        ren->arc (c[i+1], c[i+2], c[i+3], c[i+4], c[i+5], c[i+6]);
+        i += 7; break;
+      case DL_FILL_ARC:
+        ren->fill_arc (c[i+1], c[i+2], c[i+3], c[i+4], c[i+5], c[i+6]);
+        i += 7; break;
+      case DL_POLYGON:
+        ren->polygon (coords[c[i+1]], coords[c[i+2]], c[i+3] != 0);
+        i += 4; break;
+      case DL_PICTURE:
+        ren->draw_picture (pics[c[i+1]], c[i+2], c[i+3], c[i+4]);
+        i += 5; break;
+      case DL_SCALABLE:
+        ren->draw_scalable (scals[c[i+1]], c[i+2], c[i+3], c[i+4]);
+        i += 5; break;
+      default:
+        FAILED ("invalid display list");
+      }
+    }
+  }
+  restore_state (this, ren, &seg_state[DL_STATE*n], bx1, by1, bx2, by2);
+}
+
+/******************************************************************************
+* Recording renderers
+******************************************************************************/
+
+class display_list_renderer_rep: public renderer_rep {
+  display_list dl;
+  pencil pen;
+  brush  br, bg;
+  int    st[DL_STATE];     // current graphical state
+  int    nr_drawn;         // number of drawing instructions in segment
+
+  void state (int op, int index);
+  void start (SI x1, SI y1, SI x2, SI y2);
+  void start_stroke (SI x1, SI y1, SI x2, SI y2);
+  int  store (array<SI> a, SI dx);
+
+public:
+  display_list_renderer_rep (display_list dl, renderer ref);
+  ~display_list_renderer_rep ();
+
+  void get_clipping (SI &x1, SI &y1, SI &x2, SI &y2);
+  void set_clipping (SI x1, SI y1, SI x2, SI y2, bool restore= false);
+  pencil get_pencil ();
+  brush get_brush ();
+  brush get_background ();
+  void  set_pencil (pencil p);
+  void  set_brush (brush b);
+  void  set_background (brush b);
+
+  void draw (int char_code, font_glyphs fn, SI x, SI y);
+  void line (SI x1, SI y1, SI x2, SI y2);
+  void lines (array<SI> x, array<SI> y);
+  void clear (SI x1, SI y1, SI x2, SI y2);
+  void clear_pattern (SI mx1, SI my1, SI mx2, SI my2,
+                      SI x1, SI y1, SI x2, SI y2);
+  void fill (SI x1, SI y1, SI x2, SI y2);
+  void arc (SI x1, SI y1, SI x2, SI y2, int alpha, int delta);
+  void fill_arc (SI x1, SI y1, SI x2, SI y2, int alpha, int delta);
+  void polygon (array<SI> x, array<SI> y, bool convex=true);
+  void draw_picture (picture pic, SI x, SI y, int alpha= 255);
+  void draw_scalable (scalable im, SI x, SI y, int alpha= 255);
+
+  void fetch (SI x1, SI y1, SI x2, SI y2, renderer ren, SI x, SI y);
+  void new_shadow (renderer& ren);
+  void delete_shadow (renderer& ren);
+  void get_shadow (renderer ren, SI x1, SI y1, SI x2, SI y2);
+  void put_shadow (renderer ren, SI x1, SI y1, SI x2, SI y2);
+  void apply_shadow (SI x1, SI y1, SI x2, SI y2);
+  renderer shadow (picture& pic, SI x1, SI y1, SI x2, SI y2);
+  renderer shadow (scalable& im , SI x1, SI y1, SI x2, SI y2);
+  void set_transformation (frame fr);
+  void reset_transformation ();
+};
+
+display_list_renderer_rep::display_list_renderer_rep (display_list dl2,
+                                                      renderer ref):
+  renderer_rep (ref->is_screen), dl (dl2),
+  pen (ref->get_pencil ()), br (ref->get_brush ()),
+  bg (ref->get_background ()), nr_drawn (DISPLAY_LIST_SEGMENT)
+{
+  zoomf       = ref->zoomf;
+  shrinkf     = ref->shrinkf;
+  pixel       = ref->pixel;
+  retina_pixel= ref->retina_pixel;
+  brushpx     = ref->brushpx;
+  thicken     = ref->thicken;
+  cx1= cy1= -DL_HUGE;
+  cx2= cy2= DL_HUGE;
+  for (int i=0; i<DL_STATE; i++) st[i]= -1;
+  st[5]= 0;
+}
+
+display_list_renderer_rep::~display_list_renderer_rep () {
+  for (int i=0; i<DL_STATE; i++) dl->seg_state << st[i];
+}
+
+renderer
+display_list_renderer (display_list dl, renderer ref) {
+  return tm_new<display_list_renderer_rep> (dl, ref);
+}
+
+/******************************************************************************
+* Recording the graphical state
+******************************************************************************/
+
+void
+display_list_renderer_rep::state (int op, int index) {
+  if (nr_drawn >= DISPLAY_LIST_SEGMENT) start (0, 0, 0, 0);
+  switch (op) {
+  case DL_PENCIL: st[0]= index; st[1]= N(dl->code); break;
+  case DL_BRUSH: st[2]= index; st[3]= N(dl->code); break;
+  case DL_BACKGROUND: st[4]= index; break;
+  }
+  dl->code << op << index;
+}
+
+pencil
+display_list_renderer_rep::get_pencil () {
+  return pen;
+}
+
+brush
+display_list_renderer_rep::get_brush () {
+  return br;
+}
+
+brush
+display_list_renderer_rep::get_background () {
+  return bg;
+}
+
+void
+display_list_renderer_rep::set_pencil (pencil p) {
+  pen= p;
+  dl->pens << p;
+  state (DL_PENCIL, N(dl->pens) - 1);
+}
+
+void
+display_list_renderer_rep::set_brush (brush b) {
+  br= b;
+  dl->brushes << b;
+  state (DL_BRUSH, N(dl->brushes) - 1);
+}
+
+void
+display_list_renderer_rep::set_background (brush b) {
+  bg= b;
+  dl->brushes << b;
+  state (DL_BACKGROUND, N(dl->brushes) - 1);
+}
+
+void
+display_list_renderer_rep::get_clipping (SI &x1, SI &y1, SI &x2, SI &y2) {
+  x1= cx1- ox; y1= cy1- oy;
+  x2= cx2- ox; y2= cy2- oy;
+}
+
+void
+display_list_renderer_rep::set_clipping (SI x1, SI y1, SI x2, SI y2,
+                                         bool restore) {
+  // clipping rectangles are recorded without rounding, so that
+  // restoring the original clipping can be recognized
+  if (nr_drawn >= DISPLAY_LIST_SEGMENT) start (0, 0, 0, 0);
+  cx1= x1+ ox; cy1= y1+ oy;
+  cx2= x2+ ox; cy2= y2+ oy;
+  if (cx1 <= -DL_HUGE && cy1 <= -DL_HUGE && cx2 >= DL_HUGE && cy2 >= DL_HUGE) {
+    st[5]= 0;
+    dl->code << DL_UNCLIP;
+  }
+  else {
+    st[5]= 1; st[6]= cx1; st[7]= cy1; st[8]= cx2; st[9]= cy2;
+    dl->code << DL_CLIP << cx1 << cy1 << cx2 << cy2 << ((int) restore);
+  }
+}
+
+/******************************************************************************
+* Recording drawing instructions
+******************************************************************************/
+
+void
+display_list_renderer_rep::start (SI x1, SI y1, SI x2, SI y2) {
+  // account for a drawing instruction with given absolute extents
+  if (nr_drawn >= DISPLAY_LIST_SEGMENT) {
+    dl->seg_start << N(dl->code);
+    for (int i=0; i<DL_STATE; i++) dl->seg_state << st[i];
+    dl->seg_box << DL_HUGE << DL_HUGE << (-DL_HUGE) << (-DL_HUGE);
+    nr_drawn= 0;
+  }
+  if (x1 >= x2 || y1 >= y2) return;
+  SI* b= &(dl->seg_box[N(dl->seg_box) - 4]);
+  b[0]= min (b[0], x1); b[1]= min (b[1], y1);
+  b[2]= max (b[2], x2); b[3]= max (b[3], y2);
+  nr_drawn++;
+}
+
+void
+display_list_renderer_rep::start_stroke (SI x1, SI y1, SI x2, SI y2) {
+  SI d= pen->get_width () + 2 * pixel;
+  start (min (x1, x2) + ox - d, min (y1, y2) + oy - d,
+         max (x1, x2) + ox + d, max (y1, y2) + oy + d);
+}
+
+int
+display_list_renderer_rep::store (array<SI> a, SI dx) {
+  int i, n= N(a);
+  array<SI> b (n);
+  for (i=0; i<n; i++) b[i]= a[i] + dx;
+  dl->coords << b;
+  return N(dl->coords) - 1;
+}
+
+void
+display_list_renderer_rep::draw (int c, font_glyphs fng, SI x, SI y) {
+  SI x1= 0, y1= 0, x2= 0, y2= 0;
+  glyph gl= fng->get (c);
+  if (!is_nil (gl)) get_bounding_box (gl, x1, y1, x2, y2);
+  SI d= 2 * pixel;
+  start (x + ox + x1 - d, y + oy + y1 - d, x + ox + x2 + d, y + oy + y2 + d);
+  int n= N(dl->fonts);
+  if (n == 0 || dl->fonts[n-1].rep != fng.rep) dl->fonts << fng;
+  dl->code << DL_DRAW << c << (N(dl->fonts) - 1) << (x + ox) << (y + oy);
+}
+
+void
+display_list_renderer_rep::line (SI x1, SI y1, SI x2, SI y2) {
+  start_stroke (x1, y1, x2, y2);
+  dl->code << DL_LINE << (x1 + ox) << (y1 + oy) << (x2 + ox) << (y2 + oy);
+}
+
+void
+display_list_renderer_rep::lines (array<SI> x, array<SI> y) {
+  int i, n= min (N(x), N(y));
+  if (n == 0) return;
+  SI x1= x[0], y1= y[0], x2= x[0], y2= y[0];
+  for (i=1; i<n; i++) {
+    x1= min (x1, x[i]); y1= min (y1, y[i]);
+    x2= max (x2, x[i]); y2= max (y2, y[i]);
+  }
+  start_stroke (x1, y1, x2, y2);
+  int ix= store (x, ox), iy= store (y, oy);
+  dl->code << DL_LINES << ix << iy;
+}
+
+void
+display_list_renderer_rep::clear (SI x1, SI y1, SI x2, SI y2) {
+  start (x1 + ox, y1 + oy, x2 + ox, y2 + oy);
+  dl->code << DL_CLEAR << (x1 + ox) << (y1 + oy) << (x2 + ox) << (y2 + oy);
+}
+
+void
+display_list_renderer_rep::clear_pattern (SI mx1, SI my1, SI mx2, SI my2,
+                                          SI x1, SI y1, SI x2, SI y2) {
+  start (x1 + ox, y1 + oy, x2 + ox, y2 + oy);
+  dl->code << DL_CLEAR_PATTERN
+           << (mx1 + ox) << (my1 + oy) << (mx2 + ox) << (my2 + oy)
+           << (x1 + ox) << (y1 + oy) << (x2 + ox) << (y2 + oy);
+}
+
+void
+display_list_renderer_rep::fill (SI x1, SI y1, SI x2, SI y2) {
+  start (x1 + ox, y1 + oy, x2 + ox, y2 + oy);
+  dl->code << DL_FILL << (x1 + ox) << (y1 + oy) << (x2 + ox) << (y2 + oy);
+}
+
+void
+display_list_renderer_rep::arc (SI x1, SI y1, SI x2, SI y2,
+                                int alpha, int delta) {
+  start_stroke (x1, y1, x2, y2);
+  dl->code << DL_ARC << (x1 + ox) << (y1 + oy) << (x2 + ox) << (y2 + oy)
+           << alpha << delta;
+}
+
+void
+display_list_renderer_rep::fill_arc (SI x1, SI y1, SI x2, SI y2,
+                                     int alpha, int delta) {
+  start_stroke (x1, y1, x2, y2);
+  dl->code << DL_FILL_ARC << (x1 + ox) << (y1 + oy) << (x2 + ox) << (y2 + oy)
+           << alpha << delta;
+}
+
+void
+display_list_renderer_rep::polygon (array<SI> x, array<SI> y, bool convex) {
+  int i, n= min (N(x), N(y));
+  if (n == 0) return;
+  SI x1= x[0], y1= y[0], x2= x[0], y2= y[0];
+  for (i=1; i<n; i++) {
+    x1= min (x1, x[i]); y1= min (y1, y[i]);
+    x2= max (x2, x[i]); y2= max (y2, y[i]);
+  }
+  start_stroke (x1, y1, x2, y2);
+  int ix= store (x, ox), iy= store (y, oy);
+  dl->code << DL_POLYGON << ix << iy << ((int) convex);
+}
+
+void
+display_list_renderer_rep::draw_picture (picture p, SI x, SI y, int alpha) {
+  start (-DL_HUGE, -DL_HUGE, DL_HUGE, DL_HUGE);
+  dl->pics << p;
+  dl->code << DL_PICTURE << (N(dl->pics) - 1) << (x + ox) << (y + oy) << alpha;
+}
+
+void
+display_list_renderer_rep::draw_scalable (scalable im, SI x, SI y, int a) {
+  start (-DL_HUGE, -DL_HUGE, DL_HUGE, DL_HUGE);
+  dl->scals << im;
+  dl->code << DL_SCALABLE << (N(dl->scals) - 1) << (x + ox) << (y + oy) << a;
+}
+
+/******************************************************************************
+* Unsupported instructions
+******************************************************************************/
+
+void
+display_list_renderer_rep::fetch (SI x1, SI y1, SI x2, SI y2,
+                                  renderer ren, SI x, SI y) {
+  (void) x1; (void) y1; (void) x2; (void) y2;
+  (void) ren; (void) x; (void) y;
+  dl->complete= false;
+}
+
+void
+display_list_renderer_rep::new_shadow (renderer& ren) {
+  (void) ren;
+  dl->complete= false;
+}
+
+void
+display_list_renderer_rep::delete_shadow (renderer& ren) {
+  (void) ren;
+}
+
+void
+display_list_renderer_rep::get_shadow (renderer ren,
+                                       SI x1, SI y1, SI x2, SI y2) {
+  (void) ren; (void) x1; (void) y1; (void) x2; (void) y2;
+  dl->complete= false;
+}
+
+void
+display_list_renderer_rep::put_shadow (renderer ren,
+                                       SI x1, SI y1, SI x2, SI y2) {
+  (void) ren; (void) x1; (void) y1; (void) x2; (void) y2;
+  dl->complete= false;
+}
+
+void
+display_list_renderer_rep::apply_shadow (SI x1, SI y1, SI x2, SI y2) {
+  (void) x1; (void) y1; (void) x2; (void) y2;
+}
+
+renderer
+display_list_renderer_rep::shadow (picture& pic, SI x1, SI y1, SI x2, SI y2) {
+  dl->complete= false;
+  return renderer_rep::shadow (pic, x1, y1, x2, y2);
+}
+
+renderer
+display_list_renderer_rep::shadow (scalable& im, SI x1, SI y1, SI x2, SI y2) {
+  dl->complete= false;
+  return renderer_rep::shadow (im, x1, y1, x2, y2);
+}
+
+void
+display_list_renderer_rep::set_transformation (frame fr) {
+  (void) fr;
+  dl->complete= false;
+}
+
+void
+display_list_renderer_rep::reset_transformation () {
+  dl->complete= false;
+}
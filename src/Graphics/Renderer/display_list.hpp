@@ -0,0 +1,72 @@
+
+/******************************************************************************
+* MODULE     : display_list.hpp
+* DESCRIPTION: Retained lists of rendering instructions
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+#include "renderer.hpp"
+
+#define DISPLAY_LIST_SEGMENT 32
+#define DISPLAY_LIST_MEMORY  (1 << 26)
+
+/******************************************************************************
+* A display list stores the rendering instructions which were issued
+* on a recording renderer, with coordinates relative to its origin,
+* so that they can be replayed on any renderer with the same zoom.
+* Instructions are grouped into segments with a bounding box and
+* the graphical state at their start, so that only the segments which
+* intersect the clipping region need to be replayed.
+* Retained lists share a memory budget; when it is exceeded, the least
+* recently replayed lists are evicted and have to be recorded again.
+******************************************************************************/
+
+class display_list_rep: concrete_struct {
+public:
+  array<int>        code;       // opcodes followed by their arguments
+  array<int>        seg_start;  // start of each segment in code
+  array<int>        seg_state;  // pencil, brush, background and clipping
+  array<SI>         seg_box;    // bounding box of each segment
+  array<pencil>     pens;
+  array<brush>      brushes;
+  array<font_glyphs> fonts;
+  array<array<SI> > coords;
+  array<picture>    pics;
+  array<scalable>   scals;
+  tree   key;                   // identifies the recorded contents
+  bool   complete;              // false if unsupported instructions occurred
+  bool   evicted;               // the contents were dropped to save memory
+  int    bytes;                 // memory accounted for a retained list
+  int    used;                  // time stamp for eviction
+  bool   is_screen;             // renderer parameters for the recording
+  double zoomf;
+  int    shrinkf, pixel, retina_pixel, brushpx, thicken;
+
+  display_list_rep (renderer ref);
+  ~display_list_rep ();
+  bool matches (renderer ren);
+  void replay (renderer ren);
+  int  size ();
+  int  memory ();
+  void retain ();
+  void evict ();
+  friend class display_list;
+};
+
+class display_list {
+CONCRETE_NULL(display_list);
+  display_list (renderer ref);
+};
+CONCRETE_NULL_CODE(display_list);
+
+renderer display_list_renderer (display_list dl, renderer ref);
+void set_display_list_memory (int budget);
+int  display_list_memory ();
+
+#endif // defined DISPLAY_LIST_H
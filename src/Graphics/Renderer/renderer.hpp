@@ -41,6 +41,7 @@ public:
   SI  ox, oy;               // origin
   SI  cx1, cy1, cx2, cy2;   // visible region (clipping)
   bool is_screen;           // flag for renderers on screen
+  bool is_interactive;      // flag for renderers of editor windows
   double zoomf;             // zoom factor
   int shrinkf;              // shrinking factor
   int pixel;                // size of a pixel on the screen
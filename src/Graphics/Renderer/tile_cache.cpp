@@ -0,0 +1,230 @@
+
+/******************************************************************************
+* MODULE     : tile_cache.cpp
+* DESCRIPTION: Caching rasterized tiles of a document at a given zoom
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "tile_cache.hpp"
+
+static int tile_stamp = 0;           // time stamps shared by all caches
+static int tile_bytes = 0;           // memory used by the tiles of all caches
+static int tile_budget= TILE_MEMORY; // budget for the tiles of all caches
+static array<tile_cache_rep*>* all_caches= NULL;
+
+void evict_tiles (tile_cache_rep* keep);
+
+static array<tile_cache_rep*>&
+caches () {
+  // created on demand, since caches may outlive static destructors
+  if (all_caches == NULL) all_caches= tm_new<array<tile_cache_rep*> > ();
+  return *all_caches;
+}
+
+/******************************************************************************
+* Constructors and basic routines
+******************************************************************************/
+
+tile_cache_rep::tile_cache_rep (int width2, int memory):
+  width (width2), max_tiles (max (memory / (4 * width2 * width2), 4)),
+  zoomf (0.0), pixel (PIXEL), index (-1)
+{
+  caches () << this;
+}
+
+tile_cache_rep::~tile_cache_rep () {
+  clear ();
+  array<tile_cache_rep*>& a= caches ();
+  int i, n= N(a);
+  for (i=0; i<n; i++)
+    if (a[i] == this) {
+      a[i]= a[n-1];
+      a->resize (n-1);
+      break;
+    }
+}
+
+tile_cache::tile_cache (int width, int memory):
+  rep (tm_new<tile_cache_rep> (width, memory)) {}
+
+bool
+tile_cache_rep::matches (renderer ren) {
+  return ren->zoomf == zoomf && ren->pixel == pixel;
+}
+
+void
+tile_cache_rep::reset (renderer ren) {
+  if (matches (ren)) return;
+  clear ();
+  zoomf= ren->zoomf;
+  pixel= ren->pixel;
+}
+
+void
+tile_cache_rep::clear () {
+  tile_bytes -= N(pics) * 4 * width * width;
+  index= hashmap<pair<int,int>,int> (-1);
+  is  = array<int> ();
+  js  = array<int> ();
+  pics= array<picture> ();
+  used= array<int> ();
+}
+
+int
+tile_cache_rep::nr_tiles () {
+  return N(pics);
+}
+
+void
+tile_cache_rep::remove (int k) {
+  int last= N(pics) - 1;
+  tile_bytes -= 4 * width * width;
+  index->reset (pair<int,int> (is[k], js[k]));
+  if (k != last) {
+    is[k]= is[last]; js[k]= js[last];
+    pics[k]= pics[last]; used[k]= used[last];
+    index (pair<int,int> (is[k], js[k]))= k;
+  }
+  is->resize (last); js->resize (last);
+  pics->resize (last); used->resize (last);
+}
+
+/******************************************************************************
+* Geometry of tiles
+******************************************************************************/
+
+static inline int
+floor_div (SI x, SI d) {
+  return (int) (x >= 0? x / d: -((-x + d - 1) / d));
+}
+
+rectangle
+tile_cache_rep::get_rectangle (int i, int j) {
+  SI s= width * pixel;
+  return rectangle (i * s, -(j+1) * s, (i+1) * s, -j * s);
+}
+
+void
+tile_cache_rep::get_range (rectangle r, int& i1, int& j1, int& i2, int& j2) {
+  // tiles (i, j) with i1 <= i < i2 and j1 <= j < j2 cover r
+  SI s= width * pixel;
+  i1= floor_div (r->x1, s);
+  i2= floor_div (r->x2 + s - 1, s);
+  j1= floor_div (-r->y2, s);
+  j2= floor_div (-r->y1 + s - 1, s);
+}
+
+/******************************************************************************
+* Rendering and drawing tiles
+******************************************************************************/
+
+bool
+tile_cache_rep::contains (int i, int j) {
+  int k= index [pair<int,int> (i, j)];
+  if (k < 0) return false;
+  used[k]= ++tile_stamp;
+  return true;
+}
+
+renderer
+tile_cache_rep::tile_renderer (renderer ren, picture& pic, int i, int j) {
+  // the tile is rendered with the grid origin at an exact pixel,
+  // so that adjacent tiles match regardless of the scroll position
+  pic= native_picture (width, width, 0, width - 1);
+  renderer tr= picture_renderer (pic, ren->zoomf);
+  tr->is_screen   = ren->is_screen;
+  tr->is_interactive= ren->is_interactive;
+  tr->zoomf       = ren->zoomf;
+  tr->shrinkf     = ren->shrinkf;
+  tr->pixel       = ren->pixel;
+  tr->retina_pixel= ren->retina_pixel;
+  tr->brushpx     = ren->brushpx;
+  tr->thicken     = ren->thicken;
+  SI s= width * pixel;
+  tr->set_origin (-i * s, j * s);
+  rectangle r= get_rectangle (i, j);
+  tr->set_clipping (r->x1, r->y1, r->x2, r->y2);
+  return tr;
+}
+
+void
+tile_cache_rep::insert (int i, int j, picture pic) {
+  int k= index [pair<int,int> (i, j)];
+  if (k >= 0) {
+    pics[k]= pic;
+    used[k]= ++tile_stamp;
+    return;
+  }
+  if (N(pics) >= max_tiles) {
+    int l, oldest= 0;
+    for (l=1; l<N(used); l++)
+      if (used[l] < used[oldest]) oldest= l;
+    remove (oldest);
+  }
+  index (pair<int,int> (i, j))= N(pics);
+  is << i; js << j;
+  pics << pic;
+  used << ++tile_stamp;
+  tile_bytes += 4 * width * width;
+  evict_tiles (this);
+}
+
+void
+tile_cache_rep::draw (renderer ren, int i, int j) {
+  int k= index [pair<int,int> (i, j)];
+  if (k < 0) return;
+  SI x0= 0, y0= 0;
+  ren->decode (x0, y0);
+  SI x= (x0 + i * width) * ren->pixel - ren->ox;
+  SI y= -(y0 + j * width) * ren->pixel - ren->oy;
+  ren->draw_picture (pics[k], x, y);
+}
+
+void
+tile_cache_rep::invalidate (rectangle r) {
+  if (N(pics) == 0) return;
+  int i1, j1, i2, j2;
+  get_range (r, i1, j1, i2, j2);
+  for (int k= N(pics) - 1; k >= 0; k--)
+    if (is[k] >= i1 && is[k] < i2 && js[k] >= j1 && js[k] < j2)
+      remove (k);
+}
+
+/******************************************************************************
+* Memory shared by all tile caches
+******************************************************************************/
+
+void
+evict_tiles (tile_cache_rep* keep) {
+  // remove the least recently used tiles of all caches until the global
+  // budget is respected, except for the most recent tile of keep
+  array<tile_cache_rep*>& a= caches ();
+  while (tile_bytes > tile_budget) {
+    tile_cache_rep* tc= NULL;
+    int i, k, oldest= -1;
+    for (i=0; i<N(a); i++)
+      for (k=0; k<N(a[i]->used); k++)
+        if (a[i] != keep || a[i]->used[k] != tile_stamp)
+          if (tc == NULL || a[i]->used[k] < tc->used[oldest]) {
+            tc= a[i];
+            oldest= k;
+          }
+    if (tc == NULL) break;
+    tc->remove (oldest);
+  }
+}
+
+void
+set_tile_memory (int budget) {
+  tile_budget= budget;
+  evict_tiles (NULL);
+}
+
+int
+tile_memory () {
+  return tile_bytes;
+}
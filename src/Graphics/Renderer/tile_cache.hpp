@@ -0,0 +1,74 @@
+
+/******************************************************************************
+* MODULE     : tile_cache.hpp
+* DESCRIPTION: Caching rasterized tiles of a document at a given zoom
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+#include "renderer.hpp"
+#include "rectangles.hpp"
+#include "hashmap.hpp"
+
+#define TILE_SIZE   256
+#define TILE_MEMORY (1 << 26)
+
+/******************************************************************************
+* A tile cache stores pictures for square tiles of TILE_SIZE pixels,
+* which are aligned on a grid whose origin is the origin of the document.
+* The tile (i, j) covers the pixel columns i*TILE_SIZE until
+* (i+1)*TILE_SIZE-1 and the pixel rows j*TILE_SIZE until (j+1)*TILE_SIZE-1
+* to the right of and below the origin.  All tiles are rendered at
+* the same zoom; the least recently used ones are discarded when
+* the cache exceeds its own memory budget.  The tiles of all caches
+* also share a global budget, so that the caches of several views
+* together do not use more than TILE_MEMORY bytes.
+******************************************************************************/
+
+class tile_cache_rep: concrete_struct {
+  int    width;                        // width and height of tiles in pixels
+  int    max_tiles;                    // maximal number of cached tiles
+  double zoomf;                        // zoom factor of the cached tiles
+  SI     pixel;                        // size of a pixel at this zoom
+  hashmap<pair<int,int>,int> index;    // position of a tile in the arrays
+  array<int>     is, js;               // coordinates of the cached tiles
+  array<picture> pics;                 // rasterized tiles
+  array<int>     used;                 // time stamps for eviction
+
+  void remove (int k);
+
+public:
+  tile_cache_rep (int width, int memory);
+  ~tile_cache_rep ();
+  bool      matches (renderer ren);
+  void      reset (renderer ren);
+  void      clear ();
+  int       nr_tiles ();
+  rectangle get_rectangle (int i, int j);
+  void      get_range (rectangle r, int& i1, int& j1, int& i2, int& j2);
+  bool      contains (int i, int j);
+  renderer  tile_renderer (renderer ren, picture& pic, int i, int j);
+  void      insert (int i, int j, picture pic);
+  void      draw (renderer ren, int i, int j);
+  void      invalidate (rectangle r);
+  friend class tile_cache;
+  friend void evict_tiles (tile_cache_rep* keep);
+};
+
+class tile_cache {
+CONCRETE(tile_cache);
+  tile_cache (int width= TILE_SIZE, int memory= TILE_MEMORY);
+};
+CONCRETE_CODE(tile_cache);
+
+inline int N (tile_cache tc) { return tc->nr_tiles (); }
+
+void set_tile_memory (int budget);
+int  tile_memory ();
+
+#endif // defined TILE_CACHE_H
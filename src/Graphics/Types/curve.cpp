@@ -29,6 +29,15 @@ curve_rep::rectify (double eps) {
   return a;
 }
 
+array<point2>
+curve_rep::evaluate_batch (array<double> ts) {
+  int i, n= N(ts);
+  array<point2> r (n);
+  for (i=0; i<n; i++)
+    r[i]= as_point2 (evaluate (ts[i]));
+  return r;
+}
+
 double
 curve_rep::bound (double t, double eps) {
   //TODO: Improve this, as soon as the curvature ()
@@ -235,6 +244,7 @@ struct segment_rep: public curve_rep {
   segment_rep (point p1b, point p2b): p1 (p1b), p2 (p2b) {}
   point evaluate (double t) { return (1.0-t)*p1 + t*p2; }
   void rectify_cumul (array<point>& a, double eps) { (void) eps; a << p2; }
+  array<point2> evaluate_batch (array<double> ts);
   double bound (double t, double eps) {
     return curve_rep::bound (t, eps);
   }
@@ -269,6 +279,18 @@ segment_rep::get_control_points (
   return 2;
 }
 
+array<point2>
+segment_rep::evaluate_batch (array<double> ts) {
+  int i, n= N(ts);
+  array<point2> r (n);
+  point2 q1= as_point2 (p1), q2= as_point2 (p2);
+  double* t= A(ts);
+  point2* q= A(r);
+  for (i=0; i<n; i++)
+    q[i]= point2 ((1.0-t[i])*q1.x + t[i]*q2.x, (1.0-t[i])*q1.y + t[i]*q2.y);
+  return r;
+}
+
 curve
 segment (point p1, point p2) {
   return tm_new<segment_rep> (p1, p2);
@@ -344,6 +366,8 @@ struct spline_rep: public curve_rep {
   array<double> U;
   array<dpols> p;
   bool close, interpol;
+  bool flat;         // all points are two dimensional
+  array<point2> C;   // the coefficients of the first two coordinates of p
 
   spline_rep (
     array<point> a, array<path> cip, bool close=false, bool interpol=true);
@@ -356,20 +380,26 @@ struct spline_rep: public curve_rep {
   int interval_no (double u);
 
   point spline (int i,double u,int o=0);
+  point2 spline2 (int i, double u, int o=0);
   inline double S (
     array<dpol> p1, array<dpol> p2, array<dpol> p3,
     int i, double u);
   point evaluate (double t,int o);
   point evaluate (double t);
+  array<point2> evaluate_batch (array<double> ts);
   double bound (double t, double eps);
   point grad (double t, bool& error);
 
   double curvature (int i, double t1, double t2);
   double curvature (double t1, double t2);
+  double curvature2 (int i, double t1, double t2);
 
   bool approx (int i, double u1, double u2, double eps);
+  bool approx2 (int i, double u1, double u2, double eps);
   void rectify_cumul (array<point>& cum, int i,
 		      double u1, double u2, double eps);
+  void rectify_cumul2 (array<point>& cum, int i,
+		       double u1, double u2, double eps);
   void rectify_cumul (array<point>& cum, double eps);
   int get_control_points (
     array<double>&abs, array<point>& pts, array<path>& cip);
@@ -489,6 +519,14 @@ spline_rep::spline_rep (
   }
   for (i=2; i<=n; i++)
     p[i]= a[i]*p1[i] + a[i-1]*p2[i-1] + a[i-2]*p3[i-2];
+  flat= true;
+  C= array<point2> (3*(n+1));
+  for (i=2; i<=n; i++) {
+    int j, k= N(p[i]);
+    flat= flat && (k == 2);
+    for (j=0; j<3; j++)
+      C[3*i+j]= point2 (k>0? p[i][0][j]: 0.0, k>1? p[i][1][j]: 0.0);
+  }
 }
 
 // Evaluation
@@ -516,9 +554,30 @@ spline_rep::spline (int i, double u, int o) {
   return res;
 }
 
+point2
+spline_rep::spline2 (int i, double u, int o) {
+  // same as spline for the first two coordinates, without allocations
+  point2* c= A(C) + 3*i;
+  if (o == 1) return point2 (u * (2.0 * c[2].x) + c[1].x,
+                             u * (2.0 * c[2].y) + c[1].y);
+  if (o == 2) return 2.0 * c[2];
+  return point2 (u * (u * c[2].x + c[1].x) + c[0].x,
+                 u * (u * c[2].y + c[1].y) + c[0].y);
+}
+
 int
 spline_rep::interval_no (double u) {
   int i;
+  if (u >= U[0] && u < U[n+3]) {
+    // the knots U[0], ..., U[n+3] are increasing
+    int lo= 0, hi= n+3;
+    while (hi - lo > 1) {
+      int mid= (lo + hi) >> 1;
+      if (u < U[mid]) hi= mid;
+      else lo= mid;
+    }
+    return lo;
+  }
   for (i=0;i<N(U);i++)
     if (u>=U[i] && u<U[i+1]) return i;
   return -1;
@@ -552,6 +611,20 @@ spline_rep::evaluate (double t) {
   return evaluate(t,0);
 }
 
+array<point2>
+spline_rep::evaluate_batch (array<double> ts) {
+  int i, nr= N(ts);
+  array<point2> r (nr);
+  for (i=0; i<nr; i++) {
+    double t= convert (ts[i]);
+    int no= interval_no (t);
+    if (no<2) r[i]= spline2 (2, U[2]);
+    else if (no>n) r[i]= spline2 (n, U[n+1]);
+    else r[i]= spline2 (no, t);
+  }
+  return r;
+}
+
 double
 spline_rep::bound (double t, double eps) {
   return eps/norm(evaluate(t,1));
@@ -590,11 +663,33 @@ spline_rep::rectify_cumul (array<point>& cum, int i,
   }
 }
 
+bool
+spline_rep::approx2 (int i, double u1, double u2, double eps) {
+  double l= norm (spline2 (i, u1) - spline2 (i, u2));
+  if (l!=0 && fnull (l,1.0e-6)) l=0;
+  double R= curvature2 (i, u1, u2);
+  return l<=2*sqrt(2*R*eps);
+}
+
+void
+spline_rep::rectify_cumul2 (array<point>& cum, int i,
+                            double u1, double u2, double eps) {
+  // same as rectify_cumul for two dimensional splines
+  if (approx2 (i, u1, u2, eps))
+    cum << as_point (spline2 (i, u2));
+  else {
+    double u=(u1+u2)/2;
+    rectify_cumul2 (cum, i, u1, u, eps);
+    rectify_cumul2 (cum, i, u, u2, eps);
+  }
+}
+
 void
 spline_rep::rectify_cumul (array<point>& cum, double eps) {
   int i;
   for (i=2;i<=n;i++)
-    rectify_cumul(cum,i,U[i],U[i+1],eps);
+    if (flat) rectify_cumul2 (cum, i, U[i], U[i+1], eps);
+    else rectify_cumul(cum,i,U[i],U[i+1],eps);
 }
 
 // Curvature
@@ -616,6 +711,19 @@ spline_rep::curvature (int i, double t1, double t2) {
   return R;
 }
 
+double
+spline_rep::curvature2 (int i, double t1, double t2) {
+  point2 a= C[3*i+2], b= C[3*i+1];
+  if (norm (a) == 0) return tm_infinity;
+  double t= -inner (a, b) / (2 * inner (a, a));
+  if (t1>t) t=t1;
+  else if (t2<t) t=t2;
+  point2 pp= spline2 (i, t, 1);
+  point2 ps= spline2 (i, t, 2);
+  if (norm (ps) == 0) return tm_infinity;
+  return square (norm (pp)) / norm (ps);
+}
+
 double
 spline_rep::curvature (double t1, double t2) {
   double res;
@@ -678,9 +786,16 @@ spline (array<point> a, array<path> cip, bool close, bool interpol) {
 struct bezier_rep: public curve_rep {
   array<point> a;
   array<point> P;
+  bool flat;      // all control points are two dimensional
+  point2 Q[4];    // the first two coordinates of P
   bezier_rep (array<point> a);
   point evaluate (double t);
+  inline point2 evaluate2 (double t) {
+    return point2 (((Q[3].x*t + Q[2].x)*t + Q[1].x)*t + Q[0].x,
+                   ((Q[3].y*t + Q[2].y)*t + Q[1].y)*t + Q[0].y); }
+  array<point2> evaluate_batch (array<double> ts);
   void rectify_cumul (array<point>& cum, double t0, double t1, double eps);
+  void rectify_cumul2 (array<point>& cum, double t0, double t1, double eps);
   void rectify_cumul (array<point>& cum, double eps);
   double bound (double t, double eps);
   point grad (double t, bool& error);
@@ -692,6 +807,11 @@ bezier_rep::bezier_rep (array<point> a2): a (a2) {
   P << (-3.0*a[0] + 3.0*a[1]);
   P << (3.0*a[0] - 6.0*a[1] + 3.0*a[2]);
   P << (-a[0] + 3.0*a[1] - 3.0*a[2] + a[3]);
+  flat= true;
+  for (int i=0; i<4; i++) {
+    flat= flat && N(a[i]) == 2;
+    Q[i]= as_point2 (P[i]);
+  }
 }
 
 point
@@ -718,9 +838,40 @@ bezier_rep::rectify_cumul (array<point>& cum, double t0, double t1, double e) {
   cum << p1;
 }
 
+void
+bezier_rep::rectify_cumul2 (array<point>& cum, double t0, double t1, double e) {
+  // same as rectify_cumul for two dimensional curves
+  point2 p0= evaluate2 (t0);
+  point2 p1= evaluate2 (t1);
+  for (int k=1; k<=4; k++) {
+    double x= ((double) k) / 5.0;
+    double t= (1.0 - x) * t0 + x * t1;
+    point2 q= evaluate2 (t);
+    point2 r= (1.0 - x) * p0 + x * p1;
+    if (norm (q - r) >= (e / 10.0)) {
+      rectify_cumul2 (cum, t0, (t0 + t1) / 2.0, e);
+      rectify_cumul2 (cum, (t0 + t1) / 2.0, t1, e);
+      return;
+    }
+  }
+  cum << as_point (p1);
+}
+
 void
 bezier_rep::rectify_cumul (array<point>& cum, double eps) {
-  rectify_cumul (cum, 0.0, 1.0, eps);
+  if (flat) rectify_cumul2 (cum, 0.0, 1.0, eps);
+  else rectify_cumul (cum, 0.0, 1.0, eps);
+}
+
+array<point2>
+bezier_rep::evaluate_batch (array<double> ts) {
+  int i, n= N(ts);
+  array<point2> r (n);
+  double* t= A(ts);
+  point2* q= A(r);
+  for (i=0; i<n; i++)
+    q[i]= evaluate2 (t[i]);
+  return r;
 }
 
 double
@@ -911,6 +1062,7 @@ struct arc_rep: public curve_rep {
   double e1, e2; // Coordinates of the two extremal points of the arc
   arc_rep (array<point> a, array<path> cip, bool close);
   point evaluate (double t);
+  array<point2> evaluate_batch (array<double> ts);
   void rectify_cumul (array<point>& cum, double eps);
   double bound (double t, double eps);
   point grad (double t, bool& error);
@@ -978,14 +1130,36 @@ arc_rep::evaluate (double t) {
                 + r2*sin(2*tm_PI*t)*j;
 }
 
+array<point2>
+arc_rep::evaluate_batch (array<double> ts) {
+  int k, n= N(ts);
+  array<point2> r (n);
+  point2 c= as_point2 (center), i2= as_point2 (i), j2= as_point2 (j);
+  for (k=0; k<n; k++) {
+    double t= e1 + ts[k]*(e2 - e1);
+    double x= r1*cos(2*tm_PI*t), y= r2*sin(2*tm_PI*t);
+    r[k]= point2 (c.x + x*i2.x + y*j2.x, c.y + x*i2.y + y*j2.y);
+  }
+  return r;
+}
+
 void
 arc_rep::rectify_cumul (array<point>& cum, double eps) {
   double t, step;
   step= sqrt (2*eps / max (r1, r2) ) / tm_PI;
+  array<double> ts;
   for (t=step; t<=1.0; t+=step)
-    cum << evaluate (t);
+    ts << t;
   if (t-step != 1.0)
-    cum << evaluate (1.0);
+    ts << 1.0;
+  if (N(center) == 2 && N(i) == 2 && N(j) == 2) {
+    array<point2> r= evaluate_batch (ts);
+    for (int k=0; k<N(r); k++)
+      cum << as_point (r[k]);
+  }
+  else
+    for (int k=0; k<N(ts); k++)
+      cum << evaluate (ts[k]);
 }
 
 double
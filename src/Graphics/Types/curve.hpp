@@ -34,6 +34,10 @@ public:
   // add rectification of the curve  (except for the starting point)
   // to an existing polysegment
 
+  virtual array<point2> evaluate_batch (array<double> ts);
+  // evaluates the first two coordinates of the curve at all parameters ts;
+  // specific curves override this for faster drawing and hit-testing
+
   /*
   NOTE: more routines should be added later so that one
   can reliably compute the intersections between curves
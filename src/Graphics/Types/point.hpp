@@ -55,4 +55,72 @@ point  intersection (axis A, axis B);
 
 bool inside_rectangle (point p, point p1, point p2);
 
+/******************************************************************************
+* Points of fixed dimension
+*******************************************************************************
+* Unlike point, which is a reference counted array, the following
+* types are plain values.  They are meant for inner loops, such as the
+* evaluation and the rectification of curves, which would otherwise spend
+* most of their time in allocations.  Points are converted at the
+* interfaces; missing coordinates are taken to be zero.
+******************************************************************************/
+
+struct point2 {
+  double x, y;
+  inline point2 (): x (0.0), y (0.0) {}
+  inline point2 (double x2, double y2): x (x2), y (y2) {}
+};
+
+inline point2 operator - (point2 p) { return point2 (-p.x, -p.y); }
+inline point2 operator + (point2 p1, point2 p2) {
+  return point2 (p1.x + p2.x, p1.y + p2.y); }
+inline point2 operator - (point2 p1, point2 p2) {
+  return point2 (p1.x - p2.x, p1.y - p2.y); }
+inline point2 operator * (double x, point2 p) {
+  return point2 (x * p.x, x * p.y); }
+inline point2 operator / (point2 p, double x) {
+  return point2 (p.x / x, p.y / x); }
+inline bool operator == (point2 p1, point2 p2) {
+  return p1.x == p2.x && p1.y == p2.y; }
+inline bool operator != (point2 p1, point2 p2) {
+  return p1.x != p2.x || p1.y != p2.y; }
+inline double inner (point2 p1, point2 p2) {
+  return p1.x * p2.x + p1.y * p2.y; }
+inline double norm (point2 p) { return sqrt (inner (p, p)); }
+
+struct point3 {
+  double x, y, z;
+  inline point3 (): x (0.0), y (0.0), z (0.0) {}
+  inline point3 (double x2, double y2, double z2): x (x2), y (y2), z (z2) {}
+};
+
+inline point3 operator - (point3 p) { return point3 (-p.x, -p.y, -p.z); }
+inline point3 operator + (point3 p1, point3 p2) {
+  return point3 (p1.x + p2.x, p1.y + p2.y, p1.z + p2.z); }
+inline point3 operator - (point3 p1, point3 p2) {
+  return point3 (p1.x - p2.x, p1.y - p2.y, p1.z - p2.z); }
+inline point3 operator * (double x, point3 p) {
+  return point3 (x * p.x, x * p.y, x * p.z); }
+inline point3 operator / (point3 p, double x) {
+  return point3 (p.x / x, p.y / x, p.z / x); }
+inline bool operator == (point3 p1, point3 p2) {
+  return p1.x == p2.x && p1.y == p2.y && p1.z == p2.z; }
+inline bool operator != (point3 p1, point3 p2) {
+  return !(p1 == p2); }
+inline double inner (point3 p1, point3 p2) {
+  return p1.x * p2.x + p1.y * p2.y + p1.z * p2.z; }
+inline double norm (point3 p) { return sqrt (inner (p, p)); }
+inline point3 cross (point3 p1, point3 p2) {
+  return point3 (p1.y * p2.z - p1.z * p2.y,
+                 p1.z * p2.x - p1.x * p2.z,
+                 p1.x * p2.y - p1.y * p2.x); }
+
+inline point2 as_point2 (point p) {
+  return point2 (N(p) > 0? p[0]: 0.0, N(p) > 1? p[1]: 0.0); }
+inline point3 as_point3 (point p) {
+  return point3 (N(p) > 0? p[0]: 0.0, N(p) > 1? p[1]: 0.0,
+                 N(p) > 2? p[2]: 0.0); }
+inline point as_point (point2 p) { return point (p.x, p.y); }
+inline point as_point (point3 p) { return point (p.x, p.y, p.z); }
+
 #endif // defined POINT_H
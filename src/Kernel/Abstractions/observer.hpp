@@ -33,6 +33,9 @@ typedef list<int> path;
 #define OBSERVER_UNDO       7
 #define OBSERVER_HIGHLIGHT  8
 #define OBSERVER_WIDGET     9
+#define OBSERVER_SEARCH_INDEX 10
+#define OBSERVER_CELL_CACHE   11
+#define OBSERVER_TABLE_CACHE  12
 
 #define ADDENDUM_PLAYER     1
 
@@ -176,6 +179,8 @@ bool has_highlight (tree& ref, int lan);
 array<int> obtain_highlight (tree& ref, int lan);
 void detach_highlight (tree& ref, int lan);
 
+bool search_index_admits (tree& ref, string what);
+
 void stretched_print (tree t, bool ips= false, int indent= 0);
 
 #endif // defined OBSERVER_H
@@ -0,0 +1,146 @@
+
+/******************************************************************************
+* MODULE     : resource.cpp
+* DESCRIPTION: usage statistics of resources and eviction of their caches
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* Long sessions accumulate fonts, metrics and glyph tables for every zoom
+* level and magnification which has been visited.  The resources themselves
+* are small and remain in their tables, but the per character data they
+* cache are freed when the resource has not been used during several rounds
+* of eviction, or when the cached data of all resources exceed a budget.
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "resource.hpp"
+#include "hashset.hpp"
+#include "iterator.hpp"
+#include "analyze.hpp"
+#include "merge_sort.hpp"
+#include "tm_timer.hpp"
+
+#define RESOURCE_ROUND  10000     // milliseconds between rounds of eviction
+#define RESOURCE_IDLE   6         // rounds after which unused data are freed
+#define RESOURCE_BUDGET (64<<20)  // bytes of cached data for all resources
+
+int resource_clock= 0;
+static hashset<pointer>* all_resources= NULL;
+
+static hashset<pointer>&
+resources () {
+  // created on demand, since resources may be built by static initializers
+  if (all_resources == NULL) all_resources= tm_new<hashset<pointer> > ();
+  return *all_resources;
+}
+
+/******************************************************************************
+* Abstract resources
+******************************************************************************/
+
+abstract_resource_rep::abstract_resource_rep (const char* type):
+  res_type (type), res_used (resource_clock)
+{
+  resources () -> insert ((pointer) this);
+}
+
+abstract_resource_rep::~abstract_resource_rep () {
+  resources () -> remove ((pointer) this);
+}
+
+int
+abstract_resource_rep::cache_size () {
+  return 0;
+}
+
+void
+abstract_resource_rep::cache_evict () {
+}
+
+/******************************************************************************
+* Eviction
+******************************************************************************/
+
+void
+evict_resources (int max_idle, int budget) {
+  // free the cached data of the resources which were not used during
+  // the last max_idle rounds; if the remaining data exceed the budget,
+  // also free the data of the least recently used resources, except
+  // for those which were used during the current round
+  array<abstract_resource_rep*> a;
+  array<int> sizes;
+  int total= 0;
+  iterator<pointer> it= iterate (resources ());
+  while (it->busy ()) {
+    abstract_resource_rep* r= (abstract_resource_rep*) it->next ();
+    int size= r->cache_size ();
+    if (size == 0) continue;
+    if (resource_clock - r->res_used >= max_idle) r->cache_evict ();
+    else { a << r; sizes << size; total += size; }
+  }
+  for (int age= max_idle - 1; age > 0 && total > budget; age--)
+    for (int i=0; i<N(a) && total > budget; i++)
+      if (resource_clock - a[i]->res_used == age) {
+        a[i]->cache_evict ();
+        total -= sizes[i];
+      }
+  resource_clock++;
+}
+
+void
+resource_cache_clean () {
+  static time_t last_round= 0;
+  if (texmacs_time () - last_round <= RESOURCE_ROUND) return;
+  last_round= texmacs_time ();
+  bench_start ("evict resources");
+  evict_resources (RESOURCE_IDLE, RESOURCE_BUDGET);
+  bench_cumul ("evict resources");
+}
+
+/******************************************************************************
+* Statistics
+******************************************************************************/
+
+int
+resource_count (string type) {
+  int count= 0;
+  iterator<pointer> it= iterate (resources ());
+  while (it->busy ()) {
+    abstract_resource_rep* r= (abstract_resource_rep*) it->next ();
+    if (type == r->res_type) count++;
+  }
+  return count;
+}
+
+int
+resource_cache_size (string type) {
+  int size= 0;
+  iterator<pointer> it= iterate (resources ());
+  while (it->busy ()) {
+    abstract_resource_rep* r= (abstract_resource_rep*) it->next ();
+    if (type == r->res_type) size += r->cache_size ();
+  }
+  return size;
+}
+
+void
+resource_info () {
+  hashmap<string,int> count (0), size (0);
+  iterator<pointer> it= iterate (resources ());
+  while (it->busy ()) {
+    abstract_resource_rep* r= (abstract_resource_rep*) it->next ();
+    string type (r->res_type);
+    count (type) += 1;
+    size (type) += r->cache_size ();
+  }
+  array<string> types;
+  iterator<string> jt= iterate (count);
+  while (jt->busy ()) types << jt->next ();
+  merge_sort (types);
+  cout << "\n---------------- resource statistics --------------\n";
+  for (int i=0; i<N(types); i++)
+    cout << types[i] << ": " << count[types[i]] << " resident, "
+         << size[types[i]] << " bytes cached\n";
+}
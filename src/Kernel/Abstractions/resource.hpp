@@ -13,10 +13,31 @@
 #include "string.hpp"
 #include "hashmap.hpp"
 
-template<class T> struct rep {
+/******************************************************************************
+* Resources are never destroyed, since they are referred to by plain pointers
+* from boxes, fonts and other resources.  However, the data which they cache
+* (like the metrics and glyphs of characters) may be freed when the resource
+* has not been used for some time, and recomputed when needed again.
+* Each access through a resource pointer records the current value of
+* the resource clock, which is advanced at each round of eviction.
+******************************************************************************/
+
+extern int resource_clock;
+
+struct abstract_resource_rep {
+  const char* res_type;            // kind of resource
+  int         res_used;            // resource_clock at last use
+  abstract_resource_rep (const char* type);
+  virtual ~abstract_resource_rep ();
+  virtual int  cache_size ();      // bytes of cached data
+  virtual void cache_evict ();     // free the cached data
+};
+
+template<class T> struct rep: abstract_resource_rep {
   string res_name;
-  inline rep<T> (string res_name2):res_name (res_name2) {
-    T::instances (res_name)= static_cast<pointer>(this); }
+  inline rep<T> (string res_name2):
+    abstract_resource_rep (T::type_name ()), res_name (res_name2) {
+      T::instances (res_name)= static_cast<pointer>(this); }
   inline virtual ~rep<T> () {
     T::instances -> reset (res_name); }
 };
@@ -27,7 +48,7 @@ protected:
 public:
   R* rep;
   static hashmap<string,pointer> instances;
-  inline R* operator ->()  { return rep; }
+  inline R* operator ->()  { rep->res_used= resource_clock; return rep; }
 };
 
 #ifdef OS_WIN32
@@ -37,6 +58,7 @@ struct PTR : public resource_ptr<PTR##_rep> {       \
   inline PTR (PTR##_rep* rep2= NULL) { rep=rep2; }  \
   inline PTR (string s) { rep=(PTR##_rep*) instances [s]; } \
   inline ~PTR() {}                                  \
+  static inline const char* type_name () { return #PTR; } \
 }
 #else
 #define RESOURCE(PTR)                               \
@@ -46,6 +68,7 @@ struct PTR : public resource_ptr<PTR##_rep> {       \
   inline PTR (PTR##_rep* rep2= NULL) { rep=rep2; }  \
   inline PTR (string s) { rep=(PTR##_rep*) instances [s]; } \
   inline ~PTR() {}                                  \
+  static inline const char* type_name () { return #PTR; } \
 }
 #endif
 
@@ -70,4 +93,10 @@ tm_ostream& operator << (tm_ostream& out, const resource_ptr<T>& t) {
   return out << t->res_name;
 }
 
+void evict_resources (int max_idle, int budget);
+void resource_cache_clean ();
+int  resource_count (string type);
+int  resource_cache_size (string type);
+void resource_info ();
+
 #endif // RESOURCE_H
@@ -44,6 +44,25 @@ parse_string_rep::read (int n) {
   return s;
 }
 
+string
+parse_string_rep::read_until (string stops) {
+  // read the characters of the current string before the first one in stops
+  if (is_nil (l)) return "";
+  string s= l->item;
+  int i, j, start= p->item, n= N(s), k= N(stops);
+  for (i=start; i<n; i++) {
+    for (j=0; j<k; j++)
+      if (s[i] == stops[j]) break;
+    if (j<k) break;
+  }
+  if (i < n) p->item= i;
+  else {
+    l= l->next;
+    p= p->next;
+  }
+  return s (start, i);
+}
+
 void
 parse_string_rep::write (string s) {
   if (N(s) > 0) {
@@ -52,6 +71,14 @@ parse_string_rep::write (string s) {
   }
 }
 
+void
+parse_string_rep::append (string s) {
+  if (N(s) > 0) {
+    l << s;
+    p << 0;
+  }
+}
+
 char
 parse_string_rep::get_char (int n) {
   if (is_nil (l)) return 0;
@@ -102,6 +129,21 @@ test (parse_string s, string what) {
   return s->test (what);
 }
 
+static list<int>
+copy (list<int> p) {
+  if (is_nil (p)) return p;
+  return list<int> (p->item, copy (p->next));
+}
+
+parse_string
+copy (parse_string s) {
+  // the strings are shared, but the positions can be advanced separately
+  parse_string r;
+  r->l= s->l;
+  r->p= copy (s->p);
+  return r;
+}
+
 tm_ostream&
 operator << (tm_ostream& out, parse_string s) {
   list<string> l= s->l;
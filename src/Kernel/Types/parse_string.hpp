@@ -27,12 +27,15 @@ public:
 
   void advance (int n);
   string read (int n);
+  string read_until (string stops);
   void write (string s);
+  void append (string s);
   char get_char (int n);
   string get_string (int n);
   bool test (string s);
 
   friend class parse_string;
+  friend parse_string copy (parse_string s);
   friend tm_ostream& operator << (tm_ostream& out, parse_string s);
   friend bool test (parse_string s, string what);
 };
@@ -48,5 +51,6 @@ class parse_string {
 CONCRETE_CODE(parse_string);
 
 bool test (parse_string s, string what);
+parse_string copy (parse_string s);
 
 #endif // defined PARSE_STRING_H
@@ -11,6 +11,7 @@
 ******************************************************************************/
 
 #include "rectangles.hpp"
+#include "region.hpp"
 
 /******************************************************************************
 * Routines for rectangles
@@ -89,30 +90,6 @@ area (rectangle r) {
 #define min(x,y) ((x)<=(y)?(x):(y))
 #define max(x,y) ((x)<=(y)?(y):(x))
 
-void
-complement (rectangle r1, rectangle r2, rectangles& l) {
-  if (!intersect (r1, r2)) { r1 >> l; return; }
-  if (r1->x1 < r2->x1) rectangle (r1->x1, r1->y1, r2->x1, r1->y2) >> l;
-  if (r1->x2 > r2->x2) rectangle (r2->x2, r1->y1, r1->x2, r1->y2) >> l;
-  if (r1->y1 < r2->y1) rectangle (max (r1->x1, r2->x1), r1->y1,
-				  min (r1->x2, r2->x2), r2->y1) >> l;
-  if (r1->y2 > r2->y2) rectangle (max (r1->x1, r2->x1), r2->y2,
-				  min (r1->x2, r2->x2), r1->y2) >> l;
-}
-
-void
-complement (rectangles l1, rectangle r2, rectangles& l) {
-  for (; !is_nil (l1); l1= l1->next)
-    complement (l1->item, r2, l);
-}
-
-void
-intersection (rectangle r1, rectangle r2, rectangles& l) {
-  if (!intersect (r1, r2)) return;
-  rectangle (max (r1->x1, r2->x1), max (r1->y1, r2->y1),
-	     min (r1->x2, r2->x2), min (r1->y2, r2->y2)) >> l;
-}
-
 rectangle
 least_upper_bound (rectangle r1, rectangle r2) {
   return rectangle (min (r1->x1, r2->x1), min (r1->y1, r2->y1),
@@ -151,52 +128,25 @@ thicken (rectangle r, SI width, SI height) {
 * Exported routines for rectangles
 ******************************************************************************/
 
+// The set operations on lists of rectangles are performed on banded
+// regions, which avoids the quadratic behaviour of list manipulations.
+// The resulting rectangles are disjoint and sorted by bands.
+
 rectangles
 operator - (rectangles l1, rectangles l2) {
-  rectangles a=l1;
-  for (; !is_nil (l2); l2= l2->next) {
-    rectangles b;
-    complement (a, l2->item, b);
-    a=b;
-  }
-  return a;
+  if (is_nil (l1) || is_nil (l2)) return l1;
+  return as_rectangles (region (l1) - region (l2));
 }
 
 rectangles
 operator & (rectangles l1, rectangles l2) {
-  rectangles l, lc1, lc2;
-  for (lc1= l1; !is_nil (lc1); lc1= lc1->next)
-    for (lc2= l2; !is_nil (lc2); lc2= lc2->next)
-      intersection (lc1->item, lc2->item, l);
-  return l;
-}
-
-bool
-adjacent (rectangle r1, rectangle r2) {
-  return
-    (((r1->x2==r2->x1) || (r1->x1==r2->x2)) &&
-     ((r1->y1==r2->y1) && (r1->y2==r2->y2))) ||
-    (((r1->y2==r2->y1) || (r1->y1==r2->y2)) &&
-     ((r1->x1==r2->x1) && (r1->x2==r2->x2)));
-}
-
-rectangles
-disjoint_union (rectangles l, rectangle r) {
-  if (is_nil (l)) return r;
-  if (adjacent (l->item, r))
-    return disjoint_union (l->next,
-			   least_upper_bound (rectangles (l->item, r)));
-  return rectangles (l->item, disjoint_union (l->next, r));
+  if (is_nil (l1) || is_nil (l2)) return rectangles ();
+  return as_rectangles (region (l1) & region (l2));
 }
 
 rectangles
 operator | (rectangles l1, rectangles l2) {
-  rectangles l (l1-l2);
-  while (!is_nil (l2)) {
-    l = disjoint_union (l, l2->item);
-    l2= l2->next;
-  }
-  return l;
+  return as_rectangles (region (l1) | region (l2));
 }
 
 rectangles
@@ -242,16 +192,10 @@ correct (rectangles l) {
   return rectangles (l->item, correct (l->next));
 }
 
-rectangles
-simplify_bis (rectangles l) {
-  if (is_nil (l) || is_atom (l)) return l;
-  return simplify_bis (l->next) | rectangles (l->item);
-}
-
 rectangles
 simplify (rectangles l) {
-  if (N(l) > 25) return copy (l);
-  else return simplify_bis (l);
+  if (is_nil (l) || is_atom (l)) return l;
+  return as_rectangles (region (l));
 }
 
 rectangle
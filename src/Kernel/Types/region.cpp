@@ -0,0 +1,245 @@
+
+/******************************************************************************
+* MODULE     : region.cpp
+* DESCRIPTION: Regions of the plane, represented by y-x banded rectangles.
+*              Used for tracking changed and invalid parts of the screen.
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "region.hpp"
+
+#define REGION_UNION     0
+#define REGION_INTERSECT 1
+#define REGION_SUBTRACT  2
+
+/******************************************************************************
+* Constructors
+******************************************************************************/
+
+region::region (): rep (tm_new<region_rep> ()) {}
+
+region::region (array<SI> a): rep (tm_new<region_rep> (a)) {}
+
+region::region (SI x1, SI y1, SI x2, SI y2): rep (tm_new<region_rep> ()) {
+  if (x1 < x2 && y1 < y2) rep->a << x1 << y1 << x2 << y2;
+}
+
+region::region (rectangle r): rep (tm_new<region_rep> ()) {
+  if (r->x1 < r->x2 && r->y1 < r->y2)
+    rep->a << r->x1 << r->y1 << r->x2 << r->y2;
+}
+
+static region
+make_region (array<rectangle>& v, int start, int end) {
+  if (end - start == 0) return region ();
+  if (end - start == 1) return region (v[start]);
+  int middle= (start + end) >> 1;
+  return make_region (v, start, middle) | make_region (v, middle, end);
+}
+
+region::region (rectangles l): rep (tm_new<region_rep> ()) {
+  array<rectangle> v;
+  for (; !is_nil (l); l= l->next) v << l->item;
+  rep->a= make_region (v, 0, N(v))->a;
+}
+
+/******************************************************************************
+* Band operations
+******************************************************************************/
+
+static inline bool
+keep (int op, bool in1, bool in2) {
+  switch (op) {
+  case REGION_UNION: return in1 || in2;
+  case REGION_INTERSECT: return in1 && in2;
+  default: return in1 && !in2;
+  }
+}
+
+static inline int
+band_end (array<SI>& a, int i) {
+  int n= N(a);
+  SI  y= a[i+1];
+  while (i < n && a[i+1] == y) i += 4;
+  return i;
+}
+
+static void
+merge_spans (array<SI>& xs, array<SI>& a, int i, int ie,
+             array<SI>& b, int j, int je, int op)
+{
+  // Sweep over the horizontal spans a[i..ie) and b[j..je) of two bands
+  bool in1= false, in2= false, in= false;
+  SI   start= 0;
+  while (i < ie || j < je) {
+    SI x= MAX_SI;
+    if (i < ie) x= (in1? a[i+2]: a[i]);
+    if (j < je) x= min (x, in2? b[j+2]: b[j]);
+    while (i < ie && (in1? a[i+2]: a[i]) == x) {
+      if (in1) i += 4;
+      in1= !in1;
+    }
+    while (j < je && (in2? b[j+2]: b[j]) == x) {
+      if (in2) j += 4;
+      in2= !in2;
+    }
+    bool now= keep (op, in1, in2);
+    if (now && !in) start= x;
+    else if (!now && in) xs << start << x;
+    in= now;
+  }
+}
+
+static void
+append_band (array<SI>& r, int& last, SI y1, SI y2, array<SI>& xs) {
+  // Append a band, coalescing it with the previous one when possible
+  int i, n= N(r), k= N(xs) >> 1;
+  if (last >= 0 && r[last+3] == y1 && n - last == (k << 2)) {
+    for (i=0; i<k; i++)
+      if (r[last + (i<<2)] != xs[i<<1] ||
+          r[last + (i<<2) + 2] != xs[(i<<1) + 1]) break;
+    if (i == k) {
+      for (i=last; i<n; i+=4) r[i+3]= y2;
+      return;
+    }
+  }
+  last= n;
+  for (i=0; i<k; i++)
+    r << xs[i<<1] << y1 << xs[(i<<1) + 1] << y2;
+}
+
+static region
+combine (region r1, region r2, int op) {
+  array<SI> a= r1->a, b= r2->a, r, xs;
+  int na= N(a), nb= N(b), i= 0, j= 0, last= -1;
+  SI  y= -MAX_SI;
+  while (i < na || j < nb) {
+    if (i >= na && op != REGION_UNION) break;
+    if (j >= nb && op == REGION_INTERSECT) break;
+    int ie = (i < na? band_end (a, i): i);
+    int je = (j < nb? band_end (b, j): j);
+    SI  ay1= (i < na? max (a[i+1], y): MAX_SI);
+    SI  ay2= (i < na? a[i+3]: MAX_SI);
+    SI  by1= (j < nb? max (b[j+1], y): MAX_SI);
+    SI  by2= (j < nb? b[j+3]: MAX_SI);
+    SI  top= min (ay1, by1);
+    bool in1= (ay1 == top), in2= (by1 == top);
+    SI  bot= min (in1? ay2: ay1, in2? by2: by1);
+    if (op == REGION_UNION || (in1 && (in2 || op == REGION_SUBTRACT))) {
+      xs= array<SI> ();
+      merge_spans (xs, a, in1? i: ie, ie, b, in2? j: je, je, op);
+      if (N(xs) > 0) append_band (r, last, top, bot, xs);
+    }
+    y= bot;
+    if (in1 && ay2 == bot) i= ie;
+    if (in2 && by2 == bot) j= je;
+  }
+  return region (r);
+}
+
+/******************************************************************************
+* Exported routines
+******************************************************************************/
+
+tm_ostream&
+operator << (tm_ostream& out, region r) {
+  return out << "region " << as_rectangles (r);
+}
+
+int
+N (region r) {
+  return N(r->a) >> 2;
+}
+
+bool
+is_empty (region r) {
+  return N(r->a) == 0;
+}
+
+bool
+operator == (region r1, region r2) {
+  return r1->a == r2->a;
+}
+
+bool
+operator != (region r1, region r2) {
+  return r1->a != r2->a;
+}
+
+bool
+operator <= (region r1, region r2) {
+  return is_empty (r1 - r2);
+}
+
+bool
+intersect (region r1, region r2) {
+  return !is_empty (r1 & r2);
+}
+
+region
+operator | (region r1, region r2) {
+  if (is_empty (r1)) return r2;
+  if (is_empty (r2)) return r1;
+  return combine (r1, r2, REGION_UNION);
+}
+
+region
+operator & (region r1, region r2) {
+  if (is_empty (r1) || is_empty (r2)) return region ();
+  return combine (r1, r2, REGION_INTERSECT);
+}
+
+region
+operator - (region r1, region r2) {
+  if (is_empty (r1) || is_empty (r2)) return r1;
+  return combine (r1, r2, REGION_SUBTRACT);
+}
+
+region
+translate (region r, SI x, SI y) {
+  int i, n= N(r->a);
+  array<SI> a (n);
+  for (i=0; i<n; i+=4) {
+    a[i  ]= r->a[i  ] + x;
+    a[i+1]= r->a[i+1] + y;
+    a[i+2]= r->a[i+2] + x;
+    a[i+3]= r->a[i+3] + y;
+  }
+  return region (a);
+}
+
+rectangle
+least_upper_bound (region r) {
+  ASSERT (!is_empty (r), "empty region");
+  int i, n= N(r->a);
+  SI x1= MAX_SI, x2= -MAX_SI;
+  for (i=0; i<n; i+=4) {
+    x1= min (x1, r->a[i]);
+    x2= max (x2, r->a[i+2]);
+  }
+  return rectangle (x1, r->a[1], x2, r->a[n-1]);
+}
+
+double
+area (region r) {
+  int i, n= N(r->a);
+  double sum= 0.0;
+  for (i=0; i<n; i+=4) {
+    double w= r->a[i+2] - r->a[i];
+    double h= r->a[i+3] - r->a[i+1];
+    sum += w*h;
+  }
+  return sum;
+}
+
+rectangles
+as_rectangles (region r) {
+  rectangles l;
+  for (int i= N(r->a) - 4; i >= 0; i -= 4)
+    l= rectangles (rectangle (r->a[i], r->a[i+1], r->a[i+2], r->a[i+3]), l);
+  return l;
+}
@@ -0,0 +1,61 @@
+
+/******************************************************************************
+* MODULE     : region.hpp
+* DESCRIPTION: Regions of the plane, represented by y-x banded rectangles.
+*              Used for tracking changed and invalid parts of the screen.
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef REGION_H
+#define REGION_H
+#include "rectangles.hpp"
+#include "array.hpp"
+
+/******************************************************************************
+* A region is stored as a flat array of rectangles (x1, y1, x2, y2),
+* sorted by bands of increasing y and by increasing x inside each band.
+* Rectangles in the same band have the same vertical extents and are
+* neither overlapping nor adjacent; vertically adjacent bands with the
+* same horizontal spans are coalesced.  This representation is canonical,
+* so that two regions are equal if and only if their arrays are equal.
+******************************************************************************/
+
+class region_rep: concrete_struct {
+public:
+  array<SI> a;
+
+  inline region_rep () {}
+  inline region_rep (array<SI> a2): a (a2) {}
+  friend class region;
+};
+
+class region {
+  CONCRETE(region);
+  region ();
+  region (array<SI> a);
+  region (SI x1, SI y1, SI x2, SI y2);
+  region (rectangle r);
+  region (rectangles l);
+};
+CONCRETE_CODE(region);
+
+tm_ostream& operator << (tm_ostream& out, region r);
+int  N (region r);
+bool is_empty (region r);
+bool operator == (region r1, region r2);
+bool operator != (region r1, region r2);
+bool operator <= (region r1, region r2);
+bool intersect (region r1, region r2);
+region operator | (region r1, region r2);
+region operator & (region r1, region r2);
+region operator - (region r1, region r2);
+region translate (region r, SI x, SI y);
+rectangle least_upper_bound (region r);
+double area (region r);
+rectangles as_rectangles (region r);
+
+#endif // defined REGION_H
@@ -20,8 +20,11 @@
 tree type_helper<tree>::init (UNINIT);
 int type_helper<tree>::id  = new_type_identifier ();
 
+static void unfreeze_rep (tree_rep* rep);
+
 void
 destroy_tree_rep (tree_rep* rep) {
+  if (rep->frozen) unfreeze_rep (rep);
   if (((int) rep->op) == 0) tm_delete (static_cast<atomic_rep*> (rep));
   else if (((int) rep->op) > 0) tm_delete (static_cast<compound_rep*>(rep));
   else tm_delete (static_cast<generic_rep*>(rep));
@@ -119,6 +122,7 @@ tree::operator () (int begin, int end) {
 bool
 operator == (tree t, tree u) {
   if (strong_equal (t, u)) return true;
+  if (t.rep->frozen && u.rep->frozen) return false;
   return (L(t)==L(u)) &&
     (L(t)==STRING? (t->label==u->label): (A(t)==A(u)));
 }
@@ -126,6 +130,7 @@ operator == (tree t, tree u) {
 bool
 operator != (tree t, tree u) {
   if (strong_equal (t, u)) return false;
+  if (t.rep->frozen && u.rep->frozen) return true;
   return (L(t)!=L(u)) ||
     (L(t)==STRING? (t->label!=u->label): (A(t)!=A(u)));
 }
@@ -141,17 +146,110 @@ copy (tree t) {
   }
 }
 
+/******************************************************************************
+* Hash-consing of frozen trees
+*******************************************************************************
+* Frozen trees are never modified.  Structurally equal frozen trees
+* are represented by the same tree_rep, so that they can be compared in
+* constant time.  Their hash codes are computed once and for all.
+* The table of frozen trees only holds weak references: a frozen tree is
+* removed from it when its last reference disappears.
+******************************************************************************/
+
+static tree_rep** frozen_table= NULL;  // open addressing, linear probing
+static int frozen_size = 0;            // size of the table, a power of two
+static int frozen_count= 0;            // number of frozen trees
+
+static bool
+frozen_same (tree_rep* r, tree t) {
+  // t is a candidate for freezing whose children are frozen
+  if (r->op != L(t)) return false;
+  if (r->op == STRING)
+    return static_cast<atomic_rep*> (r)->label == t->label;
+  array<tree>& a= static_cast<compound_rep*> (r)->a;
+  int i, n= N(a);
+  if (n != N(t)) return false;
+  for (i=0; i<n; i++)
+    if (!strong_equal (a[i], t[i])) return false;
+  return true;
+}
+
+static int
+frozen_slot (tree t, int h) {
+  // slot of the frozen tree equal to t, or the empty slot for it
+  int i, mask= frozen_size - 1;
+  for (i= h & mask; frozen_table[i] != NULL; i= (i+1) & mask)
+    if (frozen_table[i]->h == h && frozen_same (frozen_table[i], t))
+      break;
+  return i;
+}
+
+static void
+frozen_resize (int size) {
+  tree_rep** old= frozen_table;
+  int i, old_size= frozen_size, mask= size - 1;
+  frozen_table= tm_new_array<tree_rep*> (size);
+  frozen_size = size;
+  for (i=0; i<size; i++) frozen_table[i]= NULL;
+  for (i=0; i<old_size; i++)
+    if (old[i] != NULL) {
+      int j= old[i]->h & mask;
+      while (frozen_table[j] != NULL) j= (j+1) & mask;
+      frozen_table[j]= old[i];
+    }
+  if (old != NULL) tm_delete_array (old);
+}
+
+static void
+unfreeze_rep (tree_rep* rep) {
+  int i, mask= frozen_size - 1;
+  for (i= rep->h & mask; frozen_table[i] != rep; i= (i+1) & mask) {}
+  frozen_table[i]= NULL;
+  frozen_count--;
+  // move back the entries of the cluster which follow the removed one
+  for (int j= (i+1) & mask; frozen_table[j] != NULL; j= (j+1) & mask) {
+    int k= frozen_table[j]->h & mask;
+    if (((j - k) & mask) >= ((j - i) & mask)) {
+      frozen_table[i]= frozen_table[j];
+      frozen_table[j]= NULL;
+      i= j;
+    }
+  }
+}
+
 tree
 freeze (tree t) {
-  if (is_atomic (t)) return copy (t->label);
-  if (is_func (t, UNFREEZE, 1)) return t[0];
-  else {
+  // unfreeze tags are removed; subtrees with generic trees are not frozen
+  if (t.rep->frozen || is_generic (t)) return t;
+  if (is_func (t, UNFREEZE, 1)) return freeze (t[0]);
+  if (is_compound (t)) {
     int i, n= N(t);
     tree r (t, n);
-    for (i=0; i<n; i++)
+    for (i=0; i<n; i++) {
       r[i]= freeze (t[i]);
-    return r;
+      if (!r[i].rep->frozen) {
+        for (i++; i<n; i++) r[i]= freeze (t[i]);
+        return r;
+      }
+    }
+    t= r;
   }
+  if (2 * (frozen_count + 1) > frozen_size)
+    frozen_resize (max (2 * frozen_size, 256));
+  int h= hash (t);
+  int i= frozen_slot (t, h);
+  if (frozen_table[i] != NULL) return tree (frozen_table[i]);
+  if (is_atomic (t)) t= tree (copy (t->label));
+  t.rep->h= h;
+  t.rep->frozen= true;
+  frozen_table[i]= t.rep;
+  frozen_count++;
+  return t;
+}
+
+int
+number_of_frozen_trees () {
+  return frozen_count;
 }
 
 tree
@@ -219,6 +317,7 @@ hash (array<tree> a) {
 
 int
 hash (tree t) {
+  if (inside (t)->frozen) return inside (t)->h;
   if (is_atomic (t)) return hash (t->label);
   else return ((int) L(t)) ^ hash (A(t));
 }
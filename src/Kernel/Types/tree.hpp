@@ -26,6 +26,7 @@ class compound_rep;
 class generic_rep;
 class blackbox;
 tree copy (tree t);
+tree freeze (tree t);
 
 class tree {
   tree_rep* rep; // can be atomic or compound or generic
@@ -73,6 +74,7 @@ public:
   friend inline bool operator != (tree t, const char* s);
   friend inline tree_rep* inside (tree t);
   friend inline bool strong_equal (tree t, tree u);
+  friend inline bool is_frozen (tree t);
   friend inline bool is_func (tree t, tree_label l);
   friend inline bool is_func (tree t, tree_label l, int i);
 
@@ -103,7 +105,9 @@ class tree_rep: concrete_struct {
 public:
   tree_label op;
   observer obs;
-  inline tree_rep (tree_label op2): op (op2) {}
+  int  h;       // cached hash code of frozen trees
+  bool frozen;  // shared, immutable and unique up to structural equality
+  inline tree_rep (tree_label op2): op (op2), h (0), frozen (false) {}
   friend class tree;
 };
 
@@ -222,6 +226,8 @@ inline tree_rep* inside (tree t) {
   return t.rep; }
 inline bool strong_equal (tree t, tree u) {
   return t.rep == u.rep; }
+inline bool is_frozen (tree t) {
+  return t.rep->frozen; }
 
 inline bool is_func (tree t, tree_label l) {
   return (t.rep->op==l) && (N(t)!=0); }
@@ -373,6 +379,7 @@ inline tree verbatim (tree t1) {
 
 tree   correct (tree t);
 int    hash (tree t);
+int    number_of_frozen_trees ();
 
 template<class T>
 array<T>::operator tree () {
@@ -12,6 +12,7 @@
 #include "bibtex_functions.hpp"
 #include "converter.hpp"
 #include "vars.hpp"
+#include "file.hpp"
 
 /******************************************************************************
 * Helper functions
@@ -1110,3 +1111,151 @@ bib_entries (tree t, tree bib_t) {
   return res;
 }
 
+
+/******************************************************************************
+* Indexed BibTeX files
+*******************************************************************************
+* Large bibliographies are not parsed as a whole each time a bibliography
+* is generated.  Instead, the contents of each file are kept together with
+* the @string definitions and the positions of the entries by key, as long
+* as the file does not change.  Only the cited entries and the entries they
+* refer to through crossref are parsed, and the parsed entries are kept.
+******************************************************************************/
+
+struct bib_file_index {
+  int    date, size;
+  string s;                          // the contents of the file
+  string strings;                    // the @string definitions
+  hashmap<string,int>  start, end;   // the positions of the entries
+  hashmap<string,tree> parsed;       // the entries parsed so far
+  hashset<string>      tried;        // the keys which have been parsed
+  bib_file_index (): start (-1), end (-1) {}
+};
+
+static hashmap<string,bib_file_index*> bib_indices (NULL);
+
+static bool
+bib_is_blank (char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static int
+bib_skip_entry (string s, int pos, char cend) {
+  // position of the delimiter which closes the entry opened before pos,
+  // with the same brace matching as the parser
+  int depth= 0, n= N(s);
+  bool quoted= false;
+  for (; pos<n; pos++) {
+    char c= s[pos];
+    if (c == '{') depth++;
+    else if (c == '}') {
+      if (depth == 0 && cend == '}') return pos;
+      depth--;
+    }
+    else if (cend == ')' && depth == 0) {
+      if (c == '\"') quoted= !quoted;
+      else if (c == ')' && !quoted) return pos;
+    }
+  }
+  return n-1;
+}
+
+static void
+bib_index_entries (bib_file_index* idx, url u) {
+  string s= idx->s;
+  int i= 0, n= N(s);
+  while (i < n) {
+    if (s[i] != '@') { i++; continue; }
+    int start= i++;
+    while (i < n && s[i] != '{' && s[i] != '(' && s[i] != '=' &&
+           !bib_is_blank (s[i])) i++;
+    string type= locase_all (s (start+1, i));
+    while (i < n && bib_is_blank (s[i])) i++;
+    if (i >= n || (s[i] != '{' && s[i] != '(')) continue;
+    char cend= (s[i] == '{'? '}': ')');
+    int j= i+1;
+    while (j < n && bib_is_blank (s[j])) j++;
+    int k= j;
+    while (k < n && s[k] != ',' && s[k] != cend && !bib_is_blank (s[k])) k++;
+    string key= s (j, k);
+    int end= bib_skip_entry (s, i+1, cend) + 1;
+    if (type == "string") idx->strings << s (start, end) << "\n";
+    else if (type != "comment" && type != "preamble" && key != "") {
+      if (idx->start->contains (key))
+        bibtex_warning << "Duplicate entry '" << key << "' in " << u << "\n";
+      else {
+        idx->start (key)= start;
+        idx->end   (key)= end;
+      }
+    }
+    i= end;
+  }
+}
+
+static bib_file_index*
+bib_get_index (url u) {
+  // the index of u, which is rebuilt whenever u has been modified
+  string name= as_string (u);
+  int date= last_modified (u, false), size= file_size (u);
+  bib_file_index* idx= bib_indices [name];
+  if (idx != NULL && idx->date == date && idx->size == size) return idx;
+  string s;
+  if (load_string (u, s, false)) return NULL;
+  if (idx != NULL) tm_delete (idx);
+  idx= tm_new<bib_file_index> ();
+  idx->date= date;
+  idx->size= size;
+  idx->s   = s;
+  bib_index_entries (idx, u);
+  bib_indices (name)= idx;
+  return idx;
+}
+
+static void
+bib_parse_entries (bib_file_index* idx, array<string> keys) {
+  // parse the entries for keys which have not been parsed yet, at once
+  string s= idx->strings;
+  bool todo= false;
+  for (int i=0; i<N(keys); i++)
+    if (!idx->tried->contains (keys[i]) && idx->start->contains (keys[i])) {
+      idx->tried->insert (keys[i]);
+      s << idx->s (idx->start[keys[i]], idx->end[keys[i]]) << "\n";
+      todo= true;
+    }
+  if (!todo) return;
+  tree t= parse_bib (s);
+  for (int i=0; i<N(t); i++)
+    if (bib_is_entry (t[i]) && !idx->parsed->contains (t[i][1]->label))
+      idx->parsed (t[i][1]->label)= t[i];
+}
+
+tree
+bib_entries (url u, tree bib_t) {
+  // same as bib_entries (parse_bib (s), bib_t) for the contents s of u
+  tree entries (DOCUMENT);
+  bib_file_index* idx= bib_get_index (u);
+  if (idx == NULL) {
+    std_error << "Could not load BibTeX file " << u << "\n";
+    return entries;
+  }
+  hashset<string> r;
+  tree bt= copy (bib_t);
+  int i= 0, n;
+  while (i < (n= arity (bt))) {
+    array<string> keys;
+    for (int j=i; j<n; j++) keys << as_string (bt[j]);
+    bib_parse_entries (idx, keys);
+    for (; i<n; i++) {
+      string b= as_string (bt[i]);
+      if (!idx->parsed->contains (b))
+        bibtex_warning << "Missing reference '" << b << "'\n";
+      else if (!r->contains (b)) {
+        r->insert (b);
+        entries << idx->parsed[b];
+        tree cr= bib_assoc (idx->parsed[b], string ("crossref"));
+        if (cr != "") bt << as_string (cr);
+      }
+    }
+  }
+  return entries;
+}
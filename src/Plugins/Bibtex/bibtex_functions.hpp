@@ -36,5 +36,6 @@ scheme_tree bib_upcase_first (scheme_tree st);
 hashmap<string,string> bib_strings_dict (tree t);
 tree   bib_subst_vars (tree t, hashmap<string,string> dict);
 tree   bib_entries (tree t, tree bib_t);
+tree   bib_entries (url u, tree bib_t);
 scheme_tree bib_abbreviate (scheme_tree st, scheme_tree s1, scheme_tree s2);
 
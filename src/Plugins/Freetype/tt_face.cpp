@@ -135,6 +135,16 @@ tt_font_metric_rep::kerning (int left, int right) {
   return tt_si (k.x);
 }
 
+int
+tt_font_metric_rep::cache_size () {
+  return metric_table_size (fnm);
+}
+
+void
+tt_font_metric_rep::cache_evict () {
+  clear_metric_table (fnm);
+}
+
 font_metric
 tt_font_metric (string family, int size, int hdpi, int vdpi) {
   string name= family * as_string (size) * "@" * as_string (hdpi);
@@ -202,6 +212,16 @@ tt_font_glyphs_rep::get (int i) {
   return fng(i);
 }
 
+int
+tt_font_glyphs_rep::cache_size () {
+  return glyph_table_size (fng);
+}
+
+void
+tt_font_glyphs_rep::cache_evict () {
+  clear_glyph_table (fng);
+}
+
 font_glyphs
 tt_font_glyphs (string family, int size, int hdpi, int vdpi) {
   string name=
@@ -36,6 +36,8 @@ struct tt_font_metric_rep: font_metric_rep {
   bool exists (int char_code);
   metric& get (int char_code);
   SI kerning (int left_code, int right_code);
+  int  cache_size ();
+  void cache_evict ();
 };
 
 struct tt_font_glyphs_rep: font_glyphs_rep {
@@ -47,6 +49,8 @@ struct tt_font_glyphs_rep: font_glyphs_rep {
   //bool* done;
   tt_font_glyphs_rep (string name, string family, int size, int hdpi, int vdpi);
   glyph& get (int char_code);
+  int  cache_size ();
+  void cache_evict ();
 };
 
 tt_face load_tt_face (string name);
@@ -284,10 +284,9 @@ gs_PDF_EmbedAllFonts (url image, url pdf) {
   return true;
 }
 
-bool
-gs_to_png (url image, url png, int w, int h) { //Achtung! w,h in pixels
+string
+gs_to_png_cmd (url image, url png, int w, int h) { //Achtung! w,h in pixels
   string cmd;
-  if (DEBUG_CONVERT) debug_convert << "gs_to_png using gs"<<LF;
   cmd= gs_prefix ();
   cmd << "-dQUIET -dNOPAUSE -dBATCH -dSAFER ";
   cmd << "-sDEVICE=png16m -dGraphicsAlphaBits=4 -dTextAlphaBits=4 ";
@@ -322,6 +321,13 @@ gs_to_png (url image, url png, int w, int h) { //Achtung! w,h in pixels
     cmd << "-c \" "<< as_string (-bx1) << " "<< as_string (-by1) <<" translate gsave \"  -f "
             << sys_concretize (image) << " -c \" grestore \"";    
   }
+  return cmd;
+}
+
+bool
+gs_to_png (url image, url png, int w, int h) {
+  if (DEBUG_CONVERT) debug_convert << "gs_to_png using gs"<<LF;
+  string cmd= gs_to_png_cmd (image, png, w, h);
   string ans= eval_system (cmd);
   if (DEBUG_CONVERT) debug_convert << cmd <<LF
     <<"answer :"<<ans <<LF;
@@ -371,10 +377,9 @@ gs_to_eps (url image, url eps) { //this should be used mostly for pdf->eps conve
 
 // This conversion is appropriate for eps images
 // (originally implemented in pdf_image_rep::flush)
-void  
-gs_to_pdf (url image, url pdf, int w, int h) {
+string
+gs_to_pdf_cmd (url image, url pdf, int w, int h) {
   string cmd;
-  if (DEBUG_CONVERT) debug_convert << "(eps) gs_to_pdf"<<LF;
   string s= suffix (image);    
   // take care of properly handling the bounding box
   // the resulting pdf image will always start at 0,0.
@@ -395,6 +400,13 @@ gs_to_pdf (url image, url pdf, int w, int h) {
     << as_string(scale_x) << " " << as_string(scale_y) << " scale \"";
   cmd << " -f " << sys_concretize (image);
   cmd << " -c \" grestore \"  ";
+  return cmd;
+}
+
+void
+gs_to_pdf (url image, url pdf, int w, int h) {
+  if (DEBUG_CONVERT) debug_convert << "(eps) gs_to_pdf"<<LF;
+  string cmd= gs_to_pdf_cmd (image, pdf, w, h);
   // debug_convert << cmd << LF;
   system(cmd);
   if (DEBUG_CONVERT)
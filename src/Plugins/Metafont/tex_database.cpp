@@ -0,0 +1,348 @@
+
+/******************************************************************************
+* MODULE     : tex_database.cpp
+* DESCRIPTION: native lookup of files in the ls-R databases of TeX
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* Launching kpsewhich for every font file is slow.  Instead, we read the
+* texmf.cnf configuration files and the ls-R databases of the TeX trees
+* ourselves, as kpathsea does, and answer the lookups of font files in
+* memory.  Only the subset of the kpathsea conventions needed for finding
+* fonts is implemented: variables, braces, path elements with '!!' and '//'
+* and environment variables overriding the configuration.  Files which are
+* not found in this way are left to kpsewhich.  The databases are read
+* again when one of them has been modified.
+******************************************************************************/
+
+#include "tex_database.hpp"
+#include "file.hpp"
+#include "sys_utils.hpp"
+#include "analyze.hpp"
+#include "hashmap.hpp"
+#include "tm_timer.hpp"
+
+static bool                          tex_db_loaded= false;
+static hashmap<string,string>        tex_cnf ("");
+static hashmap<string,array<string> > tex_db;
+static hashmap<string,array<string> > tex_paths;
+static array<url>                    tex_db_sources;
+static array<int>                    tex_db_dates;
+
+// compiled-in search path of kpathsea, with the usual system locations
+#define TEX_DEFAULT_CNF_PATH \
+  "{$SELFAUTOLOC,$SELFAUTOLOC/share/texmf-local/web2c," \
+  "$SELFAUTOLOC/share/texmf-dist/web2c,$SELFAUTOLOC/share/texmf/web2c," \
+  "$SELFAUTOLOC/texmf-local/web2c,$SELFAUTOLOC/texmf-dist/web2c," \
+  "$SELFAUTOLOC/texmf/web2c,$SELFAUTODIR," \
+  "$SELFAUTODIR/share/texmf-local/web2c," \
+  "$SELFAUTODIR/share/texmf-dist/web2c,$SELFAUTODIR/share/texmf/web2c," \
+  "$SELFAUTODIR/texmf-local/web2c,$SELFAUTODIR/texmf-dist/web2c," \
+  "$SELFAUTODIR/texmf/web2c,$SELFAUTOGRANDPARENT/texmf-local/web2c," \
+  "$SELFAUTOPARENT,$SELFAUTOPARENT/share/texmf-local/web2c," \
+  "$SELFAUTOPARENT/share/texmf-dist/web2c," \
+  "$SELFAUTOPARENT/share/texmf/web2c,$SELFAUTOPARENT/texmf-local/web2c," \
+  "$SELFAUTOPARENT/texmf-dist/web2c,$SELFAUTOPARENT/texmf/web2c}:" \
+  "/etc/texmf/web2c:/usr/share/texmf/web2c:" \
+  "/usr/share/texlive/texmf-dist/web2c"
+
+/******************************************************************************
+* Variables and paths
+******************************************************************************/
+
+static string
+tex_variable (string var) {
+  // environment variables take precedence over the configuration files
+  string val= get_env (var);
+  if (val != "") return val;
+  return tex_cnf [var];
+}
+
+static string
+expand_variables (string s, int depth= 0) {
+  if (depth > 32) return s;
+  string r;
+  int i= 0, n= N(s);
+  while (i < n) {
+    if (s[i] != '$') { r << s[i++]; continue; }
+    string var;
+    if (i+1 < n && s[i+1] == '{') {
+      int end= search_forwards ("}", i+2, s);
+      if (end < 0) { r << s (i, n); break; }
+      var= s (i+2, end);
+      i= end + 1;
+    }
+    else {
+      int j= i+1;
+      while (j < n && (is_alpha (s[j]) || is_digit (s[j]) || s[j] == '_')) j++;
+      var= s (i+1, j);
+      i= j;
+    }
+    r << expand_variables (tex_variable (var), depth + 1);
+  }
+  return r;
+}
+
+static array<string>
+split_path (string s) {
+  // split at the separators which are not inside braces
+  array<string> r;
+  int i, start= 0, depth= 0, n= N(s);
+  for (i=0; i<=n; i++)
+    if (i == n || ((s[i] == ':' || s[i] == ';') && depth == 0)) {
+      if (i > start) r << s (start, i);
+      start= i+1;
+    }
+    else if (s[i] == '{') depth++;
+    else if (s[i] == '}' && depth > 0) depth--;
+  return r;
+}
+
+static void
+expand_braces (string s, array<string>& r) {
+  // a{b,c}d -> abd, acd
+  int i, start= -1, depth= 0, n= N(s);
+  for (i=0; i<n; i++)
+    if (s[i] == '{') {
+      if (depth == 0) start= i;
+      depth++;
+    }
+    else if (s[i] == '}' && depth > 0) {
+      depth--;
+      if (depth != 0) continue;
+      string pre= s (0, start), post= s (i+1, n);
+      int j, k= start+1, d= 0;
+      for (j=start+1; j<=i; j++)
+        if (j == i || (s[j] == ',' && d == 0)) {
+          expand_braces (pre * s (k, j) * post, r);
+          k= j+1;
+        }
+        else if (s[j] == '{') d++;
+        else if (s[j] == '}') d--;
+      return;
+    }
+  r << s;
+}
+
+static array<string>
+path_elements (string val) {
+  // the directories of a search path, without '!!' and trailing slashes
+  array<string> r;
+  array<string> a= split_path (expand_variables (val));
+  for (int i=0; i<N(a); i++) {
+    array<string> b;
+    expand_braces (a[i], b);
+    for (int j=0; j<N(b); j++) {
+      array<string> c= split_path (b[j]);
+      for (int k=0; k<N(c); k++) {
+        string d= c[k];
+        if (starts (d, "!!")) d= d (2, N(d));
+        if (starts (d, "~")) d= get_env ("HOME") * d (1, N(d));
+        while (N(d) > 1 && d[N(d)-1] == '/') d= d (0, N(d)-1);
+        if (d != "") r << d;
+      }
+    }
+  }
+  return r;
+}
+
+static string
+parent_dir (string dir) {
+  int i= search_backwards ("/", dir);
+  if (i <= 0) return "/";
+  return dir (0, i);
+}
+
+/******************************************************************************
+* Reading the configuration files
+******************************************************************************/
+
+static void
+read_texmf_cnf (string s) {
+  // the first definition of a variable takes precedence;
+  // definitions for specific programs (VAR.prog) are ignored
+  array<string> lines= tokenize (s, "\n");
+  for (int i=0; i<N(lines); i++) {
+    string l= lines[i];
+    while (N(l) > 0 && l[N(l)-1] == '\\' && i+1 < N(lines))
+      l= l (0, N(l)-1) * lines[++i];
+    l= trim_spaces (l);
+    if (N(l) == 0 || l[0] == '#') continue;
+    int c= search_forwards ("%", l);
+    if (c >= 0) l= trim_spaces (l (0, c));
+    int j= 0, n= N(l);
+    while (j < n && l[j] != ' ' && l[j] != '\t' &&
+           l[j] != '=' && l[j] != '.') j++;
+    if (j == 0 || j == n || l[j] == '.') continue;
+    string var= l (0, j);
+    while (j < n && (l[j] == ' ' || l[j] == '\t')) j++;
+    if (j < n && l[j] == '=') j++;
+    if (!tex_cnf->contains (var))
+      tex_cnf (var)= trim_spaces (l (j, n));
+  }
+}
+
+static void
+watch (url u) {
+  tex_db_sources << u;
+  tex_db_dates << last_modified (u, false);
+}
+
+static void
+read_configuration () {
+  url kpse= resolve_in_path ("kpsewhich");
+  if (!is_none (kpse)) {
+    string loc= parent_dir (concretize (kpse));
+    tex_cnf ("SELFAUTOLOC")= loc;
+    string dir= parent_dir (loc), parent= parent_dir (dir);
+    tex_cnf ("SELFAUTODIR")= dir;
+    tex_cnf ("SELFAUTOPARENT")= parent;
+    tex_cnf ("SELFAUTOGRANDPARENT")= parent_dir (parent);
+  }
+  string cnf_path= get_env ("TEXMFCNF");
+  if (cnf_path == "") cnf_path= TEX_DEFAULT_CNF_PATH;
+  array<string> dirs= path_elements (cnf_path);
+  hashmap<string,bool> done (false);
+  for (int i=0; i<N(dirs); i++) {
+    if (done [dirs[i]]) continue;
+    done (dirs[i])= true;
+    url u= url_system (dirs[i]) * "texmf.cnf";
+    string s;
+    if (!is_regular (u) || load_string (u, s, false)) continue;
+    watch (u);
+    read_texmf_cnf (s);
+  }
+}
+
+/******************************************************************************
+* Reading the databases
+******************************************************************************/
+
+static bool
+is_font_file (string name) {
+  return ends (name, ".tfm") || ends (name, ".pfb") ||
+         ends (name, ".mf") || ends (name, "pk");
+}
+
+static void
+read_ls_r (string root, string s) {
+  string dir= root;
+  int i= 0, n= N(s);
+  while (i < n) {
+    int j= i;
+    while (j < n && s[j] != '\n') j++;
+    int k= j;
+    if (k > i && s[k-1] == '\r') k--;
+    if (k > i && s[i] != '%') {
+      if (s[k-1] == ':') {
+        string d= s (i, k-1);
+        if (starts (d, "./")) d= root * d (1, N(d));
+        else if (d == ".") d= root;
+        else if (!starts (d, "/")) d= root * "/" * d;
+        while (N(d) > 1 && d[N(d)-1] == '/') d= d (0, N(d)-1);
+        dir= d;
+      }
+      else {
+        string name= s (i, k);
+        if (is_font_file (name)) {
+          // fresh arrays, since the default value of tex_db is shared
+          if (!tex_db->contains (name)) tex_db (name)= array<string> ();
+          tex_db (name) << dir;
+        }
+      }
+    }
+    i= j+1;
+  }
+}
+
+static void
+load_tex_database () {
+  bench_start ("tex database");
+  tex_db_loaded= true;
+  tex_cnf= hashmap<string,string> ("");
+  tex_db= hashmap<string,array<string> > ();
+  tex_paths= hashmap<string,array<string> > ();
+  tex_db_sources= array<url> ();
+  tex_db_dates= array<int> ();
+  read_configuration ();
+  array<string> roots= path_elements (tex_variable ("TEXMFDBS"));
+  hashmap<string,bool> done (false);
+  for (int i=0; i<N(roots); i++) {
+    if (done [roots[i]]) continue;
+    done (roots[i])= true;
+    url u= url_system (roots[i]) * "ls-R";
+    string s;
+    if (!is_regular (u) || load_string (u, s, false)) continue;
+    watch (u);
+    read_ls_r (roots[i], s);
+  }
+  bench_cumul ("tex database");
+}
+
+static bool
+tex_database_changed () {
+  for (int i=0; i<N(tex_db_sources); i++)
+    if (last_modified (tex_db_sources[i], false) != tex_db_dates[i])
+      return true;
+  return false;
+}
+
+void
+reset_tex_database () {
+  tex_db_loaded= false;
+}
+
+/******************************************************************************
+* Looking up files
+******************************************************************************/
+
+static string
+path_variable (string name) {
+  if (ends (name, ".tfm")) return "TFMFONTS";
+  if (ends (name, ".pfb")) return "T1FONTS";
+  if (ends (name, ".mf" )) return "MFINPUTS";
+  return "PKFONTS";
+}
+
+static array<string>
+search_path (string var) {
+  if (!tex_paths->contains (var)) {
+    string val= tex_variable (var);
+    if (val == "") {
+      if (var == "TFMFONTS") val= ".;$TEXMF/fonts/tfm//";
+      else if (var == "T1FONTS") val= ".;$TEXMF/fonts/type1//";
+      else if (var == "MFINPUTS")
+        val= ".;$TEXMF/metafont//;$TEXMF/fonts/source//";
+      else val= ".;$TEXMF/fonts/pk//";
+    }
+    tex_paths (var)= path_elements (val);
+  }
+  return tex_paths [var];
+}
+
+static url
+lookup (string name) {
+  if (!tex_db->contains (name)) return url_none ();
+  array<string> dirs= tex_db [name];
+  array<string> path= search_path (path_variable (name));
+  for (int i=0; i<N(path); i++) {
+    string p= path[i], q= path[i] * "/";
+    for (int j=0; j<N(dirs); j++)
+      if (dirs[j] == p || starts (dirs[j], q))
+        return url_system (dirs[j]) * name;
+  }
+  return url_none ();
+}
+
+url
+tex_database_resolve (string name) {
+  // find the font file name in the TeX trees, or url_none () if it is not
+  // in any database; the result does not necessarily exist
+  if (!is_font_file (name)) return url_none ();
+  if (!tex_db_loaded) load_tex_database ();
+  url u= lookup (name);
+  if (is_none (u) && tex_database_changed ()) {
+    load_tex_database ();
+    u= lookup (name);
+  }
+  return u;
+}
@@ -0,0 +1,19 @@
+
+/******************************************************************************
+* MODULE     : tex_database.hpp
+* DESCRIPTION: native lookup of files in the ls-R databases of TeX
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef TEX_DATABASE_H
+#define TEX_DATABASE_H
+#include "url.hpp"
+
+url  tex_database_resolve (string name);
+void reset_tex_database ();
+
+#endif // defined TEX_DATABASE_H
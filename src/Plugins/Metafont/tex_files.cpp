@@ -10,6 +10,7 @@
 ******************************************************************************/
 
 #include "tex_files.hpp"
+#include "tex_database.hpp"
 #include "boot.hpp"
 #include "file.hpp"
 #include "sys_utils.hpp"
@@ -35,12 +36,23 @@ kpsewhich (string name) {
   return which;
 }
 
+static url
+tex_which (url name) {
+  // look up name in the databases of the TeX trees;
+  // only launch kpsewhich for the files which are not found there
+  string s= as_string (name);
+  url u= tex_database_resolve (s);
+  if (!is_none (u) && exists (u)) return u;
+  string which= kpsewhich (s);
+  if ((which!="") && exists (url_system (which))) return url_system (which);
+  return url_none ();
+}
+
 static url
 resolve_tfm (url name) {
   if (get_setting ("KPSEWHICH") == "true") {
-    string which= kpsewhich (as_string (name));
-    if ((which!="") && exists (url_system (which))) return url_system (which);
-    // cout << "Missed " << name << "\n";
+    url u= tex_which (name);
+    if (!is_none (u)) return u;
   }
   return resolve (the_tfm_path * name);
 }
@@ -49,9 +61,8 @@ static url
 resolve_pk (url name) {
 #ifndef OS_WIN32 // The kpsewhich from MikTeX is bugged for pk fonts
   if (get_setting ("KPSEWHICH") == "true") {
-    string which= kpsewhich (as_string (name));
-    if ((which!="") && exists (url_system (which))) return url_system (which);
-    // cout << "Missed " << name << "\n";
+    url u= tex_which (name);
+    if (!is_none (u)) return u;
   }
 #endif
   return resolve (the_pk_path * name);
@@ -61,9 +72,8 @@ static url
 resolve_pfb (url name) {
 #ifndef OS_WIN32 // The kpsewhich from MikTeX is bugged for pfb fonts
   if (get_setting ("KPSEWHICH") == "true") {
-    string which= kpsewhich (as_string (name));
-    if ((which!="") && exists (url_system (which))) return url_system (which);
-    // cout << "Missed " << name << "\n";
+    url u= tex_which (name);
+    if (!is_none (u)) return u;
   }
 #endif
   return resolve (the_pfb_path * name);
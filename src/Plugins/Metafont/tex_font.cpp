@@ -1058,6 +1058,8 @@ struct tfm_font_metric_rep: public font_metric_rep {
       r->y4=  ((int) gl->yoff) * PIXEL;
     }
     return *((metric*) ((void*) ms[c])); }
+  int  cache_size () { return metric_table_size (ms); }
+  void cache_evict () { clear_metric_table (ms); }
 };
 
 #undef conv
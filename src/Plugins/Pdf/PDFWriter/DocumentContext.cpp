@@ -189,6 +189,8 @@ EStatusCode	DocumentContext::FinalizeNewPDF()
 	// this will finalize writing all renments of the file, like xref, trailer and whatever objects still accumulating
 	do
 	{
+		mObjectsContext->FlushDeferredStreams();
+
 		status = WriteUsedFontsDefinitions();
 		if(status != 0)
 			break;
@@ -215,13 +217,27 @@ EStatusCode	DocumentContext::FinalizeNewPDF()
 		// write encryption dictionary, if encrypting
 		WriteEncryptionDictionary();
 
-		status = mObjectsContext->WriteXrefTable(xrefTablePosition);
-		if(status != 0)
-			break;
+		if(mObjectsContext->GetObjectStreams())
+		{
+			// compressed objects can only be referenced from an xref stream, which also holds the trailer
+			status = mObjectsContext->FlushObjectStream();
+			if(status != 0)
+				break;
 
-		status = WriteTrailerDictionary();
-		if(status != 0)
-			break;
+			status = WriteXrefStream(xrefTablePosition);
+			if(status != 0)
+				break;
+		}
+		else
+		{
+			status = mObjectsContext->WriteXrefTable(xrefTablePosition);
+			if(status != 0)
+				break;
+
+			status = WriteTrailerDictionary();
+			if(status != 0)
+				break;
+		}
 
 		WriteXrefReference(xrefTablePosition);
 		WriteFinalEOF();
@@ -0,0 +1,44 @@
+/*
+   Source File : IDeferredStreamsHandler.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   
+*/
+#pragma once
+
+#include "ObjectsBasicTypes.h"
+#include <string>
+
+class IDeferredStreamsHandler
+{
+
+public:
+	virtual ~IDeferredStreamsHandler(){}
+
+	// Deferred streams extensibility. page content streams are collected uncompressed in memory,
+	// and handed to the handler when they end, so that they can be compressed elsewhere
+	// (for instance on other threads).
+
+	// OnDeferredStream is called when a deferred stream ends, with its uncompressed content.
+	// the handler should eventually write the stream object with ObjectsContext::WriteFlateEncodedPDFStream
+	virtual void OnDeferredStream(ObjectIDType inObjectID,const std::string& inContent) = 0;
+
+	// FlushDeferredStreams is called before the document is finalized. all the pending stream objects
+	// should be written by then
+	virtual void FlushDeferredStreams() = 0;
+
+};
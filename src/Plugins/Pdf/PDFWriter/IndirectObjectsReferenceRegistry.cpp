@@ -98,6 +98,28 @@ EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsWritten(ObjectIDType i
 	return PDFHummus::eSuccess;
 }
 
+EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsWrittenInObjectStream(ObjectIDType inObjectID,ObjectIDType inObjectStreamID,unsigned long inIndex)
+{
+	if(mObjectsWritesRegistry.size() <= inObjectID)
+	{
+		TRACE_LOG1("IndirectObjectsReferenceRegistry::MarkObjectAsWrittenInObjectStream, Out of range failure. An Object ID is marked as written, which was not allocated before. ID = %ld",inObjectID);
+		return PDFHummus::eFailure; 
+	}
+
+	if(mObjectsWritesRegistry[inObjectID].mObjectWritten)
+	{
+		TRACE_LOG1("IndirectObjectsReferenceRegistry::MarkObjectAsWrittenInObjectStream, Object rewrite failure. The object %ld was already marked as written",inObjectID);
+		return PDFHummus::eFailure;
+	}
+
+    mObjectsWritesRegistry[inObjectID].mIsDirty = true;
+	mObjectsWritesRegistry[inObjectID].mWritePosition = 0;
+	mObjectsWritesRegistry[inObjectID].mObjectStreamID = inObjectStreamID;
+	mObjectsWritesRegistry[inObjectID].mObjectStreamIndex = inIndex;
+	mObjectsWritesRegistry[inObjectID].mObjectWritten = true;
+	return PDFHummus::eSuccess;
+}
+
 GetObjectWriteInformationResult IndirectObjectsReferenceRegistry::GetObjectWriteInformation(ObjectIDType inObjectID) const
 {
 	GetObjectWriteInformationResult result;
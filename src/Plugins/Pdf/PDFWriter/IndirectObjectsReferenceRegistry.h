@@ -56,6 +56,12 @@ struct ObjectWriteInformation
 	EObjectReferenceType mObjectReferenceType;
     // object generation number
     unsigned long mGenerationNumber;
+    // containing object stream, or 0 if the object is written directly to file
+    ObjectIDType mObjectStreamID;
+    // index of the object within its object stream
+    unsigned long mObjectStreamIndex;
+
+    ObjectWriteInformation(): mObjectStreamID(0), mObjectStreamIndex(0) {}
 };
 
 typedef std::pair<bool,ObjectWriteInformation> GetObjectWriteInformationResult;
@@ -70,6 +76,8 @@ public:
 	ObjectIDType AllocateNewObjectID();
 	
 	PDFHummus::EStatusCode MarkObjectAsWritten(ObjectIDType inObjectID,LongFilePositionType inWritePosition);
+	// mark an object as written compressed inside an object stream (PDF 1.5)
+	PDFHummus::EStatusCode MarkObjectAsWrittenInObjectStream(ObjectIDType inObjectID,ObjectIDType inObjectStreamID,unsigned long inIndex);
 	GetObjectWriteInformationResult GetObjectWriteInformation(ObjectIDType inObjectID) const;
 
 	ObjectIDType GetObjectsCount() const;
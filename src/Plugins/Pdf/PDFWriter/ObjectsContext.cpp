@@ -34,6 +34,7 @@
 #include "PDFLiteralString.h"
 #include "EncryptionHelper.h"
 #include "PDFObjectParser.h"
+#include "IDeferredStreamsHandler.h"
 
 using namespace PDFHummus;
 
@@ -43,6 +44,11 @@ ObjectsContext::ObjectsContext(void)
 	mCompressStreams = true;
 	mExtender = NULL;
 	mEncryptionHelper = NULL;
+	mObjectStreams = false;
+	mFileStream = NULL;
+	mDeferringObject = false;
+	mDeferredObjectID = 0;
+	mDeferredStreamsHandler = NULL;
 }
 
 ObjectsContext::~ObjectsContext(void)
@@ -55,6 +61,7 @@ ObjectsContext::~ObjectsContext(void)
 void ObjectsContext::SetOutputStream(IByteWriterWithPosition* inOutputStream)
 {
 	mOutputStream = inOutputStream;
+	mFileStream = inOutputStream;
 	mPrimitiveWriter.SetStreamForWriting(inOutputStream);
 }
 
@@ -145,10 +152,10 @@ void ObjectsContext::EndFreeContext()
 }
 
 LongFilePositionType ObjectsContext::GetCurrentPosition() {
-	if (!mOutputStream) // in case somebody gets smart and ask before the stream is set
+	if (!mFileStream) // in case somebody gets smart and ask before the stream is set
 		return 0;
 
-	return mOutputStream->GetCurrentPosition();
+	return mFileStream->GetCurrentPosition();
 }
 
 
@@ -290,6 +297,9 @@ void ObjectsContext::WriteTokenSeparator(ETokenSeparator inSeparate)
 
 void ObjectsContext::WriteKeyword(const std::string& inKeyword)
 {
+	// an object written by hand as a stream can't go into an object stream
+	if(mDeferringObject && inKeyword == "stream")
+		UndeferObject();
 	mPrimitiveWriter.WriteKeyword(inKeyword);
 }
 
@@ -317,28 +327,34 @@ static const std::string scObj = "obj";
 ObjectIDType ObjectsContext::StartNewIndirectObject()
 {
 	ObjectIDType newObjectID = mReferencesRegistry.AllocateNewObjectID();
-	mReferencesRegistry.MarkObjectAsWritten(newObjectID,mOutputStream->GetCurrentPosition());
-	mPrimitiveWriter.WriteInteger(newObjectID);
-	mPrimitiveWriter.WriteInteger(0);
-	mPrimitiveWriter.WriteKeyword(scObj);
+	StartNewIndirectObject(newObjectID);
+	return newObjectID;
+}
 
-	if(IsEncrypting()) {
-		mEncryptionHelper->OnObjectStart((long long)newObjectID, 0);
+void ObjectsContext::StartNewIndirectObject(ObjectIDType inObjectID)
+{
+	if(mDeferringObject)
+		UndeferObject();
+	// objects are not packed in encrypted documents, where strings are encrypted per object
+	if(mObjectStreams && !(mEncryptionHelper && mEncryptionHelper->IsDocumentEncrypted()))
+	{
+		StartDeferredObject(inObjectID);
+		return;
 	}
 
-	return newObjectID;
+	WriteObjectHeader(inObjectID);
+
+	if (IsEncrypting()) {
+		mEncryptionHelper->OnObjectStart((long long)inObjectID, 0);
+	}
 }
 
-void ObjectsContext::StartNewIndirectObject(ObjectIDType inObjectID)
+void ObjectsContext::WriteObjectHeader(ObjectIDType inObjectID)
 {
 	mReferencesRegistry.MarkObjectAsWritten(inObjectID,mOutputStream->GetCurrentPosition());
 	mPrimitiveWriter.WriteInteger(inObjectID);
 	mPrimitiveWriter.WriteInteger(0);
 	mPrimitiveWriter.WriteKeyword(scObj);
-
-	if (IsEncrypting()) {
-		mEncryptionHelper->OnObjectStart((long long)inObjectID, 0);
-	}
 }
 
 void ObjectsContext::StartModifiedIndirectObject(ObjectIDType inObjectID)
@@ -356,6 +372,12 @@ void ObjectsContext::StartModifiedIndirectObject(ObjectIDType inObjectID)
 static const std::string scEndObj = "endobj";
 void ObjectsContext::EndIndirectObject()
 {
+	if(mDeferringObject)
+	{
+		EndDeferredObject();
+		return;
+	}
+
 	mPrimitiveWriter.WriteKeyword(scEndObj);
 
 	if (IsEncrypting()) {
@@ -378,6 +400,98 @@ void ObjectsContext::SetCompressStreams(bool inCompressStreams)
 	mCompressStreams = inCompressStreams;
 }
 
+void ObjectsContext::SetObjectStreams(bool inObjectStreams)
+{
+	mObjectStreams = inObjectStreams;
+}
+
+bool ObjectsContext::GetObjectStreams()
+{
+	return mObjectStreams;
+}
+
+// pending objects are written out in object streams of at most that many objects
+static const size_t scObjectStreamCapacity = 200;
+
+void ObjectsContext::StartDeferredObject(ObjectIDType inObjectID)
+{
+	// collect the object body in memory until it is known whether it's a stream
+	mDeferringObject = true;
+	mDeferredObjectID = inObjectID;
+	mDeferredObject.Reset();
+	mOutputStream = &mDeferredObject;
+	mPrimitiveWriter.SetStreamForWriting(&mDeferredObject);
+}
+
+void ObjectsContext::UndeferObject()
+{
+	// the pending object turns out to be a stream. write it directly to file
+	std::string body = mDeferredObject.ToString();
+	mDeferringObject = false;
+	mOutputStream = mFileStream;
+	mPrimitiveWriter.SetStreamForWriting(mFileStream);
+	WriteObjectHeader(mDeferredObjectID);
+	mOutputStream->Write((const IOBasicTypes::Byte *)body.c_str(),body.size());
+}
+
+void ObjectsContext::EndDeferredObject()
+{
+	std::string body = mDeferredObject.ToString();
+	mDeferringObject = false;
+	mOutputStream = mFileStream;
+	mPrimitiveWriter.SetStreamForWriting(mFileStream);
+
+	mObjectStreamObjects.push_back(mDeferredObjectID);
+	mObjectStreamOffsets.push_back(mObjectStreamData.size());
+	mObjectStreamData.append(body);
+	mObjectStreamData.append("\n");
+	if(mObjectStreamObjects.size() >= scObjectStreamCapacity)
+		FlushObjectStream();
+}
+
+EStatusCode ObjectsContext::FlushObjectStream()
+{
+	if(mDeferringObject)
+		UndeferObject();
+	if(mObjectStreamObjects.empty())
+		return eSuccess;
+
+	// header of pairs of object numbers and offsets, followed by the objects themselves
+	OutputStringBufferStream header;
+	PrimitiveObjectsWriter headerWriter(&header);
+	for(size_t i = 0; i < mObjectStreamObjects.size(); ++i)
+	{
+		headerWriter.WriteInteger(mObjectStreamObjects[i]);
+		headerWriter.WriteInteger(mObjectStreamOffsets[i]);
+	}
+	std::string headerData = header.ToString();
+
+	// the object stream itself can't be packed, and its length has to be direct
+	ObjectIDType objectStreamID = mReferencesRegistry.AllocateNewObjectID();
+	WriteObjectHeader(objectStreamID);
+	DictionaryContext* streamDictionary = StartDictionary();
+	streamDictionary->WriteKey("Type");
+	streamDictionary->WriteNameValue("ObjStm");
+	streamDictionary->WriteKey("N");
+	streamDictionary->WriteIntegerValue(mObjectStreamObjects.size());
+	streamDictionary->WriteKey("First");
+	streamDictionary->WriteIntegerValue(headerData.size());
+	PDFStream* objectStream = StartPDFStream(streamDictionary,true);
+	objectStream->GetWriteStream()->Write((const IOBasicTypes::Byte *)headerData.c_str(),headerData.size());
+	objectStream->GetWriteStream()->Write((const IOBasicTypes::Byte *)mObjectStreamData.c_str(),mObjectStreamData.size());
+	EndPDFStream(objectStream);
+	delete objectStream;
+
+	EStatusCode status = eSuccess;
+	for(size_t i = 0; i < mObjectStreamObjects.size() && eSuccess == status; ++i)
+		status = mReferencesRegistry.MarkObjectAsWrittenInObjectStream(mObjectStreamObjects[i],objectStreamID,(unsigned long)i);
+
+	mObjectStreamData.clear();
+	mObjectStreamObjects.clear();
+	mObjectStreamOffsets.clear();
+	return status;
+}
+
 static const std::string scLength = "Length";
 static const std::string scStream = "stream";
 static const std::string scEndStream = "endstream";
@@ -389,6 +503,10 @@ PDFStream* ObjectsContext::StartPDFStream(DictionaryContext* inStreamDictionary,
 	// write stream header and allocate PDF stream.
 	// PDF stream will take care of maintaining state for the stream till writing is finished
 
+	// a pending object that turns out to be a stream is written directly to file
+	if(mDeferringObject)
+		UndeferObject();
+
 	// Write the stream header
 	// Write Stream Dictionary (note that inStreamDictionary is optionally used)
 	DictionaryContext* streamDictionaryContext = (NULL == inStreamDictionary ? StartDictionary() : inStreamDictionary);
@@ -432,6 +550,9 @@ PDFStream* ObjectsContext::StartUnfilteredPDFStream(DictionaryContext* inStreamD
 	// write stream header and allocate PDF stream.
 	// PDF stream will take care of maintaining state for the stream till writing is finished
 
+	if(mDeferringObject)
+		UndeferObject();
+
 	// Write the stream header
 	// Write Stream Dictionary (note that inStreamDictionary is optionally used)
 	DictionaryContext* streamDictionaryContext = (NULL == inStreamDictionary ? StartDictionary() : inStreamDictionary);
@@ -495,6 +616,54 @@ void ObjectsContext::EndPDFStream(PDFStream* inStream)
 }
  
 	
+void ObjectsContext::SetDeferredStreamsHandler(IDeferredStreamsHandler* inHandler)
+{
+	mDeferredStreamsHandler = inHandler;
+}
+
+bool ObjectsContext::DefersStreams()
+{
+	// encrypted streams have to be encrypted with their own object key, so they are written directly
+	return mDeferredStreamsHandler && mCompressStreams && !(mEncryptionHelper && mEncryptionHelper->IsDocumentEncrypted());
+}
+
+PDFStream* ObjectsContext::StartDeferredPDFStream()
+{
+	// a direct extent stream with no dictionary keeps its content in memory
+	return new PDFStream(false,&mDeferredStreamContent,NULL,(DictionaryContext*)NULL,NULL);
+}
+
+void ObjectsContext::EndDeferredPDFStream(PDFStream* inStream,ObjectIDType inObjectID)
+{
+	inStream->FinalizeStreamWrite();
+	mDeferredStreamContent.Reset();
+	inStream->FlushStreamContentForDirectExtentStream();
+	mDeferredStreamsHandler->OnDeferredStream(inObjectID,mDeferredStreamContent.ToString());
+	mDeferredStreamContent.Reset();
+}
+
+void ObjectsContext::WriteFlateEncodedPDFStream(ObjectIDType inObjectID,const std::string& inEncodedContent)
+{
+	StartNewIndirectObject(inObjectID);
+	DictionaryContext* streamDictionaryContext = StartDictionary();
+	streamDictionaryContext->WriteKey(scFilter);
+	streamDictionaryContext->WriteNameValue(scFlateDecode);
+	streamDictionaryContext->WriteKey(scLength);
+	streamDictionaryContext->WriteIntegerValue(inEncodedContent.size());
+	EndDictionary(streamDictionaryContext);
+	WriteKeyword(scStream);
+	mOutputStream->Write((const IOBasicTypes::Byte *)inEncodedContent.c_str(),inEncodedContent.size());
+	EndLine();
+	WriteKeyword(scEndStream);
+	EndIndirectObject();
+}
+
+void ObjectsContext::FlushDeferredStreams()
+{
+	if(mDeferredStreamsHandler)
+		mDeferredStreamsHandler->FlushDeferredStreams();
+}
+
 void ObjectsContext::WritePDFStreamEndWithoutExtent()
 {
 		EndLine(); // this one just to make sure
@@ -594,6 +763,13 @@ void ObjectsContext::Cleanup()
 	mCompressStreams = true;
 	mExtender = NULL;
 	mEncryptionHelper = NULL;
+	mObjectStreams = false;
+	mFileStream = NULL;
+	mDeferringObject = false;
+	mObjectStreamData.clear();
+	mObjectStreamObjects.clear();
+	mObjectStreamOffsets.clear();
+	mDeferredStreamsHandler = NULL;
 
 	mSubsetFontsNamesSequance.Reset();
 	mReferencesRegistry.Reset();
@@ -674,7 +850,14 @@ EStatusCode ObjectsContext::WriteXrefStream(DictionaryContext* inDictionaryConte
             {
                 // used object
                 
-                if(objectReference.mObjectWritten)
+                if(objectReference.mObjectWritten && objectReference.mObjectStreamID != 0)
+                {
+                    // compressed object, by containing object stream and index
+                    WriteXrefNumber(aStream->GetWriteStream(),2,typeSize);
+                    WriteXrefNumber(aStream->GetWriteStream(),objectReference.mObjectStreamID,locationSize);
+                    WriteXrefNumber(aStream->GetWriteStream(),objectReference.mObjectStreamIndex,generationSize);
+                }
+                else if(objectReference.mObjectWritten)
                 {
                     WriteXrefNumber(aStream->GetWriteStream(),1,typeSize);
                     WriteXrefNumber(aStream->GetWriteStream(),objectReference.mWritePosition,locationSize);
@@ -25,8 +25,10 @@
 #include "ETokenSeparator.h"
 #include "PrimitiveObjectsWriter.h"
 #include "UppercaseSequance.h"
+#include "OutputStringBufferStream.h"
 #include <string>
 #include <list>
+#include <vector>
 
 
 
@@ -37,6 +39,7 @@ class IObjectsContextExtender;
 class ObjectsContext;
 class PDFParser;
 class EncryptionHelper;
+class IDeferredStreamsHandler;
 
 typedef std::list<DictionaryContext*> DictionaryContextList;
 
@@ -115,6 +118,22 @@ public:
 	// Sets whether streams created by the objects context will be compressed (with flate) or not
 	void SetCompressStreams(bool inCompressStreams);
 
+	// Sets whether indirect objects that are not streams are collected in compressed object streams (PDF 1.5).
+	// object streams can only be referenced from an xref stream, which FinalizeNewPDF then writes instead of the xref table
+	void SetObjectStreams(bool inObjectStreams);
+	bool GetObjectStreams();
+	// write the collected objects, if any, into a new object stream
+	PDFHummus::EStatusCode FlushObjectStream();
+
+	// Deferred streams. when a handler is set, page content streams are collected uncompressed in memory,
+	// and passed to the handler when they end. the handler then writes them with WriteFlateEncodedPDFStream
+	void SetDeferredStreamsHandler(IDeferredStreamsHandler* inHandler);
+	bool DefersStreams();
+	PDFStream* StartDeferredPDFStream();
+	void EndDeferredPDFStream(PDFStream* inStream,ObjectIDType inObjectID);
+	void WriteFlateEncodedPDFStream(ObjectIDType inObjectID,const std::string& inEncodedContent);
+	void FlushDeferredStreams();
+
 	// Create PDF stream and write it's header. note that stream are written with indirect object for Length, to allow one pass writing.
 	// inStreamDictionary can be passed in order to include stream generic information in an already written stream dictionary
 	// that is type specific. [the method will take care of closing the dictionary.
@@ -148,6 +167,24 @@ private:
 
 	DictionaryContextList mDictionaryStack;
 
+	// object streams. while an object is pending, mOutputStream is a buffer and mFileStream the actual output
+	bool mObjectStreams;
+	IByteWriterWithPosition* mFileStream;
+	bool mDeferringObject;
+	ObjectIDType mDeferredObjectID;
+	OutputStringBufferStream mDeferredObject;
+	std::string mObjectStreamData;
+	std::vector<ObjectIDType> mObjectStreamObjects;
+	std::vector<size_t> mObjectStreamOffsets;
+
+	IDeferredStreamsHandler* mDeferredStreamsHandler;
+	OutputStringBufferStream mDeferredStreamContent;
+
+	void WriteObjectHeader(ObjectIDType inObjectID);
+	void StartDeferredObject(ObjectIDType inObjectID);
+	void EndDeferredObject();
+	void UndeferObject();
+
 	void WritePDFStreamEndWithoutExtent();
 	void WritePDFStreamExtent(PDFStream* inStream);
     void WriteXrefNumber(IByteWriter* inStream,LongFilePositionType inElement, size_t inElementSize);
@@ -34,6 +34,7 @@ PageContentContext::PageContentContext(PDFHummus::DocumentContext* inDocumentCon
 	mPageOfContext = inPageOfContext;
 	mObjectsContext = inObjectsContext;
 	mCurrentStream = NULL;
+	mDeferredStreamID = 0;
 }
 
 PageContentContext::~PageContentContext(void)
@@ -44,8 +45,18 @@ void PageContentContext::StartAStreamIfRequired()
 {
 	if(!mCurrentStream)
 	{
-		StartContentStreamDefinition();
-		mCurrentStream = mObjectsContext->StartPDFStream();
+		if(mObjectsContext->DefersStreams())
+		{
+			// the content is collected in memory, and the stream object written later
+			mDeferredStreamID = mObjectsContext->GetInDirectObjectsRegistry().AllocateNewObjectID();
+			mPageOfContext->AddContentStreamReference(mDeferredStreamID);
+			mCurrentStream = mObjectsContext->StartDeferredPDFStream();
+		}
+		else
+		{
+			StartContentStreamDefinition();
+			mCurrentStream = mObjectsContext->StartPDFStream();
+		}
 		SetPDFStreamForWrite(mCurrentStream);
 	}
 }
@@ -76,10 +87,14 @@ PDFPage* PageContentContext::GetAssociatedPage()
 
 EStatusCode PageContentContext::FinalizeStreamWriteAndRelease()
 {
-	mObjectsContext->EndPDFStream(mCurrentStream);
+	if(mDeferredStreamID != 0)
+		mObjectsContext->EndDeferredPDFStream(mCurrentStream,mDeferredStreamID);
+	else
+		mObjectsContext->EndPDFStream(mCurrentStream);
 
 	delete mCurrentStream;
 	mCurrentStream = NULL;
+	mDeferredStreamID = 0;
 	return PDFHummus::eSuccess;
 }
 
@@ -48,6 +48,7 @@ private:
 	PDFPage* mPageOfContext;
 	ObjectsContext* mObjectsContext;
 	PDFStream* mCurrentStream;
+	ObjectIDType mDeferredStreamID; // 0 unless the current stream is deferred
 
 	PDFHummus::EStatusCode FinalizeStreamWriteAndRelease();
 	void StartContentStreamDefinition();
@@ -0,0 +1,176 @@
+
+/******************************************************************************
+* MODULE     : pdf_hummus_compressor.cpp
+* DESCRIPTION: Compression of page content streams on worker threads
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "pdf_hummus_compressor.hpp"
+#include "PDFWriter/ObjectsContext.h"
+#include <zlib.h>
+#ifndef OS_MINGW
+#include <pthread.h>
+#endif
+
+std::string
+pdf_flate_encode (const std::string& s) {
+  // may be called from any thread
+  uLongf n= compressBound ((uLong) s.size ());
+  std::string r (n, '\0');
+  compress2 ((Bytef*) &r[0], &n, (const Bytef*) s.data (), (uLong) s.size (),
+             Z_DEFAULT_COMPRESSION);
+  r.resize (n);
+  return r;
+}
+
+/******************************************************************************
+* Worker threads
+******************************************************************************/
+
+#ifndef OS_MINGW
+
+struct pdf_hummus_compressor_threads {
+  pthread_mutex_t lock;
+  pthread_cond_t  work;     // a job was queued, or the pool stops
+  pthread_cond_t  done;     // a job was completed
+  pthread_t*      ids;
+};
+
+void*
+pdf_compression_worker (void* arg) {
+  ((pdf_hummus_compressor*) arg)->run_worker ();
+  return NULL;
+}
+
+void
+pdf_hummus_compressor::run_worker () {
+  while (true) {
+    pthread_mutex_lock (&threads->lock);
+    while (todo.empty () && !stopping)
+      pthread_cond_wait (&threads->work, &threads->lock);
+    if (todo.empty ()) {
+      pthread_mutex_unlock (&threads->lock);
+      return;
+    }
+    pdf_compression_job* job= todo.front ();
+    todo.pop_front ();
+    pthread_mutex_unlock (&threads->lock);
+
+    std::string r= pdf_flate_encode (job->data);
+
+    pthread_mutex_lock (&threads->lock);
+    job->data.swap (r);
+    job->done= true;
+    pthread_cond_broadcast (&threads->done);
+    pthread_mutex_unlock (&threads->lock);
+  }
+}
+
+#endif
+
+/******************************************************************************
+* Constructors and destructors
+******************************************************************************/
+
+pdf_hummus_compressor::pdf_hummus_compressor (ObjectsContext& oc, int n):
+  objectsContext (oc), nr_threads (n), max_pending (4 * max (n, 1)),
+  stopping (false), threads (NULL)
+{
+#ifdef OS_MINGW
+  nr_threads= 0;
+#else
+  if (nr_threads <= 0) return;
+  threads= tm_new<pdf_hummus_compressor_threads> ();
+  pthread_mutex_init (&threads->lock, NULL);
+  pthread_cond_init (&threads->work, NULL);
+  pthread_cond_init (&threads->done, NULL);
+  threads->ids= tm_new_array<pthread_t> (nr_threads);
+  for (int i=0; i<n; i++)
+    if (pthread_create (&threads->ids[i], NULL,
+                        pdf_compression_worker, (void*) this) != 0) {
+      // compress on the main thread if no worker could be started
+      nr_threads= i;
+      break;
+    }
+#endif
+}
+
+pdf_hummus_compressor::~pdf_hummus_compressor () {
+#ifndef OS_MINGW
+  if (threads != NULL) {
+    pthread_mutex_lock (&threads->lock);
+    stopping= true;
+    pthread_cond_broadcast (&threads->work);
+    pthread_mutex_unlock (&threads->lock);
+    for (int i=0; i<nr_threads; i++)
+      pthread_join (threads->ids[i], NULL);
+    pthread_cond_destroy (&threads->done);
+    pthread_cond_destroy (&threads->work);
+    pthread_mutex_destroy (&threads->lock);
+    tm_delete_array (threads->ids);
+    tm_delete (threads);
+  }
+#endif
+  while (!order.empty ()) {
+    tm_delete (order.front ());
+    order.pop_front ();
+  }
+}
+
+/******************************************************************************
+* Writing the compressed streams in order
+******************************************************************************/
+
+void
+pdf_hummus_compressor::write_ready (bool wait_all) {
+  // write the completed streams which are next in line; wait for the
+  // oldest one if all are needed or if too many pages are buffered
+  while (!order.empty ()) {
+    pdf_compression_job* job= order.front ();
+#ifndef OS_MINGW
+    if (nr_threads > 0) {
+      pthread_mutex_lock (&threads->lock);
+      while (!job->done && (wait_all || (int) order.size () > max_pending))
+        pthread_cond_wait (&threads->done, &threads->lock);
+      bool ready= job->done;
+      pthread_mutex_unlock (&threads->lock);
+      if (!ready) return;
+    }
+#endif
+    order.pop_front ();
+    objectsContext.WriteFlateEncodedPDFStream (job->id, job->data);
+    tm_delete (job);
+  }
+}
+
+void
+pdf_hummus_compressor::OnDeferredStream (ObjectIDType id,
+                                         const std::string& content) {
+  pdf_compression_job* job= tm_new<pdf_compression_job> ();
+  job->id  = id;
+  job->data= content;
+  job->done= false;
+  order.push_back (job);
+  if (nr_threads == 0) {
+    job->data= pdf_flate_encode (job->data);
+    job->done= true;
+  }
+#ifndef OS_MINGW
+  else {
+    pthread_mutex_lock (&threads->lock);
+    todo.push_back (job);
+    pthread_cond_signal (&threads->work);
+    pthread_mutex_unlock (&threads->lock);
+  }
+#endif
+  write_ready (false);
+}
+
+void
+pdf_hummus_compressor::FlushDeferredStreams () {
+  write_ready (true);
+}
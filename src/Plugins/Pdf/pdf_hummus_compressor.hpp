@@ -0,0 +1,59 @@
+
+/******************************************************************************
+* MODULE     : pdf_hummus_compressor.hpp
+* DESCRIPTION: Compression of page content streams on worker threads
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef PDF_HUMMUS_COMPRESSOR_H
+#define PDF_HUMMUS_COMPRESSOR_H
+
+#include "basic.hpp"
+#include "PDFWriter/IDeferredStreamsHandler.h"
+#include <deque>
+
+class ObjectsContext;
+
+/******************************************************************************
+* The page content streams are encoded on the main thread into memory.
+* Their Flate compression runs on a pool of worker threads, and the
+* compressed stream objects are written by the main thread, in the order
+* in which the pages were produced.  The worker threads only handle
+* standard strings, since the TeXmacs data structures are not thread safe.
+******************************************************************************/
+
+struct pdf_compression_job {
+  ObjectIDType id;
+  std::string  data;   // uncompressed content, then compressed content
+  bool         done;
+};
+
+struct pdf_hummus_compressor_threads;
+
+class pdf_hummus_compressor: public IDeferredStreamsHandler {
+  ObjectsContext& objectsContext;
+  int nr_threads;
+  int max_pending;                          // bound on the buffered pages
+  std::deque<pdf_compression_job*> todo;    // jobs waiting for a thread
+  std::deque<pdf_compression_job*> order;   // jobs in the order of writing
+  bool stopping;
+  pdf_hummus_compressor_threads* threads;
+
+  void write_ready (bool wait_all);
+  void run_worker ();
+  friend void* pdf_compression_worker (void* arg);
+
+public:
+  pdf_hummus_compressor (ObjectsContext& oc, int nr_threads);
+  ~pdf_hummus_compressor ();
+  void OnDeferredStream (ObjectIDType id, const std::string& content);
+  void FlushDeferredStreams ();
+};
+
+std::string pdf_flate_encode (const std::string& s);
+
+#endif // defined PDF_HUMMUS_COMPRESSOR_H
@@ -10,6 +10,7 @@
 ******************************************************************************/
 
 #include "pdf_hummus_renderer.hpp"
+#include "pdf_hummus_compressor.hpp"
 #include "Metafont/tex_files.hpp"
 #include "Freetype/tt_file.hpp"
 #include "file.hpp"
@@ -33,6 +34,7 @@
 
 #include "PDFWriter/PDFWriter.h"
 #include "PDFWriter/PDFPage.h"
+#include "PDFWriter/PDFUsedFont.h"
 #include "PDFWriter/PageContentContext.h"
 #include "PDFWriter/DictionaryContext.h"
 #include "PDFWriter/PDFImageXObject.h"
@@ -54,6 +56,14 @@
 
 static EPDFVersion ePDFVersion= ePDFVersion14;
 
+static int
+pdf_compression_threads () {
+  // page contents are compressed on that many threads
+  string s= get_preference ("texmacs->pdf:threads", "default");
+  if (is_int (s)) return max (as_int (s), 1);
+  return min (number_of_processors (), 8);
+}
+
 typedef triple<int,int,int> rgb;
 typedef quartet<string,int,SI,SI> dest_data;
 typedef quintuple<string,int,SI,SI,int> outline_data;
@@ -100,12 +110,14 @@ class pdf_hummus_renderer_rep : public renderer_rep {
   hashmap<string,pdf_raw_image> pdf_glyphs;
   hashmap<tree,pdf_image> image_pool;
   hashmap<tree,pdf_image> pattern_image_pool;
+  hashmap<tree,tree> image_keys;
   hashmap<tree,pdf_pattern> pattern_pool;
   array<url> temp_images;
   
   hashmap<int,ObjectIDType> alpha_id;
   hashmap<int,ObjectIDType> page_id;
   hashmap<string,t3font> t3font_list;
+  hashmap<string,ObjectIDType> t3_procs;
   
   // link annotation support
   hashmap<ObjectIDType,string> annot_list;
@@ -121,6 +133,7 @@ class pdf_hummus_renderer_rep : public renderer_rep {
   
   
   PDFWriter pdfWriter;
+  pdf_hummus_compressor* compressor;
   PDFPage* page;
   PageContentContext* contentContext;
   
@@ -160,10 +173,19 @@ class pdf_hummus_renderer_rep : public renderer_rep {
   int get_label_id(string label);
 
     
-  // glyph positioning
-  
-  typedef quartet<int,int,int,glyph> drawn_glyph;
-  list <drawn_glyph> drawn_glyphs;
+  // glyph positioning: consecutive glyphs on the same baseline are
+  // collected into a single TJ array, with kerning offsets wherever
+  // the advances of the glyphs do not bring us to the next position
+
+  GlyphUnicodeMappingListOrDoubleList run;  // pending TJ array
+  GlyphUnicodeMappingList run_glyphs;       // glyphs since the last offset
+  bool   run_open;                          // is a text run pending?
+  bool   run_kerned;                        // does it contain offsets?
+  double run_x, run_y;                      // start of the pending run
+  double run_pen;                           // expected position of next glyph
+  hashmap<string,hashmap<int,double> > advances; // glyph widths per font
+  hashmap<int,double> cadv;                 // glyph widths in current font
+  double glyph_advance (int index);
   void draw_glyphs();
 
   
@@ -178,6 +200,7 @@ class pdf_hummus_renderer_rep : public renderer_rep {
   PDFImageXObject *create_pdf_image_raw (string raw_data, SI width, SI height, ObjectIDType imageXObjectID);
   void make_pdf_font (string fontname);
   void draw_bitmap_glyph (int ch, font_glyphs fn, SI x, SI y);
+  tree image_key (url u);
   void  image (url u, SI w, SI h, SI x, SI y,
                int alpha);
   
@@ -298,7 +321,10 @@ pdf_hummus_renderer_rep::pdf_hummus_renderer_rep (
     pdf_fonts (0),
     destId(0),
     label_count(0),
-    outlineId(0)
+    outlineId(0),
+    compressor (NULL),
+    run_open (false), run_kerned (false),
+    advances (hashmap<int,double> (-1.0)), cadv (-1.0)
 {
   width = default_dpi * paper_w / 2.54;
   height= default_dpi * paper_h / 2.54;
@@ -311,6 +337,11 @@ pdf_hummus_renderer_rep::pdf_hummus_renderer_rep (
   if (version == "1.5") ePDFVersion= ePDFVersion15;
   if (version == "1.6") ePDFVersion= ePDFVersion16;
   if (version == "1.7") ePDFVersion= ePDFVersion17;
+  // object streams make files smaller, but require PDF 1.5
+  bool object_streams=
+    get_preference ("texmacs->pdf:object streams", "off") == "on";
+  if (object_streams && ePDFVersion < ePDFVersion15)
+    ePDFVersion= ePDFVersion15;
   LogConfiguration log= LogConfiguration::DefaultLogConfiguration();
   PDFCreationSettings settings (true, true); //, EncryptionOptions("user", 4, "owner"));
 #if (defined (__MINGW__) || defined (__MINGW32__))
@@ -326,6 +357,12 @@ pdf_hummus_renderer_rep::pdf_hummus_renderer_rep (
 	} else {
 		started=true;
 		pdfWriter.GetDocumentContext().AddDocumentContextExtender (new DestinationsWriter(this));
+		pdfWriter.GetObjectsContext().SetObjectStreams (object_streams);
+		int threads= pdf_compression_threads ();
+		if (threads > 1) {
+		  compressor= tm_new<pdf_hummus_compressor> (pdfWriter.GetObjectsContext(), threads);
+		  pdfWriter.GetObjectsContext().SetDeferredStreamsHandler (compressor);
+		}
 
 		// start real work
 
@@ -377,6 +414,7 @@ pdf_hummus_renderer_rep::~pdf_hummus_renderer_rep () {
   if (status != PDFHummus::eSuccess) {
     convert_error << "Failed in end PDF\n";
   }
+  if (compressor != NULL) tm_delete (compressor);
 
   // remove temporary pictures
   for (int i=0; i<N(temp_images); i++)
@@ -567,6 +605,7 @@ public:
 
   bool flush_jpg (PDFWriter& pdfw, url image);
   bool flush_raster (PDFWriter& pdfw, url image);
+  void prefetch ();
   void flush (PDFWriter& pdfw);
 
   bool flush_for_pattern (PDFWriter& pdfw);
@@ -650,7 +689,7 @@ pdf_hummus_renderer_rep::register_pattern_image (brush br, SI pixel) {
   get_pattern_data (u, w, h, br, pixel);
   // cout << "get_pattern_data " << u << ", " << w << " x " << h << LF;
   pdf_image image_pdf;
-  tree u_tree= tuple (u->t);
+  tree u_tree= image_key (u);
   if (pattern_image_pool->contains(u_tree))
     image_pdf= pattern_image_pool[u_tree];
   else {
@@ -998,28 +1037,33 @@ public:
   font_glyphs fn;
   ObjectIDType fontId;
   ObjectsContext &objectsContext;
+  hashmap<string, ObjectIDType> procs; // shared among fonts
   hashmap<int, int> used_chars;
   int firstchar;
   int lastchar;
   int b0,b1,b2,b3; // glyph bounding box
   bool first_glyph;
   
-  t3font_rep (font_glyphs _fn, ObjectsContext &_objectsContext)
-  : fn (_fn), objectsContext(_objectsContext), first_glyph(true)
+  t3font_rep (font_glyphs _fn, ObjectsContext &_objectsContext,
+              hashmap<string, ObjectIDType> _procs)
+  : fn (_fn), objectsContext(_objectsContext), procs (_procs),
+    first_glyph(true)
   {
     fontId = objectsContext.GetInDirectObjectsRegistry().AllocateNewObjectID();
   }
   
   void update_bbox(int llx, int lly, int urx, int ury);
   void add_glyph (int ch) {  used_chars (ch) = 1; }
-  void write_char (glyph gl, ObjectIDType inCharID);
+  string char_proc (glyph gl);
+  void write_char (string data, ObjectIDType inCharID);
   void write_definition ();
 };
 
 class t3font {
   CONCRETE_NULL(t3font);
-  t3font (font_glyphs _fn, ObjectsContext &_objectsContext)
-  : rep (tm_new<t3font_rep> (_fn,_objectsContext)) {};
+  t3font (font_glyphs _fn, ObjectsContext &_objectsContext,
+          hashmap<string, ObjectIDType> _procs)
+  : rep (tm_new<t3font_rep> (_fn,_objectsContext,_procs)) {};
 };
 
 CONCRETE_NULL_CODE(t3font);
@@ -1038,8 +1082,8 @@ t3font_rep::update_bbox(int llx, int lly, int urx, int ury)
   }
 }
 
-void
-t3font_rep::write_char (glyph gl, ObjectIDType inCharID)
+string
+t3font_rep::char_proc (glyph gl)
 {
   int llx, lly, urx, ury, cwidth, cheight, lwidth;
   llx = -gl->xoff;
@@ -1050,11 +1094,8 @@ t3font_rep::write_char (glyph gl, ObjectIDType inCharID)
   cheight = gl->height;
   lwidth = gl->lwidth;
   
-  objectsContext.StartNewIndirectObject(inCharID);
-  // write char stream
-  PDFStream *charStream = objectsContext.StartPDFStream(NULL, true);
+  string data;
   {
-    string data;
     if (is_nil (gl)) {
       // write d0 command
       data  << "0 0 d0\r\n";
@@ -1088,15 +1129,22 @@ t3font_rep::write_char (glyph gl, ObjectIDType inCharID)
       }
       data << ">\r\nEI\r\nQ\r\n"; // ">" is the EOD char for ASCIIHex
     }
-    {
-      c_string buf(data);
-      charStream->GetWriteStream()->Write((unsigned char *)(char*)buf,N(data));
-    }
   }
-  objectsContext.EndPDFStream(charStream);
+  return data;
+}
+
+void
+t3font_rep::write_char (string data, ObjectIDType inCharID)
+{
+  objectsContext.StartNewIndirectObject(inCharID);
+  // write char stream
+  PDFStream *charStream = objectsContext.StartPDFStream(NULL, true);
+  {
+    c_string buf(data);
+    charStream->GetWriteStream()->Write((unsigned char *)(char*)buf,N(data));
+  }
+  objectsContext.EndPDFStream(charStream); // also ends the object
   delete charStream;
-  objectsContext.EndIndirectObject();
-  //return PDFHummus::eSuccess;
 }
 
 void
@@ -1119,9 +1167,13 @@ t3font_rep::write_definition ()
   {
     int ch = glyph_list[i];
     glyph gl = fn->get(ch);
-    ObjectIDType temp  = objectsContext.GetInDirectObjectsRegistry().AllocateNewObjectID();
-    charIds << temp;
-    write_char (gl, temp);
+    // identical glyph procedures are written only once for all fonts
+    string data = char_proc (gl);
+    if (!procs->contains (data)) {
+      procs (data) = objectsContext.GetInDirectObjectsRegistry().AllocateNewObjectID();
+      write_char (data, procs [data]);
+    }
+    charIds << procs [data];
   }
   // create font dictionary
   {
@@ -1223,62 +1275,34 @@ pdf_hummus_renderer_rep::make_pdf_font (string fontname)
   }
 }
 
-void
-pdf_hummus_renderer_rep::draw_glyphs()
-{
-  SI x,y,w; // current pos
-
-  if (N(drawn_glyphs) == 0) return;
-  
-  begin_text ();
-  GlyphUnicodeMappingListOrDoubleList gbuf;
-  GlyphUnicodeMappingList gbuf1;
-  
-  while (!is_nil(drawn_glyphs)) {
-    SI xx,yy,ww;
-    SI bx, by;
-    x = drawn_glyphs->item.x1;
-    y = drawn_glyphs->item.x2;
-    w = drawn_glyphs->item.x4->lwidth*pixel;// - drawn_glyphs->item.x4->xoff;
-    bx = x; by = y;
-    while (1) {
-      drawn_glyph dg = drawn_glyphs->item;
-      //debug_convert << "pushing " << dg.x4->index << " " << dg.x3 << LF;
-      gbuf1.push_back(GlyphUnicodeMapping(dg.x4->index,dg.x3));
-      drawn_glyphs = drawn_glyphs->next;
-      if (is_nil(drawn_glyphs)) break;
-      
-      dg = drawn_glyphs->item;
-      
-      xx = dg.x1;
-      yy = dg.x2;
-      ww = dg.x4->lwidth*pixel;// - dg.x4->xoff;
-      
-      if (yy != y) break;
-      
-      SI dx = xx-x-w;
-      if ((dx >= 4*pixel)||(dx <=-4*pixel)) {
-        if (gbuf1.size()>0) {
-          gbuf.push_back(gbuf1);
-          gbuf1.clear();
-        }
-        gbuf.push_back((double)(-dx*(1000.0/pixel)/fsize));
-      } else dx = 0;
-      x = x+w+dx;
-      w = ww;
-    }
-    if (gbuf1.size()>0) {
-      gbuf.push_back(gbuf1);
-      gbuf1.clear();
-    }
-    
-    contentContext->Td(bx/pixel-prev_text_x, by/pixel-prev_text_y);
-    prev_text_x = bx/pixel;
-    prev_text_y = by/pixel;
-    //contentContext->Tm(1,0,0,1, p*bx/PIXEL, p*by/PIXEL);
-    contentContext->TJ(gbuf);
-    gbuf.clear();
+double
+pdf_hummus_renderer_rep::glyph_advance (int index) {
+  // width of a glyph of the current font in thousandths of the font size
+  double adv= cadv [index];
+  if (adv < 0.0) {
+    UIntList l;
+    l.push_back ((unsigned int) index);
+    adv= cfid->CalculateTextAdvance (l, 1000.0);
+    cadv (index)= adv;
   }
+  return adv;
+}
+
+void
+pdf_hummus_renderer_rep::draw_glyphs () {
+  if (!run_open) return;
+  run_open= false;
+  contentContext->Td (run_x - prev_text_x, run_y - prev_text_y);
+  prev_text_x= run_x;
+  prev_text_y= run_y;
+  if (run_kerned) {
+    if (run_glyphs.size () > 0) run.push_back (run_glyphs);
+    contentContext->TJ (run);
+    run.clear ();
+  }
+  else contentContext->Tj (run_glyphs);
+  run_glyphs.clear ();
+  run_kerned= false;
 }
 
 static double
@@ -1315,14 +1339,12 @@ pdf_hummus_renderer_rep::draw (int ch, font_glyphs fn, SI x, SI y) {
       return;
     }
   }
-  string char_name (fontname * "-" * as_string ((int) ch));
-  pdf_raw_image glyph;
   if (cfn != fontname) {
     if (!pdf_fonts [fontname]) {
       if (!t3font_list->contains(fontname)) {
         make_pdf_font (fontname);
         if (!pdf_fonts [fontname]) {
-          t3font f(fn,  pdfWriter.GetObjectsContext());
+          t3font f(fn,  pdfWriter.GetObjectsContext(), t3_procs);
           t3font_list(fontname) = f;
         }
       }
@@ -1334,6 +1356,8 @@ pdf_hummus_renderer_rep::draw (int ch, font_glyphs fn, SI x, SI y) {
     fsize = font_size (fontname);
     if (pdf_fonts->contains(fontname)) {
       cfid = pdf_fonts (cfn);
+      if (!advances->contains (cfn)) advances (cfn)= hashmap<int,double> (-1.0);
+      cadv = advances [cfn];
       contentContext->Tf(cfid, fsize);
     } else {
       cfid = NULL;
@@ -1346,17 +1370,29 @@ pdf_hummus_renderer_rep::draw (int ch, font_glyphs fn, SI x, SI y) {
   }
   if (cfid != NULL) {
     begin_text ();
-#if 1
-    contentContext->Td(to_x(x)-prev_text_x, to_y(y)-prev_text_y);
-    prev_text_x = to_x(x);
-    prev_text_y = to_y(y);
-    //debug_convert << "char " << ch << "index " << gl->index <<" " << x << " " << y << " font " << cfn  << LF;
-    GlyphUnicodeMappingList glyphs;
-    glyphs.push_back(GlyphUnicodeMapping(gl->index, ch));
-    contentContext->Tj(glyphs);
-#else
-    drawn_glyphs << drawn_glyph(ox+x,oy+y,ch,gl);
-#endif
+    double gx= to_x (x), gy= to_y (y);
+    if (run_open && gy != run_y) draw_glyphs ();
+    if (!run_open) {
+      run_open= true;
+      run_x= run_pen= gx;
+      run_y= gy;
+    }
+    else if (fabs (gx - run_pen) >= 0.5) {
+      // offsets are in thousandths of the font size, in the opposite
+      // direction; smaller deviations than half a pixel are ignored
+      double off= floor ((run_pen - gx) * 1000.0 / fsize + 0.5);
+      if (off != 0.0) {
+        if (run_glyphs.size () > 0) {
+          run.push_back (run_glyphs);
+          run_glyphs.clear ();
+        }
+        run.push_back (off);
+        run_kerned= true;
+        run_pen -= off * fsize / 1000.0;
+      }
+    }
+    run_glyphs.push_back (GlyphUnicodeMapping (gl->index, ch));
+    run_pen += glyph_advance (gl->index) * fsize / 1000.0;
   } else {
     begin_text ();
     contentContext->Td(to_x(x)-prev_text_x, to_y(y)-prev_text_y);
@@ -1518,6 +1554,18 @@ pdf_hummus_renderer_rep::polygon (array<SI> x, array<SI> y, bool convex) {
     contentContext->fStar(); // nonzero winding
 }
 
+void
+pdf_image_rep::prefetch ()
+{
+  // start converting the image in the background, so that
+  // the conversion in flush can be picked up from the image cache
+  url name= resolve (u);
+  if (is_none (name)) return;
+  string s= suffix (name);
+  if (s == "pdf" || s == "jpg" || s == "jpeg") return;
+  image_cache_prefetch (name, "pdf", w, h, 300);
+}
+
 void
 pdf_image_rep::flush (PDFWriter& pdfw)
 {
@@ -1891,11 +1939,27 @@ pdf_image_rep::flush_jpg (PDFWriter& pdfw, url image) {
   return status == eSuccess;
 }
 
+tree
+pdf_hummus_renderer_rep::image_key (url u) {
+  // identical image files are embedded only once
+  tree t= tuple (u->t);
+  if (image_keys->contains (t)) return image_keys[t];
+  string h= image_content_hash (u);
+  tree key= (h == ""? t: tuple ("content", h));
+  image_keys (t)= key;
+  return key;
+}
+
 void
 pdf_hummus_renderer_rep::flush_images ()
 {
-  // flush all images
+  // convert images concurrently before embedding them
   iterator<tree> it = iterate (image_pool);
+  while (it->busy())
+    image_pool[it->next()]->prefetch();
+  wait_image_conversions ();
+  // flush all images
+  it = iterate (image_pool);
   while (it->busy()) {
     pdf_image im = image_pool[it->next()];
     im->flush(pdfWriter);
@@ -1924,7 +1988,7 @@ pdf_hummus_renderer_rep::image (
   url u, SI w, SI h, SI x, SI y, int alpha)
 {
   // debug_convert << "image " << u << LF;
-  tree lookup= tuple (u->t);
+  tree lookup= image_key (u);
   pdf_image im = ( image_pool->contains(lookup) ? image_pool[lookup] : pdf_image() );
   
   if (is_nil(im)) {
@@ -2338,7 +2402,6 @@ pdf_hummus_renderer (url pdf_file_name, int dpi, int nr_pages,
                      string page_type, bool landscape, double paper_w, double paper_h)
 {
   //cout << "Hummus print to " << pdf_file_name << " at " << dpi << " dpi\n";
-  page_type= as_string (call ("standard-paper-size", object (page_type)));
   return tm_new<pdf_hummus_renderer_rep> (pdf_file_name, dpi, nr_pages,
 			  page_type, landscape, paper_w, paper_h);
 }
@@ -329,8 +329,73 @@ unix_system (array<string> arg,
   return WEXITSTATUS(status);
 }
 
+/******************************************************************************
+* Asynchronous evaluation
+******************************************************************************/
+
+int
+unix_spawn (string cmd) {
+  // Launch cmd in the background and return its pid, or -1 on failure
+  c_string _cmd (cmd * " > /dev/null 2>&1");
+  char* arg[]= { (char*) "sh", (char*) "-c", (char*) _cmd, (char*) NULL };
+  pid_t pid;
+  if (posix_spawn (&pid, "/bin/sh", NULL, NULL, arg, environ) != 0)
+    return -1;
+  if (DEBUG_IO) debug_io << "unix_spawn, pid " << pid << ": " << cmd << "\n";
+  return (int) pid;
+}
+
+bool
+unix_terminated (int pid, int& ret) {
+  // Check without blocking whether a spawned process has terminated
+  int status;
+  pid_t wret= waitpid ((pid_t) pid, &status, WNOHANG);
+  if (wret == 0) return false;
+  if (wret < 0 || WIFEXITED(status) == 0) ret= -1;
+  else ret= WEXITSTATUS(status);
+  return true;
+}
+
+int
+unix_processors () {
+  long n= sysconf (_SC_NPROCESSORS_ONLN);
+  return n > 0? (int) n: 1;
+}
+
+int
+unix_fork () {
+  // Fork the current process; return 0 in the child, the pid of the
+  // child in the parent, or -1 on failure
+  pid_t pid= fork ();
+  if (DEBUG_IO && pid > 0) debug_io << "unix_fork, pid " << pid << "\n";
+  return (int) pid;
+}
+
 #else
 
+int
+unix_spawn (string cmd) {
+  (void) cmd;
+  return -1;
+}
+
+bool
+unix_terminated (int pid, int& ret) {
+  (void) pid;
+  ret= -1;
+  return true;
+}
+
+int
+unix_processors () {
+  return 1;
+}
+
+int
+unix_fork () {
+  return -1;
+}
+
 int
 unix_system (array<string> arg,
 	     array<int> fd_in, array<string> str_in,
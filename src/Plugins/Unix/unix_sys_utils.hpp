@@ -19,6 +19,11 @@ int unix_system (string);
 int unix_system (string, string&);
 int unix_system (string, string&, string&);
 
+int  unix_spawn (string cmd);
+bool unix_terminated (int pid, int& ret);
+int  unix_processors ();
+int  unix_fork ();
+
 int unix_system (array<string> arg,
 		 array<int> fd_in, array<string> str_in,
 		 array<int> fd_out, array<string*> str_out);
@@ -71,6 +71,7 @@
   (bench-print bench_print (void string))
   (bench-print-all bench_print (void))
   (system-wait system_wait (void string string))
+  (convert-batch convert_batch (bool url int))
   (set-latex-command set_latex_command (void string))
   (set-bibtex-command set_bibtex_command (void string))
   (number-latex-errors number_latex_errors (int url))
@@ -115,6 +116,8 @@
   (mark-new new_marker (double))
   (glyph-register register_glyph (void string array_array_array_double))
   (glyph-recognize recognize_glyph (string array_array_array_double))
+  (glyph-index-load load_glyph_index (bool url url))
+  (glyph-index-save save_glyph_index (bool url url))
   (set-new-fonts set_new_fonts (void bool))
   (new-fonts? get_new_fonts (bool))
   (tmtm-eqnumber->nonumber eqnumber_to_nonumber (tree tree))
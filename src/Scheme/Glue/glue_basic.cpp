@@ -582,6 +582,21 @@ tmg_system_wait (tmscm arg1, tmscm arg2) {
   return TMSCM_UNSPECIFIED;
 }
 
+tmscm
+tmg_convert_batch (tmscm arg1, tmscm arg2) {
+  TMSCM_ASSERT_URL (arg1, TMSCM_ARG1, "convert-batch");
+  TMSCM_ASSERT_INT (arg2, TMSCM_ARG2, "convert-batch");
+
+  url in1= tmscm_to_url (arg1);
+  int in2= tmscm_to_int (arg2);
+
+  // TMSCM_DEFER_INTS;
+  bool out= convert_batch (in1, in2);
+  // TMSCM_ALLOW_INTS;
+
+  return bool_to_tmscm (out);
+}
+
 tmscm
 tmg_set_latex_command (tmscm arg1) {
   TMSCM_ASSERT_STRING (arg1, TMSCM_ARG1, "set-latex-command");
@@ -1132,6 +1147,36 @@ tmg_glyph_recognize (tmscm arg1) {
   return string_to_tmscm (out);
 }
 
+tmscm
+tmg_glyph_index_load (tmscm arg1, tmscm arg2) {
+  TMSCM_ASSERT_URL (arg1, TMSCM_ARG1, "glyph-index-load");
+  TMSCM_ASSERT_URL (arg2, TMSCM_ARG2, "glyph-index-load");
+
+  url in1= tmscm_to_url (arg1);
+  url in2= tmscm_to_url (arg2);
+
+  // TMSCM_DEFER_INTS;
+  bool out= load_glyph_index (in1, in2);
+  // TMSCM_ALLOW_INTS;
+
+  return bool_to_tmscm (out);
+}
+
+tmscm
+tmg_glyph_index_save (tmscm arg1, tmscm arg2) {
+  TMSCM_ASSERT_URL (arg1, TMSCM_ARG1, "glyph-index-save");
+  TMSCM_ASSERT_URL (arg2, TMSCM_ARG2, "glyph-index-save");
+
+  url in1= tmscm_to_url (arg1);
+  url in2= tmscm_to_url (arg2);
+
+  // TMSCM_DEFER_INTS;
+  bool out= save_glyph_index (in1, in2);
+  // TMSCM_ALLOW_INTS;
+
+  return bool_to_tmscm (out);
+}
+
 tmscm
 tmg_set_new_fonts (tmscm arg1) {
   TMSCM_ASSERT_BOOL (arg1, TMSCM_ARG1, "set-new-fonts");
@@ -9505,6 +9550,7 @@ initialize_glue_basic () {
   tmscm_install_procedure ("bench-print",  tmg_bench_print, 1, 0, 0);
   tmscm_install_procedure ("bench-print-all",  tmg_bench_print_all, 0, 0, 0);
   tmscm_install_procedure ("system-wait",  tmg_system_wait, 2, 0, 0);
+  tmscm_install_procedure ("convert-batch",  tmg_convert_batch, 2, 0, 0);
   tmscm_install_procedure ("set-latex-command",  tmg_set_latex_command, 1, 0, 0);
   tmscm_install_procedure ("set-bibtex-command",  tmg_set_bibtex_command, 1, 0, 0);
   tmscm_install_procedure ("number-latex-errors",  tmg_number_latex_errors, 1, 0, 0);
@@ -9549,6 +9595,8 @@ initialize_glue_basic () {
   tmscm_install_procedure ("mark-new",  tmg_mark_new, 0, 0, 0);
   tmscm_install_procedure ("glyph-register",  tmg_glyph_register, 2, 0, 0);
   tmscm_install_procedure ("glyph-recognize",  tmg_glyph_recognize, 1, 0, 0);
+  tmscm_install_procedure ("glyph-index-load",  tmg_glyph_index_load, 2, 0, 0);
+  tmscm_install_procedure ("glyph-index-save",  tmg_glyph_index_save, 2, 0, 0);
   tmscm_install_procedure ("set-new-fonts",  tmg_set_new_fonts, 1, 0, 0);
   tmscm_install_procedure ("new-fonts?",  tmg_new_fontsP, 0, 0, 0);
   tmscm_install_procedure ("tmtm-eqnumber->nonumber",  tmg_tmtm_eqnumber_2nonumber, 1, 0, 0);
@@ -2855,6 +2855,15 @@ tmg_update_forced () {
   return TMSCM_UNSPECIFIED;
 }
 
+tmscm
+tmg_update_provisionalP () {
+  // TMSCM_DEFER_INTS;
+  bool out= get_current_editor()->typeset_provisional ();
+  // TMSCM_ALLOW_INTS;
+
+  return bool_to_tmscm (out);
+}
+
 tmscm
 tmg_update_path (tmscm arg1) {
   TMSCM_ASSERT_PATH (arg1, TMSCM_ARG1, "update-path");
@@ -3545,6 +3554,7 @@ initialize_glue_editor () {
   tmscm_install_procedure ("clear-local-info",  tmg_clear_local_info, 0, 0, 0);
   tmscm_install_procedure ("refresh-window",  tmg_refresh_window, 0, 0, 0);
   tmscm_install_procedure ("update-forced",  tmg_update_forced, 0, 0, 0);
+  tmscm_install_procedure ("update-provisional?",  tmg_update_provisionalP, 0, 0, 0);
   tmscm_install_procedure ("update-path",  tmg_update_path, 1, 0, 0);
   tmscm_install_procedure ("update-current-buffer",  tmg_update_current_buffer, 0, 0, 0);
   tmscm_install_procedure ("update-players",  tmg_update_players, 2, 0, 0);
@@ -927,6 +927,8 @@ tmscm_to_array_array_array_double (tmscm p) {
 
 void register_glyph (string s, array_array_array_double gl);
 string recognize_glyph (array_array_array_double gl);
+bool load_glyph_index (url index, url source);
+bool save_glyph_index (url index, url source);
 
 
 
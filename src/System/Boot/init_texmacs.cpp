@@ -17,6 +17,7 @@
 #include "merge_sort.hpp"
 #include "drd_std.hpp"
 #include "language.hpp"
+#include "image_files.hpp"
 #include <unistd.h>
 #ifdef OS_MINGW
 #include <time.h>
@@ -209,6 +210,7 @@ init_user_dirs () {
   make_dir ("$TEXMACS_HOME_PATH/system");
   make_dir ("$TEXMACS_HOME_PATH/system/bib");
   make_dir ("$TEXMACS_HOME_PATH/system/cache");
+  make_dir ("$TEXMACS_HOME_PATH/system/cache/images");
   make_dir ("$TEXMACS_HOME_PATH/system/database");
   make_dir ("$TEXMACS_HOME_PATH/system/database/bib");
   make_dir ("$TEXMACS_HOME_PATH/system/tmp");
@@ -218,6 +220,7 @@ init_user_dirs () {
   change_mode ("$TEXMACS_HOME_PATH/system", 7 << 6);
   change_mode ("$TEXMACS_HOME_PATH/users", 7 << 6);
   clean_temp_dirs ();
+  image_cache_prune ();
 }
 
 /******************************************************************************
@@ -32,8 +32,11 @@
 #include "sys_utils.hpp"
 #include "analyze.hpp"
 #include "hashmap.hpp"
+#include "merge_sort.hpp"
 #include "scheme.hpp"
+#include "process_pool.hpp"
 #include "Imlib2/imlib2.hpp"
+#include <time.h>
 
 #ifdef MACOSX_EXTENSIONS
 #include "MacOS/mac_images.h"
@@ -368,8 +371,8 @@ pdf_image_size (url image, int& w, int& h) {
 * displaying and printing : png, eps, pdf
 ******************************************************************************/
 
-void
-image_to_eps (url image, url eps, int w_pt, int h_pt, int dpi) {
+static void
+image_to_eps_sub (url image, url eps, int w_pt, int h_pt, int dpi) {
   if (DEBUG_CONVERT) debug_convert << "image_to_eps ...";
   /* if ((suffix (eps) != "eps") && (suffix (eps) != "ps")) {
      std_warning << concretize (eps) << " has no .eps or .ps suffix\n";
@@ -418,8 +421,8 @@ image_to_psdoc (url image) {
 }
 
 //mostly the same code as image_to_eps 
-void 
-image_to_pdf (url image, url pdf, int w_pt, int h_pt, int dpi) {
+static void
+image_to_pdf_sub (url image, url pdf, int w_pt, int h_pt, int dpi) {
   if (DEBUG_CONVERT) debug_convert << "image_to_pdf ... ";
   string s= suffix (image);
   // First try to preserve "vectorialness"
@@ -443,8 +446,8 @@ image_to_pdf (url image, url pdf, int w_pt, int h_pt, int dpi) {
   call_imagemagick_convert(image, pdf, w_pt, h_pt, dpi);
 }
 
-void
-image_to_png (url image, url png, int w, int h) {// IN PIXEL UNITS!
+static void
+image_to_png_sub (url image, url png, int w, int h) {// IN PIXEL UNITS!
   if (DEBUG_CONVERT) debug_convert << "image_to_png ... ";
   /* if (suffix (png) != "png") {
      std_warning << concretize (png) << " has no .png suffix\n";
@@ -473,17 +476,18 @@ image_to_png (url image, url png, int w, int h) {// IN PIXEL UNITS!
 #endif
   if (call_scm_converter(image, png)) return;
   call_imagemagick_convert (image, png, w, h);
-  if (! exists(png)) {
-    convert_error << image << " could not be converted to png" <<LF;
-    copy("$TEXMACS_PATH/misc/pixmaps/unknown.png",png);
-    } 
+}
+
+static bool
+has_scm_converter (url image, url dest) {
+  return as_bool (call ("file-converter-exists?",
+                        "x." * suffix (image),
+                        "x." * suffix (dest)));
 }
 
 bool
 call_scm_converter(url image, url dest) {
-  if (as_bool (call ("file-converter-exists?",
-                     "x." * suffix (image),
-                     "x." * suffix (dest)))) {
+  if (has_scm_converter (image, dest)) {
     call ("file-convert", object (image), object (dest));
     bool success= exists (dest);
     if (success && DEBUG_CONVERT)
@@ -494,6 +498,243 @@ call_scm_converter(url image, url dest) {
   return false;
 }
 
+/******************************************************************************
+* Persistent cache of converted images
+* Conversions by external programs are stored in the user's cache directory
+* under a name which is determined by the contents of the image, the target
+* format and the requested size, so that they survive across sessions and
+* renamed or copied files.  Conversions by Qt or MacOS are cheap and
+* are not cached, since this would only duplicate the images on disk.
+* Since on screen conversions depend on the zoom, the cache is pruned at
+* startup: images which were not used for a month are removed, and so are
+* the least recently used ones if the cache exceeds its size limit.
+******************************************************************************/
+
+#define IMAGE_CACHE_AGE    (30 * 24 * 3600)  // seconds before removal
+#define IMAGE_CACHE_BUDGET (256 << 20)       // bytes of cached images
+#define IMAGE_CACHE_TOUCH  (24 * 3600)       // seconds between refreshes
+
+static hashmap<tree,string> image_hashes ("");
+
+string
+image_content_hash (url image) {
+  tree key= tuple (image->t, as_string (last_modified (image, false)));
+  if (image_hashes->contains (key)) return image_hashes [key];
+  string s;
+  if (load_string (image, s, false)) return "";
+  DN h1= 14695981039346656037ULL, h2= 5381;
+  for (int i=0; i<N(s); i++) {
+    DN c= (unsigned char) s[i];
+    h1= (h1 ^ c) * 1099511628211ULL;
+    h2= (h2 << 5) + h2 + c;
+  }
+  string r;
+  r << as_hexadecimal ((int) (h1 >> 32), 8)
+    << as_hexadecimal ((int) h1, 8)
+    << as_hexadecimal ((int) (h2 >> 32), 8)
+    << as_hexadecimal ((int) h2, 8)
+    << "-" << as_string (N(s));
+  image_hashes (key)= r;
+  return r;
+}
+
+static bool
+image_cache_applies (url image, string target) {
+  string s= suffix (image);
+#ifdef MACOSX_EXTENSIONS
+  if (target == "png" && mac_supports (image)) return false;
+#endif
+#ifdef QTTEXMACS
+  if (s != "svg" && qt_supports (image)) return false;
+  if (target == "png" && qt_supports (image)) return false;
+#endif
+  (void) s;
+  return is_regular (image);
+}
+
+static url
+image_cache_url (url image, string target, int w, int h, int dpi) {
+  if (!image_cache_applies (image, target)) return url_none ();
+  string hash= image_content_hash (image);
+  if (hash == "") return url_none ();
+  string name= hash * "-" * as_string (w) * "x" * as_string (h) *
+               "-" * as_string (dpi) * "." * target;
+  return url ("$TEXMACS_HOME_PATH/system/cache/images") * url (name);
+}
+
+static bool
+image_cache_load (url cached, url dest) {
+  if (is_none (cached) || !is_regular (cached)) return false;
+  if (DEBUG_CONVERT) debug_convert << "cached conversion " << cached << LF;
+  copy (cached, dest);
+  if (!exists (dest)) return false;
+  // rewrite images which are still in use, so that their modification
+  // time tells when they were last used
+  if (((int) time (NULL)) - last_modified (cached, false) > IMAGE_CACHE_TOUCH)
+    copy (dest, cached);
+  return true;
+}
+
+static void
+image_cache_save (url cached, url dest) {
+  if (is_none (cached) || !is_regular (dest)) return;
+  copy (dest, cached);
+}
+
+void
+image_cache_prune (int max_age, int budget) {
+  // remove the cached images which were not used during max_age seconds,
+  // followed by the least recently used ones until at most budget bytes
+  // remain in the cache
+  url dir ("$TEXMACS_HOME_PATH/system/cache/images");
+  bool err= false;
+  array<string> a= read_directory (dir, err);
+  if (err) return;
+  int now= (int) time (NULL), total= 0;
+  array<int> stamps;
+  array<string> names;
+  for (int i=0; i<N(a); i++) {
+    url u= dir * url (a[i]);
+    if (a[i] == "." || a[i] == ".." || !is_regular (u)) continue;
+    int stamp= last_modified (u, false);
+    if (now - stamp > max_age) remove (u);
+    else {
+      stamps << stamp;
+      names << a[i];
+      total += max (file_size (u), 0);
+    }
+  }
+  if (total <= budget) return;
+  merge_sort_leq<int,string,less_eq_operator<int> > (stamps, names);
+  for (int i=0; i<N(names) && total > budget; i++) {
+    url u= dir * url (names[i]);
+    total -= max (file_size (u), 0);
+    remove (u);
+  }
+}
+
+void
+image_cache_prune () {
+  image_cache_prune (IMAGE_CACHE_AGE, IMAGE_CACHE_BUDGET);
+}
+
+void
+image_to_eps (url image, url eps, int w_pt, int h_pt, int dpi) {
+  url cached= image_cache_url (image, suffix (eps), w_pt, h_pt, dpi);
+  if (image_cache_load (cached, eps)) return;
+  image_to_eps_sub (image, eps, w_pt, h_pt, dpi);
+  image_cache_save (cached, eps);
+}
+
+void
+image_to_pdf (url image, url pdf, int w_pt, int h_pt, int dpi) {
+  url cached= image_cache_url (image, "pdf", w_pt, h_pt, dpi);
+  if (image_cache_load (cached, pdf)) return;
+  image_to_pdf_sub (image, pdf, w_pt, h_pt, dpi);
+  image_cache_save (cached, pdf);
+}
+
+void
+image_to_png (url image, url png, int w, int h) {
+  url cached= image_cache_url (image, "png", w, h, 0);
+  if (image_cache_load (cached, png)) return;
+  image_to_png_sub (image, png, w, h);
+  if (exists (png)) image_cache_save (cached, png);
+  else {
+    convert_error << image << " could not be converted to png" <<LF;
+    copy("$TEXMACS_PATH/misc/pixmaps/unknown.png",png);
+  }
+}
+
+/******************************************************************************
+* Asynchronous conversions
+* Conversions which require an external program are run by a bounded pool
+* of concurrent processes, whose results go to the persistent cache.
+* Conversions by Qt and by scheme converters remain synchronous.
+******************************************************************************/
+
+#define IMAGE_CONVERSION_JOBS 4
+
+static process_pool image_pool (IMAGE_CONVERSION_JOBS);
+
+class image_job_command_rep: public command_rep {
+  url dest, cached;
+  command done;
+public:
+  image_job_command_rep (url dest2, url cached2, command done2):
+    dest (dest2), cached (cached2), done (done2) {}
+  void apply () {
+    if (exists (dest)) image_cache_save (cached, dest);
+    else convert_error << "could not generate " << dest << LF;
+    if (is_nil (done)) remove (dest);
+    else done ();
+  }
+};
+
+static string
+image_convert_cmd (url image, url dest, int w, int h, int dpi) {
+  // the external command which image_to_png or image_to_pdf would use,
+  // or "" if the conversion is done in-process
+  string s= suffix (image), t= suffix (dest);
+  if (t == "png") {
+#ifdef MACOSX_EXTENSIONS
+    if (mac_supports (image)) return "";
+#endif
+#ifdef QTTEXMACS
+    if (qt_supports (image)) return "";
+#endif
+#ifdef USE_GS
+    if (gs_supports (image)) return gs_to_png_cmd (image, dest, w, h);
+#endif
+    if (has_scm_converter (image, dest)) return "";
+    return imagemagick_convert_cmd (image, dest, w, h);
+  }
+  if (t == "pdf") {
+    if (s == "svg" && has_scm_converter (image, dest)) return "";
+#ifdef USE_GS
+    if (gs_supports (image)) return gs_to_pdf_cmd (image, dest, w, h);
+#endif
+#ifdef QTTEXMACS
+    if (qt_supports (image)) return "";
+#endif
+    if (has_scm_converter (image, dest)) return "";
+    return imagemagick_convert_cmd (image, dest, w, h, dpi);
+  }
+  return "";
+}
+
+bool
+image_convert_async (url image, url dest, int w, int h, int dpi,
+                     command done) {
+  // Start converting image into dest in the background and apply done
+  // once the result is available.  Returns false if nothing was started,
+  // because the result is cached or because the conversion is done
+  // in-process; the caller should then convert synchronously.
+  url cached= image_cache_url (image, suffix (dest), w, h, dpi);
+  if (is_none (cached) || is_regular (cached)) return false;
+  string cmd= image_convert_cmd (image, dest, w, h, dpi);
+  if (cmd == "") return false;
+  if (DEBUG_CONVERT) debug_convert << "queued " << cmd << LF;
+  image_pool->submit (cmd, tm_new<image_job_command_rep> (dest, cached, done));
+  return true;
+}
+
+void
+image_cache_prefetch (url image, string target, int w, int h, int dpi) {
+  url temp= url_temp ("." * target);
+  (void) image_convert_async (image, temp, w, h, dpi, command ());
+}
+
+bool
+poll_image_conversions () {
+  return image_pool->poll ();
+}
+
+void
+wait_image_conversions () {
+  image_pool->wait ();
+}
+
 /******************************************************************************
 * Imagemagick stuff 
 * last resort solution -- should rarely be useful.
@@ -524,8 +765,8 @@ imagemagick_cmd () {
   else return "";
 }
 
-void
-call_imagemagick_convert (url image, url dest, int w_pt, int h_pt, int dpi) {
+string
+imagemagick_convert_cmd (url image, url dest, int w_pt, int h_pt, int dpi) {
   if (has_image_magick ()) { 
     string cmd= imagemagick_cmd ();
     string s= suffix (image);
@@ -540,8 +781,15 @@ call_imagemagick_convert (url image, url dest, int w_pt, int h_pt, int dpi) {
         cmd << " -resize " * as_string (ww) * "x" * as_string (hh) * "!";
       }
     }
-    system (cmd, image, dest);
+    return cmd * " " * sys_concretize (image) * " " * sys_concretize (dest);
   }
+  return "";
+}
+
+void
+call_imagemagick_convert (url image, url dest, int w_pt, int h_pt, int dpi) {
+  string cmd= imagemagick_convert_cmd (image, dest, w_pt, h_pt, dpi);
+  if (cmd != "") system (cmd);
 }
 
 bool
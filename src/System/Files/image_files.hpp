@@ -12,6 +12,7 @@
 #ifndef IMAGE_FILES_H
 #define IMAGE_FILES_H
 #include "url.hpp"
+#include "command.hpp"
 
 tree          xpm_load (url file_name);
 void          xpm_size (url file_name, int& w, int& h);
@@ -30,9 +31,17 @@ string        image_to_psdoc (url image);
 void          image_to_png (url image, url png, int w= 0, int h= 0);
 bool          call_scm_converter(url image, url dest);
 void          call_imagemagick_convert(url image, url dest, int w_pt=0, int h_pt=0, int dpi=72);
+string        imagemagick_convert_cmd(url image, url dest, int w_pt=0, int h_pt=0, int dpi=72);
 bool          imagemagick_image_size(url image, int& w, int& h, bool pt_units=true);
 bool          has_image_magick();
 string        imagemagick_cmd();
 void          apply_effect (tree eff, array<url> src, url dest, int w, int h);
+string        image_content_hash (url image);
+bool          image_convert_async (url image, url dest, int w, int h, int dpi, command done);
+void          image_cache_prefetch (url image, string target, int w, int h, int dpi);
+void          image_cache_prune (int max_age, int budget);
+void          image_cache_prune ();
+bool          poll_image_conversions ();
+void          wait_image_conversions ();
 
 #endif // defined IMAGE_FILES_H
@@ -0,0 +1,100 @@
+
+/******************************************************************************
+* MODULE     : process_pool.cpp
+* DESCRIPTION: Bounded pools of concurrently running external commands
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "process_pool.hpp"
+#include "sys_utils.hpp"
+#ifndef OS_MINGW
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+* Constructors and basic routines
+******************************************************************************/
+
+process_pool_rep::process_pool_rep (int max_running2):
+  max_running (max (max_running2, 1)) {}
+
+process_pool::process_pool (int max_running):
+  rep (tm_new<process_pool_rep> (max_running)) {}
+
+int
+process_pool_rep::pending () {
+  return N(queued) + N(running);
+}
+
+int
+process_pool_rep::active () {
+  return N(running);
+}
+
+/******************************************************************************
+* Starting and reaping processes
+******************************************************************************/
+
+void
+process_pool_rep::start () {
+  while (N(queued) > 0 && N(running) < max_running) {
+    string  cmd = queued[0];
+    command done= queued_done[0];
+    queued     = range (queued, 1, N(queued));
+    queued_done= range (queued_done, 1, N(queued_done));
+    int pid= spawn_system (cmd);
+    if (pid < 0) {
+      (void) system (cmd);
+      if (!is_nil (done)) done ();
+    }
+    else {
+      running      << pid;
+      running_done << done;
+    }
+  }
+}
+
+void
+process_pool_rep::submit (string cmd, command done) {
+  queued      << cmd;
+  queued_done << done;
+  start ();
+}
+
+bool
+process_pool_rep::poll () {
+  // Reap the terminated processes, apply their completion commands
+  // and start queued ones; return true if some process terminated
+  array<int> still;
+  array<command> still_done, finished;
+  for (int i=0; i<N(running); i++) {
+    int ret;
+    if (system_terminated (running[i], ret)) finished << running_done[i];
+    else {
+      still      << running[i];
+      still_done << running_done[i];
+    }
+  }
+  if (N(finished) == 0) return false;
+  running     = still;
+  running_done= still_done;
+  start ();
+  for (int i=0; i<N(finished); i++)
+    if (!is_nil (finished[i])) finished[i] ();
+  return true;
+}
+
+void
+process_pool_rep::wait () {
+  // Without asynchronous processes, nothing remains pending after submit
+  while (pending () > 0)
+    if (!poll ()) {
+#ifndef OS_MINGW
+      usleep (1000);
+#endif
+    }
+}
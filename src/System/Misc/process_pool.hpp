@@ -0,0 +1,50 @@
+
+/******************************************************************************
+* MODULE     : process_pool.hpp
+* DESCRIPTION: Bounded pools of concurrently running external commands
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef PROCESS_POOL_H
+#define PROCESS_POOL_H
+#include "command.hpp"
+
+/******************************************************************************
+* A process pool runs at most max_running external commands at a time;
+* further commands are queued in the order in which they were submitted.
+* Termination is detected by polling, so that the completion commands
+* are always applied from the thread which polls the pool.
+* On systems without asynchronous processes, commands are executed
+* synchronously upon submission.
+******************************************************************************/
+
+class process_pool_rep: concrete_struct {
+  int             max_running;  // maximal number of concurrent processes
+  array<string>   queued;       // commands which have not been started yet
+  array<command>  queued_done;
+  array<int>      running;      // identifiers of the running processes
+  array<command>  running_done;
+
+  void start ();
+
+public:
+  process_pool_rep (int max_running);
+  void submit (string cmd, command done);
+  int  pending ();
+  int  active ();
+  bool poll ();
+  void wait ();
+  friend class process_pool;
+};
+
+class process_pool {
+CONCRETE(process_pool);
+  process_pool (int max_running= 4);
+};
+CONCRETE_CODE(process_pool);
+
+#endif // defined PROCESS_POOL_H
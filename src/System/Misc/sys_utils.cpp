@@ -80,6 +80,50 @@ var_eval_system (string s) {
   return r;
 }
 
+int
+spawn_system (string s) {
+  // Launch s in the background and return a process identifier,
+  // or -1 if this is not supported, in which case the caller should
+  // fall back on a synchronous call of system (s)
+  if (DEBUG_STD) debug_shell << s << " &\n";
+#if defined (OS_MINGW)
+  return -1;
+#else
+  return unix_spawn (s);
+#endif
+}
+
+bool
+system_terminated (int pid, int& ret) {
+#if defined (OS_MINGW)
+  (void) pid;
+  ret= -1;
+  return true;
+#else
+  return unix_terminated (pid, ret);
+#endif
+}
+
+int
+number_of_processors () {
+#if defined (OS_MINGW)
+  return 1;
+#else
+  return unix_processors ();
+#endif
+}
+
+int
+fork_process () {
+  // Duplicate the current process, as in fork (); return -1
+  // on systems which do not support this
+#if defined (OS_MINGW)
+  return -1;
+#else
+  return unix_fork ();
+#endif
+}
+
 string
 get_env (string var) {
   c_string _var (var);
@@ -22,6 +22,10 @@ int    system (string s, string &r);
 int    system (string s, string &r, string& e);
 string eval_system (string s);
 string var_eval_system (string s);
+int    spawn_system (string s);
+bool   system_terminated (int pid, int& ret);
+int    number_of_processors ();
+int    fork_process ();
 string get_env (string var);
 void   set_env (string var, string with);
 int    os_version ();
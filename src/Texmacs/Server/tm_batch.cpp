@@ -0,0 +1,224 @@
+
+/******************************************************************************
+* MODULE     : tm_batch.cpp
+* DESCRIPTION: Conversion of collections of documents on several processes
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* The typesetter, the fonts and the global caches assume a single thread.
+* Collections of documents are therefore converted in parallel by forking
+* one worker process per document from the initialized parent process,
+* which shares its loaded fonts, styles and scheme state with the workers
+* by copy on write.  The parent itself never converts a document, so that
+* every conversion starts from the same state: the output is the same
+* whatever the number of workers and the order in which they terminate.
+* A crash of a worker only affects the conversion of its own document.
+* Forking is only safe if the parent holds no connection to a display and
+* runs no other threads, so that workers are only used for headless Qt
+* sessions (QT_QPA_PLATFORM=offscreen or minimal).  Otherwise, all documents
+* are converted one after another by the process itself.
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "server.hpp"
+#include "file.hpp"
+#include "sys_utils.hpp"
+#include "analyze.hpp"
+#include "tm_timer.hpp"
+#ifndef OS_MINGW
+#include <unistd.h>
+#endif
+
+#define BATCH_WAITING  0
+#define BATCH_RUNNING  1
+#define BATCH_OK       2
+#define BATCH_FAILED   3
+#define BATCH_CRASHED  4
+
+struct batch_job {
+  url    in, out;
+  int    status;
+  int    pid;
+  time_t start, duration;
+};
+
+/******************************************************************************
+* Reading the list of jobs
+******************************************************************************/
+
+static array<batch_job>
+read_batch_jobs (url jobs) {
+  // one conversion per line, consisting of an input and an output file;
+  // empty lines and lines starting with '#' are ignored
+  array<batch_job> r;
+  string s;
+  if (load_string (jobs, s, false)) {
+    std_error << "TeXmacs] cannot read job list " << jobs << "\n";
+    return r;
+  }
+  array<string> lines= tokenize (s, "\n");
+  for (int i=0; i<N(lines); i++) {
+    string line= trim_spaces (lines[i]);
+    if (N(line) == 0 || line[0] == '#') continue;
+    array<string> a= tokenize (replace (line, "\t", " "), " ");
+    array<string> fields;
+    for (int j=0; j<N(a); j++)
+      if (N(a[j]) > 0) fields << a[j];
+    if (N(fields) != 2) {
+      std_error << "TeXmacs] invalid job '" << line << "' in "
+                << jobs << "\n";
+      continue;
+    }
+    batch_job job;
+    job.in      = url ("$PWD", fields[0]);
+    job.out     = url ("$PWD", fields[1]);
+    job.status  = BATCH_WAITING;
+    job.pid     = -1;
+    job.start   = 0;
+    job.duration= 0;
+    r << job;
+  }
+  return r;
+}
+
+/******************************************************************************
+* Converting a single document
+******************************************************************************/
+
+static bool
+convert_one (url in, url out) {
+  // the output is removed first, so that failed conversions can be detected;
+  // the buffer is closed afterwards, also if the export failed, so that
+  // sequential conversions do not keep all documents open
+  if (exists (out)) remove (out);
+  string src= scm_quote (as_string (in));
+  string dest= scm_quote (as_string (out));
+  string buf= "(system->url " * src * ")";
+  string cmd=
+    "(begin (catch #t (lambda () (load-buffer " * src * " :strict) " *
+    "(export-buffer " * dest * ")) (lambda args #f)) " *
+    "(when (and (buffer-exists? " * buf * ") (> (length (buffer-list)) 1)) " *
+    "(buffer-pretend-saved " * buf * ") (buffer-close " * buf * ")))";
+  (void) eval (cmd);
+  return exists (out);
+}
+
+static void
+run_batch_job (batch_job& job) {
+  job.start   = texmacs_time ();
+  job.status  = convert_one (job.in, job.out)? BATCH_OK: BATCH_FAILED;
+  job.duration= texmacs_time () - job.start;
+}
+
+#ifndef OS_MINGW
+static bool
+batch_headless () {
+  // true if the process may safely be forked
+  if (!gui_is_qt ()) return false;
+  string platform= get_env ("QT_QPA_PLATFORM");
+  return platform == "offscreen" || platform == "minimal";
+}
+
+static bool
+start_batch_job (batch_job& job) {
+  // launch the conversion in a child process; false if no process
+  // could be created, in which case the caller converts in place
+  cout.flush ();
+  std_error.flush ();
+  int pid= fork_process ();
+  if (pid < 0) return false;
+  if (pid == 0) {
+    // leave without running the exit handlers of the parent
+    bool ok= convert_one (job.in, job.out);
+    cout.flush ();
+    std_error.flush ();
+    _exit (ok? 0: 1);
+  }
+  job.pid   = pid;
+  job.start = texmacs_time ();
+  job.status= BATCH_RUNNING;
+  return true;
+}
+
+static bool
+reap_batch_job (batch_job& job) {
+  int ret;
+  if (!system_terminated (job.pid, ret)) return false;
+  job.duration= texmacs_time () - job.start;
+  if (ret == 0) job.status= BATCH_OK;
+  else if (ret > 0) job.status= BATCH_FAILED;
+  else job.status= BATCH_CRASHED;
+  return true;
+}
+#endif
+
+/******************************************************************************
+* Scheduling the jobs
+******************************************************************************/
+
+static void
+print_batch_report (array<batch_job> jobs, time_t total) {
+  int nr_ok= 0, nr_failed= 0, nr_crashed= 0;
+  time_t sum= 0;
+  cout << "TeXmacs] Batch conversion report\n";
+  for (int i=0; i<N(jobs); i++) {
+    string st;
+    switch (jobs[i].status) {
+    case BATCH_OK: st= "ok     "; nr_ok++; break;
+    case BATCH_FAILED: st= "failed "; nr_failed++; break;
+    default: st= "crashed"; nr_crashed++; break;
+    }
+    sum += jobs[i].duration;
+    cout << "  " << st << " " << as_string ((int) jobs[i].duration)
+         << " ms\t" << jobs[i].in << " -> " << jobs[i].out << "\n";
+  }
+  cout << "TeXmacs] " << nr_ok << " converted, "
+       << nr_failed << " failed, " << nr_crashed << " crashed; "
+       << as_string ((int) sum) << " ms of conversions in "
+       << as_string ((int) total) << " ms\n";
+}
+
+bool
+convert_batch (url jobs_file, int nr_workers) {
+  // convert the documents in the job list using at most nr_workers
+  // simultaneous processes (or one per processor if nr_workers <= 0);
+  // return true if all documents were converted successfully
+  array<batch_job> jobs= read_batch_jobs (jobs_file);
+  time_t start= texmacs_time ();
+#ifdef OS_MINGW
+  for (int i=0; i<N(jobs); i++)
+    run_batch_job (jobs[i]);
+#else
+  if (!batch_headless ()) {
+    if (nr_workers > 1)
+      std_warning << "Parallel conversions require a headless session "
+                  << "(QT_QPA_PLATFORM=offscreen); using a single process\n";
+    for (int i=0; i<N(jobs); i++)
+      run_batch_job (jobs[i]);
+  }
+  else {
+    if (nr_workers <= 0) nr_workers= number_of_processors ();
+    int next= 0, running= 0;
+    while (next < N(jobs) || running > 0) {
+      while (next < N(jobs) && running < nr_workers) {
+        if (start_batch_job (jobs[next])) running++;
+        else run_batch_job (jobs[next]);
+        next++;
+      }
+      bool reaped= false;
+      for (int i=0; i<next; i++)
+        if (jobs[i].status == BATCH_RUNNING && reap_batch_job (jobs[i])) {
+          running--;
+          reaped= true;
+        }
+      if (!reaped) usleep (1000);
+    }
+  }
+#endif
+  print_batch_report (jobs, texmacs_time () - start);
+  for (int i=0; i<N(jobs); i++)
+    if (jobs[i].status != BATCH_OK) return false;
+  return true;
+}
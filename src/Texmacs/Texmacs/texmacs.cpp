@@ -60,6 +60,9 @@ extern bool texmacs_started;
 bool disable_error_recovery= false;
 bool start_server_flag= false;
 string extra_init_cmd;
+static string batch_jobs;
+static int batch_workers= 0;
+static int batch_pos= 0;
 void server_start ();
 
 /******************************************************************************
@@ -296,6 +299,15 @@ TeXmacs_main (int argc, char** argv) {
             "(export-buffer " * scm_quote (as_string (out)) * ")";
         }
       }
+      else if ((s == "-cb") || (s == "-convert-batch")) {
+        i++;
+        if (i<argc) batch_jobs= as_string (url ("$PWD", argv[i]));
+        batch_pos= N(my_init_cmds);
+      }
+      else if ((s == "-j") || (s == "-jobs")) {
+        i++;
+        if (i<argc) batch_workers= as_int (string (argv[i]));
+      }
       else if ((s == "-x") || (s == "-execute")) {
         i++;
         if (i<argc) my_init_cmds= (my_init_cmds * " ") * argv[i];
@@ -308,6 +320,7 @@ TeXmacs_main (int argc, char** argv) {
                (s == "-delete-cache") || (s == "-delete-font-cache") ||
                (s == "-delete-style-cache") || (s == "-delete-file-cache") ||
                (s == "-delete-doc-cache") || (s == "-delete-plugin-cache") ||
+               (s == "-delete-image-cache") ||
                (s == "-delete-server-data") || (s == "-delete-databases"));
       else if (s == "-build-manual") {
         if ((++i)<argc)
@@ -330,11 +343,13 @@ TeXmacs_main (int argc, char** argv) {
         cout << "Options for TeXmacs:\n\n";
         cout << "  -b [file]  Specify scheme buffers initialization file\n";
         cout << "  -c [i] [o] Convert file 'i' into file 'o'\n";
+        cout << "  -cb [file] Convert the pairs of files listed in 'file'\n";
         cout << "  -d         For debugging purposes\n";
         cout << "  -fn [font] Set the default TeX font\n";
         cout << "  -g [geom]  Set geometry of window in pixels\n";
         cout << "  -h         Display this help message\n";
         cout << "  -i [file]  Specify scheme initialization file\n";
+        cout << "  -j [n]     Use 'n' processes for -cb (headless only)\n";
         cout << "  -p         Get the TeXmacs path\n";
         cout << "  -q         Shortcut for -x \"(quit-TeXmacs)\"\n";
         cout << "  -r         Reverse video mode\n";
@@ -351,6 +366,12 @@ TeXmacs_main (int argc, char** argv) {
       }
     }
   if (flag) debug (DEBUG_FLAG_AUTO, true);
+  if (N(batch_jobs) > 0)
+    // at the position of -cb, so that a subsequent -q quits afterwards
+    my_init_cmds= my_init_cmds (0, batch_pos) * " " *
+      "(convert-batch " * scm_quote (batch_jobs) * " " *
+      as_string (batch_workers) * ")" *
+      my_init_cmds (batch_pos, N(my_init_cmds));
 
   // Further options via environment variables
   if (get_env ("TEXMACS_RETINA") == "off") {
@@ -421,6 +442,8 @@ TeXmacs_main (int argc, char** argv) {
              (s == "-i") || (s == "-initialize") ||
              (s == "-g") || (s == "-geometry") ||
              (s == "-x") || (s == "-execute") ||
+             (s == "-cb") || (s == "-convert-batch") ||
+             (s == "-j") || (s == "-jobs") ||
              (s == "-log-file") ||
              (s == "-build-manual") ||
              (s == "-reference-suite") || (s == "-test-suite")) i++;
@@ -538,8 +561,14 @@ immediate_options (int argc, char** argv) {
       remove (url ("$TEXMACS_HOME_PATH/fonts/font-characteristics.scm"));
       remove (url ("$TEXMACS_HOME_PATH/fonts/error") * url_wildcard ("*"));
     }
-    else if (s == "-delete-cache")
+    else if (s == "-delete-cache") {
       remove (url ("$TEXMACS_HOME_PATH/system/cache") * url_wildcard ("*"));
+      remove (url ("$TEXMACS_HOME_PATH/system/cache/images") *
+              url_wildcard ("*"));
+    }
+    else if (s == "-delete-image-cache")
+      remove (url ("$TEXMACS_HOME_PATH/system/cache/images") *
+              url_wildcard ("*"));
     else if (s == "-delete-style-cache")
       remove (url ("$TEXMACS_HOME_PATH/system/cache") * url_wildcard ("__*"));
     else if (s == "-delete-font-cache") {
@@ -120,6 +120,7 @@ extern bool rescue_mode;
 scheme_tree menu_merge (scheme_tree m1, scheme_tree m2);
 server get_server ();
 void gui_set_output_language (string lan);
+bool convert_batch (url jobs, int nr_workers);
 inline bool in_rescue_mode () { return rescue_mode; }
 
 /* low level */
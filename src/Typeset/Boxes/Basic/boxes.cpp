@@ -514,6 +514,7 @@ box_rep::get_leaf_offset (string search) {
 ******************************************************************************/
 
 int nr_painted= 0;
+bool recording_display= false; // no interruptions while painting off-screen
 
 void
 clear_pattern_rectangles (renderer ren, rectangle m, rectangles l) {
@@ -543,7 +544,8 @@ box_rep::reindex (int i, int item, int n) {
 
 void
 box_rep::redraw (renderer ren, path p, rectangles& l) {
-  if ((nr_painted&15) == 15 && ren->is_screen && gui_interrupted (true)) return;
+  if ((nr_painted&15) == 15 && ren->is_screen &&
+      !recording_display && gui_interrupted (true)) return;
   ren->move_origin (x0, y0);
   SI delta= ren->retina_pixel; // adjust visibility to compensate truncation
   if (ren->is_visible (x3- delta, y3- delta, x4+ delta, y4+ delta)) {
@@ -569,7 +571,8 @@ box_rep::redraw (renderer ren, path p, rectangles& l) {
       }
     }
     
-    if ((nr_painted&15) == 15 && ren->is_screen && gui_interrupted ()) {
+    if ((nr_painted&15) == 15 && ren->is_screen &&
+        !recording_display && gui_interrupted ()) {
       l= translate (l, -ren->ox, -ren->oy);
       clear_incomplete (l, ren->retina_pixel, item, i1, i2);
       l= translate (l, ren->ox, ren->oy);
@@ -867,6 +870,25 @@ box_rep::collect_page_colors (array<brush>& bs, array<rectangle>& rs) {
   }
 }
 
+void
+box_rep::collect_display_lists (SI x, SI y, array<display_list>& dls,
+                                array<rectangle>& rs)
+{
+  int i, n= subnr ();
+  x += x0; y += y0;
+  for (i=0; i<n; i++) subbox (i)->collect_display_lists (x, y, dls, rs);
+}
+
+void
+box_rep::reuse_display_lists (SI x, SI y, array<display_list> dls,
+                              array<rectangle> rs, rectangle changed)
+{
+  int i, n= subnr ();
+  x += x0; y += y0;
+  for (i=0; i<n; i++)
+    subbox (i)->reuse_display_lists (x, y, dls, rs, changed);
+}
+
 path
 box_rep::find_tag (string name) {
   (void) name;
@@ -11,6 +11,7 @@
 
 #include "Boxes/composite.hpp"
 #include "Boxes/construct.hpp"
+#include "merge_sort.hpp"
 
 /******************************************************************************
 * Setting up composite boxes
@@ -59,11 +60,13 @@ composite_box_rep::insert (box b, SI x, SI y) {
   bs << b;
   sx(n)= x;
   sy(n)= y;
+  invalidate_index ();
 }
 
 void
 composite_box_rep::position () {
   int i, n= subnr();
+  invalidate_index ();
   if (n == 0) {
     x1= y1= x3= y3= 0;
     x2= y2= x4= y4= 0;
@@ -91,6 +94,204 @@ composite_box_rep::left_justify () {
   SI d= x1;
   x1-=d; x2-=d; x3-=d; x4-=d;
   for (i=0; i<n; i++) sx(i) -= d;
+  invalidate_index ();
+}
+
+/******************************************************************************
+* Spatial index on the children
+******************************************************************************/
+
+static void
+child_extents (composite_box_rep* b, int i, SI& x1, SI& y1, SI& x2, SI& y2) {
+  // union of logical and ink extents, so that the index can be used
+  // both for cursor positioning and for graphical selections
+  x1= min (b->sx1(i), b->sx3(i));
+  y1= min (b->sy1(i), b->sy3(i));
+  x2= max (b->sx2(i), b->sx4(i));
+  y2= max (b->sy2(i), b->sy4(i));
+}
+
+static inline SI
+lower_distance (SI x, SI y, SI x1, SI y1, SI x2, SI y2) {
+  // lower bound for box_rep::distance to any child inside (x1, y1)--(x2, y2);
+  // for delta < 0, the horizontal distance is -1 at the left border of a child
+  SI dx= 0, dy= 0;
+  if (x < x1) dx= x1 - x;
+  else if (x > x2) dx= x - x2;
+  if (y < y1) dy= y1 - y;
+  else if (y > y2) dy= y - y2;
+  return dx + dy - 1;
+}
+
+box_index_rep::box_index_rep (composite_box_rep* b): n (N(b->bs)) {
+  // Sort-Tile-Recursive packing of the children into leaves
+  int i, j, F= BOX_INDEX_FANOUT;
+  array<SI> cx (n), cy (n);
+  SI minx= MAX_SI, miny= MAX_SI, maxx= -MAX_SI, maxy= -MAX_SI;
+  X1= array<SI> (n); Y1= array<SI> (n);
+  X2= array<SI> (n); Y2= array<SI> (n);
+  for (i=0; i<n; i++) {
+    child_extents (b, i, X1[i], Y1[i], X2[i], Y2[i]);
+    cx[i]= (X1[i] >> 1) + (X2[i] >> 1);
+    cy[i]= (Y1[i] >> 1) + (Y2[i] >> 1);
+    minx= min (minx, cx[i]); maxx= max (maxx, cx[i]);
+    miny= min (miny, cy[i]); maxy= max (maxy, cy[i]);
+  }
+  double wx= ((double) maxx - (double) minx) + 1.0;
+  double wy= ((double) maxy - (double) miny) + 1.0;
+  bool hor= (wx >= wy);
+  array<SI> key= copy (hor? cx: cy);
+  nr= array<int> (n);
+  for (i=0; i<n; i++) nr[i]= i;
+  merge_sort_leq<SI,int,less_eq_operator<SI> > (key, nr);
+
+  // The number of slices along the main axis depends on the aspect ratio,
+  // so that children on a single line or column end up in sorted leaves
+  int leaves= (n + F - 1) / F;
+  double ratio= (hor? wx / wy: wy / wx);
+  int slices= (int) ceil (sqrt (((double) leaves) * ratio));
+  slices= max (1, min (leaves, slices));
+  int size= ((leaves + slices - 1) / slices) * F;
+  for (int s=0; s<n; s+=size) {
+    int e= min (n, s + size);
+    array<SI>  sk (e - s);
+    array<int> sn (e - s);
+    for (i=s; i<e; i++) {
+      sn[i-s]= nr[i];
+      sk[i-s]= (hor? cy[nr[i]]: cx[nr[i]]);
+    }
+    merge_sort_leq<SI,int,less_eq_operator<SI> > (sk, sn);
+    for (i=s; i<e; i++) nr[i]= sn[i-s];
+  }
+
+  // Leaves, followed by the upper levels of the packed tree
+  array<SI> lx1 (n), ly1 (n), lx2 (n), ly2 (n);
+  for (i=0; i<n; i++) {
+    lx1[i]= X1[nr[i]]; ly1[i]= Y1[nr[i]];
+    lx2[i]= X2[nr[i]]; ly2[i]= Y2[nr[i]];
+  }
+  X1= lx1; Y1= ly1; X2= lx2; Y2= ly2;
+  lev << 0;
+  int start= 0, cnt= n;
+  while (cnt > 1) {
+    int next= N(X1);
+    lev << next;
+    for (j=0; j<cnt; j+=F) {
+      SI a1= MAX_SI, b1= MAX_SI, a2= -MAX_SI, b2= -MAX_SI;
+      for (i=start+j; i<start+min (j+F, cnt); i++) {
+        a1= min (a1, X1[i]); b1= min (b1, Y1[i]);
+        a2= max (a2, X2[i]); b2= max (b2, Y2[i]);
+      }
+      X1 << a1; Y1 << b1; X2 << a2; Y2 << b2;
+    }
+    start= next;
+    cnt  = N(X1) - next;
+  }
+}
+
+box_index::box_index (composite_box_rep* b):
+  rep (tm_new<box_index_rep> (b)) {}
+
+void
+box_index_rep::closest (composite_box_rep* b, int l, int j, SI x, SI y,
+                        SI delta, bool force, SI& d, int& m)
+{
+  if (l == 0) {
+    // ties are resolved in favour of the first child, as in a linear scan
+    int i = nr[j];
+    SI  di= b->distance (i, x, y, delta);
+    if ((di < d) || (di == d && m != -1 && i < m))
+      if (b->bs[i]->accessible () || force) {
+        d= di;
+        m= i;
+      }
+    return;
+  }
+  int k, h, F= BOX_INDEX_FANOUT;
+  int cnt= lev[l] - lev[l-1];
+  int s= j * F, e= min (s + F, cnt);
+  SI  lb [BOX_INDEX_FANOUT];
+  int ord[BOX_INDEX_FANOUT];
+  for (k=s; k<e; k++) {
+    int c= lev[l-1] + k;
+    SI  v= lower_distance (x, y, X1[c], Y1[c], X2[c], Y2[c]);
+    for (h= k-s; h>0 && lb[h-1] > v; h--) {
+      lb [h]= lb [h-1];
+      ord[h]= ord[h-1];
+    }
+    lb [h]= v;
+    ord[h]= k;
+  }
+  for (k=0; k<e-s; k++) {
+    if (lb[k] > d) break;
+    closest (b, l-1, ord[k], x, y, delta, force, d, m);
+  }
+}
+
+int
+box_index_rep::find_child (composite_box_rep* b, SI x, SI y, SI delta,
+                           bool force)
+{
+  SI  d= MAX_SI;
+  int m= -1;
+  if (n > 0) closest (b, N(lev)-1, 0, x, y, delta, force, d, m);
+  return m;
+}
+
+void
+box_index_rep::overlapping (int l, int j, SI x1, SI y1, SI x2, SI y2,
+                            array<int>& r)
+{
+  int c= lev[l] + j;
+  if (X2[c] < x1 || X1[c] > x2 || Y2[c] < y1 || Y1[c] > y2) return;
+  if (l == 0) r << nr[j];
+  else {
+    int k, F= BOX_INDEX_FANOUT;
+    int cnt= lev[l] - lev[l-1];
+    for (k= j*F; k < min ((j+1)*F, cnt); k++)
+      overlapping (l-1, k, x1, y1, x2, y2, r);
+  }
+}
+
+void
+box_index_rep::find_children (SI x1, SI y1, SI x2, SI y2, array<int>& r) {
+  if (n > 0) overlapping (N(lev)-1, 0, x1, y1, x2, y2, r);
+}
+
+void
+composite_box_rep::invalidate_index () {
+  idx= box_index ();
+}
+
+int
+composite_box_rep::find_closest_child (SI x, SI y, SI delta, bool force) {
+  int i, n= N(bs), d= MAX_SI, m= -1;
+  if (n >= BOX_INDEX_THRESHOLD) {
+    if (is_nil (idx) || idx->n != n) idx= box_index (this);
+    return idx->find_child (this, x, y, delta, force);
+  }
+  for (i=0; i<n; i++)
+    if (distance (i, x, y, delta)< d)
+      if (bs[i]->accessible () || force) {
+	d= distance (i, x, y, delta);
+	m= i;
+      }
+  return m;
+}
+
+array<int>
+composite_box_rep::find_children (SI X1, SI Y1, SI X2, SI Y2) {
+  // children which may intersect the rectangle, in increasing order
+  array<int> r;
+  int i, n= N(bs);
+  if (n >= BOX_INDEX_THRESHOLD) {
+    if (is_nil (idx) || idx->n != n) idx= box_index (this);
+    idx->find_children (X1, Y1, X2, Y2, r);
+    merge_sort (r);
+  }
+  else
+    for (i=0; i<n; i++) r << i;
+  return r;
 }
 
 /******************************************************************************
@@ -201,14 +402,7 @@ composite_box_rep::finalize () {
 int
 composite_box_rep::find_child (SI x, SI y, SI delta, bool force) {
   if (outside (x, delta, x1, x2) && (is_accessible (ip) || force)) return -1;
-  int i, n= subnr(), d= MAX_SI, m= -1;
-  for (i=0; i<n; i++)
-    if (distance (i, x, y, delta)< d)
-      if (bs[i]->accessible () || force) {
-	d= distance (i, x, y, delta);
-	m= i;
-      }
-  return m;
+  return find_closest_child (x, y, delta, force);
 }
 
 path
@@ -348,9 +542,11 @@ gr_selections
 composite_box_rep::graphical_select (SI x, SI y, SI dist) {
   gr_selections res;
   if (graphical_distance (x, y) <= dist) {
-    int i, n= subnr();
-    for (i=n-1; i>=0; i--)
+    array<int> a= find_children (x- dist, y- dist, x+ dist, y+ dist);
+    for (int k=N(a)-1; k>=0; k--) {
+      int i= a[k];
       res << bs[i]->graphical_select (x- sx(i), y- sy(i), dist);
+    }
   }
   return res;
 }
@@ -359,10 +555,12 @@ gr_selections
 composite_box_rep::graphical_select (SI x1, SI y1, SI x2, SI y2) {
   gr_selections res;
   if (contains_rectangle (x1, y1, x2, y2)) {
-    int i, n= subnr();
-    for (i=n-1; i>=0; i--)
+    array<int> a= find_children (x1, y1, x2, y2);
+    for (int k=N(a)-1; k>=0; k--) {
+      int i= a[k];
       res << bs[i]->graphical_select (x1- sx(i), y1- sy(i),
 				      x2- sx(i), y2- sy(i));
+    }
   }
   return res;
 }
@@ -376,14 +574,7 @@ concrete_composite_box_rep::find_child (SI x, SI y, SI delta, bool force) {
   if (border_flag &&
       outside (x, delta, x1, x2) &&
       (is_accessible (ip) || force)) return -1;
-  int i, n= subnr(), d= MAX_SI, m= -1;
-  for (i=0; i<n; i++)
-    if (distance (i, x, y, delta)< d)
-      if (bs[i]->accessible () || force) {
-	d= distance (i, x, y, delta);
-	m= i;
-      }
-  return m;
+  return find_closest_child (x, y, delta, force);
 }
 
 /******************************************************************************
@@ -56,14 +56,7 @@ scatter_box_rep::operator tree () {
 
 int
 scatter_box_rep::find_child (SI x, SI y, SI delta, bool force) {
-  int i, n= subnr(), d= MAX_SI, m= -1;
-  for (i=0; i<n; i++)
-    if (distance (i, x, y, delta)< d)
-      if (bs[i]->accessible () || force) {
-	d= distance (i, x, y, delta);
-	m= i;
-      }
-  return m;
+  return find_closest_child (x, y, delta, force);
 }
 
 path
@@ -125,6 +118,8 @@ struct page_box_rep: composite_box_rep {
   brush page_bgc;
   box   decoration;
   int   old_page;
+  display_list dl;   // retained rendering for repeated redraws
+  int   nr_redraws;
 
   page_box_rep (path ip, tree page, int page_nr, brush bgc, SI w, SI h,
 		array<box> bs, array<SI> x, array<SI> y, box dec);
@@ -138,14 +133,22 @@ struct page_box_rep: composite_box_rep {
   void clear_incomplete (rectangles& rs, SI pixel, int i, int i1, int i2);
   void collect_page_numbers (hashmap<string,tree>& h, tree page);
   void collect_page_colors (array<brush>& bs, array<rectangle>& rs);
+  void collect_display_lists (SI x, SI y, array<display_list>& dls,
+                              array<rectangle>& rs);
+  void reuse_display_lists (SI x, SI y, array<display_list> dls,
+                            array<rectangle> rs, rectangle changed);
   path find_left_box_path ();
   path find_right_box_path ();
+  tree display_key ();
+  void record (renderer ren);
+  void redraw (renderer ren, path p, rectangles& l);
 };
 
 page_box_rep::page_box_rep (path ip2, tree p2, int nr2, brush bgc, SI w, SI h,
 			    array<box> bs, array<SI> x, array<SI> y, box dec):
   composite_box_rep (ip2, bs, x, y),
-  page (p2), page_nr (nr2), page_bgc (bgc), decoration (dec), old_page (0)
+  page (p2), page_nr (nr2), page_bgc (bgc), decoration (dec), old_page (0),
+  nr_redraws (0)
 {
   x1= min (x1, 0);
   x2= max (x2, w);
@@ -269,6 +272,96 @@ page_box_rep::find_right_box_path () {
   return path (N(bs)-1, bs[N(bs)-1]->find_right_box_path ());
 }
 
+/******************************************************************************
+* Retained display lists for pages
+******************************************************************************/
+
+extern int nr_painted;
+extern bool recording_display;
+
+tree
+page_box_rep::display_key () {
+  tree dec= (is_nil (decoration)? tree (""): (tree) decoration);
+  return tree (TUPLE, as_string (page_nr), dec);
+}
+
+void
+page_box_rep::record (renderer ren) {
+  dl= display_list (ren);
+  dl->key= display_key ();
+  if (anim_next () < 1.0e12) {
+    dl->complete= false;
+    return;
+  }
+  renderer rec= display_list_renderer (dl, ren);
+  rec->set_origin (-x0, -y0);
+  int old_painted= nr_painted;
+  bool old_recording= recording_display;
+  recording_display= true;
+  rectangles rs;
+  box_rep::redraw (rec, path (), rs);
+  recording_display= old_recording;
+  nr_painted= old_painted;
+  delete_renderer (rec);
+  if (rs != rectangles (rectangle (x3, y3, x4, y4))) dl->complete= false;
+  if (dl->complete) dl->retain ();
+}
+
+void
+page_box_rep::redraw (renderer ren, path p, rectangles& l) {
+  // Pages which are redrawn without being retypeset are recorded once
+  // and then replayed, which avoids traversing the entire box tree
+  if (!ren->is_screen || nr_redraws++ == 0) {
+    box_rep::redraw (ren, p, l);
+    return;
+  }
+  if (is_nil (dl) || dl->evicted || !dl->matches (ren)) record (ren);
+  if (!dl->complete) {
+    box_rep::redraw (ren, p, l);
+    return;
+  }
+  ren->move_origin (x0, y0);
+  SI delta= ren->retina_pixel;
+  if (ren->is_visible (x3- delta, y3- delta, x4+ delta, y4+ delta)) {
+    dl->replay (ren);
+    l= rectangle (x3+ ren->ox, y3+ ren->oy, x4+ ren->ox, y4+ ren->oy);
+    if (nr_painted < 15) ren->apply_shadow (x1, y1, x2, y2);
+    nr_painted++;
+  }
+  ren->move_origin (-x0, -y0);
+}
+
+void
+page_box_rep::collect_display_lists (SI x, SI y, array<display_list>& dls,
+                                     array<rectangle>& rs)
+{
+  if (is_nil (dl) || !dl->complete) return;
+  x += x0; y += y0;
+  dls << dl;
+  rs << rectangle (x+ x3, y+ y3, x+ x4, y+ y4);
+}
+
+void
+page_box_rep::reuse_display_lists (SI x, SI y, array<display_list> dls,
+                                   array<rectangle> rs, rectangle changed)
+{
+  // A retained list remains valid for a page at the same place
+  // with the same decorations, if none of its contents changed
+  x += x0; y += y0;
+  rectangle r (x+ x3, y+ y3, x+ x4, y+ y4);
+  if (intersect (r, changed)) return;
+  tree key= UNINIT;
+  for (int i=0; i<N(dls); i++)
+    if (rs[i] == r) {
+      if (key == UNINIT) key= display_key ();
+      if (dls[i]->key == key) {
+        dl= dls[i];
+        nr_redraws= 1;
+        return;
+      }
+    }
+}
+
 /******************************************************************************
 * Page border boxes
 ******************************************************************************/
@@ -379,11 +379,13 @@ effect_box_rep::expand_glyphs (int mode, double factor) {
 }
 
 extern int nr_painted;
+extern bool recording_display;
 
 void
 effect_box_rep::redraw (renderer ren, path p, rectangles& l) {
   (void) p; (void) l;
-  if (((nr_painted&15) == 15) && gui_interrupted (true)) return;
+  if (((nr_painted&15) == 15) && !recording_display &&
+      gui_interrupted (true)) return;
   ren->move_origin (x0, y0);
   array<picture> pics (subnr ());
   SI shad_pixel= ren->pixel;
@@ -394,7 +396,8 @@ effect_box_rep::redraw (renderer ren, path p, rectangles& l) {
     subbox (i)->redraw (shad, path (), rs);
     delete_renderer (shad);
   }
-  if (((nr_painted&15) == 15) && gui_interrupted (true));
+  if (((nr_painted&15) == 15) && !recording_display &&
+      gui_interrupted (true));
   else {
     picture result_pic= eff->apply (pics, shad_pixel);
     ren->draw_picture (result_pic, 0, 0);
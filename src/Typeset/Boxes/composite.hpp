@@ -14,6 +14,36 @@
 #include "boxes.hpp"
 #include "array.hpp"
 
+/******************************************************************************
+* Spatial index on the children of composite boxes
+******************************************************************************/
+
+#define BOX_INDEX_THRESHOLD 32  // minimal number of children for indexing
+#define BOX_INDEX_FANOUT    8   // number of entries per node of the index
+
+struct composite_box_rep;
+struct box_index_rep: concrete_struct {
+  int n;                         // number of indexed children
+  array<int> nr;                 // children in the order of the leaves
+  array<int> lev;                // start of each level (leaves come first)
+  array<SI>  X1, Y1, X2, Y2;     // bounding boxes of all nodes
+
+  box_index_rep (composite_box_rep* b);
+  int  find_child (composite_box_rep* b, SI x, SI y, SI delta, bool force);
+  void find_children (SI x1, SI y1, SI x2, SI y2, array<int>& r);
+
+private:
+  void closest (composite_box_rep* b, int l, int j, SI x, SI y, SI delta,
+                bool force, SI& d, int& m);
+  void overlapping (int l, int j, SI x1, SI y1, SI x2, SI y2, array<int>& r);
+};
+
+struct box_index {
+  CONCRETE_NULL(box_index);
+  box_index (composite_box_rep* b);
+};
+CONCRETE_NULL_CODE(box_index);
+
 /******************************************************************************
 * Composite boxes
 ******************************************************************************/
@@ -21,6 +51,7 @@
 struct composite_box_rep: public box_rep {
   array<box> bs;  // the children
   path lip, rip;  // left-most and right-most inverse paths
+  box_index  idx; // lazily built spatial index on the children
 
   composite_box_rep (path ip);
   composite_box_rep (path ip, array<box> bs);
@@ -32,6 +63,9 @@ struct composite_box_rep: public box_rep {
   void    position ();
   void    left_justify ();
   void    finalize ();
+  void    invalidate_index ();
+  int     find_closest_child (SI x, SI y, SI delta, bool force);
+  array<int> find_children (SI x1, SI y1, SI x2, SI y2);
 
   int     subnr ();
   box     subbox (int i);
@@ -37,7 +37,11 @@ bridge nil_bridge;
 
 bridge_rep::bridge_rep (typesetter ttt2, tree st2, path ip2):
   ttt (ttt2), env (ttt->env), st (st2), ip (ip2),
-  status (CORRUPTED), changes (UNINIT) {}
+  status (CORRUPTED), changes (UNINIT), estimated (false) {}
+
+bridge_rep::~bridge_rep () {
+  if (N(refs) > 0) ttt->remove_readers (this, refs);
+}
 
 static tree inactive_auto
   (MACRO, "x", tree (REWRITE_INACTIVE, tree (ARG, "x"), "recurse*"));
@@ -233,6 +237,40 @@ bridge_rep::notify_join (path p) {
   }
 }
 
+/******************************************************************************
+* Dependencies on references
+******************************************************************************/
+
+static bool
+is_source_ip (path ip) {
+  // bridges for macro expansions cannot be retypeset on their own
+  for (; !is_nil (ip); ip= ip->next)
+    if (ip->item < 0) return false;
+  return true;
+}
+
+void
+bridge_rep::update_references (int start) {
+  // the references read since start were read by this bridge or by
+  // descendants whose source is not in the document; bridges with a source
+  // register themselves as readers, so that they can be retypeset when one
+  // of the references changes, the others pass the references to the parent
+  array<string>& reads= env->read_refs;
+  array<string> keys;
+  hashset<string> done;
+  for (int i=start; i<N(reads); i++)
+    if (!done->contains (reads[i])) {
+      done << reads[i];
+      keys << reads[i];
+    }
+  if (N(refs) > 0) ttt->remove_readers (this, refs);
+  refs= keys;
+  if (is_source_ip (ip)) {
+    reads->resize (start);
+    if (N(refs) > 0) ttt->add_readers (this, refs);
+  }
+}
+
 /******************************************************************************
 * Getting environment variables and typesetting
 ******************************************************************************/
@@ -303,6 +341,7 @@ bridge_rep::typeset (int desired_status) {
   if ((status==desired_status) && (N(ttt->old_patch)==0)) {
     //cout << "cached" << LF;
     env->monitored_patch_env (changes);
+    if (!is_source_ip (ip)) env->read_refs << refs;
     // cout << "changes       = " << changes << LF;
   }
   else {
@@ -312,10 +351,13 @@ bridge_rep::typeset (int desired_status) {
     my_clean_links ();
     link_repository old_link_env= env->link_env;
     env->link_env= link_env;
+    int refs_start= N(env->read_refs);
     ttt->local_start (l, sb);
     env->local_start (prev_back);
     if (env->hl_lan != 0) env->lan->highlight (st);
     my_typeset (desired_status);
+    update_references (refs_start);
+    ttt->nr_typeset++;
     env->local_update (ttt->old_patch, changes);
     env->local_end (prev_back);
     ttt->local_end (l, sb);
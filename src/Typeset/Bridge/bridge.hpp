@@ -44,10 +44,12 @@ public:
   array<page_item>     l;        // the typesetted lines of st
   stack_border         sb;       // border properties of l
   link_repository      link_env; // loci and links declared inside bridge
+  array<string>        refs;     // references read by the bridge itself
+  bool                 estimated;// typeset with estimated heights
 
 public:
   bridge_rep (typesetter ttt, tree st, path ip);
-  inline virtual ~bridge_rep () {}
+  virtual ~bridge_rep ();
 
   virtual void notify_assign (path p, tree u) = 0;
   virtual void notify_insert (path p, tree u);
@@ -62,6 +64,7 @@ public:
   virtual bool my_typeset_will_be_complete ();
   virtual void my_typeset (int desired_status);
   virtual void exec_until (path p, bool skip_flag= false);
+  void update_references (int start);
   void typeset (int desired_status);
 };
 
@@ -194,6 +194,27 @@ bridge_document_rep::my_typeset_will_be_complete () {
   else return acc->my_typeset_will_be_complete ();
 }
 
+static SI
+stack_height (array<page_item> l, int start) {
+  SI h= 0;
+  for (int i=start; i<N(l); i++)
+    h += l[i]->b->h () + l[i]->spc->def;
+  return h;
+}
+
+static void
+typeset_or_estimate (bridge& br, int desired_status, bool estimate) {
+  // an estimated paragraph is typeset again from scratch, so that the
+  // estimates inside its descendants are discarded as well
+  typesetter ttt= br->ttt;
+  if (!estimate && br->estimated) replace_bridge (br, br->st, br->ip);
+  int nr= ttt->nr_typeset;
+  ttt->estimating= estimate;
+  br->typeset (desired_status);
+  ttt->estimating= false;
+  if (ttt->nr_typeset != nr) br->estimated= estimate;
+}
+
 void
 bridge_document_rep::my_typeset (int desired_status) {
   //cout << INDENT;
@@ -201,12 +222,29 @@ bridge_document_rep::my_typeset (int desired_status) {
     int i, n= N(st);
     array<line_item> a= ttt->a;
     array<line_item> b= ttt->b;
+    bool top= (ip == ttt->br->ip);
+    bool far= top && ttt->estimate_far;
+    SI done= 0;
+    if (top) {
+      ttt->estimated   = array<bool> (n);
+      ttt->nr_estimated= 0;
+    }
     for (i=0; i<n; i++) {
       //cout << "Typesetting " << st[i] << LF;
       int wanted= (i==n-1? desired_status & WANTED_MASK: WANTED_PARAGRAPH);
       ttt->a= (i==0  ? a: array<line_item> ());
       ttt->b= (i==n-1? b: array<line_item> ());
-      brs[i]->typeset (PROCESSED+ wanted);
+      if (!far) brs[i]->typeset (PROCESSED+ wanted);
+      else {
+        int start= N(ttt->l);
+        bool estimate= !ttt->near_focus (i, n, done);
+        typeset_or_estimate (brs[i], PROCESSED+ wanted, estimate);
+        if (i >= ttt->focus_first) done += stack_height (ttt->l, start);
+      }
+      if (top) {
+        ttt->estimated[i]= brs[i]->estimated;
+        if (brs[i]->estimated) ttt->nr_estimated++;
+      }
     }
   }
   else acc->my_typeset (desired_status);
@@ -12,10 +12,12 @@
 #ifndef IMPL_TYPESETTER_H
 #define IMPL_TYPESETTER_H
 #include "Bridge/bridge.hpp"
+#include "hashset.hpp"
 
 class typesetter_rep {
 public:
   edit_env&    env;
+  hashmap<string,hashset<pointer> > ref_readers; // bridges reading refs
   bridge       br;
   rectangles   change_log;
   array<brush> old_bgs;
@@ -28,19 +30,43 @@ public:
   SI x1, y1, x2, y2;
   hashmap<string,tree> old_patch;
   bool paper;
+  pager old_pager;          // for reusing the previous page breaking
+  bool ref_pass;            // retypesetting readers of changed references
+  int  nr_typeset;          // number of bridges typeset during last pass
+
+  bool   estimate_far;      // estimate paragraphs far from the focus
+  bool   estimating;        // estimating the current paragraph
+  int    focus_first;       // first visible top level paragraph
+  int    focus_last;        // last visible top level paragraph
+  SI     focus_height;      // height to be typeset from the focus on
+  time_t complete_until;    // typeset estimated paragraphs until then
+  array<bool> estimated;    // estimated top level paragraphs
+  int    nr_estimated;      // number of estimated top level paragraphs
+  bool   estimates_done;    // last estimated paragraphs were typeset
+  double typeset_bytes;     // size of the paragraphs typeset so far
+  double typeset_lines;     // number of lines of these paragraphs
+  array<string> provisional_refs; // refs changed while estimating
 
 public:
   typesetter_rep (edit_env& env, tree et, path ip);
+  ~typesetter_rep ();
 
   void insert_stack     (array<page_item> l, stack_border sb);
   void insert_parunit   (tree t, path ip);
   void insert_paragraph (tree t, path ip);
+  void insert_estimate  (tree t, path ip);
   void insert_surround  (array<line_item> a, array<line_item> b);
   void insert_marker    (tree st, path ip);
 
   void local_start   (array<page_item>& l, stack_border& sb);
   void local_end     (array<page_item>& l, stack_border& sb);
 
+  void add_readers (bridge_rep* br, array<string> keys);
+  void remove_readers (bridge_rep* br, array<string> keys);
+  array<path> readers (array<string> keys);
+  array<path> changed_readers (int pass);
+  void notify_readers (array<path> ps);
+  bool near_focus (int i, int n, SI done);
   void determine_page_references (box b);
   box  typeset ();
   box  typeset (SI& x1, SI& y1, SI& x2, SI& y2);
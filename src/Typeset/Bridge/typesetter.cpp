@@ -11,19 +11,31 @@
 
 #include "Bridge/impl_typesetter.hpp"
 #include "iterator.hpp"
+#include "Boxes/construct.hpp"
+
+extern tree the_et;
 
 /******************************************************************************
 * Constructor and destructor
 ******************************************************************************/
 
 typesetter_rep::typesetter_rep (edit_env& env2, tree et, path ip):
-  env (env2), old_patch (UNINIT)
+  env (env2), ref_readers (hashset<pointer> ()),
+  old_patch (UNINIT), old_pager (NULL), ref_pass (false), nr_typeset (0),
+  estimate_far (false), estimating (false),
+  focus_first (0), focus_last (0), focus_height (0), complete_until (0),
+  nr_estimated (0), estimates_done (false),
+  typeset_bytes (0.0), typeset_lines (0.0)
 {
   paper= (env->get_string (PAGE_MEDIUM) == "paper");
   br= make_bridge (this, et, ip);
   x1= y1= x2= y2=0;
 }
 
+typesetter_rep::~typesetter_rep () {
+  if (old_pager != NULL) tm_delete (old_pager);
+}
+
 typesetter
 new_typesetter (edit_env& env, tree et, path ip) {
   return tm_new<typesetter_rep> (env, et, ip);
@@ -48,12 +60,25 @@ typesetter_rep::insert_parunit (tree t, path ip) {
   insert_paragraph (t, ip);
 }
 
+static int
+source_size (tree t) {
+  if (is_atomic (t)) return N(t->label);
+  int i, n= N(t), r= 1;
+  for (i=0; i<n; i++) r += source_size (t[i]);
+  return r;
+}
+
 void
 typesetter_rep::insert_paragraph (tree t, path ip) {
   // cout << "Typesetting " << t << ", " << ip << "\n";
+  if (estimating) { insert_estimate (t, ip); return; }
   stack_border     temp_sb;
   array<page_item> temp_l= typeset_stack (env, t, ip, a, b, temp_sb);
   insert_stack (temp_l, temp_sb);
+  if (estimate_far) {
+    typeset_bytes += source_size (t);
+    typeset_lines += N(temp_l);
+  }
 
   /*
   int i, n= N(temp_l);
@@ -65,6 +90,28 @@ typesetter_rep::insert_paragraph (tree t, path ip) {
   */
 }
 
+void
+typesetter_rep::insert_estimate (tree t, path ip) {
+  // instead of typesetting t, execute it for its effects on the environment
+  // and insert empty lines, as many as typeset paragraphs of the same size
+  // have on average
+  (void) env->exec (t);
+  SI sep   = env->get_length (PAR_SEP);
+  SI height= env->as_length (string ("1fn"));
+  double rate= typeset_bytes > 0? typeset_lines / typeset_bytes: 1.0 / 80;
+  int i, n= max (1, (int) (source_size (t) * rate + 0.5));
+  array<page_item> temp_l (n);
+  for (i=0; i<n; i++) {
+    temp_l[i]= page_item (empty_box (decorate (ip), 0, 0, 0, height));
+    temp_l[i]->spc= space (sep);
+  }
+  stack_border temp_sb;
+  temp_sb->height= temp_sb->height_before= height + sep;
+  temp_sb->sep   = temp_sb->sep_before   = sep;
+  temp_sb->top   = height;
+  insert_stack (temp_l, temp_sb);
+}
+
 void
 typesetter_rep::insert_surround  (array<line_item> a2, array<line_item> b2) {
   a << a2;
@@ -119,6 +166,90 @@ requires_update (rectangles log) {
   return reverse (rs);
 }
 
+void
+typesetter_rep::add_readers (bridge_rep* br, array<string> keys) {
+  for (int i=0; i<N(keys); i++) {
+    if (!ref_readers->contains (keys[i]))
+      ref_readers (keys[i])= hashset<pointer> ();
+    ref_readers (keys[i]) << ((pointer) br);
+  }
+}
+
+void
+typesetter_rep::remove_readers (bridge_rep* br, array<string> keys) {
+  for (int i=0; i<N(keys); i++)
+    if (ref_readers->contains (keys[i])) {
+      hashset<pointer> h= ref_readers [keys[i]];
+      h->remove ((pointer) br);
+      if (N(h) == 0) ref_readers->reset (keys[i]);
+    }
+}
+
+array<path>
+typesetter_rep::readers (array<string> keys) {
+  // the source paths of the outermost bridges which read one of the keys
+  hashset<path> all;
+  for (int i=0; i<N(keys); i++)
+    if (ref_readers->contains (keys[i])) {
+      iterator<pointer> it= iterate (ref_readers [keys[i]]);
+      while (it->busy ())
+        all << reverse (((bridge_rep*) it->next ())->ip);
+    }
+  array<path> r;
+  iterator<path> it= iterate (all);
+  while (it->busy ()) {
+    path p= it->next (), q= p;
+    bool covered= false;
+    while (!covered && !is_nil (q)) {
+      q= path_up (q);
+      covered= all->contains (q);
+    }
+    if (!covered) r << p;
+  }
+  return r;
+}
+
+static array<string>
+clean_unused (hashmap<string,tree>& refs, hashmap<string,bool> used) {
+  array<string> a;
+  for (iterator<string> it= iterate (refs); it->busy(); ) {
+    string key= it->next ();
+    if (!used->contains (key)) a << key;
+  }
+  for (int i=0; i<N(a); i++)
+    refs->reset (a[i]);
+  return a;
+}
+
+array<path>
+typesetter_rep::changed_readers (int pass) {
+  // the subtrees to be typeset again after the given number of passes,
+  // because they read references which changed during the last pass
+  if (env->complete) {
+    env->complete= false;
+    env->changed_refs << clean_unused (env->local_ref, env->touched);
+  }
+  array<path> ps= readers (env->changed_refs);
+  env->changed_refs= array<string> ();
+  if (N(ps) != 0 && pass >= MAX_TYPESET_PASSES) {
+    typeset_warning << "References did not stabilize after "
+                    << pass << " passes" << LF;
+    return array<path> ();
+  }
+  return ps;
+}
+
+void
+typesetter_rep::notify_readers (array<path> ps) {
+  // invalidate the subtrees ps of the document, so that they are typeset
+  // again, together with the page references, at the next typesetting
+  path rp= reverse (br->ip);
+  for (int i=0; i<N(ps); i++)
+    if (rp <= ps[i])
+      ::notify_assign (this, ps[i] / rp, subtree (the_et, ps[i]));
+  ref_pass= true;
+}
+
 void
 typesetter_rep::determine_page_references (box b) {
   hashmap<string,tree> h ("?");
@@ -133,10 +264,32 @@ typesetter_rep::determine_page_references (box b) {
     else if (is_func (old, TUPLE, 3))
       env->local_ref (var)= tuple (old[0], val, old[2]);
     else env->local_ref (var)= tuple (old, val);
+    if (env->local_ref[var] != old) env->changed_refs << var;
     env->touched (var)= true;
   }
 }
 
+/******************************************************************************
+* Estimating the paragraphs far from the focus
+******************************************************************************/
+
+#define FOCUS_MARGIN 8
+
+bool
+typesetter_rep::near_focus (int i, int n, SI done) {
+  // should the top level paragraph i out of n really be typeset, if done
+  // is the height of the paragraphs typeset from the focus on
+  if (n < 8 * FOCUS_MARGIN || i == 0 || i == n-1) return true;
+  if (i >= focus_first - FOCUS_MARGIN && i <= focus_last + FOCUS_MARGIN)
+    return true;
+  if (i >= focus_first && done < focus_height) return true;
+  return complete_until != 0 && texmacs_time () < complete_until;
+}
+
+/******************************************************************************
+* Main typesetting routines (continued)
+******************************************************************************/
+
 box
 typesetter_rep::typeset () {
   old_patch= hashmap<string,tree> (UNINIT);
@@ -145,6 +298,8 @@ typesetter_rep::typeset () {
   a        = array<line_item> ();
   b        = array<line_item> ();
   paper    = (env->get_string (PAGE_MEDIUM) == "paper");
+  env->read_refs= array<string> ();
+  nr_typeset= 0;
 
   // Test whether we are doing a complete typesetting
   env->complete= br->my_typeset_will_be_complete ();
@@ -164,11 +319,26 @@ typesetter_rep::typeset () {
     env->redefined= array<tree> ();
     env->touched  = hashmap<string,bool> (false);
   }
+  bool provisional= nr_estimated > 0;
   br->typeset (PROCESSED+ WANTED_PARAGRAPH);
-  pager ppp= tm_new<pager_rep> (br->ip, env, l);
+  complete_until= 0;
+  if (nr_estimated > 0) env->complete= false;
+  estimates_done= provisional && nr_estimated == 0;
+  if (nr_estimated == 0) estimate_far= false;
+  pager ppp= tm_new<pager_rep> (br->ip, env, l,
+                                env->complete? NULL: old_pager);
   box rb= ppp->make_pages ();
-  if (env->complete && paper) determine_page_references (rb);
-  tm_delete (ppp);
+  if (nr_estimated > 0) provisional_refs << env->changed_refs;
+  if (estimates_done) {
+    // the references which changed while estimating are now final
+    env->changed_refs << provisional_refs;
+    provisional_refs= array<string> ();
+  }
+  if ((env->complete || ref_pass || estimates_done) && paper)
+    determine_page_references (rb);
+  ref_pass= false;
+  if (old_pager != NULL) tm_delete (old_pager);
+  old_pager= ppp;
   // env->complete= false;  // moved to edit_typeset_rep::typeset
   return rb;
 }
@@ -274,6 +444,64 @@ typeset (typesetter ttt, SI& x1, SI& y1, SI& x2, SI& y2) {
   return ttt->typeset (x1, y1, x2, y2);
 }
 
+void
+estimate_far_paragraphs (typesetter ttt) {
+  // until the next complete typesetting, estimate the heights of the
+  // top level paragraphs far from the focus instead of typesetting them
+  ttt->estimate_far= true;
+}
+
+bool
+set_typeset_focus (typesetter ttt, int first, int last, SI height) {
+  // set the visible top level paragraphs; true if they were estimated,
+  // in which case the document has to be typeset again
+  ttt->focus_first = first;
+  ttt->focus_last  = last;
+  ttt->focus_height= height;
+  int i, n= N(ttt->estimated);
+  for (i= max (first - FOCUS_MARGIN, 0); i <= last + FOCUS_MARGIN; i++)
+    if (i < n && ttt->estimated[i]) {
+      ttt->br->notify_change ();
+      return true;
+    }
+  return false;
+}
+
+void
+complete_estimates (typesetter ttt, time_t until) {
+  // during the next typesetting, replace estimated paragraphs by
+  // typeset ones, in the order of the document, until the given time
+  if (ttt->nr_estimated == 0) return;
+  ttt->complete_until= until;
+  ttt->br->notify_change ();
+}
+
+int
+number_of_estimates (typesetter ttt) {
+  return ttt->nr_estimated;
+}
+
+bool
+estimates_completed (typesetter ttt) {
+  return ttt->estimates_done;
+}
+
+bool
+typeset_provisional (typesetter ttt) {
+  // are page numbers and references not yet final?
+  return ttt->nr_estimated > 0;
+}
+
+array<path>
+changed_readers (typesetter ttt, int pass) {
+  return ttt->changed_readers (pass);
+}
+
+void
+notify_readers (typesetter ttt, array<path> ps) {
+  ttt->notify_readers (ps);
+}
+
 box
 typeset_as_document (edit_env env, tree t, path ip) {
   env->style_init_env ();
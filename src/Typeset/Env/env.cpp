@@ -38,7 +38,7 @@ edit_env_rep::edit_env_rep (drd_info& drd2,
   local_ref (local_ref2), global_ref (global_ref2),
   local_aux (local_aux2), global_aux (global_aux2),
   local_att (local_att2), global_att (global_att2),
-  missing (UNINIT), redefined (), touched (false)
+  missing (UNINIT), redefined (), touched (false), read_refs (), changed_refs ()
 {
   initialize_default_env ();
   initialize_default_var_type ();
@@ -180,6 +180,11 @@ edit_env_rep::read_env (hashmap<string,tree>& ret) {
   ret= copy (env);
 }
 
+bool
+edit_env_rep::equal_env (hashmap<string,tree> h) {
+  return env == h;
+}
+
 void
 edit_env_rep::local_start (hashmap<string,tree>& prev_back) {
   prev_back= back;
@@ -1758,8 +1758,12 @@ edit_env_rep::exec_set_binding (tree t) {
 	extra << "#" << part (1, N(part));
       local_ref (key) << extra;
     }
+    if (local_ref[key] != old_value) changed_refs << key;
+    // changes with respect to the previous pass are handled by retypesetting
+    // the readers of key; only report keys which are defined twice
+    bool twice= touched[key];
     touched (key)= true;
-    if (complete && is_tuple (old_value) && N(old_value) >= 1) {
+    if (complete && twice && is_tuple (old_value) && N(old_value) >= 1) {
       string old_s= tree_as_string (old_value[0]);
       string new_s= tree_as_string (value);
       if (new_s != old_s && !starts (key, "auto-")) {
@@ -1777,6 +1781,7 @@ edit_env_rep::exec_get_binding (tree t) {
   if (N(t) != 1 && N(t) != 2) return tree (ERROR, "bad get binding");
   string key= exec_string (t[0]);
   tree value= local_ref->contains (key)? local_ref [key]: global_ref [key];
+  read_refs << key;
   int type= (N(t) == 1? 0: as_int (exec_string (t[1])));
   if (type != 0 && type != 1) type= 0;
   if (is_func (value, TUPLE) && (N(value) >= 2)) value= value[type];
@@ -40,6 +40,22 @@ page_item copy (page_item l) {
   return page_item (l->type, l->b, l->spc, l->penalty,
 		    l->fl, l->nr_cols, l->t); }
 
+bool
+same_item (page_item item1, page_item item2) {
+  // items which may be copies of each other with the same contents,
+  // as made when stacking paragraphs, and which are hence placed alike
+  if (item1 == item2) return true;
+  if (item1->type != item2->type || item1->nr_cols != item2->nr_cols)
+    return false;
+  if (item1->type == PAGE_CONTROL_ITEM) return item1->t == item2->t;
+  if (item1->b != item2->b || item1->spc != item2->spc ||
+      item1->penalty != item2->penalty || N(item1->fl) != N(item2->fl))
+    return false;
+  for (int i=0; i<N(item1->fl); i++)
+    if (item1->fl[i] != item2->fl[i]) return false;
+  return true;
+}
+
 tm_ostream&
 operator << (tm_ostream& out, page_item item) {
   switch (item->type) {
@@ -51,6 +51,8 @@ class page_item {
 };
 CONCRETE_NULL_CODE(page_item);
 
+bool same_item (page_item item1, page_item item2);
+
 tm_ostream& operator << (tm_ostream& out, page_item item);
 
 #endif // defined PAGE_ITEM_H
@@ -19,7 +19,9 @@ array<page_item> sub (array<page_item> l, path p, path q);
 page_item access (array<page_item> l, path p);
 skeleton break_pages (array<page_item> l, space ph, int qual,
 		      space fn_sep, space fnote_sep, space float_sep,
-                      font fn, int first_page);
+                      font fn, int first_page,
+                      array<page_item> old_l= array<page_item> (),
+                      skeleton old_sk= skeleton ());
 box page_box (path ip, box b, tree page, int page_nr, brush bgc,
               SI width, SI height, SI left, SI top,
 	      SI bot, box header, box footer, SI head_sep, SI foot_sep);
@@ -177,15 +179,100 @@ pager_rep::pages_make_page (pagelet pg) {
 		   header, footer, head_sep, foot_sep);
 }
 
+bool
+pager_rep::same_layout (pager_rep* p) {
+  return
+    p->paper == paper && p->quality == quality && p->show_hf == show_hf &&
+    p->text_width == text_width && p->text_height == text_height &&
+    p->width == width && p->height == height &&
+    p->odd == odd && p->even == even && p->top == top && p->bot == bot &&
+    p->may_extend == may_extend && p->may_shrink == may_shrink &&
+    p->head_sep == head_sep && p->foot_sep == foot_sep &&
+    p->col_sep == col_sep && p->fn_sep == fn_sep &&
+    p->fnote_sep == fnote_sep && p->fnote_bl == fnote_bl &&
+    p->float_sep == float_sep && p->mnote_sep == mnote_sep &&
+    N(p->page_offsets) > 0 && p->page_offsets[0] == page_offset;
+}
+
+static bool
+same_items (array<page_item> l1, path p1, path q1,
+            array<page_item> l2, path p2, path q2) {
+  array<page_item> a1= sub (l1, p1, q1);
+  array<page_item> a2= sub (l2, p2, q2);
+  if (N(a1) != N(a2)) return false;
+  for (int i=0; i<N(a1); i++)
+    if (!same_item (a1[i], a2[i])) return false;
+  return true;
+}
+
+static bool same_pagelet (array<page_item> l1, pagelet pg1,
+                          array<page_item> l2, pagelet pg2);
+
+static bool
+same_insertion (array<page_item> l1, insertion ins1,
+                array<page_item> l2, insertion ins2) {
+  if (ins1->type != ins2->type || ins1->stretch != ins2->stretch ||
+      ins1->ht != ins2->ht || ins1->xh != ins2->xh ||
+      ins1->top_cor != ins2->top_cor || ins1->bot_cor != ins2->bot_cor ||
+      N(ins1->sk) != N(ins2->sk))
+    return false;
+  if (is_tuple (ins1->type, "multi-column")) {
+    for (int i=0; i<N(ins1->sk); i++)
+      if (!same_pagelet (l1, ins1->sk[i], l2, ins2->sk[i])) return false;
+    return true;
+  }
+  return same_items (l1, ins1->begin, ins1->end, l2, ins2->begin, ins2->end);
+}
+
+static bool
+same_pagelet (array<page_item> l1, pagelet pg1,
+              array<page_item> l2, pagelet pg2) {
+  // do both pagelets format to the same box?
+  // empty pagelets depend on the previous page
+  if (N(pg1->ins) == 0 || N(pg1->ins) != N(pg2->ins) ||
+      pg1->stretch != pg2->stretch)
+    return false;
+  for (int i=0; i<N(pg1->ins); i++) {
+    insertion ins1= pg1->ins[i], ins2= pg2->ins[i];
+    if (!same_insertion (l1, ins1, l2, ins2)) return false;
+    if (i+1 < N(pg1->ins) &&
+        !same_item (access (l1, path_dec (ins1->end)),
+                    access (l2, path_dec (ins2->end))))
+      return false;
+  }
+  return true;
+}
+
 void
 pager_rep::pages_make () {
   space ht (text_height- may_shrink, text_height, text_height+ may_extend);
-  skeleton sk=
-    break_pages (l, ht, quality, fn_sep, fnote_sep, float_sep,
-                 env->fn, env->first_page);
+  bool incremental= prev != NULL && same_layout (prev);
+  if (incremental)
+    sk= break_pages (l, ht, quality, fn_sep, fnote_sep, float_sep,
+                     env->fn, env->first_page, prev->l, prev->sk);
+  else
+    sk= break_pages (l, ht, quality, fn_sep, fnote_sep, float_sep,
+                     env->fn, env->first_page);
   int i, n= N(sk);
-  for (i=0; i<n; i++)
-    pages << pages_make_page (sk[i]);
+  for (i=0; i<n; i++) {
+    // the pages before which the layout state and the contents of which
+    // did not change are taken from the previous typesetting
+    page_style  << copy (style);
+    page_offsets << page_offset;
+    if (incremental && i+1 < N(prev->page_style) &&
+        page_offset == prev->page_offsets[i] &&
+        style == prev->page_style[i] &&
+        same_pagelet (l, sk[i], prev->l, prev->sk[i])) {
+      pages << prev->pages[i];
+      style      = copy (prev->page_style[i+1]);
+      page_offset= prev->page_offsets[i+1];
+      env->write (PAGE_NR, as_string (N(pages) + page_offset));
+      env->write (PAGE_THE_PAGE, style[PAGE_THE_PAGE]);
+    }
+    else pages << pages_make_page (sk[i]);
+  }
+  page_style   << copy (style);
+  page_offsets << page_offset;
 }
 
 void
@@ -29,6 +29,8 @@ typedef array<int>               ladder;
 #define BAD_BREAK      1
 #define VALID_BREAK    2
 
+#define MAX_REBREAK_TRIES  4
+
 /******************************************************************************
 * The page_breaker class
 ******************************************************************************/
@@ -87,6 +89,13 @@ struct page_breaker_rep {
   array<vpenalty>     best_pens;  // corresponding penalties
   array<pagelet>      best_pgs;   // & pagelets
 
+  array<page_item>    old_l;      // page items of the previous breaking
+  skeleton            old_sk;     // and the corresponding skeleton
+  array<int>          old_start;  // first item on each previous page
+  array<int>          old_end;    // end of the items on each previous page
+  int                 same_start; // number of unchanged items at the start
+  int                 same_end;   // number of unchanged items at the end
+
   page_breaker_rep (array<page_item> l, space ph, int quality,
                     space fn_sep, space fnote_sep, space float_sep,
                     font fn, int fp);
@@ -135,6 +144,12 @@ struct page_breaker_rep {
   void assemble_skeleton (skeleton& sk, int last);
   void assemble_skeleton (skeleton& sk);
   void assemble_skeleton (skeleton& sk, int start, int end);
+
+  void init_changes ();
+  bool reuse_skeleton (skeleton& sk, int start, int end, int delta);
+  void break_window (skeleton& sk, int start, int end, bool last);
+  void rebreak_skeleton (skeleton& sk, int start, int end);
+  void reassemble_skeleton (skeleton& sk, int start, int end);
   skeleton make_skeleton ();
 };
 
@@ -1298,6 +1313,234 @@ page_breaker_rep::fast_assemble_skeleton (skeleton& sk) {
   fast_assemble_skeleton (sk, n);
 }
 
+/******************************************************************************
+* Incremental page breaking
+******************************************************************************/
+
+static int
+pagelet_start (pagelet pg) {
+  // first top level item on the page, or -1 if unknown
+  int r= -1;
+  for (int i=0; i<N(pg->ins); i++) {
+    path p= pg->ins[i]->begin;
+    if (is_nil (p)) return -1;
+    if (r == -1 || p->item < r) r= p->item;
+  }
+  return r;
+}
+
+static int
+pagelet_end (pagelet pg) {
+  // the top level items on the page are before this index
+  int r= -1;
+  for (int i=0; i<N(pg->ins); i++) {
+    path p= pg->ins[i]->end;
+    if (is_nil (p)) return -1;
+    r= max (r, p->item + (is_atom (p)? 0: 1));
+  }
+  return r;
+}
+
+static int
+find_cut (skeleton sk, int pos) {
+  // index of the page after a page break which separates the items
+  // before pos from those after pos, or -1 if there is no such break
+  int i, n= N(sk), hi= -1;
+  for (i=0; i<n; i++) {
+    int start= pagelet_start (sk[i]);
+    if (start < 0) return -1;
+    if (start >= pos) break;
+    hi= max (hi, pagelet_end (sk[i]));
+  }
+  if (i == 0 || i == n || hi != pos) return -1;
+  for (int j=i+1; j<n; j++)
+    if (pagelet_start (sk[j]) < pos) return -1;
+  return i;
+}
+
+static inline path
+shift (path p, int delta) {
+  return path (p->item + delta, p->next);
+}
+
+static skeleton shift (skeleton sk, int delta);
+
+static insertion
+shift (insertion ins, int delta) {
+  insertion r (ins->type, shift (ins->begin, delta), shift (ins->end, delta));
+  r->sk     = shift (ins->sk, delta);
+  r->ht     = ins->ht;
+  r->xh     = ins->xh;
+  r->pen    = ins->pen;
+  r->stretch= ins->stretch;
+  r->top_cor= ins->top_cor;
+  r->bot_cor= ins->bot_cor;
+  r->nr_cols= ins->nr_cols;
+  return r;
+}
+
+static pagelet
+shift (pagelet pg, int delta) {
+  // the same page for the items which moved delta positions
+  if (delta == 0) return pg;
+  pagelet r (pg->ht);
+  for (int i=0; i<N(pg->ins); i++)
+    r->ins << shift (pg->ins[i], delta);
+  r->pen    = pg->pen;
+  r->stretch= pg->stretch;
+  return r;
+}
+
+static skeleton
+shift (skeleton sk, int delta) {
+  if (delta == 0) return sk;
+  skeleton r;
+  for (int i=0; i<N(sk); i++)
+    r << shift (sk[i], delta);
+  return r;
+}
+
+static bool
+is_page_break (page_item item) {
+  return (item->type == PAGE_CONTROL_ITEM) &&
+    ((item->t == PAGE_BREAK) ||
+     (item->t == NEW_PAGE) || (item->t == NEW_DPAGE));
+}
+
+void
+page_breaker_rep::init_changes () {
+  int i, n= N(l), old_n= N(old_l), m= min (n, old_n);
+  same_start= 0;
+  while (same_start < m && same_item (l[same_start], old_l[same_start]))
+    same_start++;
+  same_end= 0;
+  while (same_end < m - same_start &&
+         same_item (l[n-1-same_end], old_l[old_n-1-same_end]))
+    same_end++;
+  old_start= array<int> (N(old_sk));
+  old_end  = array<int> (N(old_sk));
+  for (i=0; i<N(old_sk); i++) {
+    old_start[i]= pagelet_start (old_sk[i]);
+    old_end  [i]= pagelet_end (old_sk[i]);
+  }
+}
+
+bool
+page_breaker_rep::reuse_skeleton (skeleton& sk, int start, int end, int delta)
+{
+  // Reuse the previous pages for the unchanged items from start to end,
+  // which were delta positions earlier in the previous page breaking
+  skeleton r;
+  for (int i=0; i<N(old_sk); i++) {
+    if (old_start[i] < 0) continue;
+    if (old_start[i] >= start - delta && old_end[i] <= end - delta)
+      r << shift (old_sk[i], delta);
+    else if (old_start[i] < end - delta && old_end[i] > start - delta)
+      return false;
+  }
+  if (N(r) == 0) return false;
+  sk << r;
+  return true;
+}
+
+void
+page_breaker_rep::break_window (skeleton& sk, int start, int end, bool last) {
+  // Break the items from start to end as if end were the end of the
+  // segment, unless last is set; restore what init_flows alters otherwise
+  bool flag= last_page_flag;
+  int  pen = l[end-1]->penalty;
+  if (!last) last_page_flag= false;
+  assemble_skeleton (sk, start, end);
+  if (!last) l[end-1]->penalty= pen;
+  last_page_flag= flag;
+}
+
+void
+page_breaker_rep::rebreak_skeleton (skeleton& sk, int start, int end) {
+  // Break the pages again from the page before the first changed item,
+  // until a new page break coincides with a previous one after the last
+  // changed item; the previous pages are reused before and after
+  int i, q, delta= N(l) - N(old_l);
+  int old_seg_end= end - delta, old_changed= N(old_l) - same_end;
+  array<int> pg;
+  for (i=0; i<N(old_sk); i++) {
+    if (old_start[i] < 0) continue;
+    if (old_start[i] >= start && old_end[i] <= old_seg_end) pg << i;
+    else if (old_start[i] < old_seg_end && old_end[i] > start) {
+      assemble_skeleton (sk, start, end);
+      return;
+    }
+  }
+
+  // cut[q]: first item after a page break before the q-th page which
+  // separates the items on the earlier and the later pages, or -1
+  int m= N(pg), hi= start, lo= old_seg_end;
+  array<int> cut (m+1);
+  cut[0]= start;
+  cut[m]= old_seg_end;
+  for (q=1; q<m; q++) {
+    hi= max (hi, old_end[pg[q-1]]);
+    cut[q]= hi;
+  }
+  for (q=m-1; q>=1; q--) {
+    lo= min (lo, old_start[pg[q]]);
+    if (cut[q] != lo) cut[q]= -1;
+  }
+
+  // the break before the page with the first changed item was chosen
+  // with knowledge of the items on that page, so restart one page earlier
+  q= 0;
+  while (q < m && old_end[pg[q]] <= same_start) q++;
+  q= max (q-1, 0);
+  while (q > 0 && cut[q] < 0) q--;
+  for (i=0; i<q; i++) sk << old_sk[pg[i]];
+  int from= cut[q];
+
+  array<int> stop;
+  for (i=q+1; i<m; i++)
+    if (cut[i] > old_changed) stop << i;
+  for (int t=0; true; t++) {
+    bool last= (t+1 >= N(stop)) || (t >= MAX_REBREAK_TRIES);
+    int  to  = last? end: cut[stop[t+1]] + delta;
+    skeleton win;
+    break_window (win, from, to, last);
+    if (last) {
+      sk << win;
+      return;
+    }
+    int p= find_cut (win, cut[stop[t]] + delta);
+    if (p >= 0) {
+      for (i=0; i<p; i++) sk << win[i];
+      for (i=stop[t]; i<m; i++) sk << shift (old_sk[pg[i]], delta);
+      return;
+    }
+  }
+}
+
+void
+page_breaker_rep::reassemble_skeleton (skeleton& sk, int start, int end) {
+  // Page breaking of the items from start to end, reusing as much as
+  // possible from the previous page breaking
+  int i, n= N(l), delta= n - N(old_l), changed_end= n - same_end;
+  if (N(old_sk) == 0);
+  else if (end < same_start || (same_start == n && delta == 0)) {
+    if (reuse_skeleton (sk, start, end, 0)) return;
+  }
+  else if (start > changed_end) {
+    if (reuse_skeleton (sk, start, end, delta)) return;
+  }
+  else if (start <= same_start && (end == n || end >= changed_end)) {
+    // the changed items of the previous page breaking were in one segment
+    for (i=same_start; i<N(old_l)-same_end; i++)
+      if (is_page_break (old_l[i])) break;
+    if (i == N(old_l)-same_end) {
+      rebreak_skeleton (sk, start, end);
+      return;
+    }
+  }
+  assemble_skeleton (sk, start, end);
+}
+
 /******************************************************************************
 * Page breaking routines
 ******************************************************************************/
@@ -1466,6 +1709,7 @@ page_breaker_rep::assemble_skeleton (skeleton& sk, int start, int end) {
 skeleton
 page_breaker_rep::make_skeleton () {
   skeleton sk;
+  if (N(old_sk) > 0) init_changes ();
   int i, j, n= N(l);
   bool dpage_flag= false;
   int page_offset= first_page - 1;
@@ -1478,7 +1722,7 @@ page_breaker_rep::make_skeleton () {
 	    sk << pagelet (space (0));
 	  dpage_flag= (l[j]->t == NEW_DPAGE);
 	  last_page_flag= (l[j]->t != PAGE_BREAK);
-	  if (i<j) assemble_skeleton (sk, i, j);
+	  if (i<j) reassemble_skeleton (sk, i, j);
 	  i=j+1;
 	}
       else if (is_tuple (l[j]->t, "env_page") && l[j]->t[1] == PAGE_NR)
@@ -1489,7 +1733,7 @@ page_breaker_rep::make_skeleton () {
     if (dpage_flag && ((N(sk)&1) == 1))
       sk << pagelet (space (0));
     last_page_flag= true;
-    assemble_skeleton (sk, i, j);
+    reassemble_skeleton (sk, i, j);
   }
   return sk;
 }
@@ -1505,8 +1749,11 @@ skeleton new_break_pages (array<page_item> l, space ph, int qual,
 skeleton
 break_pages (array<page_item> l, space ph, int qual,
 	     space fn_sep, space fnote_sep, space float_sep,
-             font fn, int first_page)
+             font fn, int first_page,
+             array<page_item> old_l, skeleton old_sk)
 {
+  // old_sk is the result of a previous page breaking of old_l with the
+  // same parameters; the pages for the unchanged items are reused
   if (get_user_preference ("new style page breaking") == "on")
     return new_break_pages (l, ph, qual, fn_sep, fnote_sep, float_sep,
                             fn, first_page);
@@ -1514,6 +1761,8 @@ break_pages (array<page_item> l, space ph, int qual,
     page_breaker_rep* H=
       tm_new<page_breaker_rep> (l, ph, qual, fn_sep, fnote_sep, float_sep,
                                 fn, first_page);
+    H->old_l = old_l;
+    H->old_sk= old_sk;
     // cout << HRULE << LF;
     skeleton sk= H->make_skeleton ();
     tm_delete (H);
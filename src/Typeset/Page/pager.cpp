@@ -16,8 +16,9 @@
 * Routines for the pager class
 ******************************************************************************/
 
-pager_rep::pager_rep (path ip2, edit_env env2, array<page_item> l2):
-  ip (ip2), env (env2), style (UNINIT), l (l2)
+pager_rep::pager_rep (path ip2, edit_env env2, array<page_item> l2,
+                      pager_rep* prev2):
+  ip (ip2), env (env2), style (UNINIT), l (l2), prev (prev2)
 {
   style (PAGE_THE_PAGE)     = tree (MACRO, compound ("page-nr"));
   style (PAGE_ODD_HEADER)   = env->read (PAGE_ODD_HEADER);
@@ -248,6 +249,7 @@ box
 pager_rep::make_pages () {
   if (paper) pages_make ();
   else papyrus_make ();
+  prev= NULL;
 
   int nr_pages= N(pages);
   int nx= max (1, min (env->page_packet, nr_pages));
@@ -52,6 +52,11 @@ public:
   SI           cur_top;
   array<box>   pages;
 
+  pager_rep*   prev;          // pager of the previous typesetting, if any
+  skeleton     sk;            // the page breaks
+  array<hashmap<string,tree> > page_style;  // style before each page
+  array<int>   page_offsets;  // page offset before each page
+
   array<box>   lines_bx;
   array<space> lines_ht;
 
@@ -68,11 +73,13 @@ protected: // making page boxes
   box  pages_format (insertion ins);
   box  pages_format (pagelet pg);
   box  pages_make_page (pagelet pg);
+  bool same_layout (pager_rep* p);
   void pages_make ();
   void papyrus_make ();
 
 public:
-  pager_rep (path ip, edit_env env, array<page_item> l);
+  pager_rep (path ip, edit_env env, array<page_item> l,
+             pager_rep* prev= NULL);
 
   //void start_page ();
   //void print (page_item item);
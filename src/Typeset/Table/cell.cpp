@@ -12,17 +12,126 @@
 #include "Format/format.hpp"
 #include "Table/table.hpp"
 #include "Boxes/construct.hpp"
+#include "modification.hpp"
+#include "iterator.hpp"
+
+/******************************************************************************
+* Caching the typeset contents of cells
+*******************************************************************************
+* A cell cache observer is attached to the cells of large tables in the
+* edited document.  It holds the typeset contents of the cell together with
+* the changes of the environment and the references read during typesetting.
+* The cache is invalidated by any modification inside the cell.  It is only
+* used if the environment before the cell is the same as when the contents
+* were typeset, which is ensured by table_rep::same_environment as long as
+* the previous cells of the table did not change the environment in
+* another way as before.
+******************************************************************************/
+
+class cell_cache_rep: public observer_rep {
+public:
+  bool valid;
+  path ip;                       // the source location of the contents
+  tree fm;                       // the format of the cell
+  hashmap<string,tree> changes;  // changes of the environment
+  hashmap<string,tree> refs;     // values of the references which were read
+  box  b;                        // the typeset contents
+
+  cell_cache_rep (): valid (false), changes (UNINIT), refs (UNINIT) {}
+  int get_type () { return OBSERVER_CELL_CACHE; }
+  tm_ostream& print (tm_ostream& out) { return out << " cell_cache"; }
+
+  void announce (tree& ref, modification mod) {
+    (void) ref; if (mod->k != MOD_SET_CURSOR) valid= false; }
+  void notify_detach (tree& ref, tree closest, bool right) {
+    (void) ref; (void) closest; (void) right; valid= false; }
+};
+
+static long long cell_cache_hits  = 0;
+static long long cell_cache_misses= 0;
+
+static tree
+read_reference (edit_env env, string key) {
+  return env->local_ref->contains (key)? env->local_ref [key]:
+                                         env->global_ref [key];
+}
+
+box
+cell_rep::typeset_contents (tree fm, tree t, path iq, tree ct) {
+  // typeset the contents t of the cell ct, reusing the previous result
+  // if neither the contents nor the environment did change
+  cell_cache_rep* cc= NULL;
+  if (is_func (ct, CELL, 1) && obtain_ip (ct) == ip) {
+    observer o= search_observer (ct, OBSERVER_CELL_CACHE);
+    cc= (cell_cache_rep*) o.rep;
+    if (cc == NULL && same_env) {
+      cc= tm_new<cell_cache_rep> ();
+      attach_observer (ct, cc);
+    }
+  }
+  if (cc != NULL && cc->valid && same_env && cc->ip == iq && cc->fm == fm) {
+    bool ok= true;
+    iterator<string> it= iterate (cc->refs);
+    while (ok && it->busy ()) {
+      string key= it->next ();
+      ok= (read_reference (env, key) == cc->refs[key]);
+    }
+    if (ok) {
+      cell_cache_hits++;
+      env->monitored_patch_env (cc->changes);
+      for (it= iterate (cc->refs); it->busy (); )
+        env->read_refs << it->next ();
+      return cc->b;
+    }
+  }
+
+  // typeset and monitor the side effects
+  int refs_start= N(env->read_refs);
+  int nr_changed= N(env->changed_refs);
+  int nr_touched= N(env->touched);
+  list<string>    ids  = env->link_env->ids;
+  list<soft_link> links= env->link_env->links;
+  hashmap<string,tree> prev_back (UNINIT), old_patch (UNINIT);
+  hashmap<string,tree> changes (UNINIT);
+  env->local_start (prev_back);
+  box r= typeset_as_concat (env, t, iq);
+  env->local_update (old_patch, changes);
+  env->local_end (prev_back);
+  if (cc == NULL) { same_env= false; return r; }
+  cell_cache_misses++;
+  same_env= same_env && cc->ip == iq && cc->fm == fm && changes == cc->changes;
+  cc->ip     = iq;
+  cc->fm     = fm;
+  cc->changes= changes;
+  cc->refs   = hashmap<string,tree> (UNINIT);
+  for (int i=refs_start; i<N(env->read_refs); i++)
+    cc->refs (env->read_refs[i])= read_reference (env, env->read_refs[i]);
+  cc->b      = r;
+  // contents with labels or loci cannot be reused without typesetting
+  cc->valid  = N(env->changed_refs) == nr_changed &&
+               N(env->touched) == nr_touched &&
+               strong_equal (ids, env->link_env->ids) &&
+               strong_equal (links, env->link_env->links);
+  return r;
+}
+
+void
+cell_cache_statistics (long long& hits, long long& misses) {
+  hits  = cell_cache_hits;
+  misses= cell_cache_misses;
+}
 
 /******************************************************************************
 * Cells
 ******************************************************************************/
 
 cell_rep::cell_rep (edit_env env2):
-  var (""), env (env2), border_flags (0) {}
+  var (""), env (env2), border_flags (0), same_env (false) {}
 
 void
 cell_rep::typeset (tree fm, tree t, path iq) {
   ip= iq;
+  tree ct= t;
   format_cell (fm);
   if (is_func (t, CELL, 1)) {
     iq= descend (iq, 0);
@@ -32,12 +141,13 @@ cell_rep::typeset (tree fm, tree t, path iq) {
   cell_local_begin (fm);
   if (is_func (t, SUBTABLE, 1)) {
     lsep= rsep= bsep= tsep= 0;
+    same_env= false;
     T= table (env, 2);
     T->typeset (t[0], descend (iq, 0));
   }
   else {
     if (hyphen == "n") {
-      b= typeset_as_concat (env, t, iq);
+      b= typeset_contents (fm, t, iq, ct);
       if (vcorrect != "n") {
 	SI y1= b->y1;
 	SI y2= b->y2;
@@ -49,6 +159,7 @@ cell_rep::typeset (tree fm, tree t, path iq) {
     }
     else {
       b= empty_box (iq);
+      same_env= false;
 
       tree len = env->as_tmlen ("1par");
       tree old1= env->local_begin (PAGE_MEDIUM, "papyrus");
@@ -74,6 +185,7 @@ cell_rep::typeset (tree fm, tree t, path iq) {
 
   if (decoration != "") {
     int i, j, or_row= -1, or_col= -1;
+    same_env= false;
     tree dt= decoration;
     while (is_func (dt, TFORMAT)) dt= dt [N(dt)-1];
     for (i=0; i<N(dt); i++) {
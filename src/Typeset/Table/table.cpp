@@ -13,6 +13,9 @@
 #include "Boxes/construct.hpp"
 #include "Format/format.hpp"
 #include "analyze.hpp"
+#include "modification.hpp"
+
+#define TABLE_CACHE_MIN_CELLS 64
 
 lazy make_lazy_paragraph (edit_env env, array<box> bs, path ip);
 
@@ -23,7 +26,7 @@ lazy make_lazy_paragraph (edit_env env, array<box> bs, path ip);
 table_rep::table_rep (edit_env env2, int status2, int i0b, int j0b):
   var (""), env (env2), status (status2), i0 (i0b), j0 (j0b),
   T (NULL), nr_rows (0), mw (NULL), lw (NULL), rw (NULL),
-  width (0), height (0) {}
+  width (0), height (0), same_env (false) {}
 
 table_rep::~table_rep () {
   if (T != NULL) {
@@ -70,6 +73,7 @@ table_rep::display (bool flag) {
 void
 table_rep::typeset (tree t, path iq) {
   ip= iq;
+  same_env= same_environment (t, iq);
   tree old_format= env->local_begin (CELL_FORMAT, tree (TFORMAT));
   tree new_format= old_format;
   if (!is_func (new_format, TFORMAT)) new_format= tree (TFORMAT);
@@ -117,7 +121,9 @@ table_rep::typeset_row (int i, tree fm, tree t, path ip) {
     if (i == 0) C->border_flags += 1;
     if (i == nr_rows-1) C->border_flags += 2;
     tree old= env->local_begin (CELL_COL_NR, as_string (j));
+    C->same_env= same_env;
     C->typeset (subformat[j], t[j], descend (ip, j));
+    same_env= C->same_env;
     env->local_end (CELL_COL_NR, old);
     C->row_span= min (C->row_span, nr_rows- i);
     C->col_span= min (C->col_span, nr_cols- j);
@@ -126,6 +132,44 @@ table_rep::typeset_row (int i, tree fm, tree t, path ip) {
   STACK_DELETE_ARRAY (subformat);
 }
 
+/******************************************************************************
+* Caching
+*******************************************************************************
+* The environment before a large table of the document is saved in a table
+* cache observer.  If it did not change, then the cells of the table may
+* reuse their typeset contents (see cell.cpp).
+******************************************************************************/
+
+class table_cache_rep: public observer_rep {
+public:
+  hashmap<string,tree> env;  // the environment before the table
+
+  table_cache_rep (hashmap<string,tree> env2): env (env2) {}
+  int get_type () { return OBSERVER_TABLE_CACHE; }
+  tm_ostream& print (tm_ostream& out) { return out << " table_cache"; }
+};
+
+bool
+table_rep::same_environment (tree t, path iq) {
+  tree u= t;
+  while (is_func (u, TFORMAT) && N(u) > 0) u= u[N(u)-1];
+  if (!is_func (u, TABLE) || obtain_ip (t) != iq) return false;
+  int i, nr= 0;
+  for (i=0; i<N(u); i++) nr += N(u[i]);
+  if (nr < TABLE_CACHE_MIN_CELLS) return false;
+  observer o= search_observer (t, OBSERVER_TABLE_CACHE);
+  table_cache_rep* tc= (table_cache_rep*) o.rep;
+  if (tc == NULL) {
+    hashmap<string,tree> h (UNINIT);
+    env->read_env (h);
+    attach_observer (t, tm_new<table_cache_rep> (h));
+    return false;
+  }
+  if (env->equal_env (tc->env)) return true;
+  env->read_env (tc->env);
+  return false;
+}
+
 /******************************************************************************
 * Table formatting variables
 ******************************************************************************/
@@ -60,12 +60,14 @@ public:
   string   hyphen;            // vertical hypenation
   int      row_origin;        // row span (not yet implemented)
   int      col_origin;        // column span (not yet implemented)
+  bool     same_env;          // same environment as at last typesetting
 
   table_rep (edit_env env, int status, int i0, int j0);
   ~table_rep ();
   void display (bool flag= true);
 
   void typeset (tree t, path ip);
+  bool same_environment (tree t, path ip);
   void typeset_table (tree fm, tree t, path ip);
   void typeset_row (int i, tree fm, tree t, path ip);
   void format_table (tree fm);
@@ -139,10 +141,12 @@ public:
   int      border_flags;      // 1: top row, 2: bottom row
   table    D;                 // potential decoration
   table    T;                 // potential subtable
+  bool     same_env;          // same environment as at last typesetting
 
   cell_rep (edit_env env);
 
   void typeset (tree fm, tree t, path ip);
+  box  typeset_contents (tree fm, tree t, path ip, tree ct);
   void cell_local_begin (tree fm);
   void cell_local_end (tree fm);
   void format_cell (tree fm);
@@ -162,4 +166,6 @@ class cell {
 };
 CONCRETE_NULL_CODE(cell);
 
+void cell_cache_statistics (long long& hits, long long& misses);
+
 #endif // defined TABLE_H
@@ -22,6 +22,7 @@
 #include "hashmap.hpp"
 #include "frame.hpp"
 #include "grid.hpp"
+#include "display_list.hpp"
 
 #define STD_BOX       0
 #define STACK_BOX     1
@@ -149,6 +150,10 @@ public:
   virtual void position_at (SI x, SI y, rectangles& change_log);
   virtual void collect_page_numbers (hashmap<string,tree>& h, tree page);
   virtual void collect_page_colors (array<brush>& bs, array<rectangle>& rs);
+  virtual void collect_display_lists (SI x, SI y, array<display_list>& dls,
+                                      array<rectangle>& rs);
+  virtual void reuse_display_lists (SI x, SI y, array<display_list> dls,
+                                    array<rectangle> rs, rectangle changed);
   virtual path find_tag (string name);
 
   virtual int  reindex (int i, int item, int n);
@@ -151,6 +151,8 @@ public:
   hashmap<string,tree>         missing;     // missing refs
   array<tree>                  redefined;   // redefined labels
   hashmap<string,bool>         touched;     // touched refs
+  array<string>                read_refs;   // refs read by current bridge
+  array<string>                changed_refs;// refs with a new value
   link_repository              link_env;    // current links
   array<array<int> >           size_cache;  // math font size cache
 
@@ -451,6 +453,7 @@ public:
   void monitored_patch_env (hashmap<string,tree> patch);
   void patch_env (hashmap<string,tree> patch);
   void read_env (hashmap<string,tree>& ret);
+  bool equal_env (hashmap<string,tree> h);
   void local_start (hashmap<string,tree>& prev_back);
   void local_update (hashmap<string,tree>& oldpat, hashmap<string,tree>& chg);
   void local_end (hashmap<string,tree>& prev_back);
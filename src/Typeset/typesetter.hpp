@@ -16,6 +16,8 @@
 #include "env.hpp"
 #include "array.hpp"
 
+#define MAX_TYPESET_PASSES 5
+
 class typesetter_rep;
 typedef typesetter_rep* typesetter;
 
@@ -32,6 +34,14 @@ void notify_insert_node (typesetter ttt, path p, tree t);
 void notify_remove_node (typesetter ttt, path p);
 void exec_until         (typesetter ttt, path p);
 box  typeset            (typesetter ttt, SI& x1, SI& y1, SI& x2, SI& y2);
+void estimate_far_paragraphs (typesetter ttt);
+bool set_typeset_focus  (typesetter ttt, int first, int last, SI height);
+void complete_estimates (typesetter ttt, time_t until);
+int  number_of_estimates (typesetter ttt);
+bool estimates_completed (typesetter ttt);
+bool typeset_provisional (typesetter ttt);
+array<path> changed_readers (typesetter ttt, int pass);
+void notify_readers     (typesetter ttt, array<path> ps);
 
 box        typeset_as_concat (edit_env env, tree t, path ip);
 box        typeset_as_box (edit_env env, tree t, path ip);
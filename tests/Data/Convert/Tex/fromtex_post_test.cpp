@@ -0,0 +1,201 @@
+
+/******************************************************************************
+* MODULE     : fromtex_post_test.cpp
+* DESCRIPTION: test on the fused post-processing passes of LaTeX import
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "tree.hpp"
+#include "vars.hpp"
+
+tree finalize_floats (tree t);
+tree finalize_misc (tree t, bool floats);
+tree modernize_newlines (tree t, bool skip);
+tree remove_empty_withs (tree t, bool unnest);
+tree remove_superfluous_newlines (tree t);
+tree concat_document_correct (tree t);
+bool is_verbatim (tree t);
+
+/******************************************************************************
+* The passes as they were run before being fused
+******************************************************************************/
+
+static tree
+old_unnest_withs (tree t) {
+  if (is_atomic (t)) return t;
+  if (is_func (t, WITH) && N(t) > 0) {
+    int n= N(t);
+    if (is_func (t[n-1], WITH)) {
+      tree r= t(0, n-1);
+      r << A(t[n-1]);
+      return r;
+    }
+    else if ((is_func (t[n-1], CONCAT, 1)   && is_func (t[n-1][0], WITH)) ||
+             (is_func (t[n-1], DOCUMENT, 1) && is_func (t[n-1][0], WITH))) {
+      t[n-1]= t[n-1][0];
+      return old_unnest_withs (t);
+    }
+  }
+  int i, n= N(t);
+  tree r(t,n);
+  for (i=0; i<n; i++)
+    r[i]= old_unnest_withs (t[i]);
+  return r;
+}
+
+static tree
+old_remove_empty_withs (tree t) {
+  if (is_atomic (t)) return t;
+  if (is_func (t, WITH)) {
+    int n= N(t);
+    if (t[n-1] == "" || t[n-1] == document () || t[n-1] == concat ()
+        || t[n-1] == document ("") || t[n-1] == concat (""))
+      return "";
+  }
+  int i, n= N(t);
+  tree r(L(t));
+  for (i=0; i<n; i++) {
+    tree tmp= old_remove_empty_withs (t[i]);
+    if (tmp != "" || !is_func (t[i], WITH)) {
+      r << tmp;
+    }
+  }
+  return r;
+}
+
+static tree
+old_remove_geometry (tree t) {
+  if (is_atomic (t)) return t;
+  int i, n= N(t);
+  tree r(L(t));
+  for (i=0; i<n; i++)
+    if (!is_compound (t[i], "geometry"))
+      r << old_remove_geometry (t[i]);
+  return r;
+}
+
+static tree
+old_remove_superfluous_newlines (tree t) {
+  if (is_verbatim (t) || is_atomic (t)) return t;
+  if (is_compound (t, "!emptyline")) return "";
+  tree r (L(t));
+  for (int i=0; i<N(t); i++) {
+    if (!is_document (t) || t[i] != "")
+      r << old_remove_superfluous_newlines (t[i]);
+    }
+  if (is_document (r) && N(r) == 0) r << "";
+  return r;
+}
+
+/******************************************************************************
+* Comparison of the fused and the separate passes
+******************************************************************************/
+
+static void
+check_fused (tree t) {
+  // the fused passes agree with the separate ones and leave t unchanged
+  tree t0= copy (t);
+  tree misc= finalize_misc (finalize_floats (copy (t)), false);
+  ASSERT_EQ (finalize_misc (t, true), misc);
+  ASSERT_EQ (t, t0);
+  tree withs= old_remove_empty_withs (old_unnest_withs (copy (t)));
+  ASSERT_EQ (remove_empty_withs (t, true), withs);
+  ASSERT_EQ (t, t0);
+  tree lines= modernize_newlines (old_remove_geometry (t), false);
+  ASSERT_EQ (modernize_newlines (t, false), lines);
+  ASSERT_EQ (t, t0);
+  tree news= concat_document_correct (old_remove_superfluous_newlines (t));
+  ASSERT_EQ (remove_superfluous_newlines (t), news);
+  ASSERT_EQ (t, t0);
+}
+
+static tree
+figure (tree body, tree caption) {
+  return compound ("bigfigure",
+                   document (compound ("center", body),
+                             compound ("caption", caption), ""));
+}
+
+TEST (fromtex_post, floats) {
+  check_fused (document (figure ("f.eps", "A figure"), "text"));
+  check_fused (compound ("flushleft", document (figure ("a", "b"), "")));
+  check_fused (compound ("bigtable*",
+                         document ("tab", compound ("caption", "t"))));
+  check_fused (compound ("enumerate", "[a]", document (figure ("x", "y"))));
+  check_fused (compound ("minipage", "t", "5cm",
+                         document (compound ("bigtable", document ("a")))));
+  check_fused (compound ("minipage", "t", "5cm", document ("single")));
+  check_fused (compound ("algorithm", document ("step")));
+  check_fused (compound ("algorithm",
+                         document ("step", compound ("caption", "c"))));
+  check_fused (compound ("bigfigure", document (figure ("inner", "i"))));
+  check_fused (tree (WITH, FONT_FAMILY, "tt", "https://www.texmacs.org"));
+  check_fused (compound ("text", tree (WITH, "font-family", "rm",
+                                       figure ("m", "n"))));
+}
+
+TEST (fromtex_post, nested_withs) {
+  check_fused (tree (WITH, "a", "1", tree (WITH, "b", "2", "x")));
+  check_fused (tree (WITH, "a", "1", tree (WITH, "b", "2", "")));
+  check_fused (tree (WITH, "a", "1", concat (tree (WITH, "b", "2", "x"))));
+  check_fused (tree (WITH, "a", "1",
+                     document (tree (WITH, "b", "2",
+                                     concat (tree (WITH, "c", "3", "y"))))));
+  check_fused (tree (WITH, "a", "1",
+                     document (concat (tree (WITH, "b", "2", concat ())))));
+  check_fused (concat ("x", tree (WITH, "a", "1", document ("")), "y",
+                       tree (WITH, "b", "2", concat ("")),
+                       tree (WITH, "c", "3", tree (WITH, "d", "4", "z"))));
+  check_fused (document (tree (WITH, "a", "1", document ()), ""));
+}
+
+TEST (fromtex_post, geometry_and_newlines) {
+  tree geom= compound ("geometry", tree (COLLECTION, "page-width", "10cm"));
+  check_fused (document (geom, "a", "", compound ("!emptyline"), "b"));
+  check_fused (document (compound ("doc-data", geom, "t"),
+                         concat ("a", compound ("new-line"), "b", geom)));
+  check_fused (concat ("a", document ("b", ""), "c"));
+  check_fused (document ("", "", concat (geom, document ("x")), ""));
+  check_fused (document (compound ("verbatim", document ("", "code", "")),
+                         compound ("cpp-code", concat ("a", document ("b")))));
+  check_fused (concat (compound ("abstract-data",
+                                 concat ("a", document ("b"))),
+                       compound ("!emptyline")));
+}
+
+/******************************************************************************
+* Random trees
+******************************************************************************/
+
+static tree
+random_tree (int depth) {
+  static const char* leaves[]= { "", "x", "y z", "https://a.b" };
+  static const char* labels[]= {
+    "bigfigure", "bigtable*", "algorithm", "caption", "center",
+    "flushleft", "minipage", "enumerate", "geometry", "!emptyline",
+    "new-line", "verbatim", "doc-data", "text" };
+  int k= rand () % 12;
+  if (depth == 0 || k < 3) return leaves[rand () % 4];
+  tree t;
+  if (k < 6) t= tree (WITH, "font-family", (rand () % 2)? "tt": "rm");
+  else if (k < 8) t= tree (DOCUMENT);
+  else if (k < 10) t= tree (CONCAT);
+  else t= compound (labels[rand () % 14]);
+  int n= rand () % 4;
+  if (is_func (t, WITH)) n= 1;
+  if (is_compound (t, "minipage")) n= 3;
+  for (int i=0; i<n; i++) t << random_tree (depth - 1);
+  return t;
+}
+
+TEST (fromtex_post, random) {
+  srand (35);
+  for (int i=0; i<2000; i++)
+    check_fused (random_tree (5));
+}
@@ -0,0 +1,81 @@
+
+/******************************************************************************
+* MODULE     : upgradetm_test.cpp
+* DESCRIPTION: test on upgrading documents from older versions of TeXmacs
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "convert.hpp"
+#include "drd_std.hpp"
+#include "vars.hpp"
+
+class upgradetm: public ::testing::Test {
+protected:
+  static void SetUpTestCase () { init_std_drd (); }
+};
+
+static tree
+upgraded (tree doc) {
+  // documents up to version 1.0.7.8 in the generic style also receive
+  // an explicit hyphenation of paragraphs
+  tree init= tree (COLLECTION, tree (ASSOCIATE, PAR_HYPHEN, "normal"));
+  doc << compound ("initial", init);
+  return doc;
+}
+
+TEST_F (upgradetm, hyperlinks_and_labels) {
+  tree t= document (concat (compound ("hyper-link", "text", "url"),
+                            tree (ASSIGN, "the-label", "sec1")));
+  tree r= upgraded (document (concat (compound ("hlink", "text", "url"),
+                                      tree (SET_BINDING, "sec1"))));
+  ASSERT_EQ (upgrade (t, "1.0.6.1"), r);
+}
+
+TEST_F (upgradetm, folds) {
+  tree t= document (compound ("fold", "a", "b"),
+                    compound ("unfold-proof", "c", "d"));
+  tree r= upgraded (document (compound ("folded", "a", "b"),
+                              compound ("detailed", "c", "d")));
+  ASSERT_EQ (upgrade (t, "1.0.5.3"), r);
+}
+
+TEST_F (upgradetm, cell_alignment) {
+  tree t= document (tree (CWITH, "1", "1", CELL_HALIGN, "."));
+  tree r= upgraded (document (tree (CWITH, "1", "1", CELL_HALIGN, "L.")));
+  ASSERT_EQ (upgrade (t, "1.0.6.0"), r);
+}
+
+TEST_F (upgradetm, values) {
+  tree t= document (concat (tree (VALUE, "cursor"), tree (VALUE, "mmx"),
+                            compound ("scheme-code", "(f x)")));
+  tree r= upgraded (document (concat (compound ("cursor"),
+                                      compound ("mathemagix"),
+                                      compound ("scm", "(f x)"))));
+  ASSERT_EQ (upgrade (t, "1.0.6.13"), r);
+}
+
+TEST_F (upgradetm, images) {
+  tree t= document (tree (IMAGE, "a.eps", "*2", "/2", "", "", "", ""));
+  tree r= upgraded (document (tree (IMAGE, "a.eps", "2w", "0.5h", "", "")));
+  ASSERT_EQ (upgrade (t, "1.0.7.6"), r);
+}
+
+TEST_F (upgradetm, nested) {
+  // rules from the same traversal apply at every level of a subtree
+  tree t= document (compound ("fold",
+                              compound ("hyper-link", tree (VALUE, "hrule"),
+                                        "url"),
+                              tree (CWITH, "1", "1", CELL_HALIGN, ",")));
+  tree r= upgraded (document (compound ("folded",
+                                        compound ("hlink", compound ("hrule"),
+                                                  "url"),
+                                        tree (CWITH, "1", "1",
+                                              CELL_HALIGN, "L,"))));
+  ASSERT_EQ (upgrade (t, "1.0.3.9"), r);
+}
@@ -0,0 +1,169 @@
+
+/******************************************************************************
+* MODULE     : parsexml_test.cpp
+* DESCRIPTION: test on parsing xml and html, in one go or in chunks
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "convert.hpp"
+#include "analyze.hpp"
+
+static string
+q (string s) {
+  return "\"" * s * "\"";
+}
+
+static tree
+parse_in_chunks (string s, bool html, int size) {
+  xml_html_stream stream (html);
+  for (int i=0; i<N(s); i+=size)
+    stream.feed (s (i, min (i+size, N(s))));
+  return stream.finish ();
+}
+
+static tree
+parse_in_pieces (string s, bool html, array<int> cuts) {
+  // feed s in pieces which end at the given positions
+  xml_html_stream stream (html);
+  int start= 0;
+  for (int i=0; i<N(cuts); i++) {
+    stream.feed (s (start, cuts[i]));
+    start= cuts[i];
+  }
+  stream.feed (s (start, N(s)));
+  return stream.finish ();
+}
+
+static tree
+parse_in_random_chunks (string s, bool html) {
+  array<int> cuts;
+  for (int i= rand () % 8; i < N(s); i += 1 + rand () % 8) cuts << i;
+  return parse_in_pieces (s, html, cuts);
+}
+
+static int
+inside (string s, string what, int offset) {
+  // a position offset bytes after the start of the first occurrence of what
+  int i= search_forwards (what, s);
+  EXPECT_GE (i, 0);
+  return i + offset;
+}
+
+static string sample=
+  "<?xml version=\"1.0\"?>\r\n"
+  "<!DOCTYPE doc [ <!ENTITY e \"entity\"> ]>\r\n"
+  "<doc lang='en'><!-- comment --><p>One &e; &#65;</p>"
+  "<![CDATA[a<b]]><empty/><?pi data?></doc>\r";
+
+TEST (parsexml, elements_and_attributes) {
+  tree r= tuple ("*TOP*",
+                 tuple ("a", tuple ("@", tuple ("x", q ("1"))),
+                        q ("b"), tuple ("c")));
+  ASSERT_EQ (parse_xml ("<a x=\"1\">b<c/></a>"), r);
+}
+
+TEST (parsexml, entities_and_newlines) {
+  tree r= tuple ("*TOP*",
+                 tuple ("*DOCTYPE*", q ("d")),
+                 tuple ("d", q ("x\nA\ny")));
+  string s= "<!DOCTYPE d [<!ENTITY e \"x\">]><d>&e;\r\n&#65;\ry</d>";
+  ASSERT_EQ (parse_xml (s), r);
+}
+
+TEST (parsexml, html_optional_closing_tags) {
+  tree r= tuple ("*TOP*",
+                 tuple ("ul", tuple ("li", q ("a")),
+                        tuple ("li", q ("b"), tuple ("br"))));
+  ASSERT_EQ (parse_html ("<UL><li>a<li>b<br></ul>"), r);
+}
+
+TEST (parsexml, unterminated_input) {
+  ASSERT_EQ (parse_xml ("<a><!x"), tuple ("*TOP*", tuple ("a")));
+  ASSERT_EQ (parse_xml ("<a>b &amp"),
+             tuple ("*TOP*", tuple ("a", q ("b &amp"))));
+}
+
+TEST (parsexml, chunks) {
+  tree r= parse_xml (sample);
+  for (int size=1; size<=N(sample); size++)
+    ASSERT_EQ (parse_in_chunks (sample, false, size), r);
+  for (int i=0; i<=N(sample); i++) {
+    xml_html_stream stream (false);
+    stream.feed (sample (0, i));
+    stream.feed (sample (i, N(sample)));
+    ASSERT_EQ (stream.finish (), r);
+  }
+}
+
+TEST (parsexml, html_chunks) {
+  string s= "<p>caf\xc3\xa9 <b>one<p>two &amp; <img src=a.png>three";
+  tree r= parse_html (s);
+  for (int size=1; size<=N(s); size++)
+    ASSERT_EQ (parse_in_chunks (s, true, size), r);
+  string l= "<?xml encoding=\"ISO-8859-1\"?><p>caf\xe9</p>";
+  tree rl= parse_html (l);
+  for (int size=1; size<=N(l); size++)
+    ASSERT_EQ (parse_in_chunks (l, true, size), rl);
+}
+
+static string utf8_sample=
+  "<!DOCTYPE d [\n"
+  "  <!ENTITY first \"caf\xc3\xa9\">\n"
+  "  <!ENTITY second \"&first; au lait\">\n"
+  "]>\n"
+  "<d>\xe2\x82\xac &second; &#x20AC; &lt;<!-- a -- b --><![CDATA[x]]>"
+  "<![CDATA[<&amp;>]]>\xf0\x9f\x98\x80</d>";
+
+TEST (parsexml, random_chunks) {
+  srand (37);
+  tree r= parse_xml (utf8_sample);
+  ASSERT_EQ (parse_in_chunks (utf8_sample, false, 1), r);
+  for (int k=0; k<200; k++)
+    ASSERT_EQ (parse_in_random_chunks (utf8_sample, false), r);
+  tree rs= parse_xml (sample);
+  for (int k=0; k<200; k++)
+    ASSERT_EQ (parse_in_random_chunks (sample, false), rs);
+  string h= "<ul><li>caf\xc3\xa9 &eacute;<li><!-- x --><b>two &amp;</ul>";
+  tree rh= parse_html (h);
+  for (int k=0; k<200; k++)
+    ASSERT_EQ (parse_in_random_chunks (h, true), rh);
+}
+
+TEST (parsexml, splits_inside_tokens) {
+  string s= utf8_sample;
+  tree r= parse_xml (s);
+  array<int> cuts;
+  cuts << inside (s, "<!DOCTYPE", 4)           // doctype keyword
+       << inside (s, "<!ENTITY first", 10)     // entity declaration
+       << inside (s, "caf\xc3\xa9\"", 4)       // two byte character
+       << inside (s, "&first;", 3)             // entity in a declaration
+       << inside (s, "]>", 1)                  // end of the doctype
+       << inside (s, "\xe2\x82\xac", 1)         // three byte character
+       << inside (s, "\xe2\x82\xac", 2)
+       << inside (s, "&second;", 4)            // entity reference
+       << inside (s, "&#x20AC;", 3)            // character reference
+       << inside (s, "<!-- a", 2)              // comment opening
+       << inside (s, "-- b --", 1)             // dashes inside a comment
+       << inside (s, "--><!", 2)               // comment closing
+       << inside (s, "<![CDATA[x", 5)          // cdata opening
+       << inside (s, "]]><![CDATA[<", 1)       // cdata closing
+       << inside (s, "<&amp;>", 2)             // no entities inside cdata
+       << inside (s, "\xf0\x9f\x98\x80", 3);    // four byte character
+  for (int i=0; i<N(cuts); i++) {
+    array<int> one;
+    one << cuts[i];
+    ASSERT_EQ (parse_in_pieces (s, false, one), r) << "cut at " << cuts[i];
+  }
+  ASSERT_EQ (parse_in_pieces (s, false, cuts), r);
+  for (int i=0; i<N(cuts); i++) {
+    array<int> around;
+    around << cuts[i] - 1 << cuts[i] << cuts[i] + 1;
+    ASSERT_EQ (parse_in_pieces (s, false, around), r) << "cut at " << cuts[i];
+  }
+}
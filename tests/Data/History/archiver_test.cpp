@@ -0,0 +1,69 @@
+
+/******************************************************************************
+* MODULE     : archiver_test.cpp
+* DESCRIPTION: test on undoing and redoing across spilled history
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "archiver.hpp"
+#include "modification.hpp"
+
+extern tree the_et;
+
+static void
+edit (archiver arch, int i) {
+  // one history item per edit; items are not joined by simplification,
+  // since the archiver is confirmed directly
+  tree& doc= the_et[0];
+  int  k  = i % N(doc);
+  if (i % 3 == 2 && N(doc[k]->label) != 0)
+    apply (doc, mod_remove (path (k), 0, 1));
+  else if (i % 3 == 1)
+    apply (doc, mod_insert (path (k), 0, as_string (i)));
+  else
+    apply (doc, mod_insert (path (), N(doc), tree (DOCUMENT, "p")));
+  arch->confirm ();
+}
+
+TEST (archiver, spill) {
+  the_et= tuple (tree (DOCUMENT, "start"));
+  attach_ip (the_et, path ());
+  set_history_keep (4);
+  double author= new_author ();
+  set_author (author);
+  {
+    archiver arch (author, path (0));
+    array<tree> docs;
+    docs << copy (the_et[0]);
+    for (int i=0; i<50; i++) {
+      edit (arch, i);
+      docs << copy (the_et[0]);
+    }
+    for (int i=50; i>0; i--) {
+      ASSERT_EQ (arch->undo_possibilities (), 1);
+      arch->undo ();
+      ASSERT_EQ (the_et[0], docs[i-1]);
+    }
+    ASSERT_EQ (arch->undo_possibilities (), 0);
+    for (int i=0; i<50; i++) {
+      ASSERT_EQ (arch->redo_possibilities (), 1);
+      arch->redo ();
+      ASSERT_EQ (the_et[0], docs[i+1]);
+    }
+    ASSERT_EQ (arch->redo_possibilities (), 0);
+    // undo again after the history has been brought back
+    for (int i=0; i<20; i++) arch->undo ();
+    ASSERT_EQ (the_et[0], docs[30]);
+    edit (arch, 0);
+    for (int i=0; i<30; i++) arch->undo ();
+    ASSERT_EQ (the_et[0], docs[1]);
+  }
+  set_history_keep (HISTORY_KEEP);
+  the_et= tree ();
+}
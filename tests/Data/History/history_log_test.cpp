@@ -0,0 +1,59 @@
+
+/******************************************************************************
+* MODULE     : history_log_test.cpp
+* DESCRIPTION: test on compact storage of undo/redo history
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "history_log.hpp"
+
+static patch
+typing (int n) {
+  // history of typing n characters, in the format used by the archiver
+  patch a= patch (true, array<patch> ());
+  for (int i=0; i<n; i++) {
+    path p= path (0, path (i % 3, path (2)));
+    patch q (mod_remove (p, i, 1), mod_insert (p, i, tree ("x")));
+    a= patch (patch (1.0, q), a);
+  }
+  return a;
+}
+
+TEST (history_log, roundtrip) {
+  history_log log;
+  patch p= typing (100);
+  EXPECT_EQ (log->decode (log->encode (p)), p);
+  patch q (mod_insert (path (1), 0, tree (CONCAT, "a", tree (WITH, "b", "c"))),
+           mod_remove (path (1), 0, 1));
+  array<patch> a;
+  a << q << patch (2.5, false) << patch (2.5, q);
+  patch b (true, a);
+  EXPECT_EQ (log->decode (log->encode (b)), b);
+}
+
+TEST (history_log, compact) {
+  history_log log;
+  string s= log->encode (typing (1000));
+  EXPECT_LT (N(s), 30 * 1000);
+}
+
+TEST (history_log, stack) {
+  history_log log;
+  patch p1= typing (10), p2= typing (20);
+  log->push (p1);
+  log->push (p2);
+  EXPECT_EQ (N(log), 2);
+  EXPECT_GT (log->memory (), 0);
+  patch p;
+  EXPECT_FALSE (log->pop (p));
+  EXPECT_EQ (p, p2);
+  EXPECT_FALSE (log->pop (p));
+  EXPECT_EQ (p, p1);
+  EXPECT_EQ (N(log), 0);
+}
@@ -0,0 +1,75 @@
+
+/******************************************************************************
+* MODULE     : tree_search_test.cpp
+* DESCRIPTION: test on searching inside attached and detached trees
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "tree_search.hpp"
+#include "modification.hpp"
+#include "drd_std.hpp"
+
+extern tree the_et;
+
+class tree_search: public ::testing::Test {
+protected:
+  static void SetUpTestCase () { init_std_drd (); }
+};
+
+static tree
+paragraphs (int n) {
+  tree doc (DOCUMENT);
+  for (int i=0; i<n; i++)
+    doc << concat ("Some text in paragraph " * as_string (i) * " ",
+                   compound ("em", "with emphasis"), " and more text.");
+  return doc;
+}
+
+TEST_F (tree_search, attached) {
+  // searches in attached trees use and maintain the summaries of subtrees
+  the_et= paragraphs (50);
+  attach_ip (the_et, path ());
+  tree doc= copy (the_et);
+  ASSERT_EQ (N (search (the_et, "paragraph 17", path ())), 2);
+  ASSERT_EQ (search (the_et, "paragraph 17", path ()),
+             search (doc, "paragraph 17", path ()));
+  ASSERT_EQ (N (search (the_et, "unknown", path ())), 0);
+  apply (the_et, mod_insert (path (30, 0), 5, "unknown "));
+  apply (doc, mod_insert (path (30, 0), 5, "unknown "));
+  range_set hits= search (the_et, "unknown", path ());
+  ASSERT_EQ (N (hits), 2);
+  ASSERT_EQ (hits[0], path (30, 0, 5));
+  ASSERT_EQ (hits[1], path (30, 0, 12));
+  ASSERT_EQ (hits, search (doc, "unknown", path ()));
+  apply (the_et, mod_remove (path (30), 0, 1));
+  apply (doc, mod_remove (path (30), 0, 1));
+  ASSERT_EQ (N (search (the_et, "unknown", path ())), 0);
+  ASSERT_EQ (N (search (the_et, "Some text", path ())), 98);
+  ASSERT_EQ (search (the_et, "Some text", path ()),
+             search (doc, "Some text", path ()));
+  the_et= tree ();
+}
+
+TEST_F (tree_search, navigation) {
+  range_set sels;
+  sels << path (0, 1) << path (0, 3) << path (0, 5) << path (0, 7)
+       << path (2, 0) << path (2, 4);
+  ASSERT_EQ (next_search_hit (sels, path (0, 0), false),
+             range (sels, 0, 2));
+  ASSERT_EQ (next_search_hit (sels, path (0, 4), false),
+             range (sels, 2, 4));
+  ASSERT_EQ (next_search_hit (sels, path (0, 3), true),
+             range (sels, 2, 4));
+  ASSERT_EQ (N (next_search_hit (sels, path (3, 0), false)), 0);
+  ASSERT_EQ (previous_search_hit (sels, path (1, 0), false),
+             range (sels, 2, 4));
+  ASSERT_EQ (previous_search_hit (sels, path (0, 7), true),
+             range (sels, 0, 2));
+  ASSERT_EQ (N (previous_search_hit (sels, path (0, 0), false)), 0);
+}
@@ -0,0 +1,69 @@
+
+/******************************************************************************
+* MODULE     : word_cache_test.cpp
+* DESCRIPTION: test on caches for the extents and x-positions of words
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "word_cache.hpp"
+
+TEST (word_cache, insert_find) {
+  word_cache wc (16);
+  EXPECT_TRUE (wc.find ("word") == NULL);
+  word_shape* w= wc.insert ("word");
+  ASSERT_TRUE (w != NULL);
+  EXPECT_FALSE (w->has_extents);
+  w->xpos= array<SI> (5);
+  w->xpos[4]= 42;
+  EXPECT_EQ (wc.insert ("word"), w);
+  EXPECT_EQ (wc.find ("word"), w);
+  EXPECT_EQ (wc.find ("word")->xpos[4], 42);
+}
+
+TEST (word_cache, uncached_strings) {
+  word_cache wc (16);
+  string l;
+  for (int i=0; i<=WORD_CACHE_LENGTH; i++) l << 'a';
+  EXPECT_TRUE (wc.insert ("") == NULL);
+  EXPECT_TRUE (wc.insert (l) == NULL);
+  EXPECT_TRUE (wc.insert (l (0, WORD_CACHE_LENGTH)) != NULL);
+}
+
+TEST (word_cache, generations) {
+  word_cache wc (4);
+  for (int i=0; i<4; i++) wc.insert ("w" * as_string (i));
+  // a new word starts a new generation; w0 is still found in the old one
+  wc.insert ("w4");
+  EXPECT_TRUE (wc.find ("w0") != NULL);
+  for (int i=5; i<8; i++) wc.insert ("w" * as_string (i));
+  // w0 moved back to the recent generation, w1 was discarded
+  wc.insert ("w8");
+  EXPECT_TRUE (wc.find ("w0") != NULL);
+  EXPECT_TRUE (wc.find ("w1") == NULL);
+  EXPECT_TRUE (wc.find ("w8") != NULL);
+  EXPECT_LE (wc.size (), 8 * ((int) sizeof (word_shape) + 64));
+  wc.clear ();
+  EXPECT_TRUE (wc.find ("w8") == NULL);
+  EXPECT_EQ (wc.size (), 0);
+}
+
+TEST (word_cache, statistics) {
+  long long hits, misses;
+  word_cache_statistics (hits, misses);
+  word_cache wc;
+  wc.hit ();
+  wc.hit ();
+  wc.miss ();
+  EXPECT_EQ (wc.hits, 2);
+  EXPECT_EQ (wc.misses, 1);
+  long long hits2, misses2;
+  word_cache_statistics (hits2, misses2);
+  EXPECT_EQ (hits2, hits + 2);
+  EXPECT_EQ (misses2, misses + 1);
+}
@@ -0,0 +1,74 @@
+
+/******************************************************************************
+* MODULE     : handwriting_test.cpp
+* DESCRIPTION: test on the recognition of handwritten glyphs
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "handwriting.hpp"
+
+static poly_line
+stroke (double x1, double y1, double x2, double y2, double bend) {
+  // a slightly bent stroke from (x1, y1) to (x2, y2)
+  poly_line pl;
+  for (int i=0; i<=16; i++) {
+    double t= i / 16.0, b= bend * t * (1.0 - t);
+    pl << point (x1 + t * (x2 - x1) + b, y1 + t * (y2 - y1) - b);
+  }
+  return pl;
+}
+
+static contours
+glyph (int which, double noise) {
+  contours gl;
+  switch (which) {
+  case 0:  // a vertical bar
+    gl << stroke (0.0, 0.0, noise, 1.0, noise);
+    break;
+  case 1:  // a horizontal bar
+    gl << stroke (0.0, 0.0, 1.0, noise, 0.2 + noise);
+    break;
+  case 2:  // a plus sign
+    gl << stroke (0.5, 0.0, 0.5 + noise, 1.0, noise);
+    gl << stroke (0.0, 0.5, 1.0, 0.5 + noise, noise);
+    break;
+  default: // a cross
+    gl << stroke (0.0, 0.0, 1.0, 1.0 + noise, noise);
+    gl << stroke (1.0, 0.0, noise, 1.0, noise);
+    break;
+  }
+  return gl;
+}
+
+TEST (handwriting, buckets) {
+  glyph_buckets= array<glyph_bucket> ();
+  glyph_bucket_index= hashmap<string,int> (-1);
+  register_glyph ("|", glyph (0, 0.0));
+  register_glyph ("|", glyph (0, 0.01));
+  register_glyph ("+", glyph (2, 0.0));
+  array<double> cont;
+  string key= glyph_key (glyph (0, 0.02), 2, cont);
+  int i= glyph_bucket_index[key];
+  ASSERT_GE (i, 0);
+  EXPECT_EQ (N(glyph_buckets[i].names), 2);
+  EXPECT_EQ (glyph_buckets[i].dim, N(cont));
+  EXPECT_EQ (N(glyph_buckets[i].cont), 2 * N(cont));
+  EXPECT_NE (key, glyph_key (glyph (2, 0.0), 2, cont));
+}
+
+TEST (handwriting, recognition) {
+  glyph_buckets= array<glyph_bucket> ();
+  glyph_bucket_index= hashmap<string,int> (-1);
+  string names= "|-+x";
+  for (int k=0; k<5; k++)
+    for (int i=0; i<4; i++)
+      register_glyph (names (i, i+1), glyph (i, 0.01 * k));
+  for (int i=0; i<4; i++)
+    EXPECT_EQ (recognize_glyph (glyph (i, 0.025)), names (i, i+1));
+}
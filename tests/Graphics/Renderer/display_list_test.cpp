@@ -0,0 +1,132 @@
+
+/******************************************************************************
+* MODULE     : display_list_test.cpp
+* DESCRIPTION: test on retained lists of rendering instructions
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "display_list.hpp"
+#include "Boxes/construct.hpp"
+#include "colors.hpp"
+
+#define W 64
+#define H 48
+
+static renderer
+new_renderer (picture& pic) {
+  pic= native_picture (W, H, 0, H - 1);
+  renderer ren= picture_renderer (pic, 1.0);
+  ren->set_clipping (0, -H * PIXEL, W * PIXEL, 0);
+  ren->set_background (white);
+  ren->clear (0, -H * PIXEL, W * PIXEL, 0);
+  return ren;
+}
+
+static box
+test_box () {
+  // lines, arcs and polygons in several colors, partially overlapping
+  pencil thin (black, PIXEL), thick (blue, 3 * PIXEL);
+  array<box> bs;
+  array<SI>  x, y;
+  array<SI>  px, py;
+  px << 4 * PIXEL << 40 * PIXEL << 20 * PIXEL;
+  py << -40 * PIXEL << -36 * PIXEL << -6 * PIXEL;
+  bs << polygon_box (path (), px, py, brush (red), thin);
+  bs << line_box (path (), 0, 0, 60 * PIXEL, -44 * PIXEL, thick);
+  bs << arc_box (path (), 0, 0, 30 * PIXEL, 30 * PIXEL, 0, 360 * 64, thin);
+  bs << line_box (path (), 2 * PIXEL, -2 * PIXEL, 62 * PIXEL, -2 * PIXEL,
+                  pencil (green, 2 * PIXEL));
+  for (int i=0; i<N(bs); i++) { x << 0; y << 0; }
+  x[2]= 30 * PIXEL; y[2]= -40 * PIXEL;
+  return composite_box (path (), bs, x, y);
+}
+
+static void
+draw_box (box b, renderer ren) {
+  rectangles l;
+  b->redraw (ren, path (), l);
+}
+
+static int
+nr_different (picture p1, picture p2, int x1, int y1, int x2, int y2) {
+  int r= 0;
+  for (int y=y1; y<y2; y++)
+    for (int x=x1; x<x2; x++)
+      if (p1->get_pixel (x, y) != p2->get_pixel (x, y)) r++;
+  return r;
+}
+
+TEST (display_list, replay) {
+  box b= test_box ();
+  picture direct, replayed;
+  renderer ren1= new_renderer (direct);
+  draw_box (b, ren1);
+  renderer ren2= new_renderer (replayed);
+  display_list dl (ren2);
+  renderer rec= display_list_renderer (dl, ren2);
+  draw_box (b, rec);
+  delete_renderer (rec);
+  EXPECT_TRUE (dl->complete);
+  EXPECT_GT (dl->size (), 0);
+  dl->replay (ren2);
+  delete_renderer (ren1);
+  delete_renderer (ren2);
+  EXPECT_EQ (nr_different (direct, replayed, 0, 0, W, H), 0);
+}
+
+TEST (display_list, partial_replay) {
+  // only the segments which meet the clipping rectangle are replayed
+  box b= test_box ();
+  picture direct, replayed;
+  renderer ren1= new_renderer (direct);
+  draw_box (b, ren1);
+  renderer ren2= new_renderer (replayed);
+  display_list dl (ren2);
+  renderer rec= display_list_renderer (dl, ren2);
+  draw_box (b, rec);
+  delete_renderer (rec);
+  ren2->set_clipping (16 * PIXEL, -32 * PIXEL, 48 * PIXEL, -8 * PIXEL);
+  dl->replay (ren2);
+  delete_renderer (ren1);
+  delete_renderer (ren2);
+  EXPECT_EQ (nr_different (direct, replayed, 16, 8, 48, 32), 0);
+}
+
+TEST (display_list, memory_budget) {
+  box b= test_box ();
+  picture pic;
+  renderer ren= new_renderer (pic);
+  array<display_list> dls;
+  for (int i=0; i<4; i++) {
+    display_list dl (ren);
+    renderer rec= display_list_renderer (dl, ren);
+    draw_box (b, rec);
+    delete_renderer (rec);
+    dl->retain ();
+    dls << dl;
+  }
+  int one= dls[0]->bytes;
+  EXPECT_GT (one, 0);
+  EXPECT_GE (display_list_memory (), 4 * one);
+  // the least recently replayed lists are evicted first
+  int old_memory= display_list_memory ();
+  dls[0]->replay (ren);
+  set_display_list_memory (old_memory - one);
+  EXPECT_FALSE (dls[0]->evicted);
+  EXPECT_TRUE  (dls[1]->evicted);
+  EXPECT_FALSE (dls[2]->evicted);
+  EXPECT_FALSE (dls[1]->complete);
+  EXPECT_EQ (dls[1]->size (), 0);
+  EXPECT_EQ (display_list_memory (), old_memory - one);
+  // destroyed lists are no longer accounted for
+  dls= array<display_list> ();
+  EXPECT_EQ (display_list_memory (), old_memory - 4 * one);
+  set_display_list_memory (DISPLAY_LIST_MEMORY);
+  delete_renderer (ren);
+}
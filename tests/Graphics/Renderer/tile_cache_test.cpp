@@ -0,0 +1,82 @@
+
+/******************************************************************************
+* MODULE     : tile_cache_test.cpp
+* DESCRIPTION: test on caches of rasterized tiles
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "tile_cache.hpp"
+
+TEST (tile_cache, geometry) {
+  tile_cache tc (16, 1 << 20);
+  SI s= 16 * PIXEL;
+  EXPECT_EQ (tc->get_rectangle (0, 0), rectangle (0, -s, s, 0));
+  EXPECT_EQ (tc->get_rectangle (-1, 2), rectangle (-s, -3*s, 0, -2*s));
+  int i1, j1, i2, j2;
+  tc->get_range (rectangle (0, -s, s, 0), i1, j1, i2, j2);
+  EXPECT_EQ (i1, 0); EXPECT_EQ (i2, 1);
+  EXPECT_EQ (j1, 0); EXPECT_EQ (j2, 1);
+  tc->get_range (rectangle (-1, -s-1, s+1, 1), i1, j1, i2, j2);
+  EXPECT_EQ (i1, -1); EXPECT_EQ (i2, 2);
+  EXPECT_EQ (j1, -1); EXPECT_EQ (j2, 2);
+}
+
+TEST (tile_cache, eviction) {
+  tile_cache tc (16, 4 * 16 * 16 * 4);
+  for (int i=0; i<4; i++) tc->insert (i, 0, picture ());
+  EXPECT_EQ (N(tc), 4);
+  EXPECT_TRUE (tc->contains (0, 0));
+  tc->insert (4, 0, picture ());
+  EXPECT_EQ (N(tc), 4);
+  EXPECT_TRUE (tc->contains (0, 0));
+  EXPECT_FALSE (tc->contains (1, 0));
+  EXPECT_TRUE (tc->contains (4, 0));
+}
+
+TEST (tile_cache, shared_budget) {
+  // the caches of several views share the global budget
+  int tile= 4 * 16 * 16;
+  int used= tile_memory ();
+  set_tile_memory (used + 6 * tile);
+  {
+    tile_cache a (16, 4 * tile), b (16, 4 * tile);
+    for (int i=0; i<4; i++) a->insert (i, 0, picture ());
+    EXPECT_TRUE (a->contains (0, 0));
+    for (int i=0; i<4; i++) b->insert (i, 0, picture ());
+    EXPECT_EQ (N(a) + N(b), 6);
+    EXPECT_EQ (tile_memory (), used + 6 * tile);
+    EXPECT_TRUE (a->contains (0, 0));
+    EXPECT_FALSE (a->contains (1, 0));
+    EXPECT_FALSE (a->contains (2, 0));
+    EXPECT_EQ (N(b), 4);
+    set_tile_memory (used + 2 * tile);
+    EXPECT_EQ (N(a) + N(b), 2);
+    EXPECT_TRUE (a->contains (0, 0));
+    EXPECT_TRUE (b->contains (3, 0));
+  }
+  EXPECT_EQ (tile_memory (), used);
+  set_tile_memory (TILE_MEMORY);
+}
+
+TEST (tile_cache, invalidate) {
+  tile_cache tc (16, 1 << 20);
+  for (int i=0; i<4; i++)
+    for (int j=0; j<4; j++)
+      tc->insert (i, j, picture ());
+  EXPECT_EQ (N(tc), 16);
+  SI s= 16 * PIXEL;
+  tc->invalidate (rectangle (s + 1, -2*s + 1, s + 2, -2*s + 2));
+  EXPECT_EQ (N(tc), 15);
+  EXPECT_FALSE (tc->contains (1, 1));
+  tc->invalidate (rectangle (0, -4*s, s, 0));
+  EXPECT_EQ (N(tc), 11);
+  EXPECT_TRUE (tc->contains (3, 3));
+  tc->clear ();
+  EXPECT_EQ (N(tc), 0);
+}
@@ -0,0 +1,103 @@
+
+/******************************************************************************
+* MODULE     : curve_test.cpp
+* DESCRIPTION: test on the evaluation and the rectification of curves
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "curve.hpp"
+#include "path.hpp"
+
+static array<point>
+lift (array<point> a) {
+  // the same points in three dimensions
+  array<point> r;
+  for (int i=0; i<N(a); i++)
+    r << point (a[i][0], a[i][1], 0.0);
+  return r;
+}
+
+static array<point>
+zigzag () {
+  array<point> a;
+  a << point (0.0, 0.0) << point (1.0, 2.0) << point (2.5, -1.0)
+    << point (4.0, 1.5) << point (5.0, 0.0);
+  return a;
+}
+
+static void
+check_batch (curve c) {
+  array<double> ts;
+  for (int i=0; i<=40; i++) ts << i / 40.0;
+  array<point2> r= c->evaluate_batch (ts);
+  ASSERT_EQ (N(r), N(ts));
+  for (int i=0; i<N(ts); i++) {
+    point p= c (ts[i]);
+    EXPECT_NEAR (r[i].x, p[0], 1.0e-12);
+    EXPECT_NEAR (r[i].y, p[1], 1.0e-12);
+  }
+}
+
+static void
+check_rectify (curve c2, curve c3) {
+  // two dimensional curves are rectified like their three dimensional lifts
+  array<point> a2= c2->rectify (0.01);
+  array<point> a3= c3->rectify (0.01);
+  ASSERT_EQ (N(a2), N(a3));
+  for (int i=0; i<N(a2); i++) {
+    ASSERT_EQ (N(a2[i]), 2);
+    EXPECT_DOUBLE_EQ (a2[i][0], a3[i][0]);
+    EXPECT_DOUBLE_EQ (a2[i][1], a3[i][1]);
+  }
+}
+
+TEST (curve, point2) {
+  point2 p (1.0, 2.0), q (3.0, -1.0);
+  EXPECT_TRUE (p + q == point2 (4.0, 1.0));
+  EXPECT_TRUE (p - q == point2 (-2.0, 3.0));
+  EXPECT_TRUE (2.0 * p == point2 (2.0, 4.0));
+  EXPECT_TRUE (q / 2.0 == point2 (1.5, -0.5));
+  EXPECT_EQ (inner (p, q), 1.0);
+  EXPECT_EQ (norm (point2 (3.0, 4.0)), 5.0);
+  EXPECT_TRUE (as_point2 (point (1.0, 2.0, 3.0)) == p);
+  EXPECT_TRUE (as_point2 (point ()) == point2 ());
+  EXPECT_TRUE (as_point (p) == point (1.0, 2.0));
+}
+
+TEST (curve, point3) {
+  point3 i (1.0, 0.0, 0.0), j (0.0, 1.0, 0.0);
+  EXPECT_TRUE (cross (i, j) == point3 (0.0, 0.0, 1.0));
+  EXPECT_EQ (inner (i + j, j), 1.0);
+  EXPECT_TRUE (as_point3 (point (1.0, 2.0)) == point3 (1.0, 2.0, 0.0));
+  EXPECT_TRUE (as_point (point3 (1.0, 2.0, 3.0)) == point (1.0, 2.0, 3.0));
+}
+
+TEST (curve, batch_evaluation) {
+  array<point> a= zigzag ();
+  array<point> b= range (a, 0, 4);
+  check_batch (segment (a[0], a[1]));
+  check_batch (poly_segment (a, array<path> ()));
+  check_batch (spline (a, array<path> ()));
+  check_batch (spline (a, array<path> (), true));
+  check_batch (bezier (b));
+  check_batch (arc (range (a, 0, 3), array<path> ()));
+  check_batch (spline (lift (a), array<path> ()));
+  check_batch (bezier (lift (b)));
+}
+
+TEST (curve, rectification) {
+  array<point> a= zigzag ();
+  array<point> b= range (a, 0, 4);
+  check_rectify (bezier (b), bezier (lift (b)));
+  check_rectify (spline (a, array<path> ()), spline (lift (a), array<path> ()));
+  check_rectify (spline (a, array<path> (), true),
+                 spline (lift (a), array<path> (), true));
+  check_rectify (arc (range (a, 0, 3), array<path> ()),
+                 arc (lift (range (a, 0, 3)), array<path> ()));
+}
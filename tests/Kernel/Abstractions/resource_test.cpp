@@ -0,0 +1,88 @@
+
+/******************************************************************************
+* MODULE     : resource_test.cpp
+* DESCRIPTION: test on the eviction of the cached data of resources
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "resource.hpp"
+
+RESOURCE(squares);
+
+struct squares_rep: rep<squares> {
+  hashmap<int,int> cache;
+  squares_rep (string name): rep<squares> (name), cache (0) {}
+  int get (int i) {
+    if (!cache->contains (i)) cache (i)= i * i;
+    return cache [i]; }
+  int  cache_size () { return 100 * N(cache); }
+  void cache_evict () { cache= hashmap<int,int> (0); }
+};
+
+RESOURCE_CODE(squares);
+
+static squares
+make_squares (string name) {
+  return make (squares, name, tm_new<squares_rep> (name));
+}
+
+static void
+use (squares sq, int n) {
+  for (int i=0; i<n; i++) (void) sq->get (i);
+}
+
+TEST (resource, statistics) {
+  int count= resource_count ("squares");
+  int size = resource_cache_size ("squares");
+  squares a= make_squares ("statistics a");
+  squares b= make_squares ("statistics b");
+  squares c= make_squares ("statistics a");
+  EXPECT_EQ (a.rep, c.rep);
+  use (a, 3);
+  use (b, 5);
+  EXPECT_EQ (resource_count ("squares"), count + 2);
+  EXPECT_EQ (resource_cache_size ("squares"), size + 800);
+}
+
+TEST (resource, idle_eviction) {
+  squares a= make_squares ("idle a");
+  squares b= make_squares ("idle b");
+  use (a, 10);
+  use (b, 10);
+  evict_resources (1, 1 << 30);
+  use (a, 10);
+  evict_resources (1, 1 << 30);
+  // accessing the resources through a.rep does not count as a use
+  EXPECT_EQ (a.rep->cache_size (), 1000);
+  EXPECT_EQ (b.rep->cache_size (), 0);
+  EXPECT_EQ (a->get (7), 49);
+}
+
+TEST (resource, budget) {
+  evict_resources (0, 0);
+  squares a= make_squares ("budget a");
+  squares b= make_squares ("budget b");
+  squares c= make_squares ("budget c");
+  use (a, 10);
+  evict_resources (5, 1 << 30);
+  use (b, 10);
+  evict_resources (5, 1 << 30);
+  use (c, 10);
+  // a is the least recently used resource, c is in use
+  evict_resources (5, 2000);
+  EXPECT_EQ (a.rep->cache_size (), 0);
+  EXPECT_EQ (b.rep->cache_size (), 1000);
+  EXPECT_EQ (c.rep->cache_size (), 1000);
+  // resources in use are kept, even when exceeding the budget
+  use (a, 10);
+  use (b, 10);
+  use (c, 10);
+  evict_resources (5, 0);
+  EXPECT_EQ (resource_cache_size ("squares"), 3000);
+}
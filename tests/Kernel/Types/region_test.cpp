@@ -0,0 +1,105 @@
+
+/******************************************************************************
+* MODULE     : region_test.cpp
+* DESCRIPTION: test on banded regions
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "region.hpp"
+
+static bool
+inside (region r, SI x, SI y) {
+  rectangles l= as_rectangles (r);
+  for (; !is_nil (l); l= l->next)
+    if (l->item->x1 <= x && x < l->item->x2 &&
+        l->item->y1 <= y && y < l->item->y2) return true;
+  return false;
+}
+
+static region
+random_region (int n) {
+  rectangles l;
+  for (int i=0; i<n; i++) {
+    SI x= rand () % 16, y= rand () % 16;
+    l= rectangles (rectangle (x, y, x + rand () % 8, y + rand () % 8), l);
+  }
+  return region (l);
+}
+
+/******************************************************************************
+* Construction and conversion
+******************************************************************************/
+
+TEST (region, empty) {
+  EXPECT_TRUE (is_empty (region ()));
+  EXPECT_TRUE (is_empty (region (rectangle (0, 0, 0, 10))));
+  EXPECT_TRUE (is_empty (region (rectangles ())));
+  EXPECT_EQ (N (region (0, 0, 10, 10)), 1);
+}
+
+TEST (region, coalescing) {
+  region r= region (0, 0, 10, 10) | region (10, 0, 20, 10);
+  EXPECT_EQ (r, region (0, 0, 20, 10));
+  r= region (0, 0, 10, 10) | region (0, 10, 10, 20);
+  EXPECT_EQ (r, region (0, 0, 10, 20));
+  r= region (rectangles (rectangle (0, 0, 10, 10),
+                         rectangles (rectangle (5, 5, 15, 15))));
+  EXPECT_EQ (N(r), 3);
+  EXPECT_EQ (area (r), 175.0);
+  EXPECT_EQ (least_upper_bound (r), rectangle (0, 0, 15, 15));
+}
+
+/******************************************************************************
+* Set operations
+******************************************************************************/
+
+TEST (region, operations) {
+  region a (0, 0, 10, 10), b (5, 5, 15, 15);
+  EXPECT_EQ (a & b, region (5, 5, 10, 10));
+  EXPECT_EQ (area (a - b), 75.0);
+  EXPECT_EQ (area (a | b), 175.0);
+  EXPECT_TRUE ((a & b) <= a);
+  EXPECT_FALSE (a <= b);
+  EXPECT_TRUE (intersect (a, b));
+  EXPECT_FALSE (intersect (a, translate (b, 10, 0)));
+  EXPECT_EQ ((a - b) | (a & b), a);
+}
+
+TEST (region, random) {
+  srand (42);
+  for (int k=0; k<50; k++) {
+    region a= random_region (1 + k % 7), b= random_region (1 + k % 5);
+    region u= a | b, i= a & b, d= a - b;
+    for (SI x=0; x<24; x++)
+      for (SI y=0; y<24; y++) {
+        bool in_a= inside (a, x, y), in_b= inside (b, x, y);
+        EXPECT_EQ (inside (u, x, y), in_a || in_b);
+        EXPECT_EQ (inside (i, x, y), in_a && in_b);
+        EXPECT_EQ (inside (d, x, y), in_a && !in_b);
+      }
+    EXPECT_EQ (region (as_rectangles (u)), u);
+    EXPECT_EQ (b | a, u);
+  }
+}
+
+/******************************************************************************
+* Compatibility with lists of rectangles
+******************************************************************************/
+
+TEST (region, rectangles) {
+  rectangles l1 (rectangle (0, 0, 10, 10));
+  rectangles l2 (rectangle (5, 5, 15, 15));
+  EXPECT_EQ (area (l1 | l2), 175.0);
+  EXPECT_EQ (area (l1 - l2), 75.0);
+  EXPECT_EQ (area (l1 & l2), 25.0);
+  EXPECT_TRUE (is_nil (l1 - l1));
+  EXPECT_EQ (N (simplify (rectangles (rectangle (0, 0, 10, 10),
+                                      rectangles (rectangle (10, 0, 20, 10))))),
+             1);
+}
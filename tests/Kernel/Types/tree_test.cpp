@@ -0,0 +1,78 @@
+
+/******************************************************************************
+* MODULE     : tree_test.cpp
+* DESCRIPTION: test on frozen and hash-consed trees
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "tree.hpp"
+#include "hashmap.hpp"
+
+static tree
+sample (int i) {
+  return document (concat ("x", tree (RSUP, as_string (i))),
+                   compound ("em", "text"));
+}
+
+TEST (tree, freeze_shares) {
+  tree t1= freeze (sample (1)), t2= freeze (sample (1));
+  ASSERT_TRUE (is_frozen (t1));
+  ASSERT_TRUE (strong_equal (t1, t2));
+  ASSERT_TRUE (strong_equal (freeze (t1), t1));
+  ASSERT_TRUE (strong_equal (t1[1][0], freeze (tree ("text"))));
+  tree t3= freeze (sample (2));
+  ASSERT_FALSE (strong_equal (t1, t3));
+  ASSERT_TRUE (strong_equal (t1[1], t3[1]));
+}
+
+TEST (tree, freeze_equality) {
+  tree t1= freeze (sample (1)), t3= freeze (sample (3));
+  ASSERT_EQ (t1, sample (1));
+  ASSERT_EQ (sample (1), t1);
+  ASSERT_NE (t1, t3);
+  ASSERT_TRUE (t1 != t3);
+  ASSERT_EQ (hash (t1), hash (sample (1)));
+  ASSERT_EQ (hash (t3), hash (sample (3)));
+  hashmap<tree,int> h (0);
+  h (t1)= 1;
+  h (sample (3))= 3;
+  ASSERT_EQ (h[sample (1)], 1);
+  ASSERT_EQ (h[t3], 3);
+}
+
+TEST (tree, freeze_unfreeze) {
+  tree t= concat ("a", tree (UNFREEZE, "b"));
+  ASSERT_EQ (freeze (t), concat ("a", "b"));
+}
+
+TEST (tree, freeze_release) {
+  int n= number_of_frozen_trees ();
+  {
+    tree t= freeze (sample (12345));
+    ASSERT_GT (number_of_frozen_trees (), n);
+  }
+  ASSERT_EQ (number_of_frozen_trees (), n);
+}
+
+TEST (tree, freeze_many) {
+  // exercise the growth of the table and the removal of entries
+  array<tree> a;
+  for (int i=0; i<5000; i++)
+    a << freeze (sample (i % 2000));
+  for (int i=0; i<5000; i++) {
+    ASSERT_TRUE (strong_equal (a[i], a[i % 2000]));
+    ASSERT_EQ (a[i], sample (i % 2000));
+  }
+  for (int i=0; i<2000; i+=2) {
+    a[i]= tree (); a[i+2000]= tree ();
+    if (i+4000 < 5000) a[i+4000]= tree ();
+  }
+  for (int i=1; i<2000; i+=2)
+    ASSERT_TRUE (strong_equal (freeze (sample (i)), a[i]));
+}
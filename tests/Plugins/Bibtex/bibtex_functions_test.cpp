@@ -0,0 +1,80 @@
+
+/******************************************************************************
+* MODULE     : bibtex_functions_test.cpp
+* DESCRIPTION: test on the selection of entries in BibTeX files
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "Bibtex/bibtex_functions.hpp"
+#include "file.hpp"
+#include <utime.h>
+
+static string bib_sample=
+  "% a sample bibliography\n"
+  "@string{ jsc = \"Journal of Symbolic Computation\" }\n"
+  "@article{ vdh:fast,\n"
+  "  author  = {J. van der Hoeven},\n"
+  "  title   = {Fast {E}valuation},\n"
+  "  journal = jsc,\n"
+  "  year    = 2015,\n"
+  "  crossref= {proc}\n"
+  "}\n"
+  "Some text between the entries\n"
+  "@Book(knuth:tex,\n"
+  "  author = \"D. Knuth\",\n"
+  "  title  = \"The {\\TeX}book (second edition)\"\n"
+  ")\n"
+  "@comment{ unused:entry, title = {Not an entry} }\n"
+  "@proceedings{proc, title = {Proceedings}, year = {2015}}\n"
+  "@misc{knuth:tex, title = {A duplicate}}\n"
+  "@book{knuth84 ,\n"
+  "  title = {Blanks after the key}\n"
+  "}\n";
+
+static tree
+cited (string a, string b, string c) {
+  return tree (DOCUMENT, a, b, c);
+}
+
+TEST (bibtex_functions, indexed_entries) {
+  url u= url_temp_dir () * "indexed_entries.bib";
+  save_string (u, bib_sample);
+  tree keys= cited ("knuth:tex", "vdh:fast", "missing");
+  tree expected= bib_entries (parse_bib (bib_sample), keys);
+  ASSERT_EQ (N(expected), 3);
+  EXPECT_EQ (bib_entries (u, keys), expected);
+  EXPECT_EQ (bib_entries (u, keys), expected);
+  keys= cited ("proc", "unused:entry", "knuth:tex");
+  EXPECT_EQ (bib_entries (u, keys), bib_entries (parse_bib (bib_sample), keys));
+}
+
+TEST (bibtex_functions, blanks_after_key) {
+  url u= url_temp_dir () * "blanks_after_key.bib";
+  save_string (u, bib_sample);
+  tree keys= cited ("knuth84", "proc", "missing");
+  tree expected= bib_entries (parse_bib (bib_sample), keys);
+  ASSERT_EQ (N(expected), 2);
+  EXPECT_EQ (bib_entries (u, keys), expected);
+}
+
+TEST (bibtex_functions, modified_file) {
+  url u= url_temp_dir () * "modified_file.bib";
+  save_string (u, bib_sample);
+  tree keys= cited ("knuth:tex", "vdh:fast", "new");
+  EXPECT_EQ (N (bib_entries (u, keys)), 3);
+  string s= bib_sample * "@misc{new, title = {A new entry}}\n";
+  save_string (u, s);
+  c_string path (concretize (u));
+  struct utimbuf times;
+  times.actime = 1000000000;
+  times.modtime= 1000000000;
+  utime (path, &times);
+  EXPECT_EQ (bib_entries (u, keys), bib_entries (parse_bib (s), keys));
+  EXPECT_EQ (N (bib_entries (u, keys)), 4);
+}
@@ -0,0 +1,78 @@
+
+/******************************************************************************
+* MODULE     : tex_database_test.cpp
+* DESCRIPTION: test on the native lookup of files in TeX trees
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "Metafont/tex_database.hpp"
+#include "file.hpp"
+#include "sys_utils.hpp"
+#include <utime.h>
+
+static url
+tex_tree () {
+  // a TeX installation with a local and a distribution tree
+  url root= url_temp_dir () * "tex_database";
+  string r= as_string (root);
+  mkdir (root);
+  mkdir (root * "web2c");
+  mkdir (root * "texmf-dist");
+  mkdir (root * "texmf-local");
+  save_string (root * "web2c/texmf.cnf",
+    "% configuration for the test\n"
+    "TEXMFROOT = " * r * "\n"
+    "TEXMFDIST = $TEXMFROOT/texmf-dist\n"
+    "TEXMFLOCAL = ${TEXMFROOT}/texmf-local\n"
+    "TEXMF = {$TEXMFLOCAL,!!$TEXMFDIST}\n"
+    "TEXMFDBS = {!!$TEXMFLOCAL,!!$TEXMFDIST}\n"
+    "TFMFONTS = .;$TEXMF/fonts/tfm//\n"
+    "T1FONTS = .;$TEXMF/fonts/{type1,\\\n"
+    "  pfb}//\n"
+    "TFMFONTS = ignored\n"
+    "PKFONTS.kpsewhich = ignored\n");
+  save_string (root * "texmf-dist/ls-R",
+    "% ls-R -- filename database for kpathsea; do not change this line.\n"
+    "./:\nfonts\n\n"
+    "./fonts/tfm/public/cm:\ncmr10.tfm\ncmbx10.tfm\n\n"
+    "./fonts/type1/public/amsfonts/cm:\ncmr10.pfb\n\n"
+    "./fonts/source/public/cm:\ncmr10.mf\nstray.tfm\n");
+  save_string (root * "texmf-local/ls-R",
+    "% ls-R -- filename database for kpathsea; do not change this line.\n"
+    "./fonts/tfm/local:\ncmr10.tfm\n");
+  set_env ("TEXMFCNF", as_string (root * "web2c"));
+  reset_tex_database ();
+  return root;
+}
+
+TEST (tex_database, lookup) {
+  url root= tex_tree ();
+  EXPECT_EQ (as_string (tex_database_resolve ("cmbx10.tfm")),
+             as_string (root * "texmf-dist/fonts/tfm/public/cm/cmbx10.tfm"));
+  EXPECT_EQ (as_string (tex_database_resolve ("cmr10.tfm")),
+             as_string (root * "texmf-local/fonts/tfm/local/cmr10.tfm"));
+  EXPECT_EQ (as_string (tex_database_resolve ("cmr10.pfb")),
+             as_string (root * "texmf-dist/fonts/type1/public/amsfonts" *
+                        "cm/cmr10.pfb"));
+  EXPECT_TRUE (is_none (tex_database_resolve ("stray.tfm")));
+  EXPECT_TRUE (is_none (tex_database_resolve ("missing.tfm")));
+}
+
+TEST (tex_database, modified_database) {
+  url root= tex_tree ();
+  url db= root * "texmf-local/ls-R";
+  EXPECT_TRUE (is_none (tex_database_resolve ("cmti10.tfm")));
+  save_string (db, "./fonts/tfm/local:\ncmr10.tfm\ncmti10.tfm\n");
+  struct utimbuf times;
+  times.actime= times.modtime= last_modified (db, false) + 10;
+  c_string path (concretize (db));
+  utime (path, &times);
+  EXPECT_EQ (as_string (tex_database_resolve ("cmti10.tfm")),
+             as_string (root * "texmf-local/fonts/tfm/local/cmti10.tfm"));
+}
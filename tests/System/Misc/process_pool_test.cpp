@@ -0,0 +1,64 @@
+
+/******************************************************************************
+* MODULE     : process_pool_test.cpp
+* DESCRIPTION: test on bounded pools of concurrently running commands
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "process_pool.hpp"
+
+static array<int> done_jobs;
+
+class record_command_rep: public command_rep {
+  int job;
+public:
+  record_command_rep (int job2): job (job2) {}
+  void apply () { done_jobs << job; }
+};
+
+TEST (process_pool, wait) {
+  done_jobs= array<int> ();
+  process_pool pool (2);
+  for (int i=0; i<6; i++)
+    pool->submit ("true", tm_new<record_command_rep> (i));
+  // completion commands are only applied when the pool is polled
+  EXPECT_EQ (N(done_jobs), 0);
+  EXPECT_EQ (pool->active (), 2);
+  EXPECT_EQ (pool->pending (), 6);
+  pool->wait ();
+  EXPECT_EQ (N(done_jobs), 6);
+  EXPECT_EQ (pool->active (), 0);
+  EXPECT_EQ (pool->pending (), 0);
+}
+
+TEST (process_pool, limit) {
+  done_jobs= array<int> ();
+  process_pool pool (3);
+  for (int i=0; i<10; i++)
+    pool->submit ("sleep 0.01", tm_new<record_command_rep> (i));
+  while (pool->pending () > 0) {
+    EXPECT_LE (pool->active (), 3);
+    EXPECT_EQ (pool->pending () - pool->active (), max (7 - N(done_jobs), 0));
+    pool->poll ();
+  }
+  EXPECT_EQ (N(done_jobs), 10);
+}
+
+TEST (process_pool, order) {
+  done_jobs= array<int> ();
+  process_pool pool (1);
+  EXPECT_FALSE (pool->poll ());
+  for (int i=0; i<5; i++)
+    pool->submit ("true", tm_new<record_command_rep> (i));
+  pool->submit ("true", command ());
+  while (pool->pending () > 0) pool->poll ();
+  // with a single process at a time, jobs complete in submission order
+  ASSERT_EQ (N(done_jobs), 5);
+  for (int i=0; i<5; i++) EXPECT_EQ (done_jobs[i], i);
+}
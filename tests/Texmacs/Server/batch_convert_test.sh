@@ -0,0 +1,42 @@
+#!/bin/sh
+# Convert the same documents with one and with several processes and check
+# that the results are identical.
+# usage: batch_convert_test.sh [texmacs binary] [TeXmacs directory]
+
+TEXMACS_BIN=$1
+TEXMACS_PATH=$2
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+export TEXMACS_PATH
+export TEXMACS_HOME_PATH="$TMP/home"
+export QT_QPA_PLATFORM=offscreen
+
+DOCS="about/about-summary.en.tm about/about.en.tm about/about.fr.tm
+      about/about-summary.de.tm main/start/man-conventions.en.tm"
+
+for n in 1 4; do
+  mkdir -p "$TMP/out$n"
+  : > "$TMP/jobs$n"
+  for doc in $DOCS; do
+    name=$(echo "$doc" | tr '/' '-')
+    for ext in html tex; do
+      echo "$TEXMACS_PATH/doc/$doc $TMP/out$n/$name.$ext" >> "$TMP/jobs$n"
+    done
+  done
+  "$TEXMACS_BIN" -s -cb "$TMP/jobs$n" -j $n -q || exit 1
+done
+
+status=0
+for f in "$TMP"/out1/*; do
+  g="$TMP/out4/$(basename "$f")"
+  if ! cmp -s "$f" "$g"; then
+    echo "batch conversion differs with 4 processes: $(basename "$f")"
+    status=1
+  fi
+done
+count=$(ls "$TMP/out1" | wc -l)
+if [ "$count" -ne 10 ]; then
+  echo "$count documents converted instead of 10"
+  status=1
+fi
+exit $status
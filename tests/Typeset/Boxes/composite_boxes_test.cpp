@@ -0,0 +1,104 @@
+
+/******************************************************************************
+* MODULE     : composite_boxes_test.cpp
+* DESCRIPTION: test on the spatial index on the children of composite boxes
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "Boxes/construct.hpp"
+#include "Boxes/composite.hpp"
+#include <stdlib.h>
+
+static int
+random_int (int n) {
+  return rand () % n;
+}
+
+static box
+random_layout (int mode, int n) {
+  // children on a line, in a column, or scattered, some of them inaccessible
+  array<box> bs;
+  array<SI>  x, y;
+  for (int i=0; i<n; i++) {
+    path ip= (random_int (4) == 0? decorate (): path (i));
+    bs << empty_box (ip, 0, -random_int (50), random_int (150), random_int (80));
+    if (mode == 0) { x << 100 * i; y << 0; }
+    else if (mode == 1) { x << 0; y << -100 * i; }
+    else { x << random_int (10000); y << random_int (10000); }
+  }
+  return composite_box (path (), bs, x, y);
+}
+
+static int
+linear_closest_child (composite_box_rep* b, SI x, SI y, SI delta, bool force) {
+  int i, n= N(b->bs), d= MAX_SI, m= -1;
+  for (i=0; i<n; i++)
+    if (b->distance (i, x, y, delta) < d)
+      if (b->bs[i]->accessible () || force) {
+        d= b->distance (i, x, y, delta);
+        m= i;
+      }
+  return m;
+}
+
+static array<int>
+linear_children (composite_box_rep* b, SI x1, SI y1, SI x2, SI y2) {
+  array<int> r;
+  for (int i=0; i<N(b->bs); i++)
+    if (max (b->sx2(i), b->sx4(i)) >= x1 && min (b->sx1(i), b->sx3(i)) <= x2 &&
+        max (b->sy2(i), b->sy4(i)) >= y1 && min (b->sy1(i), b->sy3(i)) <= y2)
+      r << i;
+  return r;
+}
+
+static void
+random_point (composite_box_rep* b, int q, SI& x, SI& y) {
+  // alternatively arbitrary points and points on the borders of children
+  if (q % 2 == 0) {
+    x= b->x1 - 200 + random_int (b->x2 - b->x1 + 400);
+    y= b->y1 - 200 + random_int (b->y2 - b->y1 + 400);
+  }
+  else {
+    int i= random_int (N(b->bs));
+    x= (random_int (2) == 0? b->sx1(i): b->sx2(i)) + random_int (3) - 1;
+    y= (random_int (2) == 0? b->sy1(i): b->sy2(i)) + random_int (3) - 1;
+  }
+}
+
+TEST (composite_box, find_closest_child) {
+  srand (1);
+  for (int t=0; t<60; t++) {
+    int  n= BOX_INDEX_THRESHOLD + random_int (400);
+    box  bx= random_layout (t % 3, n);
+    composite_box_rep* b= (composite_box_rep*) bx.operator-> ();
+    for (int q=0; q<200; q++) {
+      SI x, y;
+      random_point (b, q, x, y);
+      SI   delta= random_int (3) - 1;
+      bool force= (random_int (2) == 0);
+      ASSERT_EQ (b->find_closest_child (x, y, delta, force),
+                 linear_closest_child (b, x, y, delta, force));
+    }
+  }
+}
+
+TEST (composite_box, find_children) {
+  srand (2);
+  for (int t=0; t<60; t++) {
+    int  n= BOX_INDEX_THRESHOLD + random_int (400);
+    box  bx= random_layout (t % 3, n);
+    composite_box_rep* b= (composite_box_rep*) bx.operator-> ();
+    for (int q=0; q<100; q++) {
+      SI x, y, w= random_int (500);
+      random_point (b, q, x, y);
+      ASSERT_EQ (b->find_children (x - w, y - w, x + w, y + w),
+                 linear_children (b, x - w, y - w, x + w, y + w));
+    }
+  }
+}
@@ -0,0 +1,135 @@
+
+/******************************************************************************
+* MODULE     : typesetter_test.cpp
+* DESCRIPTION: test on retypesetting the readers of changed references
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "Bridge/impl_typesetter.hpp"
+#include "drd_std.hpp"
+
+extern tree the_et;
+
+class typesetter_passes: public ::testing::Test {
+protected:
+  static void SetUpTestCase () { init_std_drd (); }
+};
+
+static tree
+paragraphs (tree first, tree last, int n) {
+  tree doc (DOCUMENT);
+  doc << first;
+  for (int i=0; i<n; i++)
+    doc << concat ("Paragraph ", as_string (i), " of the test.");
+  doc << last;
+  return doc;
+}
+
+static int
+typeset_passes (typesetter ttt) {
+  // typeset as the editor does, and return the number of passes
+  SI x1= 0, y1= 0, x2= 0, y2= 0;
+  (void) typeset (ttt, x1, y1, x2, y2);
+  int pass= 1;
+  while (true) {
+    array<path> ps= changed_readers (ttt, pass);
+    if (N(ps) == 0) return pass;
+    notify_readers (ttt, ps);
+    (void) typeset (ttt, x1, y1, x2, y2);
+    pass++;
+  }
+}
+
+TEST_F (typesetter_passes, forward_reference) {
+  tree first= concat ("See ", tree (GET_BINDING, "later"));
+  tree last = concat ("Here", tree (SET_BINDING, "later", "42"));
+  the_et= tuple (paragraphs (first, last, 20));
+  attach_ip (the_et, path ());
+  drd_info drd ("none", std_drd);
+  hashmap<string,tree> h1 (UNINIT), h2 (UNINIT), h3 (UNINIT);
+  hashmap<string,tree> h4 (UNINIT), h5 (UNINIT), h6 (UNINIT);
+  edit_env env (drd, "none", h1, h2, h3, h4, h5, h6);
+
+  // the reference is only known after the first pass; the second pass
+  // typesets the first paragraph again, and nothing else
+  typesetter ttt= new_typesetter (env, the_et[0], path (0));
+  ASSERT_EQ (typeset_passes (ttt), 2);
+  ASSERT_LT (ttt->nr_typeset, N(the_et[0]) / 4);
+  ASSERT_EQ (env->local_ref ["later"][0], tree ("42"));
+  array<string> keys;
+  keys << string ("later");
+  ASSERT_EQ (N(ttt->readers (keys)), 1);
+  ASSERT_EQ (ttt->readers (keys)[0], path (0, 0));
+  delete_typesetter (ttt);
+  the_et= tree ();
+}
+
+TEST_F (typesetter_passes, unstable_references) {
+  // a reference which changes whenever it is read never stabilizes
+  tree incr= tree (SET_BINDING, "counter",
+                   tree (PLUS, tree (GET_BINDING, "counter"), "1"));
+  the_et= tuple (paragraphs (concat ("Count", incr), "End", 5));
+  attach_ip (the_et, path ());
+  drd_info drd ("none", std_drd);
+  hashmap<string,tree> h1 (UNINIT), h2 (UNINIT), h3 (UNINIT);
+  hashmap<string,tree> h4 (UNINIT), h5 (UNINIT), h6 (UNINIT);
+  h1 ("counter")= tuple ("0", "?");
+  edit_env env (drd, "none", h1, h2, h3, h4, h5, h6);
+  typesetter ttt= new_typesetter (env, the_et[0], path (0));
+  ASSERT_EQ (typeset_passes (ttt), MAX_TYPESET_PASSES);
+  ASSERT_EQ (env->local_ref ["counter"][0],
+             tree (as_string (MAX_TYPESET_PASSES)));
+  delete_typesetter (ttt);
+  the_et= tree ();
+}
+
+static SI
+stack_height (typesetter ttt) {
+  SI h= 0;
+  for (int i=0; i<N(ttt->l); i++)
+    h += ttt->l[i]->b->h () + ttt->l[i]->spc->def;
+  return h;
+}
+
+TEST_F (typesetter_passes, far_paragraphs) {
+  the_et= tuple (paragraphs ("First", "Last", 100));
+  attach_ip (the_et, path ());
+  drd_info drd ("none", std_drd);
+  hashmap<string,tree> h1 (UNINIT), h2 (UNINIT), h3 (UNINIT);
+  hashmap<string,tree> h4 (UNINIT), h5 (UNINIT), h6 (UNINIT);
+  edit_env env (drd, "none", h1, h2, h3, h4, h5, h6);
+  SI x1= 0, y1= 0, x2= 0, y2= 0;
+
+  // only the paragraphs near the focus are typeset at first
+  typesetter ttt= new_typesetter (env, the_et[0], path (0));
+  estimate_far_paragraphs (ttt);
+  (void) typeset (ttt, x1, y1, x2, y2);
+  ASSERT_GT (number_of_estimates (ttt), 0);
+  ASSERT_TRUE (typeset_provisional (ttt));
+  ASSERT_FALSE (estimates_completed (ttt));
+
+  // all estimates are replaced when there is enough time
+  complete_estimates (ttt, texmacs_time () + 1000000);
+  (void) typeset (ttt, x1, y1, x2, y2);
+  ASSERT_EQ (number_of_estimates (ttt), 0);
+  ASSERT_FALSE (typeset_provisional (ttt));
+  ASSERT_TRUE (estimates_completed (ttt));
+
+  // the result is the same as that of a complete typesetting
+  hashmap<string,tree> k1 (UNINIT), k2 (UNINIT), k3 (UNINIT);
+  hashmap<string,tree> k4 (UNINIT), k5 (UNINIT), k6 (UNINIT);
+  edit_env env2 (drd, "none", k1, k2, k3, k4, k5, k6);
+  typesetter full= new_typesetter (env2, the_et[0], path (0));
+  (void) typeset (full, x1, y1, x2, y2);
+  ASSERT_EQ (N(ttt->l), N(full->l));
+  ASSERT_EQ (stack_height (ttt), stack_height (full));
+  delete_typesetter (full);
+  delete_typesetter (ttt);
+  the_et= tree ();
+}
@@ -0,0 +1,152 @@
+
+/******************************************************************************
+* MODULE     : page_breaker_test.cpp
+* DESCRIPTION: test on incremental page breaking
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "Boxes/construct.hpp"
+#include "Format/page_item.hpp"
+#include "Page/skeleton.hpp"
+#include "font.hpp"
+
+skeleton break_pages (array<page_item> l, space ph, int qual,
+                      space fn_sep, space fnote_sep, space float_sep,
+                      font fn, int first_page,
+                      array<page_item> old_l, skeleton old_sk);
+
+struct test_font_rep: font_rep {
+  test_font_rep (): font_rep ("page-breaker-test") { y1= -2000; y2= 8000; }
+  bool supports (string c) { (void) c; return true; }
+  void get_extents (string s, metric& ex) { (void) s; (void) ex; }
+  void draw_fixed (renderer ren, string s, SI x, SI y) {
+    (void) ren; (void) s; (void) x; (void) y; }
+  font magnify (double zx, double zy) { (void) zx; (void) zy; return this; }
+};
+
+static font
+test_font () {
+  static font fn= tm_new<test_font_rep> ();
+  return fn;
+}
+
+static int serial= 0;
+
+static page_item
+line (int i, SI h= 10000) {
+  page_item item (empty_box (path (serial++), 0, -2000, 300000, h - 2000));
+  int j= i % 8;
+  item->spc    = j == 7? space (4000, 6000, 10000): space (2000);
+  item->penalty= j == 0 || j == 6? 100: (j == 7? 0: 1);
+  return item;
+}
+
+static array<page_item>
+document (int nr_lines) {
+  array<page_item> l;
+  for (int i=0; i<nr_lines; i++) l << line (i);
+  return l;
+}
+
+static skeleton
+break_document (array<page_item> l,
+                array<page_item> old_l= array<page_item> (),
+                skeleton old_sk= skeleton ()) {
+  space ht (520000, 540000, 560000);
+  return break_pages (l, ht, 2, space (0), space (0), space (0),
+                      test_font (), 1, old_l, old_sk);
+}
+
+static array<path>
+breaks (skeleton sk) {
+  array<path> r;
+  for (int i=0; i<N(sk); i++)
+    for (int j=0; j<N(sk[i]->ins); j++)
+      r << sk[i]->ins[j]->begin << sk[i]->ins[j]->end;
+  return r;
+}
+
+static void
+check_rebreak (array<page_item> old_l, array<page_item> new_l) {
+  // rebreaking a line without changing its size yields the same pages
+  skeleton old_sk= break_document (old_l);
+  skeleton sk= break_document (new_l, old_l, old_sk);
+  ASSERT_EQ (breaks (sk), breaks (break_document (new_l)));
+}
+
+static void
+check_partial_rebreak (array<page_item> old_l, array<page_item> new_l,
+                       int changed) {
+  // the optimal breaks may move all over the document, but only the pages
+  // near the change are rebroken; check that they still cover the document
+  skeleton old_sk= break_document (old_l);
+  skeleton sk= break_document (new_l, old_l, old_sk);
+  array<path> b= breaks (sk);
+  ASSERT_EQ (b[0], path (0));
+  ASSERT_EQ (b[N(b)-1], path (N(new_l)));
+  for (int i=1; i+1<N(b); i+=2) {
+    // explicit page breaks are not part of any page
+    ASSERT_TRUE (b[i] == b[i+1] || b[i+1] == path (b[i]->item + 1));
+    ASSERT_TRUE (path_inf (b[i-1], b[i]));
+  }
+  ASSERT_LE (abs (N(sk) - N(break_document (new_l))), 1);
+  for (int i=0; i<N(old_sk) && i<N(sk); i++) {
+    array<insertion> ins= old_sk[i]->ins;
+    if (ins[N(ins)-1]->end->item + 100 >= changed) break;
+    ASSERT_TRUE (sk[i].rep == old_sk[i].rep);
+  }
+}
+
+TEST (page_breaker, unchanged) {
+  array<page_item> l= document (2000);
+  skeleton sk= break_document (l);
+  skeleton sk2= break_document (l, l, sk);
+  ASSERT_EQ (N(sk2), N(sk));
+  for (int i=0; i<N(sk); i++)
+    ASSERT_TRUE (sk2[i].rep == sk[i].rep);
+}
+
+TEST (page_breaker, retyped_line) {
+  array<page_item> l= document (2000);
+  for (int k= 0; k < 2000; k += 97) {
+    array<page_item> l2= copy (l);
+    l2[k]= line (k);
+    check_rebreak (l, l2);
+  }
+}
+
+TEST (page_breaker, higher_line) {
+  array<page_item> l= document (2000);
+  for (int k= 0; k < 2000; k += 97) {
+    array<page_item> l2= copy (l);
+    l2[k]= line (k, 25000);
+    check_partial_rebreak (l, l2, k);
+  }
+}
+
+TEST (page_breaker, inserted_and_removed_lines) {
+  array<page_item> l= document (2000);
+  for (int k= 0; k < 2000; k += 97) {
+    array<page_item> l2= range (l, 0, k);
+    l2 << line (k) << line (k+1) << range (l, k, N(l));
+    check_partial_rebreak (l, l2, k);
+    check_partial_rebreak (l2, l, k);
+  }
+}
+
+TEST (page_breaker, explicit_page_breaks) {
+  array<page_item> l= document (2000);
+  for (int k= 100; k < 2000; k += 300)
+    l[k]= page_item (tree (NEW_PAGE), 1);
+  for (int k= 0; k < 2000; k += 97) {
+    array<page_item> l2= copy (l);
+    if (l2[k]->type != PAGE_CONTROL_ITEM) l2[k]= line (k, 25000);
+    check_partial_rebreak (l, l2, k);
+  }
+}
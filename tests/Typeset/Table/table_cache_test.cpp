@@ -0,0 +1,92 @@
+
+/******************************************************************************
+* MODULE     : table_cache_test.cpp
+* DESCRIPTION: test on reusing the typeset contents of unchanged cells
+* COPYRIGHT  : (C) 2026  the TeXmacs team
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "Table/table.hpp"
+#include "drd_std.hpp"
+#include "modification.hpp"
+#include "vars.hpp"
+
+extern tree the_et;
+
+class table_cache: public ::testing::Test {
+protected:
+  static void SetUpTestCase () { init_std_drd (); }
+};
+
+static tree
+large_table (int rows, int cols) {
+  tree t (TABLE);
+  for (int i=0; i<rows; i++) {
+    tree r (ROW);
+    for (int j=0; j<cols; j++)
+      r << tree (CELL, "cell " * as_string (i) * "," * as_string (j));
+    t << r;
+  }
+  return tree (TFORMAT, t);
+}
+
+static void
+check_same_layout (box b1, box b2) {
+  // b1 and b2 have the same extents and their subboxes the same positions
+  ASSERT_EQ (b1->x1, b2->x1);
+  ASSERT_EQ (b1->y1, b2->y1);
+  ASSERT_EQ (b1->x2, b2->x2);
+  ASSERT_EQ (b1->y2, b2->y2);
+  ASSERT_EQ (N(b1), N(b2));
+  for (int i=0; i<N(b1); i++) {
+    ASSERT_EQ (b1->sx (i), b2->sx (i));
+    ASSERT_EQ (b1->sy (i), b2->sy (i));
+    check_same_layout (b1[i], b2[i]);
+  }
+}
+
+TEST_F (table_cache, edit_one_cell) {
+  the_et= tuple (document (large_table (8, 8)));
+  attach_ip (the_et, path ());
+  drd_info drd ("none", std_drd);
+  hashmap<string,tree> h1 (UNINIT), h2 (UNINIT), h3 (UNINIT);
+  hashmap<string,tree> h4 (UNINIT), h5 (UNINIT), h6 (UNINIT);
+  edit_env env (drd, "none", h1, h2, h3, h4, h5, h6);
+  tree& t= the_et[0][0];
+  long long hits, misses, hits0, misses0;
+
+  // the table cache is created at the first typesetting, the cell caches
+  // at the second one; the cached contents are used from then on
+  (void) typeset_as_table (env, t, obtain_ip (t));
+  (void) typeset_as_table (env, t, obtain_ip (t));
+  cell_cache_statistics (hits0, misses0);
+  box b= typeset_as_table (env, t, obtain_ip (t));
+  cell_cache_statistics (hits, misses);
+  ASSERT_EQ (hits - hits0, 64);
+  ASSERT_EQ (misses - misses0, 0);
+  check_same_layout (b, typeset_as_table (env, copy (t), decorate ()));
+
+  // after editing a cell, only this cell is typeset again
+  apply (the_et, mod_insert (path (0, 0, 0, 3) * path (5, 0), 0, "longer "));
+  cell_cache_statistics (hits0, misses0);
+  b= typeset_as_table (env, t, obtain_ip (t));
+  cell_cache_statistics (hits, misses);
+  ASSERT_EQ (hits - hits0, 63);
+  ASSERT_EQ (misses - misses0, 1);
+  check_same_layout (b, typeset_as_table (env, copy (t), decorate ()));
+
+  // the environment before the table changed: all cells are typeset again
+  env->write (FONT_SIZE, "2");
+  env->update ();
+  cell_cache_statistics (hits0, misses0);
+  b= typeset_as_table (env, t, obtain_ip (t));
+  cell_cache_statistics (hits, misses);
+  ASSERT_EQ (hits - hits0, 0);
+  check_same_layout (b, typeset_as_table (env, copy (t), decorate ()));
+  the_et= tree ();
+}